@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+void registerModuleBenchmarks();
+void registerPatchLoadBenchmarks();
+void registerPresetBenchmarks();
+void registerStateBenchmarks();
+
+int main(int argc, char** argv) {
+    // Graph topology changes are applied on the message thread
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    registerModuleBenchmarks();
+    registerPatchLoadBenchmarks();
+    registerPresetBenchmarks();
+    registerStateBenchmarks();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
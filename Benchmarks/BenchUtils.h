@@ -0,0 +1,34 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace bench {
+
+inline constexpr double kSampleRates[] = {44100.0, 96000.0};
+inline constexpr int kBlockSizes[] = {64, 256, 1024};
+
+// Sets a parameter by ID using its real-world value. Returns false if the ID is unknown.
+inline bool setParam(juce::AudioProcessor& processor, const juce::String& paramId, float value) {
+    for (auto* p : processor.getParameters()) {
+        if (auto* withId = dynamic_cast<juce::AudioProcessorParameterWithID*>(p)) {
+            if (withId->paramID == paramId) {
+                if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p))
+                    p->setValueNotifyingHost(ranged->convertTo0to1(value));
+                else
+                    p->setValueNotifyingHost(value);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+inline bool hasParam(juce::AudioProcessor& processor, const juce::String& paramId) {
+    for (auto* p : processor.getParameters())
+        if (auto* withId = dynamic_cast<juce::AudioProcessorParameterWithID*>(p))
+            if (withId->paramID == paramId)
+                return true;
+    return false;
+}
+
+} // namespace bench
@@ -0,0 +1,116 @@
+#include "AI/AIStateMapper.h"
+#include "BenchUtils.h"
+#include "Modules/ModMatrixModule.h"
+#include "Modules/VoicePool.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+namespace {
+
+// One factory name per ModuleType, in enum order
+const char* const kModuleTypes[] = {
+    "Oscillator", "Filter", "VCA", "ADSR", "LFO", "Sequencer", "Poly Sequencer", "MIDI Keyboard", "Poly MIDI",
+    "Mod Matrix", "Delay", "Distortion", "Reverb", "Chorus", "Phaser", "Compressor", "Flanger", "Limiter",
+    "Voice Mixer"};
+
+void fillInput(juce::AudioBuffer<float>& input, const juce::String& type, bool poly, double sampleRate) {
+    const int numSamples = input.getNumSamples();
+
+    // Audio-rate test tone on every channel; doubles as moving CV for mod inputs
+    for (int ch = 0; ch < input.getNumChannels(); ++ch) {
+        auto* data = input.getWritePointer(ch);
+        float inc = juce::MathConstants<float>::twoPi * (220.0f + 10.0f * (float)ch) / (float)sampleRate;
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = 0.5f * std::sin(inc * (float)i);
+    }
+
+    if (!poly)
+        return;
+
+    // Per-voice channels carry what PolyMidi would send: pitch in Hz or a held gate
+    for (int v = 0; v < kMaxPolyVoices && v < input.getNumChannels(); ++v) {
+        if (type == "Oscillator")
+            juce::FloatVectorOperations::fill(input.getWritePointer(v), 110.0f * (float)(v + 1), numSamples);
+        else if (type == "ADSR")
+            juce::FloatVectorOperations::fill(input.getWritePointer(v), 1.0f, numSamples);
+    }
+}
+
+// The mod matrix isn't in the factory (routes create it); it is measured with every slot in use
+std::unique_ptr<juce::AudioProcessor> createBenchModule(const juce::String& type) {
+    if (type != "Mod Matrix")
+        return gsynth::AIStateMapper::createModule(type);
+    auto matrix = std::make_unique<ModMatrixModule>();
+    for (int slot = 0; slot < ModMatrixModule::kNumSlots; ++slot)
+        matrix->allocateSlot(0.5f, false);
+    return matrix;
+}
+
+void benchmarkModule(benchmark::State& state, juce::String type, bool poly, double sampleRate, int blockSize) {
+    auto processor = createBenchModule(type);
+    if (processor == nullptr) {
+        state.SkipWithError("Unknown module type");
+        return;
+    }
+
+    if (poly)
+        bench::setParam(*processor, "poly", 1.0f);
+    bench::setParam(*processor, "run", 1.0f);
+
+    const int numChannels =
+        std::max({2, processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels()});
+    processor->setPlayConfigDetails(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels(),
+                                    sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> input(numChannels, blockSize);
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    fillInput(input, type, poly, sampleRate);
+
+    // A held chord, re-sent every block (retriggers are cheap, allocation stays warm)
+    juce::MidiBuffer chord;
+    for (int note : {48, 55, 60, 64})
+        chord.addEvent(juce::MidiMessage::noteOn(1, note, 0.8f), 0);
+    juce::MidiBuffer midi;
+    midi.ensureSize(1024);
+
+    for (auto _ : state) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.copyFrom(ch, 0, input, ch, 0, blockSize);
+        midi.clear();
+        midi.addEvents(chord, 0, blockSize, 0);
+
+        processor->processBlock(buffer, midi);
+        benchmark::DoNotOptimize(buffer.getReadPointer(0));
+        benchmark::ClobberMemory();
+    }
+
+    processor->releaseResources();
+    state.SetItemsProcessed(state.iterations() * blockSize);
+    state.counters["channels"] = numChannels;
+}
+
+} // namespace
+
+void registerModuleBenchmarks() {
+    for (const char* typeName : kModuleTypes) {
+        juce::String type(typeName);
+        auto probe = createBenchModule(type);
+        bool hasPoly = probe != nullptr && bench::hasParam(*probe, "poly");
+
+        for (bool poly : {false, true}) {
+            if (poly && !hasPoly)
+                continue;
+            for (double sampleRate : bench::kSampleRates) {
+                for (int blockSize : bench::kBlockSizes) {
+                    auto name = "Module/" + type.replace(" ", "_") + (poly ? "/poly" : "/mono") +
+                                "/sr:" + juce::String((int)sampleRate) + "/bs:" + juce::String(blockSize);
+                    benchmark::RegisterBenchmark(name.toStdString(), [=](benchmark::State& state) {
+                        benchmarkModule(state, type, poly, sampleRate, blockSize);
+                    });
+                }
+            }
+        }
+    }
+}
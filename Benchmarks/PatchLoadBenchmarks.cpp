@@ -0,0 +1,88 @@
+#include "AI/AIStateMapper.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// numVoices chains of Oscillator -> Filter -> VCA -> Output, each with an LFO modulating the
+// filter cutoff: four nodes per voice, plus the mod matrices the modulations share
+juce::var buildPatch(int numVoices) {
+    juce::Array<juce::var> nodes, connections, modulations;
+    constexpr int kOutputId = 1;
+
+    auto addNode = [&nodes](int id, const char* type, const char* params) {
+        juce::DynamicObject::Ptr node = new juce::DynamicObject();
+        node->setProperty("id", id);
+        node->setProperty("type", type);
+        if (params != nullptr)
+            node->setProperty("params", juce::JSON::parse(params));
+        nodes.add(juce::var(node.get()));
+    };
+    auto addConnection = [&connections](int src, int dst) {
+        juce::DynamicObject::Ptr c = new juce::DynamicObject();
+        c->setProperty("src", src);
+        c->setProperty("srcPort", 0);
+        c->setProperty("dst", dst);
+        c->setProperty("dstPort", 0);
+        connections.add(juce::var(c.get()));
+    };
+
+    addNode(kOutputId, "Audio Output", nullptr);
+    for (int v = 0; v < numVoices; ++v) {
+        int lfo = 10 + v * 4, osc = lfo + 1, filter = lfo + 2, vca = lfo + 3;
+        addNode(lfo, "LFO", R"({"rateHz": 2.5})");
+        addNode(osc, "Oscillator", R"({"waveform": "Saw", "fine": 5.0, "level": 0.8})");
+        addNode(filter, "Filter", R"({"cutoff": 1200.0, "resonance": 0.3})");
+        addNode(vca, "VCA", R"({"gain": 0.7})");
+        addConnection(osc, filter);
+        addConnection(filter, vca);
+        addConnection(vca, kOutputId);
+
+        juce::DynamicObject::Ptr mod = new juce::DynamicObject();
+        mod->setProperty("source", lfo);
+        mod->setProperty("dest", filter);
+        mod->setProperty("destPort", 1);
+        mod->setProperty("amount", 0.5);
+        modulations.add(juce::var(mod.get()));
+    }
+
+    juce::DynamicObject::Ptr patch = new juce::DynamicObject();
+    patch->setProperty("nodes", nodes);
+    patch->setProperty("connections", connections);
+    patch->setProperty("modulations", modulations);
+    return juce::var(patch.get());
+}
+
+// Loads a patch into an empty graph. Items are nodes, so ns/item stays flat while loading is
+// linear, and the regression gate catches a load that starts growing faster than the patch
+void benchmarkPatchLoad(benchmark::State& state) {
+    const auto patch = buildPatch((int)state.range(0));
+    juce::AudioProcessorGraph graph;
+    int numNodes = 0;
+
+    for (auto _ : state) {
+        if (!gsynth::AIStateMapper::applyJSONToGraph(patch, graph, true, true)) {
+            state.SkipWithError("Patch failed to load");
+            return;
+        }
+        numNodes = graph.getNumNodes();
+
+        state.PauseTiming();
+        graph.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t)numNodes);
+    state.SetComplexityN(numNodes);
+    state.counters["nodes"] = (double)numNodes;
+}
+
+} // namespace
+
+void registerPatchLoadBenchmarks() {
+    benchmark::RegisterBenchmark("PatchLoad", benchmarkPatchLoad)
+        ->Arg(12)
+        ->Arg(25)
+        ->Arg(50)
+        ->Complexity(benchmark::oN)
+        ->Unit(benchmark::kMillisecond);
+}
@@ -0,0 +1,53 @@
+#include "OfflineRenderer.h"
+#include "PresetManager.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr double kPresetSampleRate = 48000.0;
+constexpr int kPresetBlockSizes[] = {128, 512};
+
+void benchmarkPreset(benchmark::State& state, int presetIndex, int blockSize) {
+    juce::AudioProcessorGraph graph;
+    if (!gsynth::PresetManager::loadPreset(presetIndex, graph)) {
+        state.SkipWithError("Preset failed to load");
+        return;
+    }
+
+    gsynth::OfflineRenderer renderer(graph, kPresetSampleRate, blockSize);
+    renderer.prepare();
+
+    // Hold a chord so envelopes sit at sustain and every voice path is live
+    for (int note : {48, 55, 60, 64})
+        renderer.noteOn(note, 0.8f);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+
+    // Let attacks settle before timing
+    for (int i = 0; i < 32; ++i)
+        renderer.processBlock(buffer);
+
+    for (auto _ : state) {
+        renderer.processBlock(buffer);
+        benchmark::DoNotOptimize(buffer.getReadPointer(0));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * blockSize);
+    state.counters["nodes"] = (double)graph.getNumNodes();
+}
+
+} // namespace
+
+void registerPresetBenchmarks() {
+    auto names = gsynth::PresetManager::getPresetNames();
+    for (int i = 0; i < names.size(); ++i) {
+        for (int blockSize : kPresetBlockSizes) {
+            auto name = "Preset/" + names[i].replace(" ", "_") + "/sr:" + juce::String((int)kPresetSampleRate) +
+                        "/bs:" + juce::String(blockSize);
+            benchmark::RegisterBenchmark(name.toStdString(), [i, blockSize](benchmark::State& state) {
+                benchmarkPreset(state, i, blockSize);
+            });
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include "Modules/ModuleBase.h"
+#include "PresetManager.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+enum class StateFormat { Binary, Xml };
+
+// The preset with the most nodes, so per-module overhead dominates
+int findLargestPreset() {
+    int largest = -1;
+    int mostNodes = -1;
+    auto names = gsynth::PresetManager::getPresetNames();
+    for (int i = 0; i < names.size(); ++i) {
+        juce::AudioProcessorGraph graph;
+        if (gsynth::PresetManager::loadPreset(i, graph) && graph.getNumNodes() > mostNodes) {
+            mostNodes = graph.getNumNodes();
+            largest = i;
+        }
+    }
+    return largest;
+}
+
+// Saves and restores every module in the preset, as an undo snapshot or preset save would
+void benchmarkState(benchmark::State& state, int presetIndex, StateFormat format) {
+    juce::AudioProcessorGraph graph;
+    if (presetIndex < 0 || !gsynth::PresetManager::loadPreset(presetIndex, graph)) {
+        state.SkipWithError("Preset failed to load");
+        return;
+    }
+
+    std::vector<ModuleBase*> modules;
+    for (auto* node : graph.getNodes())
+        if (auto* module = dynamic_cast<ModuleBase*>(node->getProcessor()))
+            modules.push_back(module);
+
+    std::vector<juce::MemoryBlock> blocks(modules.size());
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        bytes = 0;
+        for (size_t i = 0; i < modules.size(); ++i) {
+            if (format == StateFormat::Binary)
+                modules[i]->getStateInformation(blocks[i]);
+            else
+                modules[i]->getXmlStateInformation(blocks[i]);
+            modules[i]->setStateInformation(blocks[i].getData(), (int)blocks[i].getSize());
+            bytes += blocks[i].getSize();
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t)modules.size());
+    state.counters["modules"] = (double)modules.size();
+    state.counters["bytes"] = (double)bytes;
+}
+
+} // namespace
+
+void registerStateBenchmarks() {
+    int preset = findLargestPreset();
+    auto name = preset >= 0 ? gsynth::PresetManager::getPresetNames()[preset].replace(" ", "_") : juce::String("none");
+    benchmark::RegisterBenchmark(("State/Binary/" + name).toStdString(), [preset](benchmark::State& state) {
+        benchmarkState(state, preset, StateFormat::Binary);
+    });
+    benchmark::RegisterBenchmark(("State/Xml/" + name).toStdString(), [preset](benchmark::State& state) {
+        benchmarkState(state, preset, StateFormat::Xml);
+    });
+}
@@ -2,6 +2,11 @@
 
 namespace gsynth {
 
+namespace {
+// Separates the injected patch context from the user's own words
+const juce::String kUserRequestMarker = "\n\nUser request: ";
+} // namespace
+
 AIIntegrationService::AIIntegrationService(juce::AudioProcessorGraph& graph)
     : audioGraph(graph) {
     initSystemPrompt();
@@ -12,36 +17,37 @@ AIIntegrationService::~AIIntegrationService() {}
 void AIIntegrationService::setProvider(std::unique_ptr<AIProvider> newProvider) { provider = std::move(newProvider); }
 
 void AIIntegrationService::sendMessage(const juce::String& text, AIProvider::CompletionCallback callback,
-                                       bool useStructuredOutput) {
+                                       bool useStructuredOutput, AIProvider::PartialCallback onToken) {
     // Inject current graph state only for patch-related requests
-    juce::String messageContent = text;
-    if (useStructuredOutput) {
-        juce::var graphJson = AIStateMapper::graphToJSON(audioGraph);
-        if (auto* obj = graphJson.getDynamicObject()) {
-            if (auto* nodeArr = obj->getProperty("nodes").getArray()) {
-                if (!nodeArr->isEmpty()) {
-                    messageContent = "Current patch state:\n```json\n" + juce::JSON::toString(graphJson) +
-                                     "\n```\n\nUser request: " + text;
-                }
-            }
-        }
-    }
-
-    chatHistory.push_back({"user", messageContent});
+    chatHistory.push_back({"user", useStructuredOutput ? buildPatchRequest(text) : text});
 
     if (provider) {
         auto weakThis = juce::WeakReference<AIIntegrationService>(this);
         auto schema = useStructuredOutput ? AIStateMapper::getPatchSchema() : juce::var();
+        auto window = getPromptWindow();
+
+        juce::String cacheKey;
+        if (responseCache != nullptr) {
+            cacheKey = AIResponseCache::makeKey(provider->getCurrentModel(), window, schema);
+            if (auto cached = responseCache->lookup(cacheKey)) {
+                chatHistory.push_back({"assistant", *cached});
+                if (callback)
+                    callback(*cached, true);
+                return;
+            }
+        }
 
-        provider->sendPrompt(
-            chatHistory,
-            [weakThis, callback](const juce::String& response, bool success) {
+        provider->sendPromptStreaming(
+            window, std::move(onToken),
+            [weakThis, callback, cacheKey](const juce::String& response, bool success) {
                 if (weakThis.get() == nullptr)
                     return; // Service was destroyed
 
                 auto* self = weakThis.get();
                 if (success) {
                     self->chatHistory.push_back({"assistant", response});
+                    if (self->responseCache != nullptr && cacheKey.isNotEmpty())
+                        self->responseCache->store(cacheKey, response);
                 }
                 if (callback) {
                     callback(response, success);
@@ -55,6 +61,78 @@ void AIIntegrationService::sendMessage(const juce::String& text, AIProvider::Com
     }
 }
 
+juce::String AIIntegrationService::buildPatchRequest(const juce::String& text) {
+    juce::var current = PatchContextEncoder::encode(audioGraph);
+    auto* nodes = current["n"].getArray();
+    if (nodes == nullptr || nodes->isEmpty()) {
+        lastSentContext = juce::var();
+        contextBaseIndex = 0;
+        return text;
+    }
+
+    auto fullSnapshot = [&] {
+        return "Current patch state (compact format):\n```json\n" + juce::JSON::toString(current, true) + "\n```" +
+               kUserRequestMarker + text;
+    };
+
+    // Deltas are only meaningful while the snapshot they build on is still in the prompt window
+    if (lastSentContext.isObject() && contextBaseIndex > 0) {
+        juce::var delta = PatchContextEncoder::diff(lastSentContext, current);
+        juce::String content = "Patch unchanged since the last state I sent.";
+        if (!delta.isVoid())
+            content = "Patch changes since the last state I sent (compact delta):\n```json\n" +
+                      juce::JSON::toString(delta, true) + "\n```";
+        content += kUserRequestMarker + text;
+
+        chatHistory.push_back({"user", content});
+        bool baseStillSent = getFirstWindowIndex() <= contextBaseIndex;
+        chatHistory.pop_back();
+
+        if (baseStillSent) {
+            lastSentContext = current;
+            return content;
+        }
+    }
+
+    lastSentContext = current;
+    contextBaseIndex = chatHistory.size(); // Index this message will occupy
+    return fullSnapshot();
+}
+
+size_t AIIntegrationService::getFirstWindowIndex() const {
+    // Walk back from the newest message; the newest one is always included
+    size_t first = chatHistory.size();
+    int used = 0;
+    for (size_t i = chatHistory.size(); i-- > 1;) {
+        int cost = PatchContextEncoder::estimateTokens(chatHistory[i].content);
+        if (i + 1 < chatHistory.size() && used + cost > historyTokenBudget)
+            break;
+        used += cost;
+        first = i;
+    }
+    return first;
+}
+
+std::vector<AIProvider::Message> AIIntegrationService::getPromptWindow() const {
+    std::vector<AIProvider::Message> window;
+    if (!chatHistory.empty() && chatHistory.front().role == "system")
+        window.push_back(chatHistory.front());
+
+    for (size_t i = getFirstWindowIndex(); i < chatHistory.size(); ++i) {
+        auto message = chatHistory[i];
+        // Snapshots older than the current base are superseded; keep only the user's words
+        if (message.role == "user" && i < contextBaseIndex && message.content.contains(kUserRequestMarker))
+            message.content = message.content.fromLastOccurrenceOf(kUserRequestMarker, false, false);
+        window.push_back(std::move(message));
+    }
+    return window;
+}
+
+void AIIntegrationService::cancelPendingRequests() {
+    if (provider)
+        provider->cancelAllRequests();
+}
+
 bool AIIntegrationService::applyPatch(const juce::String& jsonString, bool mergeMode) {
     juce::String extractedJson = extractJsonFromResponse(jsonString);
     juce::var json = juce::JSON::parse(extractedJson);
@@ -65,6 +143,13 @@ bool AIIntegrationService::applyPatch(const juce::String& jsonString, bool merge
     return false;
 }
 
+void AIIntegrationService::auditionPatch(const juce::String& jsonString, bool mergeMode,
+                                        PatchAuditioner::Callback callback) {
+    juce::var json = juce::JSON::parse(extractJsonFromResponse(jsonString));
+    juce::var basePatch = mergeMode ? AIStateMapper::graphToJSON(audioGraph) : juce::var();
+    auditioner.audition(json, std::move(callback), basePatch);
+}
+
 juce::String AIIntegrationService::extractJsonFromResponse(const juce::String& response) {
     // 1. Try to find JSON between backticks
     int start = response.indexOf("```json");
@@ -100,6 +185,8 @@ juce::String AIIntegrationService::getPatchContext() {
 
 void AIIntegrationService::clearHistory() {
     chatHistory.clear();
+    lastSentContext = juce::var();
+    contextBaseIndex = 0;
     initSystemPrompt();
 }
 
@@ -142,6 +229,14 @@ void AIIntegrationService::initSystemPrompt() {
         "  ]\n"
         "}\n"
         "```\n"
+        "\n### PATCH CONTEXT FORMAT:\n"
+        "The current patch state is sent in a compact form: `n` lists nodes as `{\"i\": id, \"t\": type, "
+        "\"p\": params}` where `p` holds only parameters that differ from their defaults; `c` lists connections as "
+        "`[src, srcPort, dst, dstPort]`; `m` lists modulations as `[source, sourcePort, dest, destPort, amount]` "
+        "(a trailing `1` means bypassed). Later messages may send only a delta (`\"d\": 1`) against the previous "
+        "state: changed nodes in `n` with only the changed params, removed node IDs in `rm`, added and removed "
+        "connections in `c` and `rc`, changed modulations in `m` and removed ones in `rmm` as "
+        "`[source, dest, destPort]`. Reply in the regular patch format described above.\n"
         "\n### DELTA / MERGE MODE:\n"
         "When the user's message includes their current patch state (as JSON) and they ask to ADD, MODIFY, or REMOVE "
         "elements, respond with only the CHANGES (delta), not the entire patch. Include `\"mode\": \"merge\"` in your "
@@ -167,7 +262,7 @@ void AIIntegrationService::initSystemPrompt() {
         "**ALWAYS use the `modulations` array** when routing a modulation source (LFO, ADSR, envelope) "
         "to a parameter target (filter cutoff, VCA CV, etc.). Do NOT use `connections` for modulation — "
         "`connections` are ONLY for audio signal flow (e.g., Oscillator->Filter->VCA->Output) and MIDI. "
-        "The system automatically creates the necessary Attenuverter intermediary.\n"
+        "The system adds each modulation to its mod matrix, which scales it by `amount`.\n"
         "\nEach modulation entry needs:\n"
         "- `source`: node ID of the modulation source (LFO, envelope, etc.)\n"
         "- `sourcePort` (optional, default 0): output port of the source module\n"
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "AIProvider.h"
+#include "AIResponseCache.h"
 #include "AIStateMapper.h"
+#include "PatchAudition.h"
+#include "PatchContextEncoder.h"
 #include <functional>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_core/juce_core.h>
@@ -36,15 +39,31 @@ public:
 
     /**
      * @brief Sends a user message and gets a response.
+     * @param onToken Optional; receives partial response text as it streams in.
      */
     void sendMessage(const juce::String& text, AIProvider::CompletionCallback callback,
-                     bool useStructuredOutput = false);
+                     bool useStructuredOutput = false, AIProvider::PartialCallback onToken = nullptr);
+
+    /**
+     * @brief Cancels every queued and in-flight request on the current provider.
+     */
+    void cancelPendingRequests();
 
     /**
      * @brief Applies a JSON patch to the graph.
      */
     bool applyPatch(const juce::String& jsonString, bool mergeMode = false);
 
+    /**
+     * @brief Renders a proposed patch in a sandbox graph and reports on it, without touching the live graph.
+     *
+     * In merge mode the proposal is merged into a copy of the current patch. The callback is
+     * called on the message thread.
+     */
+    void auditionPatch(const juce::String& jsonString, bool mergeMode, PatchAuditioner::Callback callback);
+
+    PatchAuditioner& getAuditioner() { return auditioner; }
+
     /**
      * @brief Returns the current graph state as a JSON string for context.
      */
@@ -60,6 +79,32 @@ public:
      */
     void clearHistory();
 
+    /**
+     * @brief Enables (or, with nullptr, disables) the on-disk response cache.
+     *
+     * When set, a request whose model, schema and prompt window match an earlier
+     * successful one is answered from the cache without calling the provider.
+     */
+    void setResponseCache(std::unique_ptr<AIResponseCache> cache) { responseCache = std::move(cache); }
+    AIResponseCache* getResponseCache() const { return responseCache.get(); }
+
+    static constexpr int kDefaultHistoryTokenBudget = 4096;
+
+    /**
+     * @brief Caps the estimated tokens of chat history resent with each request.
+     *
+     * The system prompt and the newest message are always sent; older turns are dropped
+     * oldest first once the budget is exceeded.
+     */
+    void setHistoryTokenBudget(int tokens) { historyTokenBudget = juce::jmax(0, tokens); }
+    int getHistoryTokenBudget() const { return historyTokenBudget; }
+
+    /**
+     * @brief The messages the next request would send: the system prompt plus the newest
+     * history that fits the token budget, with superseded patch contexts stripped.
+     */
+    std::vector<AIProvider::Message> getPromptWindow() const;
+
     /**
      * @brief Model management methods.
      */
@@ -69,11 +114,19 @@ public:
 
 private:
     std::unique_ptr<AIProvider> provider;
+    std::unique_ptr<AIResponseCache> responseCache;
     std::vector<AIProvider::Message> chatHistory;
     juce::AudioProcessorGraph& audioGraph;
     juce::ListenerList<Listener> listeners;
+    PatchAuditioner auditioner;
+
+    int historyTokenBudget = kDefaultHistoryTokenBudget;
+    juce::var lastSentContext;   // Compact snapshot included with the last patch request
+    size_t contextBaseIndex = 0; // History index of the message holding the last full snapshot; 0 if none
 
     void initSystemPrompt();
+    juce::String buildPatchRequest(const juce::String& text);
+    size_t getFirstWindowIndex() const;
 
     /**
      * @brief Helper to extract JSON from a response that might contain conversational text.
@@ -24,6 +24,12 @@ public:
 
     using CompletionCallback = std::function<void(const juce::String& response, bool success)>;
 
+    /** Receives each chunk of the response text as it arrives, before the completion callback. */
+    using PartialCallback = std::function<void(const juce::String& token)>;
+
+    /** Identifies a request for cancelRequest(). 0 means "not cancellable". */
+    using RequestId = int;
+
     /**
      * @brief Sends a prompt to the AI and calls the callback when the response is ready.
      * @param conversation The chat history
@@ -33,6 +39,31 @@ public:
     virtual void sendPrompt(const std::vector<Message>& conversation, CompletionCallback callback,
                             const juce::var& responseSchema = juce::var()) = 0;
 
+    /**
+     * @brief Like sendPrompt(), but also reports partial tokens as the response streams in.
+     *
+     * The completion callback still receives the full text. onToken is called on the
+     * message thread. Providers that cannot stream fall back to sendPrompt() and never
+     * call onToken.
+     * @return An id for cancelRequest(), or 0 if the provider cannot cancel.
+     */
+    virtual RequestId sendPromptStreaming(const std::vector<Message>& conversation, PartialCallback onToken,
+                                          CompletionCallback callback, const juce::var& responseSchema = juce::var()) {
+        juce::ignoreUnused(onToken);
+        sendPrompt(conversation, std::move(callback), responseSchema);
+        return 0;
+    }
+
+    /**
+     * @brief Cancels a queued or in-flight request. Its completion callback reports failure.
+     */
+    virtual void cancelRequest(RequestId id) { juce::ignoreUnused(id); }
+
+    /**
+     * @brief Cancels every queued and in-flight request.
+     */
+    virtual void cancelAllRequests() {}
+
     /**
      * @brief Returns the name of the provider.
      */
@@ -0,0 +1,71 @@
+#include "AIResponseCache.h"
+#include <juce_cryptography/juce_cryptography.h>
+
+namespace gsynth {
+
+namespace {
+constexpr const char* kEntrySuffix = ".json";
+
+// Length-prefixed so that no two different inputs serialise to the same text
+void appendField(juce::String& out, const juce::String& field) { out << field.length() << ":" << field << "\n"; }
+} // namespace
+
+AIResponseCache::AIResponseCache(const juce::File& cacheDirectory)
+    : directory(cacheDirectory) {
+    directory.createDirectory();
+}
+
+juce::String AIResponseCache::makeKey(const juce::String& model, const std::vector<AIProvider::Message>& conversation,
+                                      const juce::var& responseSchema) {
+    juce::String material;
+    appendField(material, model);
+    appendField(material, responseSchema.isVoid() ? juce::String() : juce::JSON::toString(responseSchema, true));
+    for (const auto& message : conversation) {
+        appendField(material, message.role);
+        appendField(material, message.content);
+    }
+    return juce::SHA256(material.toUTF8()).toHexString();
+}
+
+juce::File AIResponseCache::getEntryFile(const juce::String& key) const {
+    return directory.getChildFile(key + kEntrySuffix);
+}
+
+std::optional<juce::String> AIResponseCache::lookup(const juce::String& key) const {
+    auto file = getEntryFile(key);
+    if (!file.existsAsFile())
+        return std::nullopt;
+
+    juce::var entry = juce::JSON::parse(file);
+    if (!entry.hasProperty("response"))
+        return std::nullopt;
+    return entry["response"].toString();
+}
+
+void AIResponseCache::store(const juce::String& key, const juce::String& response) {
+    juce::DynamicObject::Ptr entry = new juce::DynamicObject();
+    entry->setProperty("response", response);
+    entry->setProperty("created", juce::Time::getCurrentTime().toISO8601(true));
+
+    auto file = getEntryFile(key);
+    juce::TemporaryFile temp(file);
+    if (temp.getFile().replaceWithText(juce::JSON::toString(juce::var(entry.get()))))
+        temp.overwriteTargetFileWithTemporary();
+}
+
+void AIResponseCache::clear() {
+    for (auto& file : directory.findChildFiles(juce::File::findFiles, false, juce::String("*") + kEntrySuffix))
+        file.deleteFile();
+}
+
+int AIResponseCache::getNumEntries() const {
+    return directory.getNumberOfChildFiles(juce::File::findFiles, juce::String("*") + kEntrySuffix);
+}
+
+juce::File AIResponseCache::getDefaultDirectory(juce::ApplicationProperties& properties) {
+    if (auto* settings = properties.getUserSettings())
+        return settings->getFile().getSiblingFile("AIResponseCache");
+    return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("GravisynthAIResponseCache");
+}
+
+} // namespace gsynth
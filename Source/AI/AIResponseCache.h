@@ -0,0 +1,46 @@
+#pragma once
+
+#include "AIProvider.h"
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <optional>
+#include <vector>
+
+namespace gsynth {
+
+/**
+ * @class AIResponseCache
+ * @brief Optional on-disk, content-addressed store of successful AI responses.
+ *
+ * Entries are keyed by a SHA-256 of the model name, the response schema and the exact
+ * (already compacted) conversation sent, so repeating a prompt, or replaying a fixed one
+ * in a regression test, is answered without contacting the provider. Each entry is a
+ * small JSON file named after its key, written through a temporary file so an
+ * interrupted write never leaves a truncated entry behind. Message thread only.
+ */
+class AIResponseCache {
+public:
+    explicit AIResponseCache(const juce::File& cacheDirectory);
+
+    static juce::String makeKey(const juce::String& model, const std::vector<AIProvider::Message>& conversation,
+                                const juce::var& responseSchema);
+
+    std::optional<juce::String> lookup(const juce::String& key) const;
+    void store(const juce::String& key, const juce::String& response);
+
+    void clear();
+    int getNumEntries() const;
+    const juce::File& getDirectory() const { return directory; }
+
+    /** "AIResponseCache" next to the user settings file. */
+    static juce::File getDefaultDirectory(juce::ApplicationProperties& properties);
+
+private:
+    juce::File getEntryFile(const juce::String& key) const;
+
+    juce::File directory;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AIResponseCache)
+};
+
+} // namespace gsynth
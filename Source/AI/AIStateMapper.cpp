@@ -1,6 +1,5 @@
 #include "AIStateMapper.h"
 #include "../Modules/ADSRModule.h"
-#include "../Modules/AttenuverterModule.h"
 #include "../Modules/FX/ChorusModule.h"
 #include "../Modules/FX/CompressorModule.h"
 #include "../Modules/FX/DelayModule.h"
@@ -19,10 +18,22 @@
 #include "../Modules/SequencerModule.h"
 #include "../Modules/VCAModule.h"
 #include "../Modules/VoiceMixerModule.h"
+#include "../GraphTransaction.h"
+#include "../ModMatrixRoutes.h"
+#include "../OversamplingBinder.h"
+#include "../TraceRecorder.h"
+#include "PatchContextEncoder.h"
+#include <algorithm>
+#include <atomic>
 #include <functional> // For std::function
+#include <limits>
 #include <map>
+#include <optional>
 #include <set>
+#include <tuple>
+#include <typeindex>
 #include <unordered_map> // For the factory map
+#include <unordered_set>
 
 namespace gsynth {
 
@@ -49,8 +60,6 @@ static const std::unordered_map<juce::String, ModuleFactoryFunc> moduleFactory =
     {"Filter Env", []() { return std::make_unique<ADSRModule>("Filter Env"); }},
     {"Poly MIDI", []() { return std::make_unique<PolyMidiModule>(); }},
     {"Poly Sequencer", []() { return std::make_unique<PolySequencerModule>(); }},
-    {"Attenuverter", []() { return std::make_unique<AttenuverterModule>(); }},
-    {"Mod Slot", []() { return std::make_unique<AttenuverterModule>(); }},
     {"Chorus", []() { return std::make_unique<ChorusModule>(); }},
     {"Phaser", []() { return std::make_unique<PhaserModule>(); }},
     {"Compressor", []() { return std::make_unique<CompressorModule>(); }},
@@ -58,6 +67,98 @@ static const std::unordered_map<juce::String, ModuleFactoryFunc> moduleFactory =
     {"Limiter", []() { return std::make_unique<LimiterModule>(); }},
     {"Voice Mixer", []() { return std::make_unique<VoiceMixerModule>(); }}};
 
+static std::atomic<bool> verboseLogging{false};
+
+void AIStateMapper::setVerboseLogging(bool shouldLog) { verboseLogging = shouldLog; }
+bool AIStateMapper::isVerboseLogging() { return verboseLogging; }
+
+namespace {
+
+enum class ParamKind { Float, Int, Choice, Bool };
+
+struct ParamEntry {
+    int index = 0;
+    ParamKind kind = ParamKind::Float;
+};
+
+using ParamTable = std::unordered_map<juce::String, ParamEntry>;
+
+// paramID -> parameter index and kind, built once per processor class; parameter sets are
+// fixed at construction, so every instance of a class shares a table
+const ParamTable& getParamTable(juce::AudioProcessor& processor) {
+    static juce::CriticalSection lock;
+    static std::unordered_map<std::type_index, ParamTable> tables;
+
+    const juce::ScopedLock sl(lock);
+    auto [it, inserted] = tables.try_emplace(std::type_index(typeid(processor)));
+    if (inserted) {
+        const auto& params = processor.getParameters();
+        for (int i = 0; i < params.size(); ++i) {
+            auto* p = dynamic_cast<juce::RangedAudioParameter*>(params[i]);
+            if (p == nullptr)
+                continue;
+            ParamKind kind = ParamKind::Float;
+            if (dynamic_cast<juce::AudioParameterChoice*>(p) != nullptr)
+                kind = ParamKind::Choice;
+            else if (dynamic_cast<juce::AudioParameterBool*>(p) != nullptr)
+                kind = ParamKind::Bool;
+            else if (dynamic_cast<juce::AudioParameterInt*>(p) != nullptr)
+                kind = ParamKind::Int;
+            it->second[p->paramID] = {i, kind};
+        }
+    }
+    return it->second;
+}
+
+// A complete modulation route as the JSON names it. The source port comes last so a lookup
+// can ignore it with a range on the first three fields.
+using ModRouteKey = std::tuple<juce::uint32, juce::uint32, int, int>; // src, dst, dstPort, srcPort
+using ModRouteIndex = std::multimap<ModRouteKey, juce::AudioProcessorGraph::NodeID>;
+
+ModRouteKey makeModRouteKey(const juce::AudioProcessorGraph::NodeAndChannel& source,
+                            const juce::AudioProcessorGraph::NodeAndChannel& dest) {
+    return {source.nodeID.uid, dest.nodeID.uid, dest.channelIndex, source.channelIndex};
+}
+
+// Every route with both ends, from one pass over the nodes and one over the connections
+ModRouteIndex indexModRoutes(const juce::AudioProcessorGraph& graph) {
+    ModRouteIndex routes;
+    for (const auto& route : getModRoutes(graph))
+        if (route.source && route.dest)
+            routes.emplace(makeModRouteKey(*route.source, *route.dest), route.id);
+    return routes;
+}
+
+// First route for the routing; any source port matches if sourcePort is nullopt. Routes are
+// erased from the index as they're removed, so every entry is live.
+ModRouteIndex::iterator findIndexedRoute(ModRouteIndex& routes, juce::uint32 src, juce::uint32 dst, int dstPort,
+                                         std::optional<int> sourcePort) {
+    auto it = routes.lower_bound(ModRouteKey{src, dst, dstPort, sourcePort.value_or(std::numeric_limits<int>::min())});
+    if (it == routes.end())
+        return it;
+    const auto& [s, d, dp, sp] = it->first;
+    if (s != src || d != dst || dp != dstPort || (sourcePort && sp != *sourcePort))
+        return routes.end();
+    return it;
+}
+
+// Patches saved before the mod matrix route each modulation through its own "Attenuverter"
+// node (later named "Mod Slot"): source -> channel 0 -> dest, scaled by its "amount".
+bool isLegacyModSlotType(juce::String type) {
+    int lastSpace = type.lastIndexOf(" ");
+    if (lastSpace != -1 && type.substring(lastSpace + 1).containsOnly("0123456789"))
+        type = type.substring(0, lastSpace);
+    return type == "Attenuverter" || type == "Mod Slot";
+}
+
+struct LegacyModSlot {
+    float amount = 0.0f;
+    bool bypass = false;
+    std::optional<juce::AudioProcessorGraph::NodeAndChannel> source, dest;
+};
+
+} // namespace
+
 bool AIStateMapper::validatePatchJSON(const juce::var& json) {
     if (!json.isObject()) {
         juce::Logger::writeToLog("validatePatchJSON: Root is not an object.");
@@ -140,8 +241,8 @@ static juce::String getFactoryTypeName(juce::AudioProcessor* processor) {
             return "MIDI Keyboard";
         case ModuleType::PolyMidi:
             return "Poly MIDI";
-        case ModuleType::Attenuverter:
-            return "Attenuverter";
+        case ModuleType::ModMatrix:
+            return "Mod Matrix";
         case ModuleType::Delay:
             return "Delay";
         case ModuleType::Distortion:
@@ -165,35 +266,45 @@ static juce::String getFactoryTypeName(juce::AudioProcessor* processor) {
     return processor->getName();
 }
 
+juce::var AIStateMapper::paramsToJSON(juce::AudioProcessor& processor) {
+    // Store denormalized values to match applyJSONToGraph expectations
+    juce::DynamicObject::Ptr params = new juce::DynamicObject();
+    for (auto* param : processor.getParameters()) {
+        if (auto* p = dynamic_cast<juce::AudioProcessorParameterWithID*>(param)) {
+            if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(param)) {
+                // Store choice as string name for readability
+                params->setProperty(choice->paramID, choice->getCurrentChoiceName());
+            } else if (auto* boolParam = dynamic_cast<juce::AudioParameterBool*>(param)) {
+                params->setProperty(boolParam->paramID, boolParam->get());
+            } else if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param)) {
+                // Store denormalized value
+                float denormalized = ranged->getNormalisableRange().convertFrom0to1(ranged->getValue());
+                params->setProperty(ranged->paramID, denormalized);
+            } else {
+                params->setProperty(p->paramID, p->getValue());
+            }
+        }
+    }
+    return juce::var(params.get());
+}
+
 juce::var AIStateMapper::graphToJSON(juce::AudioProcessorGraph& graph) {
     juce::DynamicObject::Ptr root = new juce::DynamicObject();
 
+    // Mod matrix nodes and their links are written as the "modulations" array below
+    std::unordered_set<juce::uint32> matrices;
     juce::Array<juce::var> nodes;
     for (auto* node : graph.getNodes()) {
+        if (isModMatrixNode(*node)) {
+            matrices.insert(node->nodeID.uid);
+            continue;
+        }
         if (auto* processor = node->getProcessor()) {
             juce::DynamicObject::Ptr n = new juce::DynamicObject();
             n->setProperty("id", (int)node->nodeID.uid);
             n->setProperty("type", getFactoryTypeName(processor));
 
-            // Params — store denormalized values to match applyJSONToGraph expectations
-            juce::DynamicObject::Ptr params = new juce::DynamicObject();
-            for (auto* param : processor->getParameters()) {
-                if (auto* p = dynamic_cast<juce::AudioProcessorParameterWithID*>(param)) {
-                    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(param)) {
-                        // Store choice as string name for readability
-                        params->setProperty(choice->paramID, choice->getCurrentChoiceName());
-                    } else if (auto* boolParam = dynamic_cast<juce::AudioParameterBool*>(param)) {
-                        params->setProperty(boolParam->paramID, boolParam->get());
-                    } else if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param)) {
-                        // Store denormalized value
-                        float denormalized = ranged->getNormalisableRange().convertFrom0to1(ranged->getValue());
-                        params->setProperty(ranged->paramID, denormalized);
-                    } else {
-                        params->setProperty(p->paramID, p->getValue());
-                    }
-                }
-            }
-            n->setProperty("params", juce::var(params.get()));
+            n->setProperty("params", paramsToJSON(*processor));
 
             // Position
             juce::DynamicObject::Ptr pos = new juce::DynamicObject();
@@ -201,6 +312,9 @@ juce::var AIStateMapper::graphToJSON(juce::AudioProcessorGraph& graph) {
             pos->setProperty("y", node->properties["y"]);
             n->setProperty("position", juce::var(pos.get()));
 
+            if (int factor = gsynth::getOversamplingFactor(*node); factor > 1)
+                n->setProperty("oversampling", factor);
+
             nodes.add(juce::var(n.get()));
         }
     }
@@ -208,6 +322,8 @@ juce::var AIStateMapper::graphToJSON(juce::AudioProcessorGraph& graph) {
 
     juce::Array<juce::var> connections;
     for (const auto& conn : graph.getConnections()) {
+        if (matrices.count(conn.source.nodeID.uid) || matrices.count(conn.destination.nodeID.uid))
+            continue;
         juce::DynamicObject::Ptr c = new juce::DynamicObject();
         c->setProperty("src", (int)conn.source.nodeID.uid);
 
@@ -226,58 +342,21 @@ juce::var AIStateMapper::graphToJSON(juce::AudioProcessorGraph& graph) {
     }
     root->setProperty("connections", connections);
 
-    // Scan for AttenuverterModule nodes and emit modulations array
+    // One entry per route; a route the user hasn't finished setting up leaves out its missing end
     juce::Array<juce::var> modulations;
-    for (auto* node : graph.getNodes()) {
-        if (auto* attenverter = dynamic_cast<AttenuverterModule*>(node->getProcessor())) {
-            // Find source connection (input to attenuverter channel 0)
-            bool hasSource = false;
-            juce::AudioProcessorGraph::NodeID sourceNodeID;
-            int sourceChannel = 0;
-            for (const auto& conn : graph.getConnections()) {
-                if (conn.destination.nodeID == node->nodeID && conn.destination.channelIndex == 0) {
-                    sourceNodeID = conn.source.nodeID;
-                    sourceChannel = conn.source.channelIndex;
-                    hasSource = true;
-                    break;
-                }
-            }
-
-            // Find destination connection (output from attenuverter channel 0)
-            bool hasDest = false;
-            juce::AudioProcessorGraph::NodeID destNodeID;
-            int destChannel = 0;
-            for (const auto& conn : graph.getConnections()) {
-                if (conn.source.nodeID == node->nodeID && conn.source.channelIndex == 0) {
-                    destNodeID = conn.destination.nodeID;
-                    destChannel = conn.destination.channelIndex;
-                    hasDest = true;
-                    break;
-                }
-            }
-
-            // Only create modulation entry if both source and dest connections exist
-            if (hasSource && hasDest) {
-                juce::DynamicObject::Ptr modEntry = new juce::DynamicObject();
-                modEntry->setProperty("source", (int)sourceNodeID.uid);
-                modEntry->setProperty("sourcePort", sourceChannel);
-                modEntry->setProperty("dest", (int)destNodeID.uid);
-                modEntry->setProperty("destPort", destChannel);
-
-                // Get amount parameter (param[1], after bypassedParam at [0])
-                if (auto* param = dynamic_cast<juce::RangedAudioParameter*>(attenverter->getParameters()[1])) {
-                    float amount = param->getNormalisableRange().convertFrom0to1(param->getValue());
-                    modEntry->setProperty("amount", amount);
-                }
-
-                // Get bypass parameter (param[2], after bypassedParam at [0])
-                if (auto* param = dynamic_cast<juce::AudioParameterBool*>(attenverter->getParameters()[2])) {
-                    modEntry->setProperty("bypass", param->get());
-                }
-
-                modulations.add(juce::var(modEntry.get()));
-            }
+    for (const auto& route : getModRoutes(graph)) {
+        juce::DynamicObject::Ptr modEntry = new juce::DynamicObject();
+        if (route.source) {
+            modEntry->setProperty("source", (int)route.source->nodeID.uid);
+            modEntry->setProperty("sourcePort", route.source->channelIndex);
+        }
+        if (route.dest) {
+            modEntry->setProperty("dest", (int)route.dest->nodeID.uid);
+            modEntry->setProperty("destPort", route.dest->channelIndex);
         }
+        modEntry->setProperty("amount", route.matrix->getAmountParameter(route.slot).get());
+        modEntry->setProperty("bypass", route.matrix->isSlotBypassed(route.slot));
+        modulations.add(juce::var(modEntry.get()));
     }
     root->setProperty("modulations", modulations);
 
@@ -285,13 +364,20 @@ juce::var AIStateMapper::graphToJSON(juce::AudioProcessorGraph& graph) {
 }
 
 juce::String AIStateMapper::getModuleSchema() {
+    // Depends only on the compiled-in module set, so build it once
+    static const juce::String schema = buildModuleSchema();
+    return schema;
+}
+
+juce::var AIStateMapper::getPatchSchema() {
+    static const juce::var schema = buildPatchSchema();
+    return schema;
+}
+
+juce::String AIStateMapper::buildModuleSchema() {
     juce::String schema = "### Available Modules and Parameters\n\n";
 
     for (const auto& entry : moduleFactory) {
-        // Hide internal modules from AI — modulation uses the "modulations" array instead
-        if (entry.first == "Attenuverter" || entry.first == "Mod Slot")
-            continue;
-
         auto processor = entry.second();
         if (!processor)
             continue;
@@ -359,59 +445,77 @@ int AIStateMapper::findChoiceIndex(juce::AudioParameterChoice* p, const juce::St
 
 void AIStateMapper::applyParamsToProcessor(juce::AudioProcessor* processor, const juce::DynamicObject* paramsObj,
                                            bool trusted) {
-    for (auto* param : processor->getParameters()) {
-        if (auto* p = dynamic_cast<juce::RangedAudioParameter*>(param)) {
-            if (paramsObj->hasProperty(p->paramID)) {
-                auto jsonValue = paramsObj->getProperty(p->paramID);
-
-                if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(p)) {
-                    if (jsonValue.isString()) {
-                        int index = findChoiceIndex(choice, jsonValue.toString());
-                        if (index >= 0) {
-                            p->setValueNotifyingHost(p->getNormalisableRange().convertTo0to1((float)index));
-                        }
-                    } else {
-                        float val = (float)jsonValue;
-                        p->setValueNotifyingHost(p->getNormalisableRange().convertTo0to1(val));
-                    }
-                } else if (auto* b = dynamic_cast<juce::AudioParameterBool*>(p)) {
-                    b->setValueNotifyingHost((bool)jsonValue ? 1.0f : 0.0f);
-                } else {
-                    float val = (float)jsonValue;
-                    auto range = p->getNormalisableRange();
+    const auto& table = getParamTable(*processor);
+    const auto& params = processor->getParameters();
+    const bool verbose = verboseLogging;
 
-                    // Detect likely normalized 0-1 values from AI models that ignore range instructions.
-                    // If the actual range extends beyond [0,1] but the value is within [0,1],
-                    // the AI probably sent a normalized value — convert it to the actual range.
-                    // Skip this heuristic for integer params — small values like 0 or 1 are
-                    // almost always valid denormalized values, not normalized.
-                    bool isIntParam = (dynamic_cast<juce::AudioParameterInt*>(p) != nullptr);
-                    bool rangeIsUnitInterval = (range.start >= 0.0f && range.end <= 1.0f);
-                    bool wasConverted = false;
-                    if (!trusted && !isIntParam && !rangeIsUnitInterval && val >= 0.0f && val <= 1.0f) {
-                        float originalVal = val;
-                        val = range.convertFrom0to1(val);
-                        wasConverted = true;
-                        juce::Logger::writeToLog("AIStateMapper: param '" + p->paramID + "' value " +
-                                                 juce::String(originalVal) + " detected as normalized, converted to " +
-                                                 juce::String(val) + " (range " + juce::String(range.start) + " to " +
-                                                 juce::String(range.end) + ")");
-                    }
+    for (const auto& property : paramsObj->getProperties()) {
+        auto entry = table.find(property.name.toString());
+        if (entry == table.end() || entry->second.index >= params.size())
+            continue;
+
+        auto* p = static_cast<juce::RangedAudioParameter*>(params[entry->second.index]);
+        const auto& jsonValue = property.value;
 
-                    val = range.snapToLegalValue(val);
-                    float normalizedValue = range.convertTo0to1(val);
-                    juce::Logger::writeToLog("AIStateMapper: setting '" + p->paramID + "' = " + juce::String(val) +
-                                             " (normalized: " + juce::String(normalizedValue) + ")" +
-                                             (wasConverted ? " [auto-corrected]" : ""));
-                    p->setValueNotifyingHost(normalizedValue);
+        switch (entry->second.kind) {
+        case ParamKind::Choice:
+            if (jsonValue.isString()) {
+                int index = findChoiceIndex(static_cast<juce::AudioParameterChoice*>(p), jsonValue.toString());
+                if (index >= 0) {
+                    p->setValueNotifyingHost(p->getNormalisableRange().convertTo0to1((float)index));
                 }
+            } else {
+                float val = (float)jsonValue;
+                p->setValueNotifyingHost(p->getNormalisableRange().convertTo0to1(val));
             }
+            break;
+
+        case ParamKind::Bool:
+            p->setValueNotifyingHost((bool)jsonValue ? 1.0f : 0.0f);
+            break;
+
+        case ParamKind::Int:
+        case ParamKind::Float: {
+            float val = (float)jsonValue;
+            auto range = p->getNormalisableRange();
+
+            // Detect likely normalized 0-1 values from AI models that ignore range instructions.
+            // If the actual range extends beyond [0,1] but the value is within [0,1],
+            // the AI probably sent a normalized value — convert it to the actual range.
+            // Skip this heuristic for integer params — small values like 0 or 1 are
+            // almost always valid denormalized values, not normalized.
+            bool isIntParam = entry->second.kind == ParamKind::Int;
+            bool rangeIsUnitInterval = (range.start >= 0.0f && range.end <= 1.0f);
+            bool wasConverted = false;
+            if (!trusted && !isIntParam && !rangeIsUnitInterval && val >= 0.0f && val <= 1.0f) {
+                float originalVal = val;
+                val = range.convertFrom0to1(val);
+                wasConverted = true;
+                juce::Logger::writeToLog("AIStateMapper: param '" + p->paramID + "' value " +
+                                         juce::String(originalVal) + " detected as normalized, converted to " +
+                                         juce::String(val) + " (range " + juce::String(range.start) + " to " +
+                                         juce::String(range.end) + ")");
+            }
+
+            val = range.snapToLegalValue(val);
+            float normalizedValue = range.convertTo0to1(val);
+            if (verbose)
+                juce::Logger::writeToLog("AIStateMapper: setting '" + p->paramID + "' = " + juce::String(val) +
+                                         " (normalized: " + juce::String(normalizedValue) + ")" +
+                                         (wasConverted ? " [auto-corrected]" : ""));
+            p->setValueNotifyingHost(normalizedValue);
+            break;
+        }
         }
     }
 }
 
 bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessorGraph& graph, bool clearExisting,
                                      bool trusted) {
+    GSYNTH_TRACE_SCOPE("graph", "AIStateMapper::applyJSONToGraph");
+    if (PatchContextEncoder::isCompact(json))
+        return applyJSONToGraph(PatchContextEncoder::expand(json), graph, clearExisting, trusted);
+
     if (!json.isObject()) {
         juce::Logger::writeToLog("applyJSONToGraph: JSON is not an object.");
         return false;
@@ -428,14 +532,17 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
         return false;
     }
 
-    const juce::ScopedLock sl(graph.getCallbackLock());
+    // Edits update the topology immediately; the audio thread keeps running the old
+    // render sequence until the transaction publishes the new one in a single rebuild
+    GraphTransaction txn(graph);
 
     if (clearExisting) {
-        graph.clear();
+        txn.clear();
     }
 
     std::map<int, juce::AudioProcessorGraph::NodeID> idMap;
     std::set<juce::AudioProcessorGraph::NodeID> newlyCreatedNodes;
+    std::map<int, LegacyModSlot> legacyModSlots; // JSON id -> route to add in its place
 
     // Pre-populate idMap with existing nodes when merging
     if (!clearExisting) {
@@ -452,13 +559,28 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                 int nodeIdToRemove = (int)idVar;
                 auto juceNodeId = juce::AudioProcessorGraph::NodeID((juce::uint32)nodeIdToRemove);
                 if (graph.getNodeForId(juceNodeId) != nullptr) {
-                    graph.removeNode(juceNodeId);
+                    txn.removeNode(juceNodeId);
                 }
                 idMap.erase(nodeIdToRemove);
             }
         }
     }
 
+    // Existing modulation routings, indexed once and kept current as modulations are added
+    auto modRoutes = indexModRoutes(graph);
+
+    // Modulation target ports per destination node, looked up once per node rather than per connection
+    std::unordered_map<juce::uint32, std::vector<int>> modTargetPorts;
+    auto getModTargetPorts = [&modTargetPorts](juce::AudioProcessorGraph::Node& node) -> const std::vector<int>& {
+        auto [it, inserted] = modTargetPorts.try_emplace(node.nodeID.uid);
+        if (inserted) {
+            if (auto* modBase = dynamic_cast<ModuleBase*>(node.getProcessor()))
+                for (const auto& t : modBase->getModulationTargets())
+                    it->second.push_back(t.channelIndex);
+        }
+        return it->second;
+    };
+
     // Process removeModulations before adding new modulations
     if (rootObj->hasProperty("removeModulations")) {
         auto* rmModList = rootObj->getProperty("removeModulations").getArray();
@@ -469,38 +591,40 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                     int destId = (int)rmModObj->getProperty("dest");
                     int destPort = (int)rmModObj->getProperty("destPort");
 
-                    // Find and remove the matching attenuverter node
+                    // Find and remove the matching route
                     auto mappedSource = idMap.count(sourceId)
                                             ? idMap[sourceId]
                                             : juce::AudioProcessorGraph::NodeID((juce::uint32)sourceId);
                     auto mappedDest =
                         idMap.count(destId) ? idMap[destId] : juce::AudioProcessorGraph::NodeID((juce::uint32)destId);
 
-                    juce::AudioProcessorGraph::NodeID nodeToRemove;
-                    bool found = false;
-                    for (auto* node : graph.getNodes()) {
-                        if (dynamic_cast<AttenuverterModule*>(node->getProcessor()) == nullptr)
-                            continue;
+                    auto route = findIndexedRoute(modRoutes, mappedSource.uid, mappedDest.uid, destPort, std::nullopt);
+                    if (route != modRoutes.end()) {
+                        removeModRoute(txn, route->second);
+                        modRoutes.erase(route);
+                    }
+                }
+            }
+        }
+    }
 
-                        bool sourceMatch = false;
-                        bool destMatch = false;
-                        for (const auto& conn : graph.getConnections()) {
-                            if (conn.destination.nodeID == node->nodeID && conn.destination.channelIndex == 0 &&
-                                conn.source.nodeID == mappedSource)
-                                sourceMatch = true;
-                            if (conn.source.nodeID == node->nodeID && conn.source.channelIndex == 0 &&
-                                conn.destination.nodeID == mappedDest && conn.destination.channelIndex == destPort)
-                                destMatch = true;
-                        }
+    // Process removeConnections before adding new connections
+    if (rootObj->hasProperty("removeConnections")) {
+        auto* rmConnList = rootObj->getProperty("removeConnections").getArray();
+        if (rmConnList) {
+            for (const auto& cVar : *rmConnList) {
+                if (auto* cObj = cVar.getDynamicObject()) {
+                    int srcOld = cObj->getProperty("src");
+                    int dstOld = cObj->getProperty("dst");
+                    int srcPort = cObj->getProperty("srcPort");
+                    int dstPort = cObj->getProperty("dstPort");
+                    if (srcPort == -1)
+                        srcPort = juce::AudioProcessorGraph::midiChannelIndex;
+                    if (dstPort == -1)
+                        dstPort = juce::AudioProcessorGraph::midiChannelIndex;
 
-                        if (sourceMatch && destMatch) {
-                            nodeToRemove = node->nodeID;
-                            found = true;
-                            break;
-                        }
-                    }
-                    if (found)
-                        graph.removeNode(nodeToRemove);
+                    if (idMap.count(srcOld) && idMap.count(dstOld))
+                        txn.removeConnection({{idMap[srcOld], srcPort}, {idMap[dstOld], dstPort}});
                 }
             }
         }
@@ -515,11 +639,21 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                     int oldId = nObj->getProperty("id");
                     juce::String type = nObj->getProperty("type");
 
+                    if (isLegacyModSlotType(type)) {
+                        auto& slot = legacyModSlots[oldId];
+                        if (auto* pObj = nObj->getProperty("params").getDynamicObject()) {
+                            slot.amount = pObj->hasProperty("amount") ? (float)pObj->getProperty("amount") : 0.0f;
+                            slot.bypass = (bool)pObj->getProperty("bypassed");
+                        }
+                        continue;
+                    }
+
                     // In merge mode, check if this node already exists
                     if (!clearExisting && idMap.count(oldId)) {
                         auto existingNodeId = idMap[oldId];
                         if (auto* existingNode = graph.getNodeForId(existingNodeId)) {
-                            if (existingNode->getProcessor()->getName() == type) {
+                            if (existingNode->getProcessor()->getName() == type ||
+                                getFactoryTypeName(existingNode->getProcessor()) == type) {
                                 // Update parameters on existing node
                                 if (nObj->hasProperty("params")) {
                                     if (auto* pObj = nObj->getProperty("params").getDynamicObject()) {
@@ -533,6 +667,14 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                                         existingNode->properties.set("y", posObj->getProperty("y"));
                                     }
                                 }
+                                // Oversampling is re-bound on the graph's next change message
+                                if (nObj->hasProperty("oversampling")) {
+                                    int factor = nObj->getProperty("oversampling");
+                                    if (factor != gsynth::getOversamplingFactor(*existingNode)) {
+                                        gsynth::setOversamplingFactor(*existingNode, factor);
+                                        graph.sendChangeMessage();
+                                    }
+                                }
                                 continue; // Skip node creation
                             }
                         }
@@ -547,7 +689,7 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                             }
                         }
 
-                        auto node = graph.addNode(std::move(processor));
+                        auto node = txn.addNode(std::move(processor));
                         if (node) {
                             idMap[oldId] = node->nodeID;
                             newlyCreatedNodes.insert(node->nodeID);
@@ -557,6 +699,8 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                                     node->properties.set("y", posObj->getProperty("y"));
                                 }
                             }
+                            if (nObj->hasProperty("oversampling"))
+                                gsynth::setOversamplingFactor(*node, nObj->getProperty("oversampling"));
                         }
                     }
                 }
@@ -581,6 +725,23 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                     if (dstPort == -1)
                         dstPort = juce::AudioProcessorGraph::midiChannelIndex;
 
+                    // A legacy mod slot's first link into and out of channel 0 become its route's
+                    // ends; its Amount CV input (channel 1) has no counterpart and is dropped
+                    auto legacyDst = legacyModSlots.find(dstOld);
+                    auto legacySrc = legacyModSlots.find(srcOld);
+                    const bool intoLegacy = legacyDst != legacyModSlots.end();
+                    const bool outOfLegacy = legacySrc != legacyModSlots.end();
+                    if (intoLegacy || outOfLegacy) {
+                        using NodeAndChannel = juce::AudioProcessorGraph::NodeAndChannel;
+                        if (intoLegacy && !outOfLegacy && dstPort == 0 && !legacyDst->second.source &&
+                            idMap.count(srcOld))
+                            legacyDst->second.source = NodeAndChannel{idMap[srcOld], srcPort};
+                        if (outOfLegacy && !intoLegacy && srcPort == 0 && !legacySrc->second.dest &&
+                            idMap.count(dstOld))
+                            legacySrc->second.dest = NodeAndChannel{idMap[dstOld], dstPort};
+                        continue;
+                    }
+
                     auto* srcNode = graph.getNodeForId(idMap[srcOld]);
                     auto* dstNode = graph.getNodeForId(idMap[dstOld]);
                     if (srcNode && dstNode) {
@@ -589,34 +750,22 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                         bool isMidiConnection = (srcPort == juce::AudioProcessorGraph::midiChannelIndex);
 
                         // Auto-detect modulation targets: if the destination port is a
-                        // modulation target, route through an attenuverter automatically
+                        // modulation target, add a mod matrix route automatically
                         // (same logic as GraphEditor::endConnectionDrag).
-                        // Skip if source is already an AttenuverterModule (existing routing).
+                        // Skip if source is already a mod matrix (existing routing).
                         bool isModTarget = false;
-                        if (!isMidiConnection &&
-                            dynamic_cast<AttenuverterModule*>(srcNode->getProcessor()) == nullptr) {
-                            if (auto* modBase = dynamic_cast<ModuleBase*>(dstNode->getProcessor())) {
-                                for (const auto& t : modBase->getModulationTargets()) {
-                                    if (t.channelIndex == dstPort) {
-                                        isModTarget = true;
-                                        break;
-                                    }
-                                }
-                            }
+                        if (!isMidiConnection && !isModMatrixNode(*srcNode)) {
+                            const auto& ports = getModTargetPorts(*dstNode);
+                            isModTarget = std::find(ports.begin(), ports.end(), dstPort) != ports.end();
                         }
 
                         if (isModTarget) {
-                            // Create attenuverter chain: source -> attenuverter -> dest
-                            auto attenNode = graph.addNode(std::make_unique<AttenuverterModule>());
-                            if (attenNode) {
-                                if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(
-                                        attenNode->getProcessor()->getParameters()[1]))
-                                    param->setValueNotifyingHost(param->getNormalisableRange().convertTo0to1(1.0f));
-                                graph.addConnection({{idMap[srcOld], srcPort}, {attenNode->nodeID, 0}});
-                                graph.addConnection({{attenNode->nodeID, 0}, {idMap[dstOld], dstPort}});
-                            }
+                            juce::AudioProcessorGraph::NodeAndChannel source{idMap[srcOld], srcPort};
+                            juce::AudioProcessorGraph::NodeAndChannel dest{idMap[dstOld], dstPort};
+                            if (auto routeID = addModRoute(txn, source, dest, 1.0f))
+                                modRoutes.emplace(makeModRouteKey(source, dest), *routeID);
                         } else if (isMidiConnection || (srcPort < srcPorts && dstPort < dstPorts)) {
-                            graph.addConnection({{idMap[srcOld], srcPort}, {idMap[dstOld], dstPort}});
+                            txn.addConnection({{idMap[srcOld], srcPort}, {idMap[dstOld], dstPort}});
                         }
                     }
                 }
@@ -624,70 +773,54 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
         }
     }
 
+    // Legacy mod slots become routes once their links are known
+    for (auto& [oldId, slot] : legacyModSlots) {
+        if (slot.source && slot.dest &&
+            findIndexedRoute(modRoutes, slot.source->nodeID.uid, slot.dest->nodeID.uid, slot.dest->channelIndex,
+                             slot.source->channelIndex) != modRoutes.end())
+            continue;
+        auto routeID = addModRoute(txn, slot.source, slot.dest, slot.amount, slot.bypass);
+        if (routeID && slot.source && slot.dest)
+            modRoutes.emplace(makeModRouteKey(*slot.source, *slot.dest), *routeID);
+    }
+
     // 3. Modulations
     if (rootObj->hasProperty("modulations")) {
         auto* modList = rootObj->getProperty("modulations").getArray();
         if (modList) {
             for (const auto& modVar : *modList) {
                 if (auto* modObj = modVar.getDynamicObject()) {
-                    int sourceId = (int)modObj->getProperty("source");
-                    int destId = (int)modObj->getProperty("dest");
                     int sourcePort = modObj->hasProperty("sourcePort") ? (int)modObj->getProperty("sourcePort") : 0;
                     int destPort = (int)modObj->getProperty("destPort");
                     float amount = modObj->hasProperty("amount") ? (float)modObj->getProperty("amount") : 1.0f;
                     bool bypass = modObj->hasProperty("bypass") ? (bool)modObj->getProperty("bypass") : false;
 
-                    // Get mapped node IDs
-                    if (idMap.count(sourceId) && idMap.count(destId)) {
-                        auto mappedSource = idMap[sourceId];
-                        auto mappedDest = idMap[destId];
+                    // A missing end is a route the user hasn't finished setting up; an unknown one skips the entry
+                    std::optional<juce::AudioProcessorGraph::NodeAndChannel> source, dest;
+                    if (modObj->hasProperty("source")) {
+                        int sourceId = (int)modObj->getProperty("source");
+                        if (!idMap.count(sourceId))
+                            continue;
+                        source = juce::AudioProcessorGraph::NodeAndChannel{idMap[sourceId], sourcePort};
+                    }
+                    if (modObj->hasProperty("dest")) {
+                        int destId = (int)modObj->getProperty("dest");
+                        if (!idMap.count(destId))
+                            continue;
+                        dest = juce::AudioProcessorGraph::NodeAndChannel{idMap[destId], destPort};
+                    }
 
-                        // Skip if an attenuverter already exists for this routing
+                    if (source && dest) {
+                        // Skip if a route already exists for this routing
                         // (e.g., from nodes/connections arrays in the same JSON)
-                        bool alreadyExists = false;
-                        for (auto* existingNode : graph.getNodes()) {
-                            if (dynamic_cast<AttenuverterModule*>(existingNode->getProcessor()) == nullptr)
-                                continue;
-                            bool srcMatch = false, dstMatch = false;
-                            for (const auto& conn : graph.getConnections()) {
-                                if (conn.destination.nodeID == existingNode->nodeID &&
-                                    conn.destination.channelIndex == 0 && conn.source.nodeID == mappedSource &&
-                                    conn.source.channelIndex == sourcePort)
-                                    srcMatch = true;
-                                if (conn.source.nodeID == existingNode->nodeID && conn.source.channelIndex == 0 &&
-                                    conn.destination.nodeID == mappedDest && conn.destination.channelIndex == destPort)
-                                    dstMatch = true;
-                            }
-                            if (srcMatch && dstMatch) {
-                                alreadyExists = true;
-                                break;
-                            }
-                        }
-                        if (alreadyExists)
+                        if (findIndexedRoute(modRoutes, source->nodeID.uid, dest->nodeID.uid, destPort, sourcePort) !=
+                            modRoutes.end())
                             continue;
-
-                        // Create attenuverter node
-                        auto attenNode = graph.addNode(std::make_unique<AttenuverterModule>());
-                        if (attenNode) {
-                            // Set amount parameter (param[1], after bypassedParam at [0])
-                            if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(
-                                    attenNode->getProcessor()->getParameters()[1])) {
-                                param->setValueNotifyingHost(param->getNormalisableRange().convertTo0to1(amount));
-                            }
-
-                            // Set bypass parameter if true (param[2], after bypassedParam at [0])
-                            if (bypass) {
-                                if (auto* bp = dynamic_cast<juce::AudioParameterBool*>(
-                                        attenNode->getProcessor()->getParameters()[2])) {
-                                    bp->setValueNotifyingHost(1.0f);
-                                }
-                            }
-
-                            // Add connections
-                            graph.addConnection({{mappedSource, sourcePort}, {attenNode->nodeID, 0}});
-                            graph.addConnection({{attenNode->nodeID, 0}, {mappedDest, destPort}});
-                        }
                     }
+
+                    auto routeID = addModRoute(txn, source, dest, amount, bypass);
+                    if (routeID && source && dest)
+                        modRoutes.emplace(makeModRouteKey(*source, *dest), *routeID);
                 }
             }
         }
@@ -695,6 +828,18 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
 
     // 4. Auto-connect: in merge mode, connect new unconnected audio nodes to Audio Output
     if (!clearExisting && !newlyCreatedNodes.empty()) {
+        // One pass over the connections: which nodes already send audio or receive MIDI, and the MIDI sources
+        std::unordered_set<juce::uint32> hasAudioOut, hasMidiIn;
+        std::set<juce::AudioProcessorGraph::NodeID> midiSources;
+        for (const auto& conn : graph.getConnections()) {
+            if (!conn.source.isMIDI())
+                hasAudioOut.insert(conn.source.nodeID.uid);
+            if (conn.destination.isMIDI())
+                hasMidiIn.insert(conn.destination.nodeID.uid);
+            if (conn.source.isMIDI() && newlyCreatedNodes.find(conn.source.nodeID) == newlyCreatedNodes.end())
+                midiSources.insert(conn.source.nodeID);
+        }
+
         // Find the Audio Output node
         juce::AudioProcessorGraph::Node* audioOutputNode = nullptr;
         for (auto* node : graph.getNodes()) {
@@ -719,17 +864,10 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                 if (audioNodeTypes.find(typeName) == audioNodeTypes.end())
                     continue;
 
-                // Check if this node already has outgoing audio connections
-                bool hasOutgoing = false;
-                for (const auto& conn : graph.getConnections()) {
-                    if (conn.source.nodeID == newNodeId && !conn.source.isMIDI()) {
-                        hasOutgoing = true;
-                        break;
-                    }
-                }
-
+                // Skip nodes that already have outgoing audio connections
+                bool hasOutgoing = hasAudioOut.count(newNodeId.uid) > 0;
                 if (!hasOutgoing && node->getProcessor()->getTotalNumOutputChannels() > 0) {
-                    graph.addConnection({{newNodeId, 0}, {audioOutputNode->nodeID, 0}});
+                    txn.addConnection({{newNodeId, 0}, {audioOutputNode->nodeID, 0}});
                 }
             }
         }
@@ -739,14 +877,7 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
         static const std::set<juce::String> midiAcceptingTypes = {"Oscillator", "Sequencer", "Poly Sequencer",
                                                                   "Poly MIDI"};
 
-        // Find all existing MIDI source nodes (nodes that have outgoing MIDI connections)
-        std::set<juce::AudioProcessorGraph::NodeID> midiSources;
-        for (const auto& conn : graph.getConnections()) {
-            if (conn.source.isMIDI() && newlyCreatedNodes.find(conn.source.nodeID) == newlyCreatedNodes.end()) {
-                midiSources.insert(conn.source.nodeID);
-            }
-        }
-
+        // Existing MIDI source nodes (nodes that have outgoing MIDI connections) were collected above
         if (!midiSources.empty()) {
             auto midiSourceId = *midiSources.begin(); // Use the first MIDI source found
             for (auto newNodeId : newlyCreatedNodes) {
@@ -758,17 +889,10 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
                 if (midiAcceptingTypes.find(typeName) == midiAcceptingTypes.end())
                     continue;
 
-                // Check if this node already has incoming MIDI
-                bool hasMidiInput = false;
-                for (const auto& conn : graph.getConnections()) {
-                    if (conn.destination.nodeID == newNodeId && conn.destination.isMIDI()) {
-                        hasMidiInput = true;
-                        break;
-                    }
-                }
-
+                // Skip nodes that already have incoming MIDI
+                bool hasMidiInput = hasMidiIn.count(newNodeId.uid) > 0;
                 if (!hasMidiInput && node->getProcessor()->acceptsMidi()) {
-                    graph.addConnection({{midiSourceId, juce::AudioProcessorGraph::midiChannelIndex},
+                    txn.addConnection({{midiSourceId, juce::AudioProcessorGraph::midiChannelIndex},
                                          {newNodeId, juce::AudioProcessorGraph::midiChannelIndex}});
                 }
             }
@@ -778,7 +902,7 @@ bool AIStateMapper::applyJSONToGraph(const juce::var& json, juce::AudioProcessor
     return true;
 }
 
-juce::var AIStateMapper::getPatchSchema() {
+juce::var AIStateMapper::buildPatchSchema() {
     juce::DynamicObject::Ptr schema = new juce::DynamicObject();
     schema->setProperty("type", "object");
 
@@ -800,6 +924,7 @@ juce::var AIStateMapper::getPatchSchema() {
                           "\"Poly MIDI\", \"Poly Sequencer\", \"Chorus\", \"Phaser\", "
                           "\"Compressor\", \"Flanger\", \"Limiter\"]}"));
     nodeProperties->setProperty("params", juce::JSON::parse("{\"type\": \"object\"}"));
+    nodeProperties->setProperty("oversampling", juce::JSON::parse("{\"type\": \"integer\", \"enum\": [1, 2, 4]}"));
 
     nodeItems->setProperty("properties", juce::var(nodeProperties.get()));
     nodeItems->setProperty("required", juce::Array<juce::var>({"id", "type"}));
@@ -863,6 +988,12 @@ juce::var AIStateMapper::getPatchSchema() {
     removeModulations->setProperty("items", juce::var(rmModItems.get()));
     properties->setProperty("removeModulations", juce::var(removeModulations.get()));
 
+    // 7. RemoveConnections (optional)
+    juce::DynamicObject::Ptr removeConnections = new juce::DynamicObject();
+    removeConnections->setProperty("type", "array");
+    removeConnections->setProperty("items", juce::var(connItems.get()));
+    properties->setProperty("removeConnections", juce::var(removeConnections.get()));
+
     schema->setProperty("properties", juce::var(properties.get()));
     schema->setProperty("required", juce::Array<juce::var>({"nodes", "connections"}));
 
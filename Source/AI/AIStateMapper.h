@@ -17,8 +17,17 @@ public:
      */
     static juce::var graphToJSON(juce::AudioProcessorGraph& graph);
 
+    /**
+     * @brief The processor's parameters as { paramID: value }, in the units applyJSONToGraph expects.
+     */
+    static juce::var paramsToJSON(juce::AudioProcessor& processor);
+
     /**
      * @brief Applies a JSON-compatible juce::var to the graph.
+     *
+     * Accepts both the full patch format and the compact one produced by PatchContextEncoder.
+     * Runs in time linear in the patch and graph size: parameters are found through a
+     * per-class paramID table, and existing modulation routings are indexed once.
      * @return true if the patch was applied successfully.
      */
     static bool applyJSONToGraph(const juce::var& json, juce::AudioProcessorGraph& graph, bool clearExisting = true,
@@ -26,17 +35,31 @@ public:
 
     /**
      * @brief Gets a Markdown-formatted string of all available modules and their parameters.
+     *
+     * Built on first use and cached for the lifetime of the process.
      */
     static juce::String getModuleSchema();
 
     /**
-     * @brief Generates a JSON schema for patch validation and structured AI output.
+     * @brief JSON schema for patch validation and structured AI output.
+     *
+     * Built on first use and shared afterwards; treat the returned object as read-only.
      */
     static juce::var getPatchSchema();
 
     static std::unique_ptr<juce::AudioProcessor> createModule(const juce::String& type);
 
+    /**
+     * @brief Logs every parameter set while applying patches. Off by default; large patches
+     * load much faster without it. The AI chat's debug console turns it on while open.
+     */
+    static void setVerboseLogging(bool shouldLog);
+    static bool isVerboseLogging();
+
 private:
+    static juce::String buildModuleSchema();
+    static juce::var buildPatchSchema();
+
     static bool validatePatchJSON(const juce::var& json);
 
     /**
@@ -1,4 +1,5 @@
 #include "OllamaProvider.h"
+#include "../TraceRecorder.h"
 
 namespace gsynth {
 
@@ -72,30 +73,93 @@ void OllamaProvider::fetchAvailableModels(std::function<void(const juce::StringA
     });
 }
 
+AIProvider::RequestId OllamaProvider::sendPromptStreaming(const std::vector<Message>& conversation,
+                                                         PartialCallback onToken, CompletionCallback callback,
+                                                         const juce::var& responseSchema) {
+    RequestId id = 0;
+    {
+        const juce::ScopedLock sl(queueLock);
+        id = nextRequestId++;
+        pendingRequests.push_back({id, conversation, std::move(onToken), std::move(callback), responseSchema});
+    }
+
+    if (!isThreadRunning())
+        startThread();
+    notify();
+    return id;
+}
+
+void OllamaProvider::cancelRequest(RequestId id) {
+    std::vector<Request> cancelled;
+    {
+        const juce::ScopedLock sl(queueLock);
+        if (id != 0 && id == activeRequestId) {
+            cancelActive = true;
+            return; // The worker reports it once the stream has been abandoned
+        }
+        for (auto it = pendingRequests.begin(); it != pendingRequests.end(); ++it) {
+            if (it->id == id) {
+                cancelled.push_back(std::move(*it));
+                pendingRequests.erase(it);
+                break;
+            }
+        }
+    }
+
+    for (const auto& req : cancelled)
+        deliverResult(req, "Cancelled", false);
+}
+
+void OllamaProvider::cancelAllRequests() {
+    std::vector<Request> cancelled;
+    {
+        const juce::ScopedLock sl(queueLock);
+        if (activeRequestId != 0)
+            cancelActive = true;
+        cancelled.assign(std::make_move_iterator(pendingRequests.begin()),
+                         std::make_move_iterator(pendingRequests.end()));
+        pendingRequests.clear();
+    }
+
+    for (const auto& req : cancelled)
+        deliverResult(req, "Cancelled", false);
+}
+
 void OllamaProvider::run() {
+    GSYNTH_TRACE_SCOPE("ai", "OllamaProvider::run");
     while (!threadShouldExit()) {
         Request currentRequest;
 
         {
             const juce::ScopedLock sl(queueLock);
-            if (pendingRequests.empty()) {
-                break;
+            if (!pendingRequests.empty()) {
+                currentRequest = std::move(pendingRequests.front());
+                pendingRequests.pop_front();
+                activeRequestId = currentRequest.id;
+                cancelActive = false;
             }
-            currentRequest = pendingRequests.front();
-            pendingRequests.erase(pendingRequests.begin());
+        }
+
+        if (currentRequest.id == 0) {
+            wait(-1); // Woken by sendPromptStreaming() or stopThread()
+            continue;
         }
 
         processRequest(currentRequest);
+
+        const juce::ScopedLock sl(queueLock);
+        activeRequestId = 0;
     }
 }
 
 void OllamaProvider::processRequest(const Request& req) {
+    GSYNTH_TRACE_SCOPE("ai", "OllamaProvider::processRequest");
     juce::URL url(ollamaHost + "/api/chat");
 
     // Build JSON body
     juce::DynamicObject::Ptr body = new juce::DynamicObject();
     body->setProperty("model", currentModel);
-    body->setProperty("stream", false);
+    body->setProperty("stream", true);
 
     juce::Array<juce::var> messages;
     for (const auto& msg : req.conversation) {
@@ -117,34 +181,79 @@ void OllamaProvider::processRequest(const Request& req) {
     if (auto stream = createStream(
             url.withPOSTData(jsonString),
             juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inPostData).withConnectionTimeoutMs(120000))) {
-        responseText = stream->readEntireStreamAsString();
-        // DBG("AI Chat Response (before JSON parse): [" + responseText + "]"); // Potentially expensive
-
-        juce::var jsonResponse = juce::JSON::parse(responseText);
-        if (jsonResponse.isObject()) {
-            if (auto* obj = jsonResponse.getDynamicObject()) {
-                if (obj->hasProperty("message")) {
-                    auto msgObj = obj->getProperty("message");
-                    if (msgObj.getDynamicObject()) {
-                        responseText = msgObj.getDynamicObject()->getProperty("content").toString();
-                        success = true;
-                    }
+        // Ollama streams one JSON object per line, each carrying the next piece of
+        // message.content, and ends with a line whose "done" is true.
+        bool receivedMessage = false;
+        bool done = false;
+        bool cancelled = false;
+        juce::String error;
+
+        while (!done && !stream->isExhausted()) {
+            if (cancelActive || threadShouldExit()) {
+                cancelled = true;
+                break;
+            }
+
+            auto line = stream->readNextLine().trim();
+            if (line.isEmpty())
+                continue;
+
+            juce::var chunk = juce::JSON::parse(line);
+            if (!chunk.isObject())
+                continue;
+
+            if (chunk.hasProperty("error")) {
+                error = chunk["error"].toString();
+                break;
+            }
+
+            auto msgObj = chunk["message"];
+            if (msgObj.isObject()) {
+                receivedMessage = true;
+                auto token = msgObj["content"].toString();
+                if (token.isNotEmpty()) {
+                    responseText += token;
+                    deliverToken(req, token);
                 }
             }
+            done = (bool)chunk["done"];
+        }
+
+        if (cancelled) {
+            responseText = "Cancelled";
+        } else if (error.isNotEmpty()) {
+            responseText = "Error: " + error;
+        } else {
+            success = receivedMessage;
         }
     } else {
         responseText = "Error: Could not connect to Ollama at " + ollamaHost;
     }
 
+    deliverResult(req, responseText, success);
+}
+
+void OllamaProvider::deliverToken(const Request& req, const juce::String& token) {
+    if (!req.onToken)
+        return;
+
+    if (isTestMode) {
+        req.onToken(token);
+    } else {
+        juce::MessageManager::callAsync([onToken = req.onToken, token]() { onToken(token); });
+    }
+}
+
+void OllamaProvider::deliverResult(const Request& req, const juce::String& responseText, bool success) {
     if (isTestMode) {
         if (req.callback)
             req.callback(responseText, success);
     } else {
-        juce::MessageManager::callAsync([req, responseText, success]() {
-            if (req.callback)
-                req.callback(responseText, success);
+        juce::MessageManager::callAsync([callback = req.callback, responseText, success]() {
+            if (callback)
+                callback(responseText, success);
         });
     }
 }
 
-} // namespace gsynth
\ No newline at end of file
+} // namespace gsynth
@@ -3,6 +3,8 @@
 #include "AIProvider.h"
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
+#include <atomic>
+#include <deque>
 #include <thread>
 #include <vector>
 
@@ -11,6 +13,11 @@ namespace gsynth {
 /**
  * @class OllamaProvider
  * @brief AI provider implementation for local Ollama instances.
+ *
+ * Requests are served in order by a single worker thread, which sleeps while the
+ * queue is empty. Chat responses are requested as NDJSON streams so partial tokens
+ * reach the caller as they are generated, and cancelling a request stops reading
+ * its stream at the next chunk.
  */
 class OllamaProvider
     : public AIProvider
@@ -28,6 +35,7 @@ public:
         , createStream(std::move(streamFactory)) {}
 
     ~OllamaProvider() override {
+        cancelActive = true;
         stopThread(2000);
         if (discoveryThread.joinable())
             discoveryThread.join();
@@ -35,15 +43,14 @@ public:
 
     void sendPrompt(const std::vector<Message>& conversation, CompletionCallback callback,
                     const juce::var& responseSchema = juce::var()) override {
-        {
-            const juce::ScopedLock sl(queueLock);
-            pendingRequests.push_back({conversation, callback, responseSchema});
-        }
-
-        if (!isThreadRunning())
-            startThread();
+        sendPromptStreaming(conversation, nullptr, std::move(callback), responseSchema);
     }
 
+    RequestId sendPromptStreaming(const std::vector<Message>& conversation, PartialCallback onToken,
+                                  CompletionCallback callback, const juce::var& responseSchema = juce::var()) override;
+    void cancelRequest(RequestId id) override;
+    void cancelAllRequests() override;
+
     juce::String getProviderName() const override { return "Ollama"; }
 
     using juce::Thread::stopThread; // Make stopThread public for testing purposes
@@ -62,16 +69,23 @@ private:
     std::thread discoveryThread;
 
     struct Request {
+        RequestId id = 0;
         std::vector<Message> conversation;
+        AIProvider::PartialCallback onToken;
         AIProvider::CompletionCallback callback;
         juce::var responseSchema;
     };
 
     juce::CriticalSection queueLock;
-    std::vector<Request> pendingRequests;
+    std::deque<Request> pendingRequests; // Guarded by queueLock
+    RequestId nextRequestId = 1;         // Guarded by queueLock
+    RequestId activeRequestId = 0;       // Guarded by queueLock; 0 while idle
+    std::atomic<bool> cancelActive{false};
 
     void run() override;                     // Declaration for inherited method
     void processRequest(const Request& req); // Declaration for private method
+    void deliverToken(const Request& req, const juce::String& token);
+    void deliverResult(const Request& req, const juce::String& responseText, bool success);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OllamaProvider)
 };
@@ -0,0 +1,227 @@
+#include "PatchAudition.h"
+#include "../OfflineRenderer.h"
+#include "../TraceRecorder.h"
+#include "AIStateMapper.h"
+#include <algorithm>
+#include <cmath>
+
+namespace gsynth {
+
+namespace {
+constexpr int kCostBlocks = 32; // Blocks timed per node
+
+double secondsSince(juce::int64 startTicks) {
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+}
+} // namespace
+
+struct PatchAuditioner::Job {
+    Callback callback;
+    Settings settings;
+    std::unique_ptr<juce::AudioProcessorGraph> graph;
+    std::unique_ptr<OfflineRenderer> renderer;
+    AuditionReport report;
+};
+
+juce::String AuditionReport::getSummary() const {
+    if (!built)
+        return "Audition failed: " + error;
+
+    auto dB = [](float gain) { return juce::String(juce::Decibels::gainToDecibels(gain), 1) + " dB"; };
+    juce::String summary = "Peak " + dB(peak) + ", RMS " + dB(rms) + ", CPU " + juce::String(cpuPercent, 1) + "%";
+    if (!nodeCosts.empty())
+        summary << " (" << nodeCosts.front().name << ": " << juce::String(nodeCosts.front().cpuPercent, 1) << "%)";
+    if (!warnings.isEmpty())
+        summary << " - " << warnings.joinIntoString("; ");
+    return summary;
+}
+
+PatchAuditioner::PatchAuditioner()
+    : Thread("PatchAuditionThread") {
+    startThread(juce::Thread::Priority::low);
+}
+
+PatchAuditioner::~PatchAuditioner() {
+    cancelPending();
+    stopThread(5000);
+}
+
+void PatchAuditioner::audition(const juce::var& patch, Callback callback, const juce::var& basePatch) {
+    JUCE_ASSERT_MESSAGE_THREAD
+    auto job = build(patch, basePatch, settings);
+    job->callback = std::move(callback);
+
+    if (!job->report.built) {
+        deliver(std::move(job));
+        return;
+    }
+
+    {
+        const juce::ScopedLock sl(queueLock);
+        pendingJobs.push_back(std::move(job));
+    }
+    notify();
+}
+
+AuditionReport PatchAuditioner::auditionNow(const juce::var& patch, const Settings& settings,
+                                            const juce::var& basePatch) {
+    auto job = build(patch, basePatch, settings);
+    if (job->report.built)
+        render(*job);
+    return std::move(job->report);
+}
+
+void PatchAuditioner::cancelPending() {
+    std::deque<std::shared_ptr<Job>> cancelled;
+    {
+        const juce::ScopedLock sl(queueLock);
+        cancelled.swap(pendingJobs);
+    }
+    // Sandbox graphs are released here, on the caller's (message) thread
+}
+
+void PatchAuditioner::run() {
+    while (!threadShouldExit()) {
+        std::shared_ptr<Job> job;
+        {
+            const juce::ScopedLock sl(queueLock);
+            if (!pendingJobs.empty()) {
+                job = std::move(pendingJobs.front());
+                pendingJobs.pop_front();
+            }
+        }
+
+        if (job == nullptr) {
+            wait(-1); // Woken by audition() or stopThread()
+            continue;
+        }
+
+        render(*job);
+        deliver(std::move(job));
+    }
+}
+
+void PatchAuditioner::deliver(std::shared_ptr<Job> job) {
+    // The job (and its sandbox graph) is released on the message thread, after the callback
+    juce::MessageManager::callAsync([self = juce::WeakReference<PatchAuditioner>(this), job = std::move(job)]() {
+        auto report = std::make_shared<const AuditionReport>(std::move(job->report));
+        if (self != nullptr && job->callback)
+            job->callback(report);
+    });
+}
+
+std::shared_ptr<PatchAuditioner::Job> PatchAuditioner::build(const juce::var& patch, const juce::var& basePatch,
+                                                              const Settings& settings) {
+    GSYNTH_TRACE_SCOPE("ai", "PatchAuditioner::build");
+    auto job = std::make_shared<Job>();
+    job->settings = settings;
+    job->report.sampleRate = settings.sampleRate;
+    job->graph = std::make_unique<juce::AudioProcessorGraph>();
+
+    if (!basePatch.isVoid() && !AIStateMapper::applyJSONToGraph(basePatch, *job->graph, true, true)) {
+        job->report.error = "the current patch could not be copied";
+        return job;
+    }
+    if (!AIStateMapper::applyJSONToGraph(patch, *job->graph, basePatch.isVoid())) {
+        job->report.error = "the patch is not valid";
+        return job;
+    }
+
+    job->renderer = std::make_unique<OfflineRenderer>(*job->graph, settings.sampleRate, settings.blockSize);
+    job->renderer->prepare();
+    job->report.built = true;
+    return job;
+}
+
+void PatchAuditioner::render(Job& job) {
+    GSYNTH_TRACE_SCOPE("ai", "PatchAuditioner::render");
+    const auto& s = job.settings;
+    const int numSamples = juce::jmax(s.blockSize, (int)(s.seconds * s.sampleRate));
+    const int noteOffAt = juce::jlimit(0, numSamples, (int)(s.noteSeconds * s.sampleRate));
+
+    auto start = juce::Time::getHighResolutionTicks();
+    auto rendered = job.renderer->render(numSamples, {{0, s.note, s.velocity}, {noteOffAt, s.note, 0.0f}});
+    job.report.cpuPercent = 100.0 * secondsSince(start) / ((double)numSamples / s.sampleRate);
+
+    analyse(job.report, rendered, s);
+    measureNodeCosts(job);
+}
+
+void PatchAuditioner::analyse(AuditionReport& report, const juce::AudioBuffer<float>& rendered,
+                              const Settings& settings) {
+    report.preview.makeCopyOf(rendered);
+    report.peak = 0.0f;
+    report.nonFiniteSamples = 0;
+
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    const int numSamples = rendered.getNumSamples();
+    for (int ch = 0; ch < report.preview.getNumChannels(); ++ch) {
+        auto* samples = report.preview.getWritePointer(ch);
+        for (int i = 0; i < numSamples; ++i) {
+            float x = samples[i];
+            if (!std::isfinite(x)) {
+                ++report.nonFiniteSamples;
+                samples[i] = 0.0f;
+                continue;
+            }
+            report.peak = std::max(report.peak, std::abs(x));
+            sum += x;
+            sumSquares += (double)x * x;
+            samples[i] = juce::jlimit(-1.0f, 1.0f, x);
+        }
+    }
+
+    const double count = juce::jmax(1.0, (double)numSamples * rendered.getNumChannels());
+    report.rms = (float)std::sqrt(sumSquares / count);
+    report.dcOffset = (float)(sum / count);
+
+    report.warnings.clear();
+    if (report.nonFiniteSamples > 0)
+        report.warnings.add(juce::String(report.nonFiniteSamples) + " NaN/Inf samples");
+    if (report.peak > settings.maxPeak)
+        report.warnings.add("peak exceeds " + juce::String(juce::Decibels::gainToDecibels(settings.maxPeak), 1) +
+                            " dB");
+    if (std::abs(report.dcOffset) > settings.maxDcOffset)
+        report.warnings.add("DC offset " + juce::String(report.dcOffset, 2));
+    if (report.peak < 1.0e-4f && report.nonFiniteSamples == 0)
+        report.warnings.add("silent");
+    if (report.cpuPercent > settings.maxCpuPercent)
+        report.warnings.add("CPU heavy");
+
+    report.safe = report.built && report.nonFiniteSamples == 0 && report.peak <= settings.maxPeak &&
+                  std::abs(report.dcOffset) <= settings.maxDcOffset && report.cpuPercent <= settings.maxCpuPercent;
+}
+
+void PatchAuditioner::measureNodeCosts(Job& job) {
+    GSYNTH_TRACE_SCOPE("ai", "PatchAuditioner::measureNodeCosts");
+    const auto& s = job.settings;
+    const double blockSeconds = (double)s.blockSize / s.sampleRate;
+    juce::MidiBuffer midi;
+    juce::AudioBuffer<float> scratch;
+
+    job.report.nodeCosts.clear();
+    for (auto* node : job.graph->getNodes()) {
+        auto* processor = node->getProcessor();
+        if (dynamic_cast<juce::AudioProcessorGraph::AudioGraphIOProcessor*>(processor) != nullptr)
+            continue;
+
+        // Each node processes silence on its own, after the full render, so its state is already warm
+        int channels = juce::jmax(1, processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels());
+        scratch.setSize(channels, s.blockSize, false, false, true);
+
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < kCostBlocks; ++i) {
+            scratch.clear();
+            midi.clear();
+            processor->processBlock(scratch, midi);
+        }
+        double cpu = 100.0 * secondsSince(start) / (blockSeconds * kCostBlocks);
+        job.report.nodeCosts.push_back({node->nodeID.uid, processor->getName(), cpu});
+    }
+
+    std::sort(job.report.nodeCosts.begin(), job.report.nodeCosts.end(),
+              [](const auto& a, const auto& b) { return a.cpuPercent > b.cpuPercent; });
+}
+
+} // namespace gsynth
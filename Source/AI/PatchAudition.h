@@ -0,0 +1,112 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+namespace gsynth {
+
+/**
+ * @struct AuditionReport
+ * @brief Result of rendering a proposed patch in a sandbox graph.
+ */
+struct AuditionReport {
+    struct NodeCost {
+        juce::uint32 nodeId = 0;
+        juce::String name;
+        double cpuPercent = 0.0; // Standalone processBlock time as a share of real time
+    };
+
+    bool built = false;
+    juce::String error; // Why the patch could not be built, if !built
+
+    double sampleRate = 0.0;
+    juce::AudioBuffer<float> preview; // Rendered audio, non-finite samples zeroed and clipped to +-1
+
+    float peak = 0.0f; // Of the raw render, before sanitising
+    float rms = 0.0f;
+    float dcOffset = 0.0f; // Mean sample value across all channels
+    int nonFiniteSamples = 0;
+    double cpuPercent = 0.0;         // Whole-graph render time as a share of real time
+    std::vector<NodeCost> nodeCosts; // Most expensive first
+
+    bool safe = false; // Built, finite, and within every limit in PatchAuditioner::Settings
+    juce::StringArray warnings;
+
+    /** One line for display, e.g. "Peak -3.1 dB, RMS -14.8 dB, CPU 2.4% (Reverb 1: 1.1%)". */
+    juce::String getSummary() const;
+};
+
+/**
+ * @class PatchAuditioner
+ * @brief Renders AI-proposed patches in a private, device-less graph before they are applied.
+ *
+ * audition() builds the patch into its own AudioProcessorGraph and renders a short note
+ * through an OfflineRenderer, then checks the result for NaN/Inf, runaway peaks and DC
+ * and times the whole graph and each node. Nothing touches the live graph.
+ *
+ * The sandbox graph is built and prepared on the message thread, because
+ * AudioProcessorGraph only rebuilds its render sequence synchronously there; rendering
+ * and analysis, which is where the time goes, run on the auditioner's worker thread.
+ * Callbacks arrive on the message thread, and the sandbox graph is destroyed there.
+ */
+class PatchAuditioner : private juce::Thread {
+public:
+    struct Settings {
+        double sampleRate = 44100.0;
+        int blockSize = 512;
+        double seconds = 1.5;     // Length of the preview
+        int note = 60;
+        float velocity = 0.8f;
+        double noteSeconds = 1.0; // Note-off time; the rest of the preview is release tail
+        float maxPeak = 4.0f;     // About +12 dBFS; above this the patch is treated as blowing up
+        float maxDcOffset = 0.1f;
+        double maxCpuPercent = 50.0;
+    };
+
+    using Callback = std::function<void(std::shared_ptr<const AuditionReport>)>;
+
+    PatchAuditioner();
+    ~PatchAuditioner() override;
+
+    void setSettings(const Settings& newSettings) { settings = newSettings; }
+    const Settings& getSettings() const { return settings; }
+
+    /**
+     * @brief Auditions patch asynchronously. Message thread only.
+     * @param basePatch Optional full patch the proposal is merged into (for "merge" patches).
+     */
+    void audition(const juce::var& patch, Callback callback, const juce::var& basePatch = {});
+
+    /** Builds, renders and analyses patch on the calling thread. Message thread only. */
+    static AuditionReport auditionNow(const juce::var& patch, const Settings& settings,
+                                      const juce::var& basePatch = {});
+
+    /** Drops queued auditions; their callbacks are not called. */
+    void cancelPending();
+
+    /** Fills report's levels, warnings and sanitised preview from a rendered buffer. */
+    static void analyse(AuditionReport& report, const juce::AudioBuffer<float>& rendered, const Settings& settings);
+
+private:
+    struct Job;
+
+    void run() override;
+
+    static std::shared_ptr<Job> build(const juce::var& patch, const juce::var& basePatch, const Settings& settings);
+    static void render(Job& job);
+    static void measureNodeCosts(Job& job);
+    void deliver(std::shared_ptr<Job> job);
+
+    Settings settings;
+    juce::CriticalSection queueLock;
+    std::deque<std::shared_ptr<Job>> pendingJobs;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(PatchAuditioner)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchAuditioner)
+};
+
+} // namespace gsynth
@@ -0,0 +1,360 @@
+#include "PatchContextEncoder.h"
+#include "AIStateMapper.h"
+#include <cmath>
+#include <map>
+#include <set>
+
+namespace gsynth {
+
+namespace {
+
+constexpr double kValuePrecision = 1000.0; // Three decimals is plenty for the model
+
+bool isNumeric(const juce::var& v) { return v.isInt() || v.isInt64() || v.isDouble() || v.isBool(); }
+
+juce::var roundValue(const juce::var& v) {
+    if (v.isDouble()) {
+        double rounded = std::round((double)v * kValuePrecision) / kValuePrecision;
+        if (rounded == std::floor(rounded) && std::abs(rounded) < 1.0e9)
+            return (int)rounded; // "800" rather than "800.0"
+        return rounded;
+    }
+    return v;
+}
+
+bool sameValue(const juce::var& a, const juce::var& b) {
+    if (isNumeric(a) && isNumeric(b))
+        return std::abs((double)roundValue(a) - (double)roundValue(b)) < 0.5 / kValuePrecision;
+    return a.toString() == b.toString();
+}
+
+// Per-route modulation nodes in patches saved before the mod matrix; their routes are in "modulations" too
+bool isModulationNode(const juce::String& type) { return type == "Attenuverter" || type == "Mod Slot"; }
+
+// Parameter defaults per module type, taken from a freshly created module. Kept as plain
+// values (no DynamicObjects) so the cache can outlive JUCE's leak detectors at shutdown.
+const std::map<juce::String, juce::var>& getDefaultParams(const juce::String& type) {
+    static std::map<juce::String, std::map<juce::String, juce::var>> cache;
+
+    auto it = cache.find(type);
+    if (it == cache.end()) {
+        std::map<juce::String, juce::var> defaults;
+        if (auto processor = AIStateMapper::createModule(type)) {
+            if (auto* obj = AIStateMapper::paramsToJSON(*processor).getDynamicObject())
+                for (const auto& prop : obj->getProperties())
+                    defaults[prop.name.toString()] = prop.value;
+        }
+        it = cache.emplace(type, std::move(defaults)).first;
+    }
+    return it->second;
+}
+
+juce::var defaultFor(const juce::String& type, const juce::String& paramID) {
+    const auto& defaults = getDefaultParams(type);
+    auto it = defaults.find(paramID);
+    return it != defaults.end() ? it->second : juce::var();
+}
+
+juce::var intArray(std::initializer_list<int> values) {
+    juce::Array<juce::var> arr;
+    for (int v : values)
+        arr.add(v);
+    return arr;
+}
+
+juce::String arrayKey(const juce::var& arr, int count) {
+    juce::String key;
+    for (int i = 0; i < count; ++i)
+        key << arr[i].toString() << ",";
+    return key;
+}
+
+struct NodeEntry {
+    juce::String type;
+    juce::NamedValueSet params;
+};
+
+std::map<int, NodeEntry> indexNodes(const juce::var& snapshot) {
+    std::map<int, NodeEntry> nodes;
+    if (auto* arr = snapshot["n"].getArray()) {
+        for (const auto& n : *arr) {
+            NodeEntry entry;
+            entry.type = n["t"].toString();
+            if (auto* p = n["p"].getDynamicObject())
+                entry.params = p->getProperties();
+            nodes[(int)n["i"]] = std::move(entry);
+        }
+    }
+    return nodes;
+}
+
+std::map<juce::String, juce::var> indexArray(const juce::var& snapshot, const char* key, int keyLength) {
+    std::map<juce::String, juce::var> entries;
+    if (auto* arr = snapshot[key].getArray())
+        for (const auto& e : *arr)
+            entries[arrayKey(e, keyLength)] = e;
+    return entries;
+}
+
+bool sameArray(const juce::var& a, const juce::var& b) {
+    if (a.size() != b.size())
+        return false;
+    for (int i = 0; i < a.size(); ++i)
+        if (!sameValue(a[i], b[i]))
+            return false;
+    return true;
+}
+
+} // namespace
+
+juce::var PatchContextEncoder::encode(juce::AudioProcessorGraph& graph) {
+    return compact(AIStateMapper::graphToJSON(graph));
+}
+
+juce::var PatchContextEncoder::compact(const juce::var& patch) {
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+
+    std::set<int> modulationNodes;
+    juce::Array<juce::var> nodes;
+    if (auto* arr = patch["nodes"].getArray()) {
+        for (const auto& n : *arr) {
+            int id = n["id"];
+            juce::String type = n["type"].toString();
+            if (isModulationNode(type)) {
+                modulationNodes.insert(id);
+                continue;
+            }
+
+            juce::DynamicObject::Ptr node = new juce::DynamicObject();
+            node->setProperty("i", id);
+            node->setProperty("t", type);
+
+            juce::DynamicObject::Ptr params = new juce::DynamicObject();
+            if (auto* p = n["params"].getDynamicObject()) {
+                for (const auto& prop : p->getProperties()) {
+                    auto defaultValue = defaultFor(type, prop.name.toString());
+                    if (defaultValue.isVoid() || !sameValue(prop.value, defaultValue))
+                        params->setProperty(prop.name, roundValue(prop.value));
+                }
+            }
+            if (!params->getProperties().isEmpty())
+                node->setProperty("p", juce::var(params.get()));
+            nodes.add(juce::var(node.get()));
+        }
+    }
+    root->setProperty("n", nodes);
+
+    juce::Array<juce::var> connections;
+    if (auto* arr = patch["connections"].getArray()) {
+        for (const auto& c : *arr) {
+            int src = c["src"];
+            int dst = c["dst"];
+            if (modulationNodes.count(src) || modulationNodes.count(dst))
+                continue; // Represented by the "m" entry instead
+            connections.add(intArray({src, (int)c["srcPort"], dst, (int)c["dstPort"]}));
+        }
+    }
+    root->setProperty("c", connections);
+
+    juce::Array<juce::var> modulations;
+    if (auto* arr = patch["modulations"].getArray()) {
+        for (const auto& m : *arr) {
+            if (!m.hasProperty("source") || !m.hasProperty("dest"))
+                continue; // An unfinished route changes nothing the model can see
+            juce::Array<juce::var> entry{m["source"], (int)m["sourcePort"], m["dest"], m["destPort"],
+                                         roundValue(m.hasProperty("amount") ? m["amount"] : juce::var(1.0))};
+            if ((bool)m["bypass"])
+                entry.add(1);
+            modulations.add(entry);
+        }
+    }
+    root->setProperty("m", modulations);
+
+    return juce::var(root.get());
+}
+
+juce::var PatchContextEncoder::diff(const juce::var& previous, const juce::var& current) {
+    auto before = indexNodes(previous);
+    auto after = indexNodes(current);
+
+    juce::Array<juce::var> changedNodes;
+    juce::Array<juce::var> removedNodes;
+    std::set<int> removedIds;
+
+    for (const auto& [id, node] : after) {
+        auto it = before.find(id);
+        bool isNew = it == before.end() || it->second.type != node.type;
+        if (it != before.end() && isNew) {
+            removedNodes.add(id); // Same id, different module: replace it
+            removedIds.insert(id);
+        }
+
+        juce::DynamicObject::Ptr params = new juce::DynamicObject();
+        if (isNew) {
+            for (const auto& prop : node.params)
+                params->setProperty(prop.name, prop.value);
+        } else {
+            // Compare the union of non-default params; a missing one means "back to default"
+            auto valueOrDefault = [&](const juce::NamedValueSet& set, const juce::Identifier& paramID) {
+                auto* v = set.getVarPointer(paramID);
+                return v != nullptr ? *v : defaultFor(node.type, paramID.toString());
+            };
+            std::set<juce::String> paramIDs;
+            for (const auto& prop : node.params)
+                paramIDs.insert(prop.name.toString());
+            for (const auto& prop : it->second.params)
+                paramIDs.insert(prop.name.toString());
+
+            for (const auto& paramID : paramIDs) {
+                auto now = valueOrDefault(node.params, paramID);
+                if (!sameValue(now, valueOrDefault(it->second.params, paramID)))
+                    params->setProperty(paramID, now);
+            }
+            if (params->getProperties().isEmpty())
+                continue;
+        }
+
+        juce::DynamicObject::Ptr entry = new juce::DynamicObject();
+        entry->setProperty("i", id);
+        entry->setProperty("t", node.type);
+        if (!params->getProperties().isEmpty())
+            entry->setProperty("p", juce::var(params.get()));
+        changedNodes.add(juce::var(entry.get()));
+    }
+
+    for (const auto& [id, node] : before) {
+        if (after.find(id) == after.end()) {
+            removedNodes.add(id);
+            removedIds.insert(id);
+        }
+    }
+
+    // Connections and modulations touching removed nodes disappear with them
+    auto touchesRemoved = [&](int a, int b) { return removedIds.count(a) > 0 || removedIds.count(b) > 0; };
+
+    auto connectionsBefore = indexArray(previous, "c", 4);
+    auto connectionsAfter = indexArray(current, "c", 4);
+    juce::Array<juce::var> addedConnections;
+    juce::Array<juce::var> removedConnections;
+    for (const auto& [key, c] : connectionsAfter)
+        if (connectionsBefore.find(key) == connectionsBefore.end())
+            addedConnections.add(c);
+    for (const auto& [key, c] : connectionsBefore)
+        if (connectionsAfter.find(key) == connectionsAfter.end() && !touchesRemoved(c[0], c[2]))
+            removedConnections.add(c);
+
+    auto modulationsBefore = indexArray(previous, "m", 4);
+    auto modulationsAfter = indexArray(current, "m", 4);
+    juce::Array<juce::var> changedModulations;
+    juce::Array<juce::var> removedModulations;
+    for (const auto& [key, m] : modulationsAfter) {
+        auto it = modulationsBefore.find(key);
+        if (it == modulationsBefore.end()) {
+            changedModulations.add(m);
+        } else if (!sameArray(it->second, m)) {
+            removedModulations.add(intArray({m[0], m[2], m[3]})); // Re-created with the new amount
+            changedModulations.add(m);
+        }
+    }
+    for (const auto& [key, m] : modulationsBefore)
+        if (modulationsAfter.find(key) == modulationsAfter.end() && !touchesRemoved(m[0], m[2]))
+            removedModulations.add(intArray({m[0], m[2], m[3]}));
+
+    if (changedNodes.isEmpty() && removedNodes.isEmpty() && addedConnections.isEmpty() &&
+        removedConnections.isEmpty() && changedModulations.isEmpty() && removedModulations.isEmpty())
+        return {};
+
+    juce::DynamicObject::Ptr delta = new juce::DynamicObject();
+    delta->setProperty("d", 1);
+    auto setIfNotEmpty = [&](const char* key, const juce::Array<juce::var>& arr) {
+        if (!arr.isEmpty())
+            delta->setProperty(key, arr);
+    };
+    setIfNotEmpty("n", changedNodes);
+    setIfNotEmpty("rm", removedNodes);
+    setIfNotEmpty("c", addedConnections);
+    setIfNotEmpty("rc", removedConnections);
+    setIfNotEmpty("m", changedModulations);
+    setIfNotEmpty("rmm", removedModulations);
+    return juce::var(delta.get());
+}
+
+bool PatchContextEncoder::isCompact(const juce::var& json) {
+    return json.isObject() && !json.hasProperty("nodes") && (json.hasProperty("n") || json.hasProperty("d"));
+}
+
+juce::var PatchContextEncoder::expand(const juce::var& compactPatch) {
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    const bool isDelta = (bool)compactPatch["d"];
+    if (isDelta)
+        root->setProperty("mode", "merge");
+
+    juce::Array<juce::var> nodes;
+    if (auto* arr = compactPatch["n"].getArray()) {
+        for (const auto& n : *arr) {
+            juce::DynamicObject::Ptr node = new juce::DynamicObject();
+            node->setProperty("id", n["i"]);
+            node->setProperty("type", n["t"]);
+            if (n.hasProperty("p"))
+                node->setProperty("params", n["p"]);
+            nodes.add(juce::var(node.get()));
+        }
+    }
+    root->setProperty("nodes", nodes);
+
+    auto expandConnections = [](const juce::var& list) {
+        juce::Array<juce::var> connections;
+        if (auto* arr = list.getArray()) {
+            for (const auto& c : *arr) {
+                juce::DynamicObject::Ptr conn = new juce::DynamicObject();
+                conn->setProperty("src", c[0]);
+                conn->setProperty("srcPort", c[1]);
+                conn->setProperty("dst", c[2]);
+                conn->setProperty("dstPort", c[3]);
+                connections.add(juce::var(conn.get()));
+            }
+        }
+        return connections;
+    };
+    root->setProperty("connections", expandConnections(compactPatch["c"]));
+
+    juce::Array<juce::var> modulations;
+    if (auto* arr = compactPatch["m"].getArray()) {
+        for (const auto& m : *arr) {
+            juce::DynamicObject::Ptr mod = new juce::DynamicObject();
+            mod->setProperty("source", m[0]);
+            mod->setProperty("sourcePort", m[1]);
+            mod->setProperty("dest", m[2]);
+            mod->setProperty("destPort", m[3]);
+            mod->setProperty("amount", m.size() > 4 ? m[4] : juce::var(1.0));
+            mod->setProperty("bypass", m.size() > 5 && (bool)m[5]);
+            modulations.add(juce::var(mod.get()));
+        }
+    }
+    root->setProperty("modulations", modulations);
+
+    if (isDelta) {
+        if (compactPatch.hasProperty("rm"))
+            root->setProperty("remove", compactPatch["rm"]);
+        if (compactPatch.hasProperty("rc"))
+            root->setProperty("removeConnections", expandConnections(compactPatch["rc"]));
+
+        if (auto* arr = compactPatch["rmm"].getArray()) {
+            juce::Array<juce::var> removedModulations;
+            for (const auto& m : *arr) {
+                juce::DynamicObject::Ptr mod = new juce::DynamicObject();
+                mod->setProperty("source", m[0]);
+                mod->setProperty("dest", m[1]);
+                mod->setProperty("destPort", m[2]);
+                removedModulations.add(juce::var(mod.get()));
+            }
+            root->setProperty("removeModulations", removedModulations);
+        }
+    }
+
+    return juce::var(root.get());
+}
+
+int PatchContextEncoder::estimateTokens(const juce::String& text) { return (text.length() + 3) / 4; }
+
+} // namespace gsynth
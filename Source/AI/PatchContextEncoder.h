@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
+
+namespace gsynth {
+
+/**
+ * @class PatchContextEncoder
+ * @brief Token-lean encoding of the patch state that is sent to the AI as context.
+ *
+ * The compact form keeps only what the model needs to reason about the patch:
+ *
+ *     {"n": [{"i": 3, "t": "Filter", "p": {"cutoff": 800}}],  // "p": non-default params only
+ *      "c": [[1, 0, 3, 0]],                                     // [src, srcPort, dst, dstPort]
+ *      "m": [[5, 0, 3, 1, 0.5]]}                                // [src, srcPort, dst, dstPort, amount(, 1)]
+ *
+ * A trailing 1 on a modulation marks it bypassed. Positions are dropped, values are
+ * rounded to three decimals, and modulations missing an end are left out of "m"
+ * (as are the per-route Attenuverter nodes of older patches).
+ *
+ * A delta ("d": 1) lists only what changed since an earlier snapshot: changed or new
+ * nodes in "n" (with only the changed params), removed node ids in "rm", added and
+ * removed connections in "c" / "rc", and added or changed modulations in "m" with
+ * removals in "rmm" ([src, dst, dstPort]).
+ *
+ * expand() turns either form back into the full patch format, and
+ * AIStateMapper::applyJSONToGraph() accepts compact input directly.
+ */
+class PatchContextEncoder {
+public:
+    /** Compact snapshot of the graph. Message thread only. */
+    static juce::var encode(juce::AudioProcessorGraph& graph);
+
+    /** Converts a full AIStateMapper::graphToJSON() patch into a compact snapshot. */
+    static juce::var compact(const juce::var& patch);
+
+    /** Compact delta that turns snapshot previous into current, or void if they describe the same patch. */
+    static juce::var diff(const juce::var& previous, const juce::var& current);
+
+    /** True if json is a compact snapshot or delta rather than a full patch. */
+    static bool isCompact(const juce::var& json);
+
+    /** Expands a compact snapshot or delta into the full format (deltas become "mode": "merge" patches). */
+    static juce::var expand(const juce::var& compactPatch);
+
+    /** Rough token count for prompt budgeting (about four characters per token). */
+    static int estimateTokens(const juce::String& text);
+};
+
+} // namespace gsynth
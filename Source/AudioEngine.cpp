@@ -1,21 +1,29 @@
 #include "AudioEngine.h"
 #include "Modules/ADSRModule.h"
-#include "Modules/AttenuverterModule.h"
 #include "Modules/FX/DelayModule.h"
 #include "Modules/FX/DistortionModule.h"
 #include "Modules/FX/ReverbModule.h"
 #include "Modules/FilterModule.h"
 #include "Modules/LFOModule.h"
 #include "Modules/MidiKeyboardModule.h"
+#include "Modules/ModMatrixModule.h"
 #include "Modules/OscillatorModule.h"
 #include "Modules/SequencerModule.h"
 #include "Modules/VCAModule.h"
+#include "ModMatrixRoutes.h"
 #include "PresetManager.h"
+#include "OversamplingBinder.h"
+#include "TraceRecorder.h"
+#include "VoiceActivityBinder.h"
+#include <algorithm>
 #include <map>
 
-AudioEngine::AudioEngine() {}
+AudioEngine::AudioEngine() { mainProcessorGraph.addChangeListener(this); }
 
-AudioEngine::~AudioEngine() { shutdown(); }
+AudioEngine::~AudioEngine() {
+    shutdown();
+    mainProcessorGraph.removeChangeListener(this);
+}
 
 void AudioEngine::initialise() {
     deviceManager.initialiseWithDefaultDevices(0, 2);
@@ -30,112 +38,247 @@ void AudioEngine::shutdown() {
     mainProcessorGraph.clear();
 }
 
-std::vector<AudioEngine::ModRoutingInfo> AudioEngine::getActiveModRoutings() const {
+std::vector<AudioEngine::ModRoutingInfo> AudioEngine::getActiveModRoutings() {
+    syncModRoutingIndex();
+
     std::vector<ModRoutingInfo> routings;
-    for (auto* node : mainProcessorGraph.getNodes()) {
-        if (dynamic_cast<AttenuverterModule*>(node->getProcessor()) != nullptr) {
-            ModRoutingInfo info;
-            info.attenuverterNodeID = node->nodeID;
-            info.sourceChannelIndex = 0;
-            for (auto& conn : mainProcessorGraph.getConnections()) {
-                if (conn.destination.nodeID == node->nodeID && conn.destination.channelIndex == 0) {
-                    info.sourceNodeID = conn.source.nodeID;
-                    info.sourceChannelIndex = conn.source.channelIndex;
-                    break;
-                }
-            }
-            for (auto& conn : mainProcessorGraph.getConnections()) {
-                if (conn.source.nodeID == node->nodeID && conn.source.channelIndex == 0) {
-                    info.destNodeID = conn.destination.nodeID;
-                    info.destChannelIndex = conn.destination.channelIndex;
-                    break;
-                }
-            }
-
-            // Get bypass state
-            info.isBypassed = false;
-            if (auto* module = dynamic_cast<ModuleBase*>(node->getProcessor())) {
-                info.isBypassed = module->isBypassed();
-            }
-
-            routings.push_back(info);
-        }
+    routings.reserve(modRoutingIndex.size());
+    for (auto& entry : modRoutingIndex) {
+        auto info = entry.info;
+        info.isBypassed = entry.matrix->isSlotBypassed(entry.slot);
+        routings.push_back(info);
     }
     return routings;
 }
 
-std::vector<AudioEngine::ModulationDisplayInfo> AudioEngine::getModulationDisplayInfo() const {
+std::vector<AudioEngine::ModulationDisplayInfo> AudioEngine::getModulationDisplayInfo() {
+    syncModRoutingIndex();
+
     std::vector<ModulationDisplayInfo> result;
-    for (auto* node : mainProcessorGraph.getNodes()) {
-        if (auto* atten = dynamic_cast<AttenuverterModule*>(node->getProcessor())) {
-            ModulationDisplayInfo info;
-            info.attenuverterNodeID = node->nodeID;
-            info.modSignalValue = atten->getLastModValue();
-            info.modSignalPeak = atten->getLastOutputPeak();
-            info.isBypassed = false;
-            if (auto* bp = dynamic_cast<juce::AudioParameterBool*>(node->getProcessor()->getParameters()[2]))
-                info.isBypassed = bp->get();
-
-            bool foundDest = false;
-            for (auto& conn : mainProcessorGraph.getConnections()) {
-                if (conn.source.nodeID == node->nodeID && conn.source.channelIndex == 0) {
-                    info.destNodeID = conn.destination.nodeID;
-                    info.destChannelIndex = conn.destination.channelIndex;
-                    foundDest = true;
-                    break;
-                }
-            }
-            if (foundDest)
-                result.push_back(info);
-        }
+    for (auto& entry : modRoutingIndex) {
+        if (!entry.hasDest)
+            continue;
+
+        ModulationDisplayInfo info;
+        info.routeID = entry.info.routeID;
+        info.destNodeID = entry.info.destNodeID;
+        info.destChannelIndex = entry.info.destChannelIndex;
+        info.modSignalValue = entry.matrix->getLastModValue(entry.slot);
+        info.modSignalPeak = entry.matrix->getLastOutputPeak(entry.slot);
+        info.isBypassed = entry.matrix->isSlotBypassed(entry.slot);
+        result.push_back(info);
     }
     return result;
 }
 
-void AudioEngine::addModRouting(juce::AudioProcessorGraph::NodeID sourceNodeID, int sourceChannelIndex,
-                                juce::AudioProcessorGraph::NodeID destNodeID, int destChannelIndex) {
-    auto attenuverterNode = mainProcessorGraph.addNode(std::make_unique<AttenuverterModule>());
-    if (attenuverterNode == nullptr)
+juce::uint32 AudioEngine::getModRoutingVersion() {
+    syncModRoutingIndex();
+    return modRoutingVersion;
+}
+
+juce::uint32 AudioEngine::getNodeSetVersion() {
+    syncModRoutingIndex();
+    return nodeSetVersion;
+}
+
+const gsynth::ModuleRegistry& AudioEngine::getModuleRegistry() {
+    syncModRoutingIndex();
+    return moduleRegistry;
+}
+
+void AudioEngine::changeListenerCallback(juce::ChangeBroadcaster* source) {
+    if (source == &mainProcessorGraph) {
+        modRoutingIndexDirty = true;
+        for (auto* node : mainProcessorGraph.getNodes())
+            node->getProcessor()->addListener(this); // Ignored if already listening
+
+        gsynth::bindVoiceActivity(mainProcessorGraph);
+        gsynth::bindOversamplingRegions(mainProcessorGraph);
+        if (latencyChanged.exchange(false))
+            mainProcessorGraph.rebuild();
+    }
+}
+
+void AudioEngine::audioProcessorChanged(juce::AudioProcessor* processor, const ChangeDetails& details) {
+    juce::ignoreUnused(processor);
+    if (!details.latencyChanged)
         return;
-    if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(attenuverterNode->getProcessor()->getParameters()[1]))
-        param->setValueNotifyingHost(param->convertTo0to1(1.0f));
-    mainProcessorGraph.addConnection({{sourceNodeID, sourceChannelIndex}, {attenuverterNode->nodeID, 0}});
-    mainProcessorGraph.addConnection({{attenuverterNode->nodeID, 0}, {destNodeID, destChannelIndex}});
+
+    // Deferred through the graph's change message, so a module reporting mid-edit
+    // doesn't rebuild the graph under the edit
+    latencyChanged = true;
+    mainProcessorGraph.sendChangeMessage();
 }
 
-void AudioEngine::addEmptyModRouting() { mainProcessorGraph.addNode(std::make_unique<AttenuverterModule>()); }
+void AudioEngine::syncModRoutingIndex() {
+    // The graph broadcasts topology changes asynchronously; deliver any pending one now
+    // so reads straight after an edit see it
+    mainProcessorGraph.dispatchPendingMessages();
+    if (!modRoutingIndexDirty)
+        return;
 
-void AudioEngine::removeModRouting(juce::AudioProcessorGraph::NodeID attenuverterNodeID) {
-    mainProcessorGraph.removeNode(attenuverterNodeID);
+    moduleRegistry.rebuild(mainProcessorGraph);
+    rebuildModRoutingIndex();
+    modRoutingIndexDirty = false;
 }
 
-void AudioEngine::toggleModBypass(juce::AudioProcessorGraph::NodeID attenuverterNodeID) {
-    if (auto* node = mainProcessorGraph.getNodeForId(attenuverterNodeID)) {
-        if (auto* module = dynamic_cast<ModuleBase*>(node->getProcessor())) {
-            module->setBypassed(!module->isBypassed());
+void AudioEngine::rebuildModRoutingIndex() {
+    GSYNTH_TRACE_SCOPE("graph", "AudioEngine::rebuildModRoutingIndex");
+
+    std::vector<IndexedModRouting> routings;
+    std::vector<juce::uint32> nodeIDs;
+
+    nodeIDs.reserve(moduleRegistry.getEntries().size());
+    for (auto& entry : moduleRegistry.getEntries())
+        nodeIDs.push_back(entry.node->nodeID.uid);
+
+    for (const auto& route : gsynth::getModRoutes(mainProcessorGraph)) {
+        IndexedModRouting entry;
+        entry.info = {route.id, {}, 0, {}, 0, false};
+        entry.matrix = route.matrix;
+        entry.slot = route.slot;
+        if (route.source) {
+            entry.info.sourceNodeID = route.source->nodeID;
+            entry.info.sourceChannelIndex = route.source->channelIndex;
+            entry.hasSource = true;
+        }
+        if (route.dest) {
+            entry.info.destNodeID = route.dest->nodeID;
+            entry.info.destChannelIndex = route.dest->channelIndex;
+            entry.hasDest = true;
         }
+        routings.push_back(entry);
     }
+
+    auto sameRouting = [](const IndexedModRouting& a, const IndexedModRouting& b) {
+        return a.matrix == b.matrix && a.info.routeID == b.info.routeID &&
+               a.info.sourceNodeID == b.info.sourceNodeID && a.info.sourceChannelIndex == b.info.sourceChannelIndex &&
+               a.info.destNodeID == b.info.destNodeID && a.info.destChannelIndex == b.info.destChannelIndex;
+    };
+
+    if (modRoutingVersion == 0 ||
+        !std::equal(routings.begin(), routings.end(), modRoutingIndex.begin(), modRoutingIndex.end(), sameRouting))
+        ++modRoutingVersion;
+    if (nodeSetVersion == 0 || nodeIDs != indexedNodeIDs)
+        ++nodeSetVersion;
+
+    modRoutingIndex = std::move(routings);
+    indexedNodeIDs = std::move(nodeIDs);
 }
 
-bool AudioEngine::isModBypassed(juce::AudioProcessorGraph::NodeID attenuverterNodeID) const {
-    if (auto* node = mainProcessorGraph.getNodeForId(attenuverterNodeID)) {
-        if (auto* module = dynamic_cast<ModuleBase*>(node->getProcessor())) {
-            return module->isBypassed();
+void AudioEngine::playPreview(const juce::AudioBuffer<float>& preview, double sampleRate) {
+    auto buffer = std::make_unique<juce::AudioBuffer<float>>();
+    double ratio = deviceSampleRate > 0.0 ? sampleRate / deviceSampleRate : 1.0;
+    if (std::abs(ratio - 1.0) < 1.0e-6) {
+        buffer->makeCopyOf(preview);
+    } else {
+        int numSamples = (int)(preview.getNumSamples() / ratio);
+        buffer->setSize(preview.getNumChannels(), numSamples);
+        for (int ch = 0; ch < preview.getNumChannels(); ++ch) {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, preview.getReadPointer(ch), buffer->getWritePointer(ch), numSamples,
+                                 preview.getNumSamples(), 0);
         }
     }
-    return false;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(previewLock);
+        std::swap(previewBuffer, buffer);
+        previewPosition = 0;
+    }
+    // The previous preview, if any, is freed here rather than on the audio thread
+}
+
+void AudioEngine::stopPreview() {
+    std::unique_ptr<juce::AudioBuffer<float>> old;
+    const juce::SpinLock::ScopedLockType lock(previewLock);
+    std::swap(previewBuffer, old);
+}
+
+const AudioEngine::IndexedModRouting* AudioEngine::findIndexedModRouting(juce::AudioProcessorGraph::NodeID routeID) {
+    syncModRoutingIndex();
+    auto it = std::lower_bound(modRoutingIndex.begin(), modRoutingIndex.end(), routeID.uid,
+                               [](const IndexedModRouting& entry, juce::uint32 uid) {
+                                   return entry.info.routeID.uid < uid;
+                               });
+    return it != modRoutingIndex.end() && it->info.routeID == routeID ? &*it : nullptr;
+}
+
+void AudioEngine::addModRouting(juce::AudioProcessorGraph::NodeID sourceNodeID, int sourceChannelIndex,
+                                juce::AudioProcessorGraph::NodeID destNodeID, int destChannelIndex) {
+    gsynth::GraphTransaction txn(mainProcessorGraph);
+    gsynth::addModRoute(txn, juce::AudioProcessorGraph::NodeAndChannel{sourceNodeID, sourceChannelIndex},
+                        juce::AudioProcessorGraph::NodeAndChannel{destNodeID, destChannelIndex}, 1.0f);
+}
+
+void AudioEngine::addEmptyModRouting() {
+    gsynth::GraphTransaction txn(mainProcessorGraph);
+    gsynth::addModRoute(txn, std::nullopt, std::nullopt, 0.0f);
+}
+
+void AudioEngine::removeModRouting(juce::AudioProcessorGraph::NodeID routeID) {
+    gsynth::GraphTransaction txn(mainProcessorGraph);
+    gsynth::removeModRoute(txn, routeID);
+}
+
+void AudioEngine::rerouteModRouting(juce::AudioProcessorGraph::NodeID routeID,
+                                    juce::AudioProcessorGraph::NodeID sourceNodeID, int sourceChannelIndex,
+                                    juce::AudioProcessorGraph::NodeID destNodeID, int destChannelIndex) {
+    using NodeAndChannel = juce::AudioProcessorGraph::NodeAndChannel;
+    std::optional<NodeAndChannel> source, dest;
+    if (sourceNodeID.uid != 0)
+        source = NodeAndChannel{sourceNodeID, sourceChannelIndex};
+    if (destNodeID.uid != 0)
+        dest = NodeAndChannel{destNodeID, destChannelIndex};
+
+    gsynth::GraphTransaction txn(mainProcessorGraph);
+    gsynth::setModRouteEnds(txn, routeID, source, dest);
+}
+
+void AudioEngine::toggleModBypass(juce::AudioProcessorGraph::NodeID routeID) {
+    if (auto* bypass = getModBypassParameter(routeID))
+        bypass->setValueNotifyingHost(bypass->get() ? 0.0f : 1.0f);
+}
+
+bool AudioEngine::isModBypassed(juce::AudioProcessorGraph::NodeID routeID) const {
+    auto route = gsynth::findModRoute(mainProcessorGraph, routeID);
+    return route && route->matrix->isSlotBypassed(route->slot);
+}
+
+juce::AudioParameterFloat* AudioEngine::getModAmountParameter(juce::AudioProcessorGraph::NodeID routeID) {
+    auto* entry = findIndexedModRouting(routeID);
+    return entry != nullptr ? &entry->matrix->getAmountParameter(entry->slot) : nullptr;
+}
+
+juce::AudioParameterBool* AudioEngine::getModBypassParameter(juce::AudioProcessorGraph::NodeID routeID) {
+    auto* entry = findIndexedModRouting(routeID);
+    return entry != nullptr ? &entry->matrix->getBypassParameter(entry->slot) : nullptr;
+}
+
+void AudioEngine::setOversampling(juce::AudioProcessorGraph::NodeID nodeID, int factor) {
+    if (auto* node = mainProcessorGraph.getNodeForId(nodeID)) {
+        auto* module = dynamic_cast<ModuleBase*>(node->getProcessor());
+        if (module == nullptr || !module->supportsOversampling())
+            return;
+        gsynth::setOversamplingFactor(*node, factor);
+        gsynth::bindOversamplingRegions(mainProcessorGraph);
+    }
+}
+
+int AudioEngine::getOversampling(juce::AudioProcessorGraph::NodeID nodeID) const {
+    if (auto* node = mainProcessorGraph.getNodeForId(nodeID))
+        return gsynth::getOversamplingFactor(*node);
+    return 1;
 }
 
 void AudioEngine::updateModuleNames() {
     std::map<juce::String, int> typeCounts;
-    for (auto* node : mainProcessorGraph.getNodes()) {
-        if (auto* module = dynamic_cast<ModuleBase*>(node->getProcessor())) {
+    for (auto& entry : getModuleRegistry().getEntries()) {
+        if (auto* module = entry.module) {
             juce::String baseName = module->getName();
             int lastSpace = baseName.lastIndexOf(" ");
             if (lastSpace != -1 && baseName.substring(lastSpace + 1).containsOnly("0123456789"))
                 baseName = baseName.substring(0, lastSpace);
-            if (baseName.startsWith("Attenuverter"))
-                baseName = "Mod Slot";
             int index = ++typeCounts[baseName];
             module->setModuleName(baseName + " " + juce::String(index));
         }
@@ -143,23 +286,22 @@ void AudioEngine::updateModuleNames() {
 }
 
 void AudioEngine::createDefaultPatch() {
-    mainProcessorGraph.clear();
+    gsynth::GraphTransaction txn(mainProcessorGraph);
+    txn.clear();
     using AudioGraphIOProcessor = juce::AudioProcessorGraph::AudioGraphIOProcessor;
-    auto inputNode =
-        mainProcessorGraph.addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor::audioInputNode));
-    auto outputNode =
-        mainProcessorGraph.addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor::audioOutputNode));
-
-    auto sequencerNode = mainProcessorGraph.addNode(std::make_unique<SequencerModule>());
-    auto oscillatorNode = mainProcessorGraph.addNode(std::make_unique<OscillatorModule>());
-    auto filterNode = mainProcessorGraph.addNode(std::make_unique<FilterModule>());
-    auto vcaNode = mainProcessorGraph.addNode(std::make_unique<VCAModule>());
-    auto adsrNode = mainProcessorGraph.addNode(std::make_unique<ADSRModule>("Amp Env"));
-    auto filterAdsrNode = mainProcessorGraph.addNode(std::make_unique<ADSRModule>("Filter Env"));
-    auto lfoNode = mainProcessorGraph.addNode(std::make_unique<LFOModule>());
-    auto distortionNode = mainProcessorGraph.addNode(std::make_unique<DistortionModule>());
-    auto delayNode = mainProcessorGraph.addNode(std::make_unique<DelayModule>());
-    auto reverbNode = mainProcessorGraph.addNode(std::make_unique<ReverbModule>());
+    auto inputNode = txn.addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor::audioInputNode));
+    auto outputNode = txn.addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor::audioOutputNode));
+
+    auto sequencerNode = txn.addNode(std::make_unique<SequencerModule>());
+    auto oscillatorNode = txn.addNode(std::make_unique<OscillatorModule>());
+    auto filterNode = txn.addNode(std::make_unique<FilterModule>());
+    auto vcaNode = txn.addNode(std::make_unique<VCAModule>());
+    auto adsrNode = txn.addNode(std::make_unique<ADSRModule>("Amp Env"));
+    auto filterAdsrNode = txn.addNode(std::make_unique<ADSRModule>("Filter Env"));
+    auto lfoNode = txn.addNode(std::make_unique<LFOModule>());
+    auto distortionNode = txn.addNode(std::make_unique<DistortionModule>());
+    auto delayNode = txn.addNode(std::make_unique<DelayModule>());
+    auto reverbNode = txn.addNode(std::make_unique<ReverbModule>());
 
     inputNode->properties.set("x", 10.0f);
     inputNode->properties.set("y", 10.0f);
@@ -191,30 +333,32 @@ void AudioEngine::createDefaultPatch() {
     for (int i = 0; i < 4; ++i)
         addEmptyModRouting();
 
-    mainProcessorGraph.addConnection({{sequencerNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
-                                      {oscillatorNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
-    mainProcessorGraph.addConnection({{sequencerNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
-                                      {adsrNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
-    mainProcessorGraph.addConnection({{sequencerNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
-                                      {filterAdsrNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
-    mainProcessorGraph.addConnection({{oscillatorNode->nodeID, 0}, {filterNode->nodeID, 0}});
-    mainProcessorGraph.addConnection({{filterNode->nodeID, 0}, {vcaNode->nodeID, 0}});
-    mainProcessorGraph.addConnection({{sequencerNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
-                                      {filterNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
-    mainProcessorGraph.addConnection({{vcaNode->nodeID, 0}, {distortionNode->nodeID, 0}});
-    mainProcessorGraph.addConnection({{vcaNode->nodeID, 0}, {distortionNode->nodeID, 1}});
-    mainProcessorGraph.addConnection({{distortionNode->nodeID, 0}, {delayNode->nodeID, 0}});
-    mainProcessorGraph.addConnection({{distortionNode->nodeID, 1}, {delayNode->nodeID, 1}});
-    mainProcessorGraph.addConnection({{delayNode->nodeID, 0}, {reverbNode->nodeID, 0}});
-    mainProcessorGraph.addConnection({{delayNode->nodeID, 1}, {reverbNode->nodeID, 1}});
-    mainProcessorGraph.addConnection({{reverbNode->nodeID, 0}, {outputNode->nodeID, 0}});
-    mainProcessorGraph.addConnection({{reverbNode->nodeID, 1}, {outputNode->nodeID, 1}});
+    txn.addConnection({{sequencerNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
+                       {oscillatorNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
+    txn.addConnection({{sequencerNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
+                       {adsrNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
+    txn.addConnection({{sequencerNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
+                       {filterAdsrNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
+    txn.addConnection({{oscillatorNode->nodeID, 0}, {filterNode->nodeID, 0}});
+    txn.addConnection({{filterNode->nodeID, 0}, {vcaNode->nodeID, 0}});
+    txn.addConnection({{sequencerNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
+                       {filterNode->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
+    txn.addConnection({{vcaNode->nodeID, 0}, {distortionNode->nodeID, 0}});
+    txn.addConnection({{vcaNode->nodeID, 0}, {distortionNode->nodeID, 1}});
+    txn.addConnection({{distortionNode->nodeID, 0}, {delayNode->nodeID, 0}});
+    txn.addConnection({{distortionNode->nodeID, 1}, {delayNode->nodeID, 1}});
+    txn.addConnection({{delayNode->nodeID, 0}, {reverbNode->nodeID, 0}});
+    txn.addConnection({{delayNode->nodeID, 1}, {reverbNode->nodeID, 1}});
+    txn.addConnection({{reverbNode->nodeID, 0}, {outputNode->nodeID, 0}});
+    txn.addConnection({{reverbNode->nodeID, 1}, {outputNode->nodeID, 1}});
 }
 
 void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannels,
                                                    float* const* outputChannelData, int numOutputChannels,
                                                    int numSamples, const juce::AudioIODeviceCallbackContext& context) {
     juce::ignoreUnused(inputChannelData, numInputChannels, context);
+    gsynth::TraceRecorder::getInstance().setCurrentThreadName("Audio");
+    GSYNTH_TRACE_SCOPE("audio", "AudioEngine::audioDeviceIOCallback");
     for (int i = 0; i < numOutputChannels; ++i) {
         if (outputChannelData[i])
             std::fill(outputChannelData[i], outputChannelData[i] + numSamples, 0.0f);
@@ -222,10 +366,22 @@ void AudioEngine::audioDeviceIOCallbackWithContext(const float* const* inputChan
     juce::AudioBuffer<float> buffer(const_cast<float**>(outputChannelData), numOutputChannels, numSamples);
     juce::MidiBuffer midiMessages;
     mainProcessorGraph.processBlock(buffer, midiMessages);
+
+    const juce::SpinLock::ScopedTryLockType lock(previewLock);
+    if (lock.isLocked() && previewBuffer != nullptr && previewPosition < previewBuffer->getNumSamples()) {
+        int len = std::min(numSamples, previewBuffer->getNumSamples() - previewPosition);
+        for (int ch = 0; ch < numOutputChannels; ++ch) {
+            if (outputChannelData[ch] != nullptr && previewBuffer->getNumChannels() > 0)
+                buffer.addFrom(ch, 0, *previewBuffer, std::min(ch, previewBuffer->getNumChannels() - 1),
+                               previewPosition, len);
+        }
+        previewPosition += len;
+    }
 }
 
 void AudioEngine::audioDeviceAboutToStart(juce::AudioIODevice* device) {
     if (device) {
+        deviceSampleRate = device->getCurrentSampleRate();
         mainProcessorGraph.setPlayConfigDetails(device->getActiveInputChannels().countNumberOfSetBits(),
                                                 device->getActiveOutputChannels().countNumberOfSetBits(),
                                                 device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
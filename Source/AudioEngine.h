@@ -5,8 +5,18 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
 
-class AudioEngine : public juce::AudioIODeviceCallback {
+#include "GraphTransaction.h"
+#include "ModuleRegistry.h"
+#include <atomic>
+
+class ModMatrixModule;
+
+class AudioEngine
+    : public juce::AudioIODeviceCallback
+    , private juce::ChangeListener
+    , private juce::AudioProcessorListener {
 public:
     AudioEngine();
     ~AudioEngine() override;
@@ -24,8 +34,20 @@ public:
     juce::AudioProcessorGraph& getGraph() { return mainProcessorGraph; }
     juce::AudioDeviceManager& getDeviceManager() { return deviceManager; }
 
+    /**
+     * Plays a rendered preview (e.g. a patch audition) once, mixed over the live graph.
+     * The buffer is resampled to the device rate here. Message thread only.
+     */
+    void playPreview(const juce::AudioBuffer<float>& preview, double sampleRate);
+    void stopPreview();
+
+    /**
+     * A modulation routing: one route of the graph's mod matrix (see ModMatrixRoutes.h).
+     * routeID packs the matrix node and slot (gsynth::makeModRouteID); it is not a node of
+     * the graph and must not be passed to getNodeForId(). Pass it back to the functions below.
+     */
     struct ModRoutingInfo {
-        juce::AudioProcessorGraph::NodeID attenuverterNodeID;
+        juce::AudioProcessorGraph::NodeID routeID;
         juce::AudioProcessorGraph::NodeID sourceNodeID;
         int sourceChannelIndex;
         juce::AudioProcessorGraph::NodeID destNodeID;
@@ -34,7 +56,7 @@ public:
     };
 
     struct ModulationDisplayInfo {
-        juce::AudioProcessorGraph::NodeID attenuverterNodeID;
+        juce::AudioProcessorGraph::NodeID routeID; // See ModRoutingInfo
         juce::AudioProcessorGraph::NodeID destNodeID;
         int destChannelIndex;
         float modSignalValue;
@@ -42,14 +64,42 @@ public:
         bool isBypassed;
     };
 
-    std::vector<ModRoutingInfo> getActiveModRoutings() const;
-    std::vector<ModulationDisplayInfo> getModulationDisplayInfo() const;
+    /** Mod routings sorted by route ID. Served from the routing index. */
+    std::vector<ModRoutingInfo> getActiveModRoutings();
+    std::vector<ModulationDisplayInfo> getModulationDisplayInfo();
+
+    /**
+     * The routing index is rebuilt once per graph topology change (a transaction's
+     * batch counts as one). These versions bump only when the routings, or the set of
+     * nodes, actually changed, so UI can poll them for free and re-read on change.
+     */
+    juce::uint32 getModRoutingVersion();
+    juce::uint32 getNodeSetVersion();
+
+    /** The typed node index, rebuilt alongside the routing index. Message thread only. */
+    const gsynth::ModuleRegistry& getModuleRegistry();
+
     void addModRouting(juce::AudioProcessorGraph::NodeID sourceNodeID, int sourceChannelIndex,
                        juce::AudioProcessorGraph::NodeID destNodeID, int destChannelIndex);
     void addEmptyModRouting();
-    void removeModRouting(juce::AudioProcessorGraph::NodeID attenuverterNodeID);
-    void toggleModBypass(juce::AudioProcessorGraph::NodeID attenuverterNodeID);
-    bool isModBypassed(juce::AudioProcessorGraph::NodeID attenuverterNodeID) const;
+    void removeModRouting(juce::AudioProcessorGraph::NodeID routeID);
+    void toggleModBypass(juce::AudioProcessorGraph::NodeID routeID);
+    bool isModBypassed(juce::AudioProcessorGraph::NodeID routeID) const;
+
+    /**
+     * Reconnects a routing; a node ID of 0 leaves that end unconnected. The routing keeps
+     * its amount and bypass, but its ID changes if it has to move to another matrix node.
+     */
+    void rerouteModRouting(juce::AudioProcessorGraph::NodeID routeID, juce::AudioProcessorGraph::NodeID sourceNodeID,
+                           int sourceChannelIndex, juce::AudioProcessorGraph::NodeID destNodeID, int destChannelIndex);
+
+    /** The routing's Amount (-1..1) and Bypass parameters, or nullptr if it's gone. Message thread only. */
+    juce::AudioParameterFloat* getModAmountParameter(juce::AudioProcessorGraph::NodeID routeID);
+    juce::AudioParameterBool* getModBypassParameter(juce::AudioProcessorGraph::NodeID routeID);
+
+    /** Marks a module to run at 2x or 4x (1 turns it off) and re-binds the oversampling regions. */
+    void setOversampling(juce::AudioProcessorGraph::NodeID nodeID, int factor);
+    int getOversampling(juce::AudioProcessorGraph::NodeID nodeID) const;
     void updateModuleNames();
 
 private:
@@ -57,7 +107,40 @@ private:
     juce::AudioProcessorGraph mainProcessorGraph;
     juce::AudioProcessorPlayer processorPlayer;
 
+    // Preview playback; the audio thread only try-locks, and skips a block rather than wait
+    juce::SpinLock previewLock;
+    std::unique_ptr<juce::AudioBuffer<float>> previewBuffer;
+    int previewPosition = 0;
+    double deviceSampleRate = 0.0;
+
     void createDefaultPatch();
 
+    // Mod routing index
+    struct IndexedModRouting {
+        ModRoutingInfo info;
+        ModMatrixModule* matrix = nullptr;
+        int slot = 0;
+        bool hasSource = false;
+        bool hasDest = false;
+    };
+
+    gsynth::ModuleRegistry moduleRegistry;
+    std::vector<IndexedModRouting> modRoutingIndex;
+    std::vector<juce::uint32> indexedNodeIDs;
+    juce::uint32 modRoutingVersion = 0;
+    juce::uint32 nodeSetVersion = 0;
+    bool modRoutingIndexDirty = true;
+
+    // Modules report latency changes from the message thread; the graph is rebuilt there
+    // so its delay compensation picks them up
+    std::atomic<bool> latencyChanged{false};
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override {}
+    void audioProcessorChanged(juce::AudioProcessor* processor, const ChangeDetails& details) override;
+    void syncModRoutingIndex();
+    void rebuildModRoutingIndex();
+    const IndexedModRouting* findIndexedModRouting(juce::AudioProcessorGraph::NodeID routeID);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
 };
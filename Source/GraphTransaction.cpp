@@ -0,0 +1,101 @@
+#include "GraphTransaction.h"
+#include "TraceRecorder.h"
+#include <map>
+
+namespace gsynth {
+
+namespace {
+
+struct OpenState {
+    int depth = 0;
+    int pendingEdits = 0;
+};
+
+std::map<const juce::AudioProcessorGraph*, OpenState>& getOpenStates() {
+    static std::map<const juce::AudioProcessorGraph*, OpenState> states;
+    return states;
+}
+
+int numRebuilds = 0;
+
+constexpr auto kDeferred = juce::AudioProcessorGraph::UpdateKind::none;
+
+} // namespace
+
+GraphTransaction::GraphTransaction(Graph& g)
+    : graph(g) {
+    auto& state = getOpenStates()[&graph];
+    outermost = state.depth == 0;
+    ++state.depth;
+}
+
+GraphTransaction::~GraphTransaction() {
+    commit();
+
+    auto it = getOpenStates().find(&graph);
+    if (it != getOpenStates().end() && --it->second.depth == 0)
+        getOpenStates().erase(it);
+}
+
+void GraphTransaction::markEdited() { ++getOpenStates()[&graph].pendingEdits; }
+
+GraphTransaction::Graph::Node::Ptr GraphTransaction::addNode(std::unique_ptr<juce::AudioProcessor> processor,
+                                                             std::optional<Graph::NodeID> nodeID) {
+    auto node = graph.addNode(std::move(processor), nodeID, kDeferred);
+    if (node != nullptr)
+        markEdited();
+    return node;
+}
+
+bool GraphTransaction::removeNode(Graph::NodeID nodeID) {
+    bool removed = graph.removeNode(nodeID, kDeferred) != nullptr;
+    if (removed)
+        markEdited();
+    return removed;
+}
+
+bool GraphTransaction::addConnection(const Graph::Connection& connection) {
+    bool added = graph.addConnection(connection, kDeferred);
+    if (added)
+        markEdited();
+    return added;
+}
+
+bool GraphTransaction::removeConnection(const Graph::Connection& connection) {
+    bool removed = graph.removeConnection(connection, kDeferred);
+    if (removed)
+        markEdited();
+    return removed;
+}
+
+bool GraphTransaction::disconnectNode(Graph::NodeID nodeID) {
+    bool changed = graph.disconnectNode(nodeID, kDeferred);
+    if (changed)
+        markEdited();
+    return changed;
+}
+
+void GraphTransaction::clear() {
+    graph.clear(kDeferred);
+    markEdited();
+}
+
+void GraphTransaction::commit() {
+    if (!outermost)
+        return;
+
+    auto& state = getOpenStates()[&graph];
+    if (state.pendingEdits == 0)
+        return;
+
+    GSYNTH_TRACE_SCOPE("graph", "GraphTransaction::commit");
+    state.pendingEdits = 0;
+    ++numRebuilds;
+    graph.rebuild();
+}
+
+bool GraphTransaction::isOpen(const Graph& graph) { return getOpenStates().count(&graph) > 0; }
+
+int GraphTransaction::getNumRebuilds() { return numRebuilds; }
+
+} // namespace gsynth
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <optional>
+
+namespace gsynth {
+
+/**
+ * @class GraphTransaction
+ * @brief Batches AudioProcessorGraph edits into a single render-sequence rebuild.
+ *
+ * Every plain AudioProcessorGraph edit rebuilds the render sequence synchronously.
+ * Edits made through a transaction update the graph's topology immediately (so
+ * getNodes()/getConnections() stay accurate) but defer the rebuild; the outermost
+ * transaction on a graph rebuilds once when it commits. JUCE prepares the new render
+ * sequence on the calling (message) thread and hands it to the audio thread with a
+ * non-blocking exchange, so a batch of N edits costs the audio thread one swap
+ * instead of N.
+ *
+ * Transactions nest: an inner transaction on the same graph defers to the outer
+ * one. Message thread only.
+ */
+class GraphTransaction {
+public:
+    using Graph = juce::AudioProcessorGraph;
+
+    explicit GraphTransaction(Graph& graph);
+    ~GraphTransaction();
+
+    Graph::Node::Ptr addNode(std::unique_ptr<juce::AudioProcessor> processor,
+                             std::optional<Graph::NodeID> nodeID = std::nullopt);
+    bool removeNode(Graph::NodeID nodeID);
+    bool addConnection(const Graph::Connection& connection);
+    bool removeConnection(const Graph::Connection& connection);
+    bool disconnectNode(Graph::NodeID nodeID);
+    void clear();
+
+    /** Publishes pending edits now (outermost transaction only); later edits start a new batch. */
+    void commit();
+
+    Graph& getGraph() { return graph; }
+    bool isOutermost() const { return outermost; }
+
+    static bool isOpen(const Graph& graph);
+
+    /** Render-sequence rebuilds issued by committed transactions, for tests and benchmarks. */
+    static int getNumRebuilds();
+
+private:
+    void markEdited();
+
+    Graph& graph;
+    bool outermost = false;
+
+    JUCE_DECLARE_NON_COPYABLE(GraphTransaction)
+};
+
+} // namespace gsynth
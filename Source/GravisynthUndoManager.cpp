@@ -1,5 +1,7 @@
 #include "GravisynthUndoManager.h"
 #include "AI/AIStateMapper.h"
+#include "GraphTransaction.h"
+#include "TraceRecorder.h"
 #include "UI/GraphEditor.h"
 
 /**
@@ -184,11 +186,16 @@ private:
 GravisynthUndoManager::GravisynthUndoManager() {}
 
 void GravisynthUndoManager::recordStructuralChange(juce::AudioProcessorGraph& graph, std::function<void()> mutation) {
+    GSYNTH_TRACE_SCOPE("undo", "GravisynthUndoManager::recordStructuralChange");
     auto beforeState = gsynth::AIStateMapper::graphToJSON(graph);
 
     undoManager.beginNewTransaction();
 
-    mutation();
+    {
+        // One rebuild for the whole mutation, however many edits it makes
+        gsynth::GraphTransaction txn(graph);
+        mutation();
+    }
 
     auto afterState = gsynth::AIStateMapper::graphToJSON(graph);
 
@@ -224,10 +231,12 @@ void GravisynthUndoManager::recordPositionChange(juce::AudioProcessorGraph& grap
 }
 
 void GravisynthUndoManager::captureBeforeState(juce::AudioProcessorGraph& graph) {
+    GSYNTH_TRACE_SCOPE("undo", "GravisynthUndoManager::captureBeforeState");
     capturedBeforeState = gsynth::AIStateMapper::graphToJSON(graph);
 }
 
 void GravisynthUndoManager::pushSnapshotFromCapture(juce::AudioProcessorGraph& graph) {
+    GSYNTH_TRACE_SCOPE("undo", "GravisynthUndoManager::pushSnapshotFromCapture");
     if (capturedBeforeState.isVoid())
         return;
 
@@ -1,5 +1,6 @@
 #include "MainComponent.h"
 #include "AI/OllamaProvider.h"
+#include "TraceRecorder.h"
 #include "UI/SettingsWindow.h"
 
 MainComponent::MainComponent(std::unique_ptr<gsynth::AIProvider> provider)
@@ -25,7 +26,14 @@ MainComponent::MainComponent(std::unique_ptr<gsynth::AIProvider> provider)
         aiService.setProvider(std::make_unique<gsynth::OllamaProvider>(savedOllamaHost));
     }
 
+    if (appProperties.getUserSettings()->getBoolValue("aiResponseCache", false))
+        aiService.setResponseCache(
+            std::make_unique<gsynth::AIResponseCache>(gsynth::AIResponseCache::getDefaultDirectory(appProperties)));
+
     aiChatComponent.refreshModels();
+    aiChatComponent.onPlayPreview = [this](const juce::AudioBuffer<float>& preview, double sampleRate) {
+        audioEngine.playPreview(preview, sampleRate);
+    };
 
     aiService.addListener(this);
     setSize(1600, 900);
@@ -38,7 +46,8 @@ MainComponent::MainComponent(std::unique_ptr<gsynth::AIProvider> provider)
     commandManager.registerAllCommandsForTarget(this);
     commandManager.setFirstCommandTarget(this);
     shortcutManager.onBindingsChanged = [this] { updateCommandShortcuts(); };
-    startTimerHz(10);
+    frameClock->addClient(*this, 10);
+    frameClock->attachToDisplay(*this);
     addAndMakeVisible(graphEditor);
     addAndMakeVisible(moduleLibrary);
     addAndMakeVisible(aiChatComponent);
@@ -160,13 +169,14 @@ MainComponent::MainComponent(std::unique_ptr<gsynth::AIProvider> provider)
 }
 
 MainComponent::~MainComponent() {
-    stopTimer();
+    frameClock->removeClient(*this);
+    frameClock->detachFromDisplay();
     aiService.removeListener(this);
     graphEditor.detachAllModuleComponents();
     audioEngine.shutdown();
 }
 
-void MainComponent::timerCallback() {
+void MainComponent::onFrame(double) {
     undoButton.setEnabled(undoManager.canUndo());
     redoButton.setEnabled(undoManager.canRedo());
 }
@@ -200,7 +210,7 @@ void MainComponent::paint(juce::Graphics& g) {
 
 void MainComponent::getAllCommands(juce::Array<juce::CommandID>& commands) {
     commands.addArray({GravisynthCommands::openSettings, GravisynthCommands::savePreset, GravisynthCommands::openPreset,
-                       GravisynthCommands::undo, GravisynthCommands::redo});
+                       GravisynthCommands::undo, GravisynthCommands::redo, GravisynthCommands::toggleTrace});
 }
 
 void MainComponent::getCommandInfo(juce::CommandID commandID, juce::ApplicationCommandInfo& result) {
@@ -235,6 +245,12 @@ void MainComponent::getCommandInfo(juce::CommandID commandID, juce::ApplicationC
         result.addDefaultKeypress(kp.getKeyCode(), kp.getModifiers());
         break;
     }
+    case GravisynthCommands::toggleTrace: {
+        result.setInfo("Start/Stop Trace Capture", "Record a timeline and save it as Chrome trace JSON", "Debug", 0);
+        auto kp = shortcutManager.getBinding("toggleTrace");
+        result.addDefaultKeypress(kp.getKeyCode(), kp.getModifiers());
+        break;
+    }
     default:
         break;
     }
@@ -261,11 +277,32 @@ bool MainComponent::perform(const InvocationInfo& info) {
         if (undoManager.canRedo())
             undoManager.redo();
         return true;
+    case GravisynthCommands::toggleTrace:
+        toggleTraceCapture();
+        return true;
     default:
         return false;
     }
 }
 
+void MainComponent::toggleTraceCapture() {
+    auto& recorder = gsynth::TraceRecorder::getInstance();
+    if (!recorder.isRecording()) {
+        recorder.start();
+        juce::Logger::writeToLog("Trace capture started");
+        return;
+    }
+
+    recorder.stop();
+    auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                    .getChildFile("Gravisynth-trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") +
+                                  ".json");
+    if (recorder.writeChromeTrace(file))
+        juce::Logger::writeToLog("Trace written to " + file.getFullPathName());
+    else
+        juce::Logger::writeToLog("Failed to write trace to " + file.getFullPathName());
+}
+
 void MainComponent::updateCommandShortcuts() { commandManager.commandStatusChanged(); }
 
 bool MainComponent::keyPressed(const juce::KeyPress& key) {
@@ -6,6 +6,7 @@
 #include "PresetManager.h"
 #include "ShortcutManager.h"
 #include "UI/AIChatComponent.h"
+#include "UI/FrameClock.h"
 #include "UI/GraphEditor.h"
 #include "UI/ModuleLibraryComponent.h"
 #include <juce_audio_utils/juce_audio_utils.h>
@@ -14,14 +15,14 @@
 class MainComponent
     : public juce::Component
     , public juce::DragAndDropContainer
-    , public juce::Timer
+    , public FrameClock::Client
     , public juce::ApplicationCommandTarget
     , private gsynth::AIIntegrationService::Listener {
 public:
     MainComponent(std::unique_ptr<gsynth::AIProvider> provider = nullptr);
     ~MainComponent() override;
 
-    void timerCallback() override;
+    void onFrame(double nowMs) override;
 
     void paint(juce::Graphics&) override;
     void resized() override;
@@ -59,11 +60,13 @@ public:
     GravisynthUndoManager& getUndoManager() { return undoManager; }
     AudioEngine& getAudioEngine() { return audioEngine; }
     void openPresetFromFile();
+    void toggleTraceCapture();
 
 private:
     // AIIntegrationService::Listener
     void aiPatchApplied() override;
 
+    juce::SharedResourcePointer<FrameClock> frameClock;
     GravisynthUndoManager undoManager;
     AudioEngine audioEngine;
     GraphEditor graphEditor;
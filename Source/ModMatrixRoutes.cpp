@@ -0,0 +1,202 @@
+#include "ModMatrixRoutes.h"
+#include "Modules/ModMatrixModule.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace gsynth {
+
+namespace {
+
+using Graph = juce::AudioProcessorGraph;
+using NodeID = Graph::NodeID;
+using NodeAndChannel = Graph::NodeAndChannel;
+using End = std::optional<NodeAndChannel>;
+
+constexpr int kSlotBits = 8;
+constexpr juce::uint32 kSlotMask = (1u << kSlotBits) - 1;
+static_assert(ModMatrixModule::kNumSlots <= (1 << kSlotBits), "Route IDs pack the slot into kSlotBits");
+
+ModMatrixModule* getMatrix(const Graph::Node& node) { return dynamic_cast<ModMatrixModule*>(node.getProcessor()); }
+
+// A route from source to dest feeds itself if dest already reaches source, wherever it goes
+bool feedsItself(const Graph& graph, End source, End dest) {
+    if (!source || !dest)
+        return false;
+    auto* sourceNode = graph.getNodeForId(source->nodeID);
+    auto* destNode = graph.getNodeForId(dest->nodeID);
+    return sourceNode != nullptr && destNode != nullptr &&
+           (sourceNode == destNode || graph.isAnInputTo(*destNode, *sourceNode));
+}
+
+// A matrix can take a route unless it already reaches the source, or the destination reaches it:
+// every route in one matrix runs at the same point in the graph
+bool canJoin(const Graph& graph, const Graph::Node& matrixNode, End source, End dest) {
+    if (source) {
+        auto* sourceNode = graph.getNodeForId(source->nodeID);
+        if (sourceNode == &matrixNode || (sourceNode != nullptr && graph.isAnInputTo(matrixNode, *sourceNode)))
+            return false;
+    }
+    if (dest) {
+        auto* destNode = graph.getNodeForId(dest->nodeID);
+        if (destNode == &matrixNode || (destNode != nullptr && graph.isAnInputTo(*destNode, matrixNode)))
+            return false;
+    }
+    return true;
+}
+
+// The first matrix with a free slot that can take the route, or a new one
+Graph::Node* findMatrixFor(GraphTransaction& txn, End source, End dest, const Graph::Node* excluded = nullptr) {
+    auto& graph = txn.getGraph();
+    for (auto* node : graph.getNodes()) {
+        if (node == excluded)
+            continue;
+        if (auto* matrix = getMatrix(*node); matrix != nullptr && matrix->hasFreeSlot() &&
+                                             canJoin(graph, *node, source, dest))
+            return node;
+    }
+    return txn.addNode(std::make_unique<ModMatrixModule>()).get();
+}
+
+void connectSlot(GraphTransaction& txn, NodeID matrixID, int slot, End source, End dest) {
+    if (source)
+        txn.addConnection({*source, {matrixID, slot}});
+    if (dest)
+        txn.addConnection({{matrixID, slot}, *dest});
+}
+
+// Claiming or releasing a slot isn't a topology change, so the graph's listeners are told here
+void notifySlotsChanged(GraphTransaction& txn) { txn.getGraph().sendChangeMessage(); }
+
+void disconnectSlot(GraphTransaction& txn, NodeID matrixID, int slot) {
+    for (const auto& connection : txn.getGraph().getConnections())
+        if ((connection.destination.nodeID == matrixID && connection.destination.channelIndex == slot) ||
+            (connection.source.nodeID == matrixID && connection.source.channelIndex == slot))
+            txn.removeConnection(connection);
+}
+
+} // namespace
+
+juce::AudioProcessorGraph::NodeID makeModRouteID(juce::AudioProcessorGraph::NodeID matrixID, int slot) {
+    jassert(matrixID.uid <= (std::numeric_limits<juce::uint32>::max() >> kSlotBits));
+    jassert(juce::isPositiveAndBelow(slot, ModMatrixModule::kNumSlots));
+    return NodeID((matrixID.uid << kSlotBits) | (juce::uint32)slot);
+}
+
+std::vector<ModRoute> getModRoutes(const juce::AudioProcessorGraph& graph) {
+    GSYNTH_TRACE_SCOPE("graph", "getModRoutes");
+
+    std::vector<ModRoute> routes;
+    std::unordered_map<juce::uint64, size_t> routeForSlot; // (matrix uid, slot) -> route
+    auto slotKey = [](NodeID nodeID, int slot) { return ((juce::uint64)nodeID.uid << 32) | (juce::uint32)slot; };
+    for (auto* node : graph.getNodes()) {
+        auto* matrix = getMatrix(*node);
+        if (matrix == nullptr)
+            continue;
+        for (int slot = 0; slot < ModMatrixModule::kNumSlots; ++slot) {
+            if (!matrix->isSlotUsed(slot))
+                continue;
+            routeForSlot[slotKey(node->nodeID, slot)] = routes.size();
+            auto id = makeModRouteID(node->nodeID, slot);
+            routes.push_back({id, node->nodeID, matrix, slot, std::nullopt, std::nullopt});
+        }
+    }
+    if (routes.empty())
+        return routes;
+
+    // One pass over the connections: the first link into and out of each used slot
+    auto findRoute = [&](const NodeAndChannel& end) -> ModRoute* {
+        auto it = routeForSlot.find(slotKey(end.nodeID, end.channelIndex));
+        return it != routeForSlot.end() ? &routes[it->second] : nullptr;
+    };
+    for (const auto& connection : graph.getConnections()) {
+        if (auto* route = findRoute(connection.destination); route != nullptr && !route->source)
+            route->source = connection.source;
+        if (auto* route = findRoute(connection.source); route != nullptr && !route->dest)
+            route->dest = connection.destination;
+    }
+
+    std::sort(routes.begin(), routes.end(), [](const ModRoute& a, const ModRoute& b) { return a.id.uid < b.id.uid; });
+    return routes;
+}
+
+std::optional<ModRoute> findModRoute(const juce::AudioProcessorGraph& graph,
+                                     juce::AudioProcessorGraph::NodeID routeID) {
+    auto* node = graph.getNodeForId(NodeID(routeID.uid >> kSlotBits));
+    auto* matrix = node != nullptr ? getMatrix(*node) : nullptr;
+    const int slot = (int)(routeID.uid & kSlotMask);
+    if (matrix == nullptr || !matrix->isSlotUsed(slot))
+        return std::nullopt;
+
+    ModRoute route{routeID, node->nodeID, matrix, slot, std::nullopt, std::nullopt};
+    for (const auto& connection : graph.getConnections()) {
+        if (!route.source && connection.destination == NodeAndChannel{node->nodeID, slot})
+            route.source = connection.source;
+        if (!route.dest && connection.source == NodeAndChannel{node->nodeID, slot})
+            route.dest = connection.destination;
+    }
+    return route;
+}
+
+std::optional<juce::AudioProcessorGraph::NodeID> addModRoute(GraphTransaction& txn, End source, End dest,
+                                                             float amount, bool bypassed) {
+    if (feedsItself(txn.getGraph(), source, dest))
+        return std::nullopt;
+
+    auto* node = findMatrixFor(txn, source, dest);
+    if (node == nullptr)
+        return std::nullopt;
+    const int slot = getMatrix(*node)->allocateSlot(amount, bypassed);
+    connectSlot(txn, node->nodeID, slot, source, dest);
+    notifySlotsChanged(txn);
+    return makeModRouteID(node->nodeID, slot);
+}
+
+bool removeModRoute(GraphTransaction& txn, juce::AudioProcessorGraph::NodeID routeID) {
+    auto route = findModRoute(txn.getGraph(), routeID);
+    if (!route)
+        return false;
+    disconnectSlot(txn, route->matrixID, route->slot);
+    route->matrix->releaseSlot(route->slot);
+    notifySlotsChanged(txn);
+    return true;
+}
+
+std::optional<juce::AudioProcessorGraph::NodeID> setModRouteEnds(GraphTransaction& txn,
+                                                                 juce::AudioProcessorGraph::NodeID routeID,
+                                                                 End source, End dest) {
+    auto& graph = txn.getGraph();
+    auto route = findModRoute(graph, routeID);
+    if (!route)
+        return std::nullopt;
+
+    // The route's own links are dropped first, so they don't count as a loop against the new ends
+    disconnectSlot(txn, route->matrixID, route->slot);
+    if (feedsItself(graph, source, dest)) {
+        connectSlot(txn, route->matrixID, route->slot, route->source, route->dest);
+        return std::nullopt;
+    }
+
+    auto* matrixNode = graph.getNodeForId(route->matrixID);
+    if (canJoin(graph, *matrixNode, source, dest)) {
+        connectSlot(txn, route->matrixID, route->slot, source, dest);
+        return routeID;
+    }
+
+    auto* node = findMatrixFor(txn, source, dest, matrixNode);
+    if (node == nullptr) {
+        connectSlot(txn, route->matrixID, route->slot, route->source, route->dest);
+        return std::nullopt;
+    }
+    const float amount = route->matrix->getAmountParameter(route->slot).get();
+    const int slot = getMatrix(*node)->allocateSlot(amount, route->matrix->isSlotBypassed(route->slot));
+    route->matrix->releaseSlot(route->slot);
+    connectSlot(txn, node->nodeID, slot, source, dest);
+    notifySlotsChanged(txn);
+    return makeModRouteID(node->nodeID, slot);
+}
+
+bool isModMatrixNode(const juce::AudioProcessorGraph::Node& node) { return getMatrix(node) != nullptr; }
+
+} // namespace gsynth
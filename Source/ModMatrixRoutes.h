@@ -0,0 +1,70 @@
+#pragma once
+
+#include "GraphTransaction.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <optional>
+#include <vector>
+
+class ModMatrixModule;
+
+namespace gsynth {
+
+/**
+ * @brief One modulation route: a slot of a ModMatrixModule node.
+ *
+ * The slot's input is connected to the route's source and its output to the
+ * destination's CV input. Either end may be missing, for a route the user hasn't
+ * finished setting up or whose module was deleted.
+ */
+struct ModRoute {
+    using NodeID = juce::AudioProcessorGraph::NodeID;
+    using NodeAndChannel = juce::AudioProcessorGraph::NodeAndChannel;
+
+    NodeID id; // See makeModRouteID()
+    NodeID matrixID;
+    ModMatrixModule* matrix = nullptr;
+    int slot = 0;
+    std::optional<NodeAndChannel> source;
+    std::optional<NodeAndChannel> dest;
+};
+
+/**
+ * Names a route by its matrix node and slot, packed into one NodeID. The ID changes only
+ * when the route moves to another matrix (see setModRouteEnds()) or the graph is rebuilt.
+ */
+juce::AudioProcessorGraph::NodeID makeModRouteID(juce::AudioProcessorGraph::NodeID matrixID, int slot);
+
+/** Every route in the graph, sorted by ID, from one pass over the nodes and one over the connections. */
+std::vector<ModRoute> getModRoutes(const juce::AudioProcessorGraph& graph);
+
+std::optional<ModRoute> findModRoute(const juce::AudioProcessorGraph& graph, juce::AudioProcessorGraph::NodeID routeID);
+
+/**
+ * Adds a route with the given ends, amount and bypass, and returns its ID.
+ *
+ * Routes share as few matrix nodes as possible: a route goes into the first matrix
+ * it can join without closing a loop in the graph (a module that is both modulated
+ * and a modulation source), and a new matrix is added only when none can take it.
+ * Returns nullopt if the route would feed its own source.
+ */
+std::optional<juce::AudioProcessorGraph::NodeID> addModRoute(GraphTransaction& txn,
+                                                             std::optional<ModRoute::NodeAndChannel> source,
+                                                             std::optional<ModRoute::NodeAndChannel> dest,
+                                                             float amount, bool bypassed = false);
+
+bool removeModRoute(GraphTransaction& txn, juce::AudioProcessorGraph::NodeID routeID);
+
+/**
+ * Reconnects a route's ends. If its matrix can't take the new ends without closing a
+ * loop, the route moves to one that can, keeping its amount and bypass. Returns the
+ * route's ID afterwards, or nullopt (leaving the route as it was) if the new ends
+ * would feed the route's own source.
+ */
+std::optional<juce::AudioProcessorGraph::NodeID> setModRouteEnds(GraphTransaction& txn,
+                                                                 juce::AudioProcessorGraph::NodeID routeID,
+                                                                 std::optional<ModRoute::NodeAndChannel> source,
+                                                                 std::optional<ModRoute::NodeAndChannel> dest);
+
+bool isModMatrixNode(const juce::AudioProcessorGraph::Node& node);
+
+} // namespace gsynth
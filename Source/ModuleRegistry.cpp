@@ -0,0 +1,92 @@
+#include "ModuleRegistry.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+
+namespace gsynth {
+
+void ModuleRegistry::rebuild(const juce::AudioProcessorGraph& graph) {
+    GSYNTH_TRACE_SCOPE("graph", "ModuleRegistry::rebuild");
+
+    entries.clear();
+    for (auto& nodes : nodesByType)
+        nodes.clear();
+    overflowSlots.clear();
+
+    const auto& nodes = graph.getNodes();
+    entries.reserve((size_t)nodes.size());
+
+    // Dense up to a few times the node count; IDs beyond that are rare and go to the overflow map
+    const size_t denseSize = (size_t)std::max(1024, nodes.size() * 8);
+    slotForUid.assign(denseSize, kNoSlot);
+
+    for (auto* node : nodes) {
+        Entry entry{node, dynamic_cast<ModuleBase*>(node->getProcessor())};
+        const int slot = (int)entries.size();
+        const auto uid = node->nodeID.uid;
+        if (uid < denseSize)
+            slotForUid[uid] = slot;
+        else
+            overflowSlots[uid] = slot;
+
+        if (entry.module != nullptr) {
+            nodesByType[(size_t)entry.module->getModuleType()].push_back(node);
+            getParameterTable(*entry.module);
+        }
+        entries.push_back(entry);
+    }
+}
+
+const ModuleRegistry::Entry* ModuleRegistry::find(NodeID nodeID) const {
+    int slot = kNoSlot;
+    if (nodeID.uid < slotForUid.size()) {
+        slot = slotForUid[nodeID.uid];
+    } else if (auto it = overflowSlots.find(nodeID.uid); it != overflowSlots.end()) {
+        slot = it->second;
+    }
+    return slot != kNoSlot ? &entries[(size_t)slot] : nullptr;
+}
+
+ModuleBase* ModuleRegistry::getModule(NodeID nodeID) const {
+    auto* entry = find(nodeID);
+    return entry != nullptr ? entry->module : nullptr;
+}
+
+bool ModuleRegistry::isModuleType(NodeID nodeID, ModuleType type) const {
+    auto* module = getModule(nodeID);
+    return module != nullptr && module->getModuleType() == type;
+}
+
+juce::RangedAudioParameter* ModuleRegistry::getParameter(NodeID nodeID, const juce::String& paramID) const {
+    auto* module = getModule(nodeID);
+    if (module == nullptr)
+        return nullptr;
+
+    const auto& params = module->getParameters();
+
+    // The type's table is built during rebuild() for every type present in the graph
+    if (auto& table = parameterTables[(size_t)module->getModuleType()]; table != nullptr) {
+        if (auto it = table->find(paramID); it != table->end())
+            if (auto* p = dynamic_cast<juce::RangedAudioParameter*>(params[it->second]); p && p->paramID == paramID)
+                return p;
+    }
+
+    // A module whose layout differs from the first of its type; only test doubles do this
+    for (auto* param : params)
+        if (auto* p = dynamic_cast<juce::RangedAudioParameter*>(param); p && p->paramID == paramID)
+            return p;
+    return nullptr;
+}
+
+const ModuleRegistry::ParameterTable& ModuleRegistry::getParameterTable(ModuleBase& module) {
+    auto& table = parameterTables[(size_t)module.getModuleType()];
+    if (table == nullptr) {
+        table = std::make_unique<ParameterTable>();
+        const auto& params = module.getParameters();
+        for (int i = 0; i < params.size(); ++i)
+            if (auto* p = dynamic_cast<juce::RangedAudioParameter*>(params[i]))
+                (*table)[p->paramID] = i;
+    }
+    return *table;
+}
+
+} // namespace gsynth
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Modules/ModuleBase.h"
+#include <array>
+#include <memory>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <unordered_map>
+#include <vector>
+
+namespace gsynth {
+
+/**
+ * @class ModuleRegistry
+ * @brief A typed index of a graph's nodes, rebuilt once per topology change.
+ *
+ * The registry replaces dynamic_cast scans over graph.getNodes(). It holds:
+ * - every node in graph order, each with its ModuleBase (nullptr for the I/O nodes);
+ * - a dense NodeID -> slot table, so node and module lookups are O(1);
+ * - one node list per ModuleType, so "all Mod Matrices" costs O(k);
+ * - a paramID -> parameter index table per ModuleType, so parameters are found by
+ *   ID, not by position.
+ *
+ * Modules of one type share a parameter layout, so each type's table is built the
+ * first time the type is seen and kept across rebuilds.
+ *
+ * Pointers are only valid until the graph next changes. Message thread only.
+ */
+class ModuleRegistry {
+public:
+    using Node = juce::AudioProcessorGraph::Node;
+    using NodeID = juce::AudioProcessorGraph::NodeID;
+
+    struct Entry {
+        Node* node = nullptr;
+        ModuleBase* module = nullptr; // nullptr for nodes that aren't modules (the graph's I/O)
+    };
+
+    void rebuild(const juce::AudioProcessorGraph& graph);
+
+    /** Every node, in graph order. */
+    const std::vector<Entry>& getEntries() const { return entries; }
+
+    /** Nodes of one module type, in graph order. */
+    const std::vector<Node*>& getNodesOfType(ModuleType type) const { return nodesByType[(size_t)type]; }
+
+    const Entry* find(NodeID nodeID) const;
+    ModuleBase* getModule(NodeID nodeID) const;
+    bool isModuleType(NodeID nodeID, ModuleType type) const;
+
+    /** The node's parameter with this ID, or nullptr. */
+    juce::RangedAudioParameter* getParameter(NodeID nodeID, const juce::String& paramID) const;
+
+    int getNumNodes() const { return (int)entries.size(); }
+
+private:
+    using ParameterTable = std::unordered_map<juce::String, int>;
+
+    const ParameterTable& getParameterTable(ModuleBase& module);
+
+    static constexpr int kNoSlot = -1;
+
+    std::vector<Entry> entries;
+    std::array<std::vector<Node*>, (size_t)kNumModuleTypes> nodesByType;
+    std::array<std::unique_ptr<ParameterTable>, (size_t)kNumModuleTypes> parameterTables;
+
+    // NodeIDs are handed out in increasing order, so a vector indexed by uid covers almost
+    // every node; the rare uid far beyond the node count goes to the overflow map instead
+    std::vector<int> slotForUid;
+    std::unordered_map<juce::uint32, int> overflowSlots;
+};
+
+} // namespace gsynth
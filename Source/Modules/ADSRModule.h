@@ -1,115 +1,100 @@
 #pragma once
 
+#include "EnvelopeBank.h"
 #include "ModuleBase.h"
+#include "VoicePool.h"
 #include <algorithm>
 
 class ADSRModule : public ModuleBase {
 public:
     ADSRModule(const juce::String& name = "ADSR")
-        : ModuleBase(name, 8, 8) // 8 inputs (gate CV per voice), 8 outputs (envelope per voice)
+        : ModuleBase(name, kMaxPolyVoices, kMaxPolyVoices) // gate CV in, envelope out, one channel per voice
     {
         addParameter(attackParam = new juce::AudioParameterFloat("attack", "Attack", 0.01f, 5.0f, 0.05f));
         addParameter(decayParam = new juce::AudioParameterFloat("decay", "Decay", 0.01f, 5.0f, 0.2f));
         addParameter(sustainParam = new juce::AudioParameterFloat("sustain", "Sustain", 0.0f, 1.0f, 0.0f));
         addParameter(releaseParam = new juce::AudioParameterFloat("release", "Release", 0.01f, 5.0f, 0.1f));
         addParameter(polyParam = new juce::AudioParameterBool("poly", "Poly", false));
+        addParameter(curveParam = new juce::AudioParameterChoice(
+                         "curve", "Curve", juce::StringArray{"Linear", "Exponential", "Analogue"}, 0));
         enableVisualBuffer(true);
     }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
         juce::ignoreUnused(samplesPerBlock);
-        for (int v = 0; v < MAX_VOICES; ++v)
-            adsrs[v].setSampleRate(sampleRate);
+        envelopes.prepare(sampleRate);
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "ADSR");
         if (isBypassed() || buffer.getNumSamples() == 0 || buffer.getNumChannels() == 0) {
             buffer.clear();
+            getVoiceActivityLink().publishEnvelope(VoiceActivity::kAllVoices);
             return;
         }
 
-        float a = std::max(static_cast<float>(*attackParam), 0.002f);
-        float d = *decayParam;
-        float s = *sustainParam;
-        float r = std::max(static_cast<float>(*releaseParam), 0.005f);
+        envelopes.setParameters(std::max(static_cast<float>(*attackParam), 0.002f), *decayParam, *sustainParam,
+                                std::max(static_cast<float>(*releaseParam), 0.005f),
+                                static_cast<EnvelopeBank::Curve>(curveParam->getIndex()));
 
-        if (a != adsrParams.attack || d != adsrParams.decay || s != adsrParams.sustain || r != adsrParams.release) {
-            adsrParams.attack = a;
-            adsrParams.decay = d;
-            adsrParams.sustain = s;
-            adsrParams.release = r;
-            for (int v = 0; v < MAX_VOICES; ++v)
-                adsrs[v].setParameters(adsrParams);
-        }
-
-        bool poly = *polyParam;
+        const int numSamples = buffer.getNumSamples();
+        int numVoices = 1;
 
-        if (!poly) {
-            // Mono mode: MIDI gate handling, single envelope on channel 0
+        if (!*polyParam) {
+            // Mono mode: MIDI gate, one envelope on channel 0, split at each note event's sample
+            float* out = buffer.getWritePointer(0);
+            int position = 0;
             for (const auto metadata : midiMessages) {
                 auto message = metadata.getMessage();
-                if (message.isNoteOn()) {
-                    adsrs[0].noteOn();
-                } else if (message.isNoteOff()) {
-                    adsrs[0].noteOff();
-                }
-            }
-
-            // Generate valid control signal by filling all channels with 1.0f
-            for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-                auto* data = buffer.getWritePointer(ch);
-                std::fill(data, data + buffer.getNumSamples(), 1.0f);
+                if (!message.isNoteOn() && !message.isNoteOff())
+                    continue;
+                int eventPosition = juce::jlimit(position, numSamples, metadata.samplePosition);
+                float* segment = out + position;
+                envelopes.process(nullptr, &segment, 1, eventPosition - position);
+                position = eventPosition;
+                message.isNoteOn() ? envelopes.noteOn(0) : envelopes.noteOff(0);
             }
+            float* segment = out + position;
+            envelopes.process(nullptr, &segment, 1, numSamples - position);
 
-            adsrs[0].applyEnvelopeToBuffer(buffer, 0, buffer.getNumSamples());
-            if (auto* vb = getVisualBuffer())
-                for (int s = 0; s < buffer.getNumSamples(); ++s)
-                    vb->pushSample(buffer.getSample(0, s));
+            // A mono envelope is shared by every voice, so it can't release any of them
+            getVoiceActivityLink().publishEnvelope(VoiceActivity::kAllVoices);
         } else {
-            // Poly mode: gate CV per voice
-            for (int v = 0; v < MAX_VOICES; ++v)
-                adsrs[v].setParameters(adsrParams);
-
-            int numChannels = buffer.getNumChannels();
-            int numSamples = buffer.getNumSamples();
-
-            for (int v = 0; v < std::min(MAX_VOICES, numChannels); ++v) {
-                // Read gate CV from input channel v
-                const float* gateData = buffer.getReadPointer(v);
+            // Poly mode: gate CV per voice, with edges detected on every sample. The gates
+            // arrive in the channels the envelopes are written to; EnvelopeBank reads each
+            // gate sample before overwriting it.
+            numVoices = std::min(kMaxPolyVoices, buffer.getNumChannels());
+            const VoiceMask activeAtStart = envelopes.getActiveMask();
+            envelopes.process(buffer.getArrayOfReadPointers(), buffer.getArrayOfWritePointers(), numVoices,
+                              numSamples);
+
+            // Voices still audible anywhere in this block stay sounding until the next one
+            getVoiceActivityLink().publishEnvelope(activeAtStart | envelopes.getActiveMask());
+        }
 
-                // Edge detection at start of block
-                bool gateHigh = gateData[0] > 0.5f;
-                if (gateHigh && !previousGateState[v])
-                    adsrs[v].noteOn();
-                if (!gateHigh && previousGateState[v])
-                    adsrs[v].noteOff();
-                previousGateState[v] = gateHigh;
+        // Only the envelope channels are written; the rest must not pass their gate input through
+        for (int ch = numVoices; ch < buffer.getNumChannels(); ++ch)
+            buffer.clear(ch, 0, numSamples);
 
-                // Generate per-voice envelope (can't use applyEnvelopeToBuffer
-                // as it applies to ALL channels, corrupting other voices)
-                float* out = buffer.getWritePointer(v);
-                for (int smp = 0; smp < numSamples; ++smp)
-                    out[smp] = adsrs[v].getNextSample();
-            }
-            if (auto* vb = getVisualBuffer())
-                for (int s = 0; s < numSamples; ++s)
-                    vb->pushSample(buffer.getSample(0, s));
+        if (auto* vb = getVisualBuffer()) {
+            const float* voice0 = buffer.getReadPointer(0);
+            for (int s = 0; s < numSamples; ++s)
+                vb->pushSample(voice0[s]);
         }
     }
 
     ModulationCategory getModulationCategory() const override { return ModulationCategory::Envelope; }
     juce::String getInputPortLabel(int) const override { return "Gate"; }
     juce::String getOutputPortLabel(int) const override { return "Env"; }
+    PortRate getOutputPortRate(int) const override { return PortRate::Control; }
     int getVisibleInputPortCount() const override { return 1; }
     int getVisibleOutputPortCount() const override { return 1; }
     ModuleType getModuleType() const override { return ModuleType::ADSR; }
 
 private:
-    static constexpr int MAX_VOICES = 8;
-    juce::ADSR adsrs[MAX_VOICES];
-    juce::ADSR::Parameters adsrParams;
-    bool previousGateState[MAX_VOICES] = {};
+    EnvelopeBank envelopes;
     juce::AudioParameterBool* polyParam = nullptr;
+    juce::AudioParameterChoice* curveParam = nullptr;
 
     juce::AudioParameterFloat* attackParam = nullptr;
     juce::AudioParameterFloat* decayParam = nullptr;
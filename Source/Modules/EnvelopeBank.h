@@ -0,0 +1,210 @@
+#pragma once
+
+#include "VoicePool.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @class EnvelopeBank
+ * @brief ADSR envelopes for every voice, stored as parallel arrays and run in lockstep.
+ *
+ * Every stage is the same one-pole recurrence, level = level * coef + base, with a
+ * per-voice coefficient pair and an end level. Linear stages use coef = 1; the
+ * exponential and analogue curves use a decaying coefficient towards an overshoot
+ * target, so no stage needs pow() or exp() per sample. Coefficients are only
+ * recomputed when the parameters change or a voice changes stage.
+ *
+ * process() detects gate edges on every sample, so a gate that changes mid-block
+ * starts or releases its voice on that sample.
+ */
+class EnvelopeBank {
+public:
+    enum class Curve { Linear, Exponential, Analogue };
+
+    static constexpr float kGateThreshold = 0.5f;
+
+    void prepare(double newSampleRate) {
+        sampleRate = newSampleRate;
+        reset();
+        updateCoefficients();
+    }
+
+    void reset() {
+        for (int v = 0; v < kMaxPolyVoices; ++v) {
+            levels[v] = 0.0f;
+            gateHigh[v] = false;
+            enterStage(v, Stage::Idle);
+        }
+    }
+
+    void setParameters(float attackSeconds, float decaySeconds, float sustainLevel, float releaseSeconds,
+                       Curve newCurve) {
+        if (attackSeconds == attack && decaySeconds == decay && sustainLevel == sustain &&
+            releaseSeconds == release && newCurve == curve)
+            return;
+
+        attack = attackSeconds;
+        decay = decaySeconds;
+        sustain = sustainLevel;
+        release = releaseSeconds;
+        curve = newCurve;
+        updateCoefficients();
+
+        // Voices mid-stage pick up the new shape from where they are
+        for (int v = 0; v < kMaxPolyVoices; ++v)
+            enterStage(v, stages[v]);
+    }
+
+    void noteOn(int voice) { enterStage(voice, Stage::Attack); }
+
+    void noteOff(int voice) {
+        if (stages[voice] != Stage::Idle)
+            enterStage(voice, levels[voice] > 0.0f ? Stage::Release : Stage::Idle);
+    }
+
+    bool isActive(int voice) const { return stages[voice] != Stage::Idle; }
+    float getLevel(int voice) const { return levels[voice]; }
+
+    /** One bit per voice that is not Idle. */
+    VoiceMask getActiveMask() const {
+        VoiceMask mask = 0;
+        for (int v = 0; v < kMaxPolyVoices; ++v)
+            if (stages[v] != Stage::Idle)
+                mask |= VoiceMask{1} << v;
+        return mask;
+    }
+
+    /**
+     * Renders voices [0, numVoices) into outputs. gates, if given, holds one gate
+     * channel per voice; a voice starts on a rising edge and releases on a falling
+     * edge. Without gates, voices only change through noteOn() and noteOff().
+     * gates and outputs may alias (in-place processing): each gate sample is read
+     * before the envelope sample is written over it.
+     */
+    void process(const float* const* gates, float* const* outputs, int numVoices, int numSamples) {
+        numVoices = std::min(numVoices, kMaxPolyVoices);
+
+        for (int i = 0; i < numSamples; ++i) {
+            if (gates != nullptr) {
+                for (int v = 0; v < numVoices; ++v) {
+                    const bool high = gates[v][i] > kGateThreshold;
+                    if (high != gateHigh[v]) {
+                        gateHigh[v] = high;
+                        high ? noteOn(v) : noteOff(v);
+                    }
+                }
+            }
+
+            // The recurrence itself has no branches; all voices advance together
+            for (int v = 0; v < numVoices; ++v)
+                levels[v] = levels[v] * coefs[v] + bases[v];
+
+            for (int v = 0; v < numVoices; ++v) {
+                if (directions[v] != 0.0f && (levels[v] - endLevels[v]) * directions[v] >= 0.0f) {
+                    levels[v] = endLevels[v];
+                    enterStage(v, nextStage(stages[v]));
+                }
+                outputs[v][i] = levels[v];
+            }
+        }
+    }
+
+private:
+    enum class Stage { Idle, Attack, Decay, Sustain, Release };
+
+    struct StageShape {
+        float coef = 1.0f;
+        float base = 0.0f;
+    };
+
+    static Stage nextStage(Stage stage) {
+        switch (stage) {
+        case Stage::Attack:
+            return Stage::Decay;
+        case Stage::Decay:
+            return Stage::Sustain;
+        case Stage::Release:
+            return Stage::Idle;
+        default:
+            return stage;
+        }
+    }
+
+    // One-pole that moves from its start to within targetRatio of the overshoot target in numSamples
+    static float onePoleCoef(float numSamples, float targetRatio) {
+        return std::exp(-std::log((1.0f + targetRatio) / targetRatio) / numSamples);
+    }
+
+    void updateCoefficients() {
+        const auto sr = (float)sampleRate;
+        attackSamples = std::max(1.0f, attack * sr);
+        decaySamples = std::max(1.0f, decay * sr);
+        releaseSamples = std::max(1.0f, release * sr);
+
+        if (curve == Curve::Linear) {
+            attackShape = {1.0f, 1.0f / attackSamples};
+            decayShape = {1.0f, -(1.0f - sustain) / decaySamples};
+            releaseShape = {}; // Linear release depends on the level at note-off; see enterStage()
+            return;
+        }
+
+        // Exponential: steep RC curves throughout. Analogue: the attack charges towards an overshoot,
+        // so it rises quickly and bends over into the peak, like a capacitor-based envelope.
+        const float attackRatio = curve == Curve::Analogue ? 0.3f : 0.0001f;
+        const float decayReleaseRatio = 0.0001f;
+
+        const float attackCoef = onePoleCoef(attackSamples, attackRatio);
+        const float decayCoef = onePoleCoef(decaySamples, decayReleaseRatio);
+        const float releaseCoef = onePoleCoef(releaseSamples, decayReleaseRatio);
+        attackShape = {attackCoef, (1.0f + attackRatio) * (1.0f - attackCoef)};
+        decayShape = {decayCoef, (sustain - decayReleaseRatio) * (1.0f - decayCoef)};
+        releaseShape = {releaseCoef, -decayReleaseRatio * (1.0f - releaseCoef)};
+    }
+
+    void enterStage(int v, Stage stage) {
+        stages[v] = stage;
+        StageShape shape;
+        switch (stage) {
+        case Stage::Idle:
+            shape = {0.0f, 0.0f};
+            directions[v] = 0.0f;
+            break;
+        case Stage::Attack:
+            shape = attackShape;
+            endLevels[v] = 1.0f;
+            directions[v] = 1.0f;
+            break;
+        case Stage::Decay:
+            shape = decayShape;
+            endLevels[v] = sustain;
+            directions[v] = -1.0f;
+            break;
+        case Stage::Sustain:
+            shape = {0.0f, sustain}; // Follows the sustain level if it changes
+            directions[v] = 0.0f;
+            break;
+        case Stage::Release:
+            shape = curve == Curve::Linear ? StageShape{1.0f, -levels[v] / releaseSamples} : releaseShape;
+            endLevels[v] = 0.0f;
+            directions[v] = -1.0f;
+            break;
+        }
+        coefs[v] = shape.coef;
+        bases[v] = shape.base;
+    }
+
+    double sampleRate = 44100.0;
+    float attack = 0.05f, decay = 0.2f, sustain = 0.0f, release = 0.1f;
+    Curve curve = Curve::Linear;
+    float attackSamples = 1.0f, decaySamples = 1.0f, releaseSamples = 1.0f;
+    StageShape attackShape, decayShape, releaseShape;
+
+    // Per-voice state, one array per field so the per-sample loops run across voices
+    float levels[kMaxPolyVoices] = {};
+    float coefs[kMaxPolyVoices] = {};
+    float bases[kMaxPolyVoices] = {};
+    float endLevels[kMaxPolyVoices] = {};
+    float directions[kMaxPolyVoices] = {}; // +1 rising to endLevel, -1 falling to it, 0 no end
+    Stage stages[kMaxPolyVoices] = {};
+    bool gateHigh[kMaxPolyVoices] = {};
+};
@@ -1,12 +1,15 @@
 #pragma once
 
 #include "../ModuleBase.h"
-#include <juce_dsp/juce_dsp.h>
+#include "DynamicsProcessor.h"
 
-class CompressorModule : public ModuleBase {
+class CompressorModule
+    : public ModuleBase
+    , public juce::AudioProcessorParameter::Listener
+    , private juce::AsyncUpdater {
 public:
     CompressorModule()
-        : ModuleBase("Compressor", 2, 2) {
+        : ModuleBase("Compressor", 5, 2) { // stereo audio, stereo sidechain, threshold CV in; stereo out
         addParameter(thresholdParam =
                          new juce::AudioParameterFloat("threshold", "Threshold (dB)", -60.0f, 0.0f, -12.0f));
         addParameter(ratioParam = new juce::AudioParameterFloat("ratio", "Ratio", 1.0f, 20.0f, 4.0f));
@@ -14,70 +17,137 @@ public:
         addParameter(releaseParam = new juce::AudioParameterFloat("release", "Release (ms)", 10.0f, 1000.0f, 100.0f));
         addParameter(makeupGainParam =
                          new juce::AudioParameterFloat("makeupGain", "Makeup Gain (dB)", 0.0f, 24.0f, 0.0f));
+        addParameter(kneeParam = new juce::AudioParameterFloat("knee", "Knee (dB)", 0.0f, 24.0f, 6.0f));
+        addParameter(lookaheadParam = new juce::AudioParameterFloat("lookahead", "Lookahead (ms)", 0.0f,
+                                                                    DynamicsProcessor::kMaxLookaheadMs, 0.0f));
+        addParameter(stereoLinkParam = new juce::AudioParameterFloat("stereoLink", "Stereo Link", 0.0f, 1.0f, 1.0f));
+        addParameter(sidechainParam = new juce::AudioParameterBool("sidechain", "External Sidechain", false));
+
+        lookaheadParam->addListener(this);
+    }
+
+    ~CompressorModule() override {
+        cancelPendingUpdate();
+        if (lookaheadParam != nullptr)
+            lookaheadParam->removeListener(this);
     }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sampleRate;
-        spec.maximumBlockSize = (juce::uint32)samplesPerBlock;
-        spec.numChannels = 2;
-        compressor.prepare(spec);
-        compressor.reset();
-
-        smoothedThreshold.reset(sampleRate, 0.01);
+        juce::ignoreUnused(samplesPerBlock);
+        dynamics.prepare(sampleRate);
+        dynamics.setSettings(makeSettings(0.0f));
+        setLatencySamples(dynamics.getLatencySamples());
+
         smoothedMakeupGain.reset(sampleRate, 0.005);
-        smoothedThreshold.setCurrentAndTargetValue(*thresholdParam);
-        smoothedMakeupGain.setCurrentAndTargetValue(*makeupGainParam);
+        smoothedMakeupGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain((float)*makeupGainParam));
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "Compressor");
         if (isBypassed())
             return;
 
         juce::ignoreUnused(midiMessages);
 
         const int numSamples = buffer.getNumSamples();
-        if (numSamples == 0 || buffer.getNumChannels() < 2)
+        const int numChannels = buffer.getNumChannels();
+        if (numSamples == 0 || numChannels < 2)
             return;
 
-        smoothedThreshold.setTargetValue(*thresholdParam);
-        smoothedMakeupGain.setTargetValue(*makeupGainParam);
-
-        compressor.setThreshold(smoothedThreshold.getCurrentValue());
-        compressor.setRatio(*ratioParam);
-        compressor.setAttack(*attackParam);
-        compressor.setRelease(*releaseParam);
-
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        compressor.process(context);
+        const float* sidechain[] = {numChannels > 3 ? buffer.getReadPointer(2) : nullptr,
+                                    numChannels > 3 ? buffer.getReadPointer(3) : nullptr};
+        const bool useSidechain = sidechainParam->get() && numChannels > 3;
+        const float* cvThreshold = numChannels > 4 ? buffer.getReadPointer(4) : nullptr;
+
+        // Threshold CV sweeps +-30 dB and is control rate: read once per control block,
+        // with runs of blocks at the same CV value processed in one go
+        for (int start = 0; start < numSamples;) {
+            const float cv = cvThreshold != nullptr ? cvThreshold[start] : 0.0f;
+            int end = std::min(start + kControlBlockSize, numSamples);
+            while (end < numSamples && cvThreshold != nullptr && cvThreshold[end] == cv)
+                end = std::min(end + kControlBlockSize, numSamples);
+
+            dynamics.setSettings(makeSettings(cv));
+            float* audio[] = {buffer.getWritePointer(0, start), buffer.getWritePointer(1, start)};
+            const float* key[] = {useSidechain ? sidechain[0] + start : nullptr,
+                                  useSidechain ? sidechain[1] + start : nullptr};
+            dynamics.process(audio, useSidechain ? key : nullptr, 2, end - start);
+            start = end;
+        }
 
-        // Apply makeup gain per-sample (smoothed)
-        for (int i = 0; i < numSamples; ++i) {
-            float linearGain = juce::Decibels::decibelsToGain(smoothedMakeupGain.getNextValue());
-            buffer.getWritePointer(0)[i] *= linearGain;
-            buffer.getWritePointer(1)[i] *= linearGain;
+        // Makeup gain: one multiply per channel unless it's moving
+        smoothedMakeupGain.setTargetValue(juce::Decibels::decibelsToGain((float)*makeupGainParam));
+        if (smoothedMakeupGain.isSmoothing()) {
+            float* left = buffer.getWritePointer(0);
+            float* right = buffer.getWritePointer(1);
+            for (int i = 0; i < numSamples; ++i) {
+                const float gain = smoothedMakeupGain.getNextValue();
+                left[i] *= gain;
+                right[i] *= gain;
+            }
+        } else {
+            buffer.applyGain(0, 0, numSamples, smoothedMakeupGain.getTargetValue());
+            buffer.applyGain(1, 0, numSamples, smoothedMakeupGain.getTargetValue());
         }
 
-        smoothedThreshold.skip(numSamples);
+        // Clear sidechain and CV channels to prevent leaking to downstream modules
+        for (int ch = 2; ch < numChannels; ++ch)
+            buffer.clear(ch, 0, numSamples);
     }
 
-    juce::String getInputPortLabel(int i) const override { return i == 0 ? "Left" : "Right"; }
+    /** Deepest gain reduction in the last block, in dB (0 or below). */
+    float getGainReductionDb() const { return dynamics.getGainReductionDb(); }
+
+    juce::String getInputPortLabel(int i) const override {
+        const juce::String labels[] = {"Left", "Right", "Sidechain L", "Sidechain R", "Threshold"};
+        return (i >= 0 && i < 5) ? labels[i] : ModuleBase::getInputPortLabel(i);
+    }
     juce::String getOutputPortLabel(int i) const override { return i == 0 ? "Left" : "Right"; }
 
-    std::vector<ModulationTarget> getModulationTargets() const override { return {}; }
+    PortRate getInputPortRate(int i) const override { return i == 4 ? PortRate::Control : PortRate::Audio; }
+
+    std::vector<ModulationTarget> getModulationTargets() const override { return {{"Threshold", 4}}; }
     ModulationCategory getModulationCategory() const override { return ModulationCategory::FX; }
     ModuleType getModuleType() const override { return ModuleType::Compressor; }
 
+    void parameterValueChanged(int, float) override {
+        // May come from any thread; the latency is reported from the message thread
+        triggerAsyncUpdate();
+    }
+    void parameterGestureChanged(int, bool) override {}
+
 private:
-    juce::dsp::Compressor<float> compressor;
+    void handleAsyncUpdate() override {
+        // Reporting a new latency notifies the processor's listeners, which rebuild the graph
+        const int latency = dynamics.getLatencySamples(makeSettings(0.0f));
+        if (latency != getLatencySamples())
+            setLatencySamples(latency);
+    }
+
+    DynamicsProcessor::Settings makeSettings(float cvThreshold) const {
+        DynamicsProcessor::Settings settings;
+        settings.mode = DynamicsProcessor::Mode::Compressor;
+        settings.thresholdDb = juce::jlimit(-60.0f, 0.0f, (float)*thresholdParam + cvThreshold * 30.0f);
+        settings.ratio = *ratioParam;
+        settings.kneeDb = *kneeParam;
+        settings.attackMs = *attackParam;
+        settings.releaseMs = *releaseParam;
+        settings.lookaheadMs = *lookaheadParam;
+        settings.stereoLink = *stereoLinkParam;
+        return settings;
+    }
+
+    DynamicsProcessor dynamics;
 
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedThreshold;
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedMakeupGain;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedMakeupGain;
 
     juce::AudioParameterFloat* thresholdParam;
     juce::AudioParameterFloat* ratioParam;
     juce::AudioParameterFloat* attackParam;
     juce::AudioParameterFloat* releaseParam;
     juce::AudioParameterFloat* makeupGainParam;
+    juce::AudioParameterFloat* kneeParam;
+    juce::AudioParameterFloat* lookaheadParam;
+    juce::AudioParameterFloat* stereoLinkParam;
+    juce::AudioParameterBool* sidechainParam;
 };
@@ -28,6 +28,7 @@ public:
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "Delay");
         if (isBypassed())
             return;
 
@@ -28,6 +28,8 @@ public:
     }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        prepareOversampling(sampleRate, samplesPerBlock);
+
         // Pre-allocate 2x and 4x oversamplers for real-time safe switching
         oversamplers[0] = std::make_unique<juce::dsp::Oversampling<float>>(
             2, 1, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true); // 2x
@@ -60,10 +62,48 @@ public:
         if (oversamplers[1])
             oversamplers[1]->reset();
 
-        setLatencySamples(juce::roundToInt(getLatencyInSamples()));
+        refreshLatency();
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        getOversamplingLink().process(buffer, midiMessages, [this](auto& b, auto& m) { render(b, m); });
+    }
+
+    juce::String getInputPortLabel(int i) const override {
+        const juce::String labels[] = {"Left", "Right", "Drive", "Mix"};
+        return (i >= 0 && i < 4) ? labels[i] : ModuleBase::getInputPortLabel(i);
+    }
+    juce::String getOutputPortLabel(int i) const override { return i == 0 ? "Left" : "Right"; }
+
+    std::vector<ModulationTarget> getModulationTargets() const override { return {{"Drive", 2}, {"Mix", 3}}; }
+
+    ModulationCategory getModulationCategory() const override { return ModulationCategory::FX; }
+    ModuleType getModuleType() const override { return ModuleType::Distortion; }
+    bool supportsOversampling() const override { return true; }
+    int getInternalLatencySamples() const override { return juce::roundToInt(getLatencyInSamples()); }
+
+    double getLatencyInSamples() const {
+        int idx = getInternalOversamplingIndex();
+        if (idx == 0)
+            return 0.0;
+        return oversamplers[idx - 1] ? oversamplers[idx - 1]->getLatencyInSamples() : 0.0;
+    }
+
+    void parameterValueChanged(int parameterIndex, float newValue) override {
+        juce::ignoreUnused(newValue);
+        if (oversamplingParam && parameterIndex == oversamplingParam->getParameterIndex()) {
+            latencyDelay.setDelay(static_cast<float>(getLatencyInSamples()));
+            refreshLatency();
+        }
+    }
+
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {
+        juce::ignoreUnused(parameterIndex, gestureIsStarting);
+    }
+
+private:
+    void render(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+        GSYNTH_TRACE_SCOPE("audio", "Distortion");
         juce::ignoreUnused(midiMessages);
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
@@ -115,7 +155,7 @@ public:
         juce::dsp::ProcessContextReplacing<float> dryContext(dryBlock);
         latencyDelay.process(dryContext);
 
-        int oversamplingIndex = oversamplingParam ? oversamplingParam->getIndex() : 0;
+        int oversamplingIndex = getInternalOversamplingIndex();
         int type = typeParam ? typeParam->getIndex() : 0;
 
         if (oversamplingIndex == 0) {
@@ -209,40 +249,13 @@ public:
             buffer.clear(ch, 0, numSamples);
     }
 
-    juce::String getInputPortLabel(int i) const override {
-        const juce::String labels[] = {"Left", "Right", "Drive", "Mix"};
-        return (i >= 0 && i < 4) ? labels[i] : ModuleBase::getInputPortLabel(i);
+    // Inside an oversampling region the whole module already runs oversampled
+    int getInternalOversamplingIndex() const {
+        if (oversamplingParam == nullptr || getOversamplingLink().isBound())
+            return 0;
+        return oversamplingParam->getIndex();
     }
-    juce::String getOutputPortLabel(int i) const override { return i == 0 ? "Left" : "Right"; }
-
-    std::vector<ModulationTarget> getModulationTargets() const override { return {{"Drive", 2}, {"Mix", 3}}; }
 
-    ModulationCategory getModulationCategory() const override { return ModulationCategory::FX; }
-    ModuleType getModuleType() const override { return ModuleType::Distortion; }
-
-    double getLatencyInSamples() const {
-        if (!oversamplingParam)
-            return 0.0;
-        int idx = oversamplingParam->getIndex();
-        if (idx == 0)
-            return 0.0;
-        return oversamplers[idx - 1] ? oversamplers[idx - 1]->getLatencyInSamples() : 0.0;
-    }
-
-    void parameterValueChanged(int parameterIndex, float newValue) override {
-        juce::ignoreUnused(newValue);
-        if (oversamplingParam && parameterIndex == oversamplingParam->getParameterIndex()) {
-            float lat = static_cast<float>(getLatencyInSamples());
-            setLatencySamples(juce::roundToInt(lat));
-            latencyDelay.setDelay(lat);
-        }
-    }
-
-    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {
-        juce::ignoreUnused(parameterIndex, gestureIsStarting);
-    }
-
-private:
     static float applyWaveshaper(float input, float drive, int type) {
         // Soft clipper
         if (type == 0) {
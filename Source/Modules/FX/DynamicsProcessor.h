@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+/**
+ * @class DynamicsProcessor
+ * @brief Feed-forward compressor and lookahead limiter shared by the Compressor and Limiter modules.
+ *
+ * Audio is processed in chunks of kChunkSize samples, one stage at a time across
+ * the chunk: detect, link, compute gain, then delay and apply. Only the envelope
+ * smoothing runs sample by sample. The compressor works in dB using fastLog2() and
+ * fastExp2(), so no stage calls pow() or log() per sample.
+ *
+ * The limiter computes the exact linear gain that brings each detected peak down to
+ * the ceiling. It holds the minimum gain over the lookahead window and averages it
+ * over the same window. The gain is therefore fully down when the peak leaves the
+ * delay line. A final clip catches float rounding, so sample peaks never exceed
+ * the ceiling. With true-peak detection on, the detector also checks the three
+ * points between each pair of samples using a 4x polyphase interpolator, which
+ * catches inter-sample peaks that a DAC would reconstruct.
+ *
+ * The detector can read an external sidechain instead of the audio. Stereo link
+ * blends each channel's detector towards the louder channel's.
+ */
+class DynamicsProcessor {
+public:
+    enum class Mode { Compressor, Limiter };
+
+    struct Settings {
+        Mode mode = Mode::Compressor;
+        float thresholdDb = -12.0f; // The limiter's ceiling
+        float ratio = 4.0f;         // Compressor only
+        float kneeDb = 6.0f;        // Compressor only
+        float attackMs = 10.0f;     // Compressor only; the limiter attacks over its lookahead
+        float releaseMs = 100.0f;
+        float lookaheadMs = 0.0f;
+        float stereoLink = 1.0f; // 0: independent channels, 1: both follow the louder one
+        bool truePeak = false;
+
+        bool operator==(const Settings& other) const {
+            return mode == other.mode && thresholdDb == other.thresholdDb && ratio == other.ratio &&
+                   kneeDb == other.kneeDb && attackMs == other.attackMs && releaseMs == other.releaseMs &&
+                   lookaheadMs == other.lookaheadMs && stereoLink == other.stereoLink && truePeak == other.truePeak;
+        }
+        bool operator!=(const Settings& other) const { return !(*this == other); }
+    };
+
+    static constexpr int kMaxChannels = 2;
+    static constexpr int kChunkSize = 256;
+    static constexpr float kMaxLookaheadMs = 10.0f;
+    static constexpr int kTruePeakTaps = 12;                 // Per interpolator phase
+    static constexpr int kTruePeakDelay = kTruePeakTaps / 2; // Samples the detector lags its input
+    static constexpr int kTruePeakPhases = 3;                // Points between each pair of samples
+
+    /** log2(x) for x > 0: exponent bits plus a degree-5 polynomial on the mantissa (error below 0.0002 dB). */
+    static float fastLog2(float x) {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        const auto exponent = (float)((int)((bits >> 23) & 0xff) - 127);
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+        float t;
+        std::memcpy(&t, &bits, sizeof(t));
+        t -= 1.0f;
+        const float high = 0.415411186f + t * (-0.194408323f + t * 0.0458789501f);
+        return exponent + t * (1.4418255f + t * (-0.708678912f + t * high));
+    }
+
+    /** 2^x, clamped to the float range: a degree-4 polynomial on the fraction (error below 0.00004 dB). */
+    static float fastExp2(float x) {
+        x = std::clamp(x, -126.0f, 126.0f);
+        const float whole = std::floor(x);
+        const float f = x - whole;
+        const float mantissa = 1.0f + f * (0.693018631f + f * (0.241404768f + f * (0.0520739356f + f * 0.0134934755f)));
+        const auto scaleBits = (uint32_t)((int)whole + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &scaleBits, sizeof(scale));
+        return mantissa * scale;
+    }
+
+    static float fastGainToDecibels(float gain) { return kDecibelsPerOctave * fastLog2(std::max(gain, kFloor)); }
+    static float fastDecibelsToGain(float dB) { return fastExp2(dB / kDecibelsPerOctave); }
+
+    void prepare(double newSampleRate) {
+        sampleRate = newSampleRate;
+        maxLookaheadSamples = (int)std::ceil(kMaxLookaheadMs * 0.001 * sampleRate);
+
+        int holdSize = 1;
+        while (holdSize < maxLookaheadSamples + 2)
+            holdSize <<= 1;
+
+        for (auto& ch : channels) {
+            ch.delayLine.assign((size_t)(maxLookaheadSamples + kTruePeakDelay + kChunkSize), 0.0f);
+            ch.holdValues.assign((size_t)holdSize, 1.0f);
+            ch.holdIndices.assign((size_t)holdSize, 0);
+            ch.box.assign((size_t)maxLookaheadSamples + 1, 1.0f);
+        }
+        holdMask = (uint32_t)holdSize - 1;
+
+        updateCoefficients();
+        reset();
+    }
+
+    void reset() {
+        for (auto& ch : channels) {
+            std::fill(ch.delayLine.begin(), ch.delayLine.end(), 0.0f);
+            ch.truePeakHistory.fill(0.0f);
+            ch.gainReductionDb = 0.0f;
+            ch.release = 1.0f;
+            ch.holdHead = ch.holdTail = 0;
+            std::fill(ch.box.begin(), ch.box.end(), 1.0f);
+            ch.boxPos = 0;
+            ch.boxSum = (double)boxLength;
+        }
+        sampleCounter = 0;
+        gainReductionDb.store(0.0f, std::memory_order_relaxed);
+    }
+
+    void setSettings(const Settings& newSettings) {
+        if (newSettings == settings)
+            return;
+
+        const int previousDelay = getLatencySamples();
+        const int previousBoxLength = boxLength;
+        settings = newSettings;
+        updateCoefficients();
+
+        // A new delay length would replay stale history; start from silence instead
+        if (getLatencySamples() != previousDelay)
+            for (auto& ch : channels)
+                std::fill(ch.delayLine.begin(), ch.delayLine.end(), 0.0f);
+
+        if (boxLength != previousBoxLength) {
+            for (auto& ch : channels) {
+                ch.holdHead = ch.holdTail = 0;
+                std::fill(ch.box.begin(), ch.box.end(), ch.release);
+                ch.boxPos = 0;
+                ch.boxSum = (double)ch.release * boxLength;
+            }
+        }
+    }
+
+    const Settings& getSettings() const { return settings; }
+
+    /** Samples the audio is delayed by: the lookahead, plus the true-peak detector's lag when it is on. */
+    int getLatencySamples() const { return lookaheadSamples + (settings.truePeak ? kTruePeakDelay : 0); }
+
+    /** The latency these settings would give at the prepared rate, without applying them. */
+    int getLatencySamples(const Settings& s) const {
+        return toLookaheadSamples(s.lookaheadMs) + (s.truePeak ? kTruePeakDelay : 0);
+    }
+
+    /** Deepest gain reduction in the last processed chunk, in dB (0 or below). Safe to read from any thread. */
+    float getGainReductionDb() const { return gainReductionDb.load(std::memory_order_relaxed); }
+
+    /**
+     * Applies gain to audio in place. key, if given, holds the detector input for
+     * each channel (an external sidechain); otherwise the audio itself is detected.
+     */
+    void process(float* const* audio, const float* const* key, int numChannels, int numSamples) {
+        numChannels = std::min(numChannels, kMaxChannels);
+        for (int start = 0; start < numSamples; start += kChunkSize) {
+            const int n = std::min(kChunkSize, numSamples - start);
+            float* chunkAudio[kMaxChannels] = {};
+            const float* chunkKey[kMaxChannels] = {};
+            for (int c = 0; c < numChannels; ++c) {
+                chunkAudio[c] = audio[c] + start;
+                chunkKey[c] = (key != nullptr ? key[c] : audio[c]) + start;
+            }
+            processChunk(chunkAudio, chunkKey, numChannels, n);
+        }
+    }
+
+private:
+    static constexpr float kFloor = 1.0e-6f;                // -120 dB
+    static constexpr float kDecibelsPerOctave = 6.0205999f; // 20 * log10(2)
+
+    struct ChannelState {
+        std::vector<float> delayLine; // History (latency samples) followed by the chunk being delayed
+        std::array<float, kTruePeakTaps - 1> truePeakHistory{};
+        float gainReductionDb = 0.0f; // Compressor envelope
+
+        // Limiter: sliding minimum over the lookahead window, release, then a box average
+        std::vector<float> holdValues;
+        std::vector<int64_t> holdIndices;
+        uint32_t holdHead = 0, holdTail = 0; // Wrap around freely; indexed through holdMask
+        float release = 1.0f;
+        std::vector<float> box;
+        int boxPos = 0;
+        double boxSum = 1.0;
+    };
+
+    int toLookaheadSamples(float lookaheadMs) const {
+        return juce::jlimit(0, maxLookaheadSamples, (int)std::lround(lookaheadMs * 0.001f * (float)sampleRate));
+    }
+
+    void updateCoefficients() {
+        const auto sr = (float)sampleRate;
+        lookaheadSamples = toLookaheadSamples(settings.lookaheadMs);
+        boxLength = lookaheadSamples + 1;
+        attackCoef = std::exp(-1.0f / std::max(1.0f, settings.attackMs * 0.001f * sr));
+        releaseCoef = std::exp(-1.0f / std::max(1.0f, settings.releaseMs * 0.001f * sr));
+        ceilingGain = juce::Decibels::decibelsToGain(settings.thresholdDb);
+
+        // Windowed-sinc interpolator at 1/4, 2/4 and 3/4 of the way from tap 5 to tap 6,
+        // each phase normalised to unity gain at DC
+        for (int p = 0; p < kTruePeakPhases; ++p) {
+            const float offset = (float)(p + 1) / (float)(kTruePeakPhases + 1);
+            float sum = 0.0f;
+            for (int m = 0; m < kTruePeakTaps; ++m) {
+                const float u = offset - (float)(m - (kTruePeakDelay - 1));
+                const float x = juce::MathConstants<float>::pi * u;
+                const float sinc = std::abs(u) < 1.0e-6f ? 1.0f : std::sin(x) / x;
+                const float w = x / (float)(kTruePeakDelay + 1);
+                const float blackman = 0.42f + 0.5f * std::cos(w) + 0.08f * std::cos(2.0f * w);
+                truePeakCoefs[(size_t)p][(size_t)m] = sinc * blackman;
+                sum += truePeakCoefs[(size_t)p][(size_t)m];
+            }
+            for (auto& coef : truePeakCoefs[(size_t)p])
+                coef /= sum;
+        }
+    }
+
+    void processChunk(float* const* audio, const float* const* key, int numChannels, int n) {
+        for (int c = 0; c < numChannels; ++c) {
+            if (settings.truePeak)
+                detectTruePeak(channels[(size_t)c], key[c], detector[(size_t)c].data(), n);
+            else
+                juce::FloatVectorOperations::abs(detector[(size_t)c].data(), key[c], n);
+        }
+
+        if (numChannels == 2 && settings.stereoLink > 0.0f) {
+            float* left = detector[0].data();
+            float* right = detector[1].data();
+            juce::FloatVectorOperations::max(linked.data(), left, right, n);
+            for (float* d : {left, right}) {
+                juce::FloatVectorOperations::multiply(d, 1.0f - settings.stereoLink, n);
+                juce::FloatVectorOperations::addWithMultiply(d, linked.data(), settings.stereoLink, n);
+            }
+        }
+
+        float deepest = 1.0f;
+        for (int c = 0; c < numChannels; ++c) {
+            auto& ch = channels[(size_t)c];
+            float* g = gain[(size_t)c].data();
+            if (settings.mode == Mode::Limiter)
+                computeLimiterGain(ch, detector[(size_t)c].data(), g, n);
+            else
+                computeCompressorGain(ch, detector[(size_t)c].data(), g, n);
+
+            applyDelayed(ch, audio[c], g, n);
+            if (settings.mode == Mode::Limiter)
+                juce::FloatVectorOperations::clip(audio[c], audio[c], -ceilingGain, ceilingGain, n);
+
+            deepest = std::min(deepest, juce::FloatVectorOperations::findMinimum(g, n));
+        }
+        sampleCounter += n;
+        gainReductionDb.store(juce::Decibels::gainToDecibels(deepest, -120.0f), std::memory_order_relaxed);
+    }
+
+    // The detector output lags the key by kTruePeakDelay samples
+    void detectTruePeak(ChannelState& ch, const float* key, float* out, int n) {
+        constexpr int history = kTruePeakTaps - 1;
+        std::copy(ch.truePeakHistory.begin(), ch.truePeakHistory.end(), truePeakInput.begin());
+        std::copy(key, key + n, truePeakInput.begin() + history);
+
+        for (int i = 0; i < n; ++i) {
+            const float* taps = truePeakInput.data() + i;
+            float peak = std::abs(taps[kTruePeakDelay - 1]);
+            for (int p = 0; p < kTruePeakPhases; ++p) {
+                float y = 0.0f;
+                for (int m = 0; m < kTruePeakTaps; ++m)
+                    y += taps[m] * truePeakCoefs[(size_t)p][(size_t)m];
+                peak = std::max(peak, std::abs(y));
+            }
+            out[i] = peak;
+        }
+
+        std::copy(truePeakInput.begin() + n, truePeakInput.begin() + n + history, ch.truePeakHistory.begin());
+    }
+
+    void computeCompressorGain(ChannelState& ch, const float* level, float* g, int n) {
+        const float threshold = settings.thresholdDb;
+        const float knee = std::max(settings.kneeDb, 1.0e-3f);
+        const float slope = 1.0f / std::max(settings.ratio, 1.0f) - 1.0f;
+
+        // Static curve in dB, soft knee centred on the threshold
+        for (int i = 0; i < n; ++i) {
+            const float over = fastGainToDecibels(level[i]) - threshold;
+            const float kneePos = over + 0.5f * knee;
+            g[i] = 2.0f * over <= -knee ? 0.0f
+                   : 2.0f * over >= knee ? slope * over
+                                         : slope * kneePos * kneePos / (2.0f * knee);
+        }
+
+        // Attack when the reduction deepens, release when it recovers
+        float env = ch.gainReductionDb;
+        for (int i = 0; i < n; ++i) {
+            const float target = g[i];
+            env = target + (target < env ? attackCoef : releaseCoef) * (env - target);
+            g[i] = env;
+        }
+        ch.gainReductionDb = env;
+
+        for (int i = 0; i < n; ++i)
+            g[i] = fastDecibelsToGain(g[i]);
+    }
+
+    void computeLimiterGain(ChannelState& ch, const float* level, float* g, int n) {
+        // The gain that brings each sample exactly to the ceiling
+        for (int i = 0; i < n; ++i)
+            g[i] = std::min(1.0f, ceilingGain / std::max(level[i], kFloor));
+
+        const double invBoxLength = 1.0 / boxLength;
+        for (int i = 0; i < n; ++i) {
+            const int64_t index = sampleCounter + i;
+
+            // Minimum over the last boxLength samples (monotonic queue)
+            while (ch.holdTail != ch.holdHead && ch.holdValues[(size_t)((ch.holdTail - 1) & holdMask)] >= g[i])
+                --ch.holdTail;
+            ch.holdValues[(size_t)(ch.holdTail & holdMask)] = g[i];
+            ch.holdIndices[(size_t)(ch.holdTail & holdMask)] = index;
+            ++ch.holdTail;
+            if (ch.holdIndices[(size_t)(ch.holdHead & holdMask)] <= index - boxLength)
+                ++ch.holdHead;
+            const float held = ch.holdValues[(size_t)(ch.holdHead & holdMask)];
+
+            // Instant attack, exponential release
+            ch.release = held < ch.release ? held : held + releaseCoef * (ch.release - held);
+
+            // Averaging over the window turns the attack into a ramp that ends as the peak leaves the delay
+            ch.boxSum += ch.release - ch.box[(size_t)ch.boxPos];
+            ch.box[(size_t)ch.boxPos] = ch.release;
+            if (++ch.boxPos == boxLength)
+                ch.boxPos = 0;
+            g[i] = (float)(ch.boxSum * invBoxLength);
+        }
+    }
+
+    void applyDelayed(ChannelState& ch, float* audio, const float* g, int n) {
+        const int delay = getLatencySamples();
+        float* line = ch.delayLine.data();
+        std::copy(audio, audio + n, line + delay);
+        juce::FloatVectorOperations::multiply(audio, line, g, n);
+        std::memmove(line, line + n, sizeof(float) * (size_t)delay);
+    }
+
+    Settings settings;
+    double sampleRate = 44100.0;
+    int maxLookaheadSamples = 0;
+    int lookaheadSamples = 0;
+    int boxLength = 1;
+    uint32_t holdMask = 0;
+    int64_t sampleCounter = 0;
+    float attackCoef = 0.0f, releaseCoef = 0.0f;
+    float ceilingGain = 1.0f;
+    std::array<std::array<float, kTruePeakTaps>, kTruePeakPhases> truePeakCoefs{};
+
+    std::array<ChannelState, kMaxChannels> channels;
+    std::array<std::array<float, kChunkSize>, kMaxChannels> detector{};
+    std::array<std::array<float, kChunkSize>, kMaxChannels> gain{};
+    std::array<float, kChunkSize> linked{};
+    std::array<float, kChunkSize + kTruePeakTaps - 1> truePeakInput{};
+
+    std::atomic<float> gainReductionDb{0.0f};
+};
@@ -1,70 +1,143 @@
 #pragma once
 
 #include "../ModuleBase.h"
-#include <juce_dsp/juce_dsp.h>
+#include "DynamicsProcessor.h"
 
-class LimiterModule : public ModuleBase {
+class LimiterModule
+    : public ModuleBase
+    , public juce::AudioProcessorParameter::Listener
+    , private juce::AsyncUpdater {
 public:
     LimiterModule()
-        : ModuleBase("Limiter", 2, 2) {
-        addParameter(thresholdParam =
-                         new juce::AudioParameterFloat("threshold", "Threshold (dB)", -20.0f, 0.0f, -1.0f));
+        : ModuleBase("Limiter", 5, 2) { // stereo audio, stereo sidechain, input gain CV in; stereo out
+        addParameter(thresholdParam = new juce::AudioParameterFloat("threshold", "Ceiling (dB)", -20.0f, 0.0f, -1.0f));
         addParameter(releaseParam = new juce::AudioParameterFloat("release", "Release (ms)", 1.0f, 500.0f, 100.0f));
         addParameter(inputGainParam =
                          new juce::AudioParameterFloat("inputGain", "Input Gain (dB)", -12.0f, 12.0f, 0.0f));
+        addParameter(lookaheadParam = new juce::AudioParameterFloat("lookahead", "Lookahead (ms)", 0.0f,
+                                                                    DynamicsProcessor::kMaxLookaheadMs, 1.5f));
+        addParameter(truePeakParam = new juce::AudioParameterBool("truePeak", "True Peak", true));
+        addParameter(stereoLinkParam = new juce::AudioParameterFloat("stereoLink", "Stereo Link", 0.0f, 1.0f, 1.0f));
+        addParameter(sidechainParam = new juce::AudioParameterBool("sidechain", "External Sidechain", false));
+
+        lookaheadParam->addListener(this);
+        truePeakParam->addListener(this);
+    }
+
+    ~LimiterModule() override {
+        cancelPendingUpdate();
+        if (lookaheadParam != nullptr)
+            lookaheadParam->removeListener(this);
+        if (truePeakParam != nullptr)
+            truePeakParam->removeListener(this);
     }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sampleRate;
-        spec.maximumBlockSize = (juce::uint32)samplesPerBlock;
-        spec.numChannels = 2;
-        limiter.prepare(spec);
-        limiter.reset();
+        juce::ignoreUnused(samplesPerBlock);
+        dynamics.prepare(sampleRate);
+        dynamics.setSettings(makeSettings());
+        setLatencySamples(dynamics.getLatencySamples());
 
         smoothedInputGain.reset(sampleRate, 0.005);
-        smoothedInputGain.setCurrentAndTargetValue(*inputGainParam);
+        smoothedInputGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain((float)*inputGainParam));
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "Limiter");
         if (isBypassed())
             return;
 
         juce::ignoreUnused(midiMessages);
 
         const int numSamples = buffer.getNumSamples();
-        if (numSamples == 0 || buffer.getNumChannels() < 2)
+        const int numChannels = buffer.getNumChannels();
+        if (numSamples == 0 || numChannels < 2)
             return;
 
-        smoothedInputGain.setTargetValue(*inputGainParam);
-        limiter.setThreshold(*thresholdParam);
-        limiter.setRelease(*releaseParam);
+        // Input gain CV adds +-12 dB and is control rate: the gain target moves once per control block
+        const float* cvInputGain = numChannels > 4 ? buffer.getReadPointer(4) : nullptr;
+        float* left = buffer.getWritePointer(0);
+        float* right = buffer.getWritePointer(1);
+        for (int start = 0; start < numSamples; start += kControlBlockSize) {
+            const int n = std::min(kControlBlockSize, numSamples - start);
+            const float cv = cvInputGain != nullptr ? cvInputGain[start] : 0.0f;
+            const float inputGainDb = juce::jlimit(-24.0f, 24.0f, (float)*inputGainParam + cv * 12.0f);
+            smoothedInputGain.setTargetValue(juce::Decibels::decibelsToGain(inputGainDb));
 
-        // Apply input gain per-sample (smoothed)
-        for (int i = 0; i < numSamples; ++i) {
-            float gain = juce::Decibels::decibelsToGain(smoothedInputGain.getNextValue());
-            buffer.getWritePointer(0)[i] *= gain;
-            buffer.getWritePointer(1)[i] *= gain;
+            // One multiply per channel unless the gain is moving
+            if (smoothedInputGain.isSmoothing()) {
+                for (int i = start; i < start + n; ++i) {
+                    const float gain = smoothedInputGain.getNextValue();
+                    left[i] *= gain;
+                    right[i] *= gain;
+                }
+            } else {
+                juce::FloatVectorOperations::multiply(left + start, smoothedInputGain.getTargetValue(), n);
+                juce::FloatVectorOperations::multiply(right + start, smoothedInputGain.getTargetValue(), n);
+            }
         }
 
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        limiter.process(context);
+        dynamics.setSettings(makeSettings());
+
+        const float* sidechain[] = {numChannels > 3 ? buffer.getReadPointer(2) : nullptr,
+                                    numChannels > 3 ? buffer.getReadPointer(3) : nullptr};
+        const bool useSidechain = sidechainParam->get() && numChannels > 3;
+        dynamics.process(buffer.getArrayOfWritePointers(), useSidechain ? sidechain : nullptr, 2, numSamples);
+
+        // Clear sidechain and CV channels to prevent leaking to downstream modules
+        for (int ch = 2; ch < numChannels; ++ch)
+            buffer.clear(ch, 0, numSamples);
     }
 
-    juce::String getInputPortLabel(int i) const override { return i == 0 ? "Left" : "Right"; }
+    /** Deepest gain reduction in the last block, in dB (0 or below). */
+    float getGainReductionDb() const { return dynamics.getGainReductionDb(); }
+
+    juce::String getInputPortLabel(int i) const override {
+        const juce::String labels[] = {"Left", "Right", "Sidechain L", "Sidechain R", "Input Gain"};
+        return (i >= 0 && i < 5) ? labels[i] : ModuleBase::getInputPortLabel(i);
+    }
     juce::String getOutputPortLabel(int i) const override { return i == 0 ? "Left" : "Right"; }
 
-    std::vector<ModulationTarget> getModulationTargets() const override { return {}; }
+    PortRate getInputPortRate(int i) const override { return i == 4 ? PortRate::Control : PortRate::Audio; }
+
+    std::vector<ModulationTarget> getModulationTargets() const override { return {{"Input Gain", 4}}; }
     ModulationCategory getModulationCategory() const override { return ModulationCategory::FX; }
     ModuleType getModuleType() const override { return ModuleType::Limiter; }
 
+    void parameterValueChanged(int, float) override {
+        // May come from any thread; the latency is reported from the message thread
+        triggerAsyncUpdate();
+    }
+    void parameterGestureChanged(int, bool) override {}
+
 private:
-    juce::dsp::Limiter<float> limiter;
+    void handleAsyncUpdate() override {
+        // Reporting a new latency notifies the processor's listeners, which rebuild the graph
+        const int latency = dynamics.getLatencySamples(makeSettings());
+        if (latency != getLatencySamples())
+            setLatencySamples(latency);
+    }
+
+    DynamicsProcessor::Settings makeSettings() const {
+        DynamicsProcessor::Settings settings;
+        settings.mode = DynamicsProcessor::Mode::Limiter;
+        settings.thresholdDb = *thresholdParam;
+        settings.releaseMs = *releaseParam;
+        settings.lookaheadMs = *lookaheadParam;
+        settings.truePeak = truePeakParam->get();
+        settings.stereoLink = *stereoLinkParam;
+        return settings;
+    }
+
+    DynamicsProcessor dynamics;
 
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedInputGain;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedInputGain;
 
     juce::AudioParameterFloat* thresholdParam;
     juce::AudioParameterFloat* releaseParam;
     juce::AudioParameterFloat* inputGainParam;
+    juce::AudioParameterFloat* lookaheadParam;
+    juce::AudioParameterBool* truePeakParam;
+    juce::AudioParameterFloat* stereoLinkParam;
+    juce::AudioParameterBool* sidechainParam;
 };
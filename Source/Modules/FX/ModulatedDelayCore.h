@@ -0,0 +1,248 @@
+#pragma once
+
+#include "../ModuleBase.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+/**
+ * @class ModulatedDelayCore
+ * @brief The LFO sweep and signal path shared by the Chorus, Flanger and Phaser modules.
+ *
+ * A sine LFO sweeps either a fractional delay line (Chorus, Flanger) or a chain of
+ * first-order allpass stages (Phaser). The sweep runs at control rate: once every
+ * ModuleBase::kControlBlockSize samples the core reads the Rate and Depth CV at
+ * that sample, advances the parameter smoothers and the LFO, and computes where
+ * the sweep should be at the end of the control block. The delay time (or the
+ * allpass coefficient) then ramps linearly towards that point sample by sample,
+ * so CV and parameter changes glide instead of stepping once per host block.
+ *
+ * The control grid carries over from one process() call to the next, so the
+ * output is the same whatever the host block size.
+ *
+ * The feedback polarity, the LFO swing and the linear dry/wet law match the
+ * juce::dsp::Chorus and juce::dsp::Phaser processors these modules used before.
+ */
+class ModulatedDelayCore {
+public:
+    enum class Mode { Delay, Allpass };
+
+    /** Fixed per module: the sweep's shape and range. */
+    struct Config {
+        Mode mode = Mode::Delay;
+        float minRateHz = 0.1f;
+        float maxRateHz = 10.0f;
+        float rateHzPerCV = 5.0f;       // Added to the rate per unit of Rate CV
+        float maxCentreDelayMs = 30.0f; // Delay only; sizes the delay line
+    };
+
+    /** Read from the module's parameters every block; the core smooths them. */
+    struct Settings {
+        float rateHz = 0.5f;
+        float depth = 0.5f;
+        float centre = 7.0f; // Delay: centre delay in ms. Allpass: centre frequency in Hz.
+        float feedback = 0.0f;
+        float mix = 0.5f;
+    };
+
+    static constexpr int kMaxChannels = 2;
+    static constexpr int kNumAllpassStages = 6;
+    static constexpr float kMaxModulationMs = 10.0f; // Delay swing either side of the centre at full depth
+    static constexpr float kMinDelayMs = 1.0f;
+    static constexpr float kMinSweepHz = 20.0f;
+
+    explicit ModulatedDelayCore(const Config& newConfig)
+        : config(newConfig) {}
+
+    void prepare(double newSampleRate) {
+        sampleRate = newSampleRate;
+
+        if (config.mode == Mode::Delay) {
+            const double maxDelayMs = (double)config.maxCentreDelayMs + kMaxModulationMs;
+            const int maxDelaySamples = (int)std::ceil(maxDelayMs * 0.001 * sampleRate);
+            int size = 1;
+            while (size < maxDelaySamples + 2)
+                size <<= 1;
+            for (auto& line : delayLines)
+                line.assign((size_t)size, 0.0f);
+            delayMask = size - 1;
+        }
+
+        maxSweepHz = (float)std::min(20000.0, 0.49 * sampleRate);
+
+        smoothedRate.reset(sampleRate, 0.05);
+        smoothedDepth.reset(sampleRate, 0.005);
+        smoothedCentre.reset(sampleRate, 0.05);
+        smoothedFeedback.reset(sampleRate, 0.05);
+        smoothedMix.reset(sampleRate, 0.05);
+        reset();
+    }
+
+    /** Clears the signal state and snaps the smoothers to the current settings. */
+    void reset() {
+        for (auto& line : delayLines)
+            std::fill(line.begin(), line.end(), 0.0f);
+        for (auto& channelStages : allpassStates)
+            channelStages.fill(0.0f);
+        feedbackStates.fill(0.0f);
+        writeIndex = 0;
+
+        for (auto* smoothed : {&smoothedRate, &smoothedDepth, &smoothedCentre, &smoothedFeedback, &smoothedMix})
+            smoothed->setCurrentAndTargetValue(smoothed->getTargetValue());
+
+        phase = 0.0f;
+        samplesUntilUpdate = 0;
+        primed = false;
+    }
+
+    void setSettings(const Settings& settings) {
+        smoothedRate.setTargetValue(settings.rateHz);
+        smoothedDepth.setTargetValue(settings.depth);
+        smoothedCentre.setTargetValue(settings.centre);
+        smoothedFeedback.setTargetValue(settings.feedback);
+        smoothedMix.setTargetValue(settings.mix);
+    }
+
+    /**
+     * Processes numChannels (at most kMaxChannels) of audio in place. cvRate and
+     * cvDepth, if given, are read at the start of each control block.
+     */
+    void process(float* const* audio, int numChannels, int numSamples, const float* cvRate, const float* cvDepth) {
+        numChannels = std::min(numChannels, kMaxChannels);
+
+        for (int start = 0; start < numSamples;) {
+            if (samplesUntilUpdate == 0) {
+                updateControl(cvRate != nullptr ? cvRate[start] : 0.0f, cvDepth != nullptr ? cvDepth[start] : 0.0f);
+                samplesUntilUpdate = ModuleBase::kControlBlockSize;
+            }
+
+            const int n = std::min(samplesUntilUpdate, numSamples - start);
+            const int offset = ModuleBase::kControlBlockSize - samplesUntilUpdate;
+            if (config.mode == Mode::Delay)
+                renderDelay(audio, numChannels, start, n, offset);
+            else
+                renderAllpass(audio, numChannels, start, n, offset);
+
+            start += n;
+            samplesUntilUpdate -= n;
+        }
+    }
+
+private:
+    void updateControl(float rateCV, float depthCV) {
+        constexpr int k = ModuleBase::kControlBlockSize;
+        const float rate =
+            juce::jlimit(config.minRateHz, config.maxRateHz, smoothedRate.skip(k) + rateCV * config.rateHzPerCV);
+        const float depth = juce::jlimit(0.0f, 1.0f, smoothedDepth.skip(k) + depthCV);
+        const float centre = smoothedCentre.skip(k);
+        feedback = smoothedFeedback.skip(k);
+        mix = smoothedMix.skip(k);
+
+        phase += rate * (float)k / (float)sampleRate;
+        phase -= std::floor(phase);
+        const float lfo = std::sin(juce::MathConstants<float>::twoPi * phase);
+
+        float target;
+        if (config.mode == Mode::Delay) {
+            const float delayMs = std::max(kMinDelayMs, centre + kMaxModulationMs * depth * lfo);
+            target = std::min(delayMs * 0.001f * (float)sampleRate, (float)(delayMask - 1));
+        } else {
+            // The centre and the swing are mapped on a log-frequency axis from kMinSweepHz to maxSweepHz
+            const float octaves = std::log2(maxSweepHz / kMinSweepHz);
+            const float normCentre = std::log2(juce::jlimit(kMinSweepHz, maxSweepHz, centre) / kMinSweepHz) / octaves;
+            const float norm = juce::jlimit(0.0f, 1.0f, normCentre + 0.5f * depth * lfo);
+            const float g = std::tan(juce::MathConstants<float>::pi * kMinSweepHz * std::exp2(norm * octaves) /
+                                     (float)sampleRate);
+            target = g / (1.0f + g);
+        }
+
+        sweepStart = primed ? sweepTarget : target;
+        sweepTarget = target;
+        sweepStep = (target - sweepStart) / (float)k;
+        primed = true;
+    }
+
+    // The sweep after the offset-th sample of the current control block
+    float sweepAt(int offset) const { return sweepStart + sweepStep * (float)(offset + 1); }
+
+    // Chorus/Flanger: the delay time in samples ramps across the segment
+    void renderDelay(float* const* audio, int numChannels, int start, int n, int offset) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* data = audio[ch] + start;
+            float* line = delayLines[(size_t)ch].data();
+            float& feedbackState = feedbackStates[(size_t)ch];
+            int write = writeIndex;
+
+            for (int i = 0; i < n; ++i) {
+                const float delay = sweepAt(offset + i);
+                const float input = data[i];
+                line[write] = input - feedbackState;
+
+                const float readPos = (float)(write + delayMask + 1) - delay;
+                const int index = (int)readPos;
+                const float frac = readPos - (float)index;
+                const float a = line[index & delayMask];
+                const float b = line[(index + 1) & delayMask];
+                const float wet = a + frac * (b - a);
+
+                feedbackState = wet * feedback;
+                data[i] = input + mix * (wet - input);
+                write = (write + 1) & delayMask;
+            }
+        }
+        writeIndex = (writeIndex + n) & delayMask;
+    }
+
+    // Phaser: the allpass coefficient G ramps across the segment; the stages are TPT one-poles
+    void renderAllpass(float* const* audio, int numChannels, int start, int n, int offset) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* data = audio[ch] + start;
+            auto& states = allpassStates[(size_t)ch];
+            float& feedbackState = feedbackStates[(size_t)ch];
+
+            for (int i = 0; i < n; ++i) {
+                const float G = sweepAt(offset + i);
+                const float input = data[i];
+                float y = input - feedbackState;
+                for (auto& s : states) {
+                    const float v = (y - s) * G;
+                    const float lowpass = v + s;
+                    s = lowpass + v;
+                    y = 2.0f * lowpass - y;
+                }
+
+                feedbackState = y * feedback;
+                data[i] = input + mix * (y - input);
+            }
+        }
+    }
+
+    Config config;
+    double sampleRate = 44100.0;
+    float maxSweepHz = 20000.0f;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedRate;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedDepth;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedCentre;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedFeedback;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedMix;
+
+    // Control-rate state
+    float phase = 0.0f;
+    int samplesUntilUpdate = 0;
+    bool primed = false;
+    float sweepStart = 0.0f; // Delay in samples, or the allpass G, at the start of the control block
+    float sweepTarget = 0.0f;
+    float sweepStep = 0.0f;
+    float feedback = 0.0f;
+    float mix = 0.5f;
+
+    // Signal state
+    std::array<std::vector<float>, kMaxChannels> delayLines;
+    int delayMask = 0;
+    int writeIndex = 0;
+    std::array<std::array<float, kNumAllpassStages>, kMaxChannels> allpassStates{};
+    std::array<float, kMaxChannels> feedbackStates{};
+};
@@ -20,6 +20,7 @@ public:
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "Reverb");
         if (isBypassed() || buffer.getNumSamples() == 0 || buffer.getNumChannels() == 0)
             return;
 
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "ModuleBase.h"
+#include "VoicePool.h"
 #include <atomic>
 #include <juce_dsp/juce_dsp.h>
 
 class FilterModule : public ModuleBase {
 public:
     FilterModule()
-        : ModuleBase("Filter", 11, 8) { // 0-7: per-voice audio, 8-10: shared CV, outputs 0-7: filtered audio
+        : ModuleBase("Filter", kMaxPolyVoices + 3, kMaxPolyVoices) { // per-voice audio, then 3 shared CV; per-voice out
         addParameter(cutoffParam = new juce::AudioParameterFloat("cutoff", "Cutoff", 20.0f, 20000.0f, 440.0f));
         addParameter(resonanceParam = new juce::AudioParameterFloat("resonance", "Resonance", 0.0f, 1.0f, 0.1f));
         addParameter(driveParam = new juce::AudioParameterFloat("drive", "Drive", 1.0f, 10.0f, 1.0f));
@@ -20,9 +21,10 @@ public:
     }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        prepareOversampling(sampleRate, samplesPerBlock);
         lastSampleRate = sampleRate;
         juce::dsp::ProcessSpec monoSpec = {sampleRate, static_cast<juce::uint32>(samplesPerBlock), 1};
-        for (int v = 0; v < MAX_VOICES; ++v) {
+        for (int v = 0; v < kMaxPolyVoices; ++v) {
             ladders[v].prepare(monoSpec);
             ladders[v].setEnabled(true);
             svfsForNotch[v].prepare(monoSpec);
@@ -32,7 +34,40 @@ public:
         smoothedCutoff.setCurrentAndTargetValue(*cutoffParam);
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& /*midiMessages*/) override {
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        getOversamplingLink().process(buffer, midiMessages, [this](auto& b, auto& m) { render(b, m); });
+    }
+
+    std::vector<ModulationTarget> getModulationTargets() const override {
+        if (polyParam->get())
+            return {{"Cutoff", kMaxPolyVoices}, {"Resonance", kMaxPolyVoices + 1}, {"Drive", kMaxPolyVoices + 2}};
+        return {{"Cutoff", 1}, {"Resonance", 2}, {"Drive", 3}};
+    }
+    juce::String getInputPortLabel(int i) const override {
+        const juce::String labels[] = {"Audio", "Cutoff", "Resonance", "Drive"};
+        return (i >= 0 && i < 4) ? labels[i] : ModuleBase::getInputPortLabel(i);
+    }
+    juce::String getOutputPortLabel(int) const override { return "Audio"; }
+    PortRate getInputPortRate(int i) const override {
+        int firstCV = polyParam->get() ? kMaxPolyVoices : 1;
+        return i >= firstCV ? PortRate::Control : PortRate::Audio;
+    }
+    int getVisibleInputPortCount() const override { return 4; }
+    int getVisibleOutputPortCount() const override { return 1; }
+    ModulationCategory getModulationCategory() const override { return ModulationCategory::Filter; }
+    ModuleType getModuleType() const override { return ModuleType::Filter; }
+    bool supportsOversampling() const override { return true; }
+
+    float getCurrentCutoff() const { return modulatedCutoff.load(std::memory_order_relaxed); }
+    float getCurrentResonance() const { return *resonanceParam; }
+    float getModulatedResonance() const { return modulatedResonance.load(std::memory_order_relaxed); }
+    float getCurrentDrive() const { return *driveParam; }
+    int getCurrentFilterType() const { return filterTypeParam->getIndex(); }
+    double getLastSampleRate() const { return lastSampleRate; }
+
+private:
+    void render(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& /*midiMessages*/) {
+        GSYNTH_TRACE_SCOPE("audio", "Filter");
         if (isBypassed())
             return;
 
@@ -63,36 +98,11 @@ public:
         }
 
         // Clear CV channels to prevent leaking to downstream modules
-        int cvStartChannel = polyParam->get() ? 8 : 1;
+        int cvStartChannel = polyParam->get() ? kMaxPolyVoices : 1;
         for (int ch = cvStartChannel; ch < buffer.getNumChannels(); ++ch)
             buffer.clear(ch, 0, numSamples);
     }
 
-    std::vector<ModulationTarget> getModulationTargets() const override {
-        if (polyParam->get())
-            return {{"Cutoff", 8}, {"Resonance", 9}, {"Drive", 10}};
-        return {{"Cutoff", 1}, {"Resonance", 2}, {"Drive", 3}};
-    }
-    juce::String getInputPortLabel(int i) const override {
-        const juce::String labels[] = {"Audio", "Cutoff", "Resonance", "Drive"};
-        return (i >= 0 && i < 4) ? labels[i] : ModuleBase::getInputPortLabel(i);
-    }
-    juce::String getOutputPortLabel(int) const override { return "Audio"; }
-    int getVisibleInputPortCount() const override { return 4; }
-    int getVisibleOutputPortCount() const override { return 1; }
-    ModulationCategory getModulationCategory() const override { return ModulationCategory::Filter; }
-    ModuleType getModuleType() const override { return ModuleType::Filter; }
-
-    float getCurrentCutoff() const { return modulatedCutoff.load(std::memory_order_relaxed); }
-    float getCurrentResonance() const { return *resonanceParam; }
-    float getModulatedResonance() const { return modulatedResonance.load(std::memory_order_relaxed); }
-    float getCurrentDrive() const { return *driveParam; }
-    int getCurrentFilterType() const { return filterTypeParam->getIndex(); }
-    double getLastSampleRate() const { return lastSampleRate; }
-
-private:
-    static constexpr int MAX_VOICES = 8;
-
     void processMonoMode(juce::AudioBuffer<float>& buffer, int numSamples, int numChannels, float baseRes,
                          float baseDrive) {
         const float* cvCutoffCh = (numChannels > 1) ? buffer.getReadPointer(1) : nullptr;
@@ -118,9 +128,13 @@ private:
             resCVActive = (rms / numSamples) > 1e-6f;
         }
 
-        for (int i = 0; i < numSamples; ++i) {
+        // The CV inputs are control rate: coefficients are updated once per control block
+        for (int start = 0; start < numSamples; start += kControlBlockSize) {
+            const int n = std::min(kControlBlockSize, numSamples - start);
             float baseCutoff = smoothedCutoff.getNextValue();
-            float totalCutoffMod = cvCutoffCh ? cvCutoffCh[i] : 0.0f;
+            smoothedCutoff.skip(n - 1);
+
+            float totalCutoffMod = cvCutoffCh ? cvCutoffCh[start] : 0.0f;
             totalCutoffMod = juce::jlimit(-1.0f, 1.0f, totalCutoffMod);
 
             float f = baseCutoff;
@@ -133,14 +147,14 @@ private:
                 modulatedCutoff.store(f, std::memory_order_relaxed);
             ladders[0].setCutoffFrequencyHz(f);
 
-            float totalResMod = cvResCh ? cvResCh[i] : 0.0f;
+            float totalResMod = cvResCh ? cvResCh[start] : 0.0f;
             totalResMod = juce::jlimit(-1.0f, 1.0f, totalResMod);
             float res = juce::jlimit(0.0f, 1.0f, baseRes + totalResMod);
             if (resCVActive)
                 modulatedResonance.store(res, std::memory_order_relaxed);
             ladders[0].setResonance(res);
 
-            float totalDriveMod = cvDriveCh ? cvDriveCh[i] : 0.0f;
+            float totalDriveMod = cvDriveCh ? cvDriveCh[start] : 0.0f;
             totalDriveMod = juce::jlimit(-1.0f, 1.0f, totalDriveMod);
             float drive = juce::jlimit(1.0f, 10.0f, baseDrive + (totalDriveMod * 9.0f));
             ladders[0].setDrive(drive);
@@ -149,12 +163,14 @@ private:
                 svfsForNotch[0].setCutoffFrequency(f);
                 svfsForNotch[0].setResonance(0.707f + res * 15.0f);
                 svfsForNotch[0].setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-                float input = audioData[i];
-                float filtered = svfsForNotch[0].processSample(0, input);
-                audioData[i] = input - filtered;
+                for (int i = start; i < start + n; ++i) {
+                    float input = audioData[i];
+                    float filtered = svfsForNotch[0].processSample(0, input);
+                    audioData[i] = input - filtered;
+                }
             } else {
-                auto sampleBlock = singleChannelBlock.getSubBlock(i, 1);
-                juce::dsp::ProcessContextReplacing<float> context(sampleBlock);
+                auto controlBlock = singleChannelBlock.getSubBlock((size_t)start, (size_t)n);
+                juce::dsp::ProcessContextReplacing<float> context(controlBlock);
                 ladders[0].process(context);
             }
         }
@@ -162,19 +178,19 @@ private:
 
     void processPolyMode(juce::AudioBuffer<float>& buffer, int numSamples, int numChannels, float baseRes,
                          float baseDrive) {
-        // Read shared CV from channels 8-10 into pre-allocated cache
+        // Read shared CV (the 3 channels after the voices) into pre-allocated cache
         int ns = std::min(numSamples, 4096);
         std::fill_n(cutoffCVCache.data(), ns, 0.0f);
         std::fill_n(resCVCache.data(), ns, 0.0f);
         std::fill_n(driveCVCache.data(), ns, 0.0f);
-        if (numChannels > 8)
-            std::copy_n(buffer.getReadPointer(8), ns, cutoffCVCache.data());
-        if (numChannels > 9)
-            std::copy_n(buffer.getReadPointer(9), ns, resCVCache.data());
-        if (numChannels > 10)
-            std::copy_n(buffer.getReadPointer(10), ns, driveCVCache.data());
+        if (numChannels > kMaxPolyVoices)
+            std::copy_n(buffer.getReadPointer(kMaxPolyVoices), ns, cutoffCVCache.data());
+        if (numChannels > kMaxPolyVoices + 1)
+            std::copy_n(buffer.getReadPointer(kMaxPolyVoices + 1), ns, resCVCache.data());
+        if (numChannels > kMaxPolyVoices + 2)
+            std::copy_n(buffer.getReadPointer(kMaxPolyVoices + 2), ns, driveCVCache.data());
 
-        int voiceCount = std::min(MAX_VOICES, numChannels);
+        int voiceCount = std::min(kMaxPolyVoices, numChannels);
 
         // Compute shared CV modulation once (use mid-block sample)
         int midSample = ns / 2;
@@ -197,8 +213,20 @@ private:
         modulatedDrive.store(drive, std::memory_order_relaxed);
 
         // Process only active voices (skip silent channels to save CPU)
+        const VoiceMask sounding = getVoiceActivityLink().getSoundingVoices();
         juce::dsp::AudioBlock<float> fullBlock(buffer);
         for (int v = 0; v < voiceCount; ++v) {
+            const VoiceMask bit = VoiceMask{1} << v;
+            if ((sounding & bit) == 0) {
+                // A finished voice starts its next note from a clean filter
+                if ((lastSoundingVoices & bit) != 0) {
+                    ladders[v].reset();
+                    svfsForNotch[v].reset();
+                }
+                buffer.clear(v, 0, numSamples);
+                continue;
+            }
+
             // Skip silent voices
             if (buffer.getRMSLevel(v, 0, numSamples) < 1e-6f)
                 continue;
@@ -223,6 +251,7 @@ private:
                 ladders[v].process(context);
             }
         }
+        lastSoundingVoices = sounding;
     }
 
     void applyFilterType(int typeIndex) {
@@ -232,7 +261,7 @@ private:
                 juce::dsp::LadderFilterMode::LPF24, juce::dsp::LadderFilterMode::LPF12,
                 juce::dsp::LadderFilterMode::HPF24, juce::dsp::LadderFilterMode::HPF12,
                 juce::dsp::LadderFilterMode::BPF24, juce::dsp::LadderFilterMode::BPF12};
-            for (int v = 0; v < MAX_VOICES; ++v)
+            for (int v = 0; v < kMaxPolyVoices; ++v)
                 ladders[v].setMode(modes[typeIndex]);
         } else if (typeIndex == 6) {
             isNotchMode = true;
@@ -244,9 +273,10 @@ private:
     std::array<float, 4096> resCVCache{};
     std::array<float, 4096> driveCVCache{};
 
-    juce::dsp::LadderFilter<float> ladders[MAX_VOICES];
-    juce::dsp::StateVariableTPTFilter<float> svfsForNotch[MAX_VOICES];
+    juce::dsp::LadderFilter<float> ladders[kMaxPolyVoices];
+    juce::dsp::StateVariableTPTFilter<float> svfsForNotch[kMaxPolyVoices];
     bool isNotchMode = false;
+    VoiceMask lastSoundingVoices = VoiceActivity::kAllVoices;
     double lastSampleRate = 44100.0;
     juce::SmoothedValue<float> smoothedCutoff;
     juce::AudioParameterFloat* cutoffParam = nullptr;
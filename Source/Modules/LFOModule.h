@@ -1,13 +1,24 @@
 #pragma once
 
 #include "ModuleBase.h"
+#include "VoicePool.h"
 #include <juce_core/juce_core.h>
 #include <random>
 
+/**
+ * @class LFOModule
+ * @brief A bank of phase-locked LFOs sharing one rate and shape.
+ *
+ * In mono mode only output 0 runs. In poly mode every voice output runs, voice v
+ * offset in phase by spread * v / kMaxPolyVoices, for per-voice vibrato and wobble
+ * from one node. The bank is rendered at control rate: all voices are evaluated
+ * together once per control block in a shape-specialised loop (with a polynomial
+ * sine), then each output ramps linearly to its next value.
+ */
 class LFOModule : public ModuleBase {
 public:
     LFOModule()
-        : ModuleBase("LFO", 0, 1) { // 0 Audio Inputs, 1 Control Output
+        : ModuleBase("LFO", 0, kMaxPolyVoices) { // 0 Audio Inputs, one Control Output per voice
         // Enable visual buffer for scope display
         enableVisualBuffer(true);
 
@@ -37,23 +48,27 @@ public:
 
         // Glide (S&H only)
         addParameter(glideParam = new juce::AudioParameterFloat("glide", "Glide", 0.0f, 1.0f, 0.0f));
+
+        // Poly: one output per voice, phases fanned out by Spread (0 = in unison, 1 = evenly around the cycle)
+        addParameter(polyParam = new juce::AudioParameterBool("poly", "Poly", false));
+        addParameter(spreadParam = new juce::AudioParameterFloat("spread", "Spread", 0.0f, 1.0f, 0.0f));
     }
 
     void prepareToPlay(double sampleRate, int /*samplesPerBlock*/) override {
         currentSampleRate = sampleRate;
-        shSmoother.reset(sampleRate, 0.05); // 50ms default ramp for smooth glide
+        for (auto& smoother : shSmoothers)
+            smoother.reset(sampleRate, 0.05); // 50ms default ramp for smooth glide
     }
 
     void releaseResources() override {}
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "LFO");
         if (isBypassed() || buffer.getNumSamples() == 0 || buffer.getNumChannels() == 0) {
             buffer.clear();
             return;
         }
 
-        auto* channelData0 = buffer.getWritePointer(0);
-
         // Process MIDI for Retrig
         if (retrigParam->get()) {
             for (const auto metadata : midiMessages) {
@@ -120,68 +135,47 @@ public:
             rate = 1.0f / ((60.0 / bpm) * subdivision);
         }
 
-        float phaseIncrement = rate / (float)currentSampleRate;
-        float level = levelParam->get();
-        int shape = shapeParam->getIndex();
-
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-            float currentSample = 0.0f;
-
-            switch (shape) {
-            case 0: // Sine
-                currentSample = std::sin(phase * juce::MathConstants<float>::twoPi);
-                break;
-            case 1: // Triangle
-                currentSample = 2.0f * std::abs(2.0f * (phase - std::floor(phase + 0.5f))) - 1.0f;
-                break;
-            case 2: // Sawtooth
-                currentSample = 2.0f * (phase - 0.5f);
-                break;
-            case 3: // Square
-                currentSample = (phase < 0.5f) ? 1.0f : -1.0f;
-                break;
-            case 4: // S&H
-                // The value is managed by shSmoother
-                currentSample = shSmoother.getNextValue();
-                break;
-            }
-
-            // Advance phase
-            phase += phaseIncrement;
-
-            // Wrap and handle S&H trigger
-            if (phase >= 1.0f) {
-                phase -= 1.0f;
-                if (shape == 4) {
-                    // Trigger new random value
-                    lastRandomSample = (random.nextFloat() * 2.0f) - 1.0f;
-
-                    float glideValue = glideParam->get();
-                    if (glideValue <= 0.0f) {
-                        shSmoother.setCurrentAndTargetValue(lastRandomSample);
-                    } else {
-                        // Map 0..1 to 0..0.5s glide time? Or just let it be linear.
-                        // Adjust smoother time based on glide param
-                        shSmoother.reset(currentSampleRate, juce::jmax(0.001f, glideValue * 0.5f));
-                        shSmoother.setTargetValue(lastRandomSample);
-                    }
-                }
-            }
-
-            // If we just switched to S&H or something, ensure initialized?
-            // lastRandomSample init to 0.
-
-            if (!bipolarParam->get()) {
-                // Unipolar conversion: map [-1, 1] to [0, 1]
-                currentSample = (currentSample + 1.0f) * 0.5f;
-            }
+        const float phaseIncrement = rate / (float)currentSampleRate;
+        const int numSamples = buffer.getNumSamples();
+        const int numVoices = polyParam->get() ? std::min(kMaxPolyVoices, buffer.getNumChannels()) : 1;
+
+        // Output = waveform * gain + offset; unipolar maps [-1, 1] to [0, level]
+        const float level = levelParam->get();
+        const bool bipolar = bipolarParam->get();
+        const float gain = bipolar ? level : 0.5f * level;
+        const float offset = bipolar ? 0.0f : 0.5f * level;
+
+        const float spread = spreadParam->get();
+        for (int v = 0; v < numVoices; ++v)
+            phaseOffsets[v] = spread * (float)v / (float)kMaxPolyVoices;
+
+        // The shape is dispatched once per block, not per sample
+        switch (shapeParam->getIndex()) {
+        case kSine:
+            render<kSine>(buffer, numSamples, numVoices, phaseIncrement, gain, offset);
+            break;
+        case kTriangle:
+            render<kTriangle>(buffer, numSamples, numVoices, phaseIncrement, gain, offset);
+            break;
+        case kSawtooth:
+            render<kSawtooth>(buffer, numSamples, numVoices, phaseIncrement, gain, offset);
+            break;
+        case kSquare:
+            render<kSquare>(buffer, numSamples, numVoices, phaseIncrement, gain, offset);
+            break;
+        default:
+            render<kSampleAndHold>(buffer, numSamples, numVoices, phaseIncrement, gain, offset);
+            break;
+        }
 
-            float outputSample = currentSample * level;
-            channelData0[sample] = outputSample;
+        for (int ch = numVoices; ch < buffer.getNumChannels(); ++ch)
+            buffer.clear(ch, 0, numSamples);
 
-            // Push to visual buffer for scope display
-            if (auto* vb = getVisualBuffer())
-                vb->pushSample(outputSample);
+        // Push voice 0 to the visual buffer for scope display
+        if (auto* vb = getVisualBuffer()) {
+            const float* voice0 = buffer.getReadPointer(0);
+            for (int sample = 0; sample < numSamples; ++sample)
+                vb->pushSample(voice0[sample]);
         }
     }
 
@@ -190,9 +184,97 @@ public:
 
     ModulationCategory getModulationCategory() const override { return ModulationCategory::LFO; }
     juce::String getOutputPortLabel(int) const override { return "CV"; }
+    int getVisibleOutputPortCount() const override { return 1; }
+    PortRate getOutputPortRate(int) const override { return PortRate::Control; }
     ModuleType getModuleType() const override { return ModuleType::LFO; }
 
+    /** sin(2 * pi * phase) for phase in [0, 1): folded into [-pi/2, pi/2], then odd terms to x^9 (error < 4e-6). */
+    static float fastSin2Pi(float phase) {
+        float x = phase < 0.5f ? phase : phase - 1.0f;
+        x = x > 0.25f ? 0.5f - x : (x < -0.25f ? -0.5f - x : x);
+        const float y = x * juce::MathConstants<float>::twoPi;
+        const float y2 = y * y;
+        return y * (1.0f + y2 * (-1.0f / 6.0f + y2 * (1.0f / 120.0f + y2 * (-1.0f / 5040.0f + y2 / 362880.0f))));
+    }
+
 private:
+    enum Waveform { kSine, kTriangle, kSawtooth, kSquare, kSampleAndHold }; // In shape choice order
+
+    static float wrapPhase(float p) { return p >= 1.0f ? p - 1.0f : p; }
+
+    template <int waveform>
+    void render(juce::AudioBuffer<float>& buffer, int numSamples, int numVoices, float phaseIncrement, float gain,
+                float offset) {
+        float rampStart[kMaxPolyVoices];
+        float rampEnd[kMaxPolyVoices];
+        evaluate<waveform>(rampStart, numVoices, gain, offset);
+
+        for (int start = 0; start < numSamples; start += kControlBlockSize) {
+            const int n = std::min(kControlBlockSize, numSamples - start);
+            advance<waveform>(phaseIncrement * (float)n, n, numVoices);
+            evaluate<waveform>(rampEnd, numVoices, gain, offset);
+
+            for (int v = 0; v < numVoices; ++v) {
+                float* out = buffer.getWritePointer(v, start);
+                const float step = (rampEnd[v] - rampStart[v]) / (float)n;
+                for (int i = 0; i < n; ++i)
+                    out[i] = rampStart[v] + step * (float)i;
+                rampStart[v] = rampEnd[v];
+            }
+        }
+    }
+
+    // All voices at the current phase; no per-voice branching on shape, so the loop vectorises
+    template <int waveform>
+    void evaluate(float* values, int numVoices, float gain, float offset) const {
+        for (int v = 0; v < numVoices; ++v) {
+            const float p = wrapPhase(phase + phaseOffsets[v]);
+            float value;
+            if constexpr (waveform == kSine)
+                value = fastSin2Pi(p);
+            else if constexpr (waveform == kTriangle)
+                value = 4.0f * std::abs(p < 0.5f ? p : p - 1.0f) - 1.0f;
+            else if constexpr (waveform == kSawtooth)
+                value = 2.0f * (p - 0.5f);
+            else if constexpr (waveform == kSquare)
+                value = p < 0.5f ? 1.0f : -1.0f;
+            else
+                value = shSmoothers[v].getCurrentValue();
+            values[v] = value * gain + offset;
+        }
+    }
+
+    template <int waveform>
+    void advance(float phaseDelta, int numSamples, int numVoices) {
+        const float previous = phase;
+        phase += phaseDelta;
+        if (phase >= 1.0f)
+            phase -= std::floor(phase);
+
+        if constexpr (waveform == kSampleAndHold) {
+            for (int v = 0; v < numVoices; ++v) {
+                shSmoothers[v].skip(numSamples);
+                // Each voice samples a new value when its own phase wraps
+                if (wrapPhase(phase + phaseOffsets[v]) < wrapPhase(previous + phaseOffsets[v]))
+                    sampleNewValue(v);
+            }
+        }
+    }
+
+    void sampleNewValue(int voice) {
+        const float target = (random.nextFloat() * 2.0f) - 1.0f;
+        auto& smoother = shSmoothers[voice];
+
+        float glideValue = glideParam->get();
+        if (glideValue <= 0.0f) {
+            smoother.setCurrentAndTargetValue(target);
+        } else {
+            // Glide maps 0..1 to a 0..0.5s linear ramp
+            smoother.reset(currentSampleRate, juce::jmax(0.001f, glideValue * 0.5f));
+            smoother.setTargetValue(target);
+        }
+    }
+
     juce::AudioParameterChoice* shapeParam;
     juce::AudioParameterBool* modeParam; // Sync (true)
     juce::AudioParameterFloat* rateHzParam;
@@ -201,11 +283,13 @@ private:
     juce::AudioParameterBool* retrigParam;
     juce::AudioParameterFloat* levelParam;
     juce::AudioParameterFloat* glideParam;
+    juce::AudioParameterBool* polyParam;
+    juce::AudioParameterFloat* spreadParam;
 
-    float phase = 0.0f;
+    float phase = 0.0f; // Voice 0; voice v runs at phase + phaseOffsets[v]
+    float phaseOffsets[kMaxPolyVoices] = {};
     double currentSampleRate = 44100.0;
 
-    float lastRandomSample = 0.0f;
     juce::Random random;
-    juce::LinearSmoothedValue<float> shSmoother;
+    juce::LinearSmoothedValue<float> shSmoothers[kMaxPolyVoices];
 };
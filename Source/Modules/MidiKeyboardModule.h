@@ -26,6 +26,7 @@ public:
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "MIDI Keyboard");
         if (isBypassed()) {
             buffer.clear();
             return;
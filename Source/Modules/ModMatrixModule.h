@@ -0,0 +1,140 @@
+#pragma once
+
+#include "ModuleBase.h"
+#include <array>
+
+/**
+ * Owns a list of up to kNumSlots modulation routes and applies them all in one
+ * pass per block. Each route has a slot: the slot's input carries the route's
+ * source, and its output is connected straight to the destination's CV input,
+ * scaled by the slot's Amount (-1..1) unless the slot is bypassed.
+ *
+ * The module keeps which slots are in use and each slot's Amount and Bypass. A
+ * route's ends are the graph connections on its slot, so they disappear with the
+ * modules they touch; see ModMatrixRoutes.h for adding, finding and rerouting routes.
+ */
+class ModMatrixModule : public ModuleBase {
+public:
+    static constexpr int kNumSlots = 32;
+
+    ModMatrixModule()
+        : ModuleBase("Mod Matrix", kNumSlots, kNumSlots) {
+        for (int slot = 0; slot < kNumSlots; ++slot) {
+            auto& route = routes[(size_t)slot];
+            auto number = juce::String(slot + 1);
+            addParameter(route.amount =
+                             new juce::AudioParameterFloat("amount" + number, "Amount " + number, -1.0f, 1.0f, 0.0f));
+            addParameter(route.bypass = new juce::AudioParameterBool("bypass" + number, "Bypass " + number, false));
+        }
+    }
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        juce::ignoreUnused(samplesPerBlock);
+        for (auto& route : routes) {
+            route.smoothedAmount.reset(sampleRate, 0.01);
+            route.smoothedAmount.setCurrentAndTargetValue(*route.amount);
+        }
+    }
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "ModMatrix");
+        juce::ignoreUnused(midiMessages);
+
+        const int numSamples = buffer.getNumSamples();
+        const int numSlots = std::min(buffer.getNumChannels(), kNumSlots);
+        if (numSamples == 0)
+            return;
+
+        const bool matrixBypassed = isBypassed();
+        for (int slot = 0; slot < numSlots; ++slot) {
+            auto& route = routes[(size_t)slot];
+            const bool used = route.used.load(std::memory_order_acquire);
+            if (used && !route.wasUsed)
+                route.smoothedAmount.setCurrentAndTargetValue(*route.amount); // A new route starts at its amount
+            route.wasUsed = used;
+
+            if (!used || matrixBypassed || route.bypass->get()) {
+                buffer.clear(slot, 0, numSamples);
+                route.lastOutputPeak.store(0.0f, std::memory_order_relaxed);
+                route.lastModValue.store(0.0f, std::memory_order_relaxed);
+                continue;
+            }
+
+            // One vector op per route in the common case; per-sample work only while its knob glides
+            auto* signal = buffer.getWritePointer(slot);
+            route.smoothedAmount.setTargetValue(*route.amount);
+            if (route.smoothedAmount.isSmoothing()) {
+                for (int sample = 0; sample < numSamples; ++sample)
+                    signal[sample] *= route.smoothedAmount.getNextValue();
+            } else if (route.smoothedAmount.getTargetValue() == 0.0f) {
+                buffer.clear(slot, 0, numSamples);
+            } else {
+                juce::FloatVectorOperations::multiply(signal, route.smoothedAmount.getTargetValue(), numSamples);
+            }
+
+            // Track output for UI visualization
+            auto range = juce::FloatVectorOperations::findMinAndMax(signal, numSamples);
+            route.lastOutputPeak.store(std::max(-range.getStart(), range.getEnd()), std::memory_order_relaxed);
+            route.lastModValue.store(signal[numSamples / 2], std::memory_order_relaxed);
+        }
+
+        for (int ch = numSlots; ch < buffer.getNumChannels(); ++ch)
+            buffer.clear(ch, 0, numSamples);
+    }
+
+    juce::String getInputPortLabel(int i) const override { return "Source " + juce::String(i + 1); }
+    juce::String getOutputPortLabel(int i) const override { return "Route " + juce::String(i + 1); }
+    ModuleType getModuleType() const override { return ModuleType::ModMatrix; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+
+    /** Claims the first free slot with the given amount and bypass, or returns -1 if all are in use. */
+    int allocateSlot(float amount, bool bypassed) {
+        for (int slot = 0; slot < kNumSlots; ++slot) {
+            auto& route = routes[(size_t)slot];
+            if (route.used.load(std::memory_order_relaxed))
+                continue;
+            route.amount->setValueNotifyingHost(route.amount->convertTo0to1(amount));
+            route.bypass->setValueNotifyingHost(bypassed ? 1.0f : 0.0f);
+            route.used.store(true, std::memory_order_release);
+            return slot;
+        }
+        return -1;
+    }
+
+    void releaseSlot(int slot) {
+        if (juce::isPositiveAndBelow(slot, kNumSlots))
+            routes[(size_t)slot].used.store(false, std::memory_order_release);
+    }
+
+    bool isSlotUsed(int slot) const {
+        return juce::isPositiveAndBelow(slot, kNumSlots) && routes[(size_t)slot].used.load(std::memory_order_relaxed);
+    }
+
+    bool hasFreeSlot() const {
+        return std::any_of(routes.begin(), routes.end(),
+                           [](const Route& route) { return !route.used.load(std::memory_order_relaxed); });
+    }
+
+    juce::AudioParameterFloat& getAmountParameter(int slot) { return *routes[(size_t)slot].amount; }
+    juce::AudioParameterBool& getBypassParameter(int slot) { return *routes[(size_t)slot].bypass; }
+    bool isSlotBypassed(int slot) const { return routes[(size_t)slot].bypass->get(); }
+
+    float getLastOutputPeak(int slot) const {
+        return routes[(size_t)slot].lastOutputPeak.load(std::memory_order_relaxed);
+    }
+    float getLastModValue(int slot) const { return routes[(size_t)slot].lastModValue.load(std::memory_order_relaxed); }
+
+private:
+    struct Route {
+        juce::AudioParameterFloat* amount = nullptr;
+        juce::AudioParameterBool* bypass = nullptr;
+        std::atomic<bool> used{false}; // Written on the message thread
+        bool wasUsed = false;          // Audio thread only
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedAmount;
+        std::atomic<float> lastOutputPeak{0.0f};
+        std::atomic<float> lastModValue{0.0f};
+    };
+
+    std::array<Route, kNumSlots> routes;
+};
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "../TraceRecorder.h"
+#include "OversamplingRegion.h"
 #include "VisualBuffer.h"
+#include "VoiceActivity.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_core/juce_core.h>
@@ -13,6 +19,15 @@ struct ModulationTarget {
 
 enum class ModulationCategory { Envelope, LFO, Oscillator, Sequencer, Filter, FX, Other };
 
+/**
+ * Audio-rate ports carry a signal that can change on every sample. Control-rate
+ * ports carry modulation that only needs a new value every kControlBlockSize
+ * samples: a control output is computed once per control block and ramped
+ * linearly in between, so it can feed any input without zipper noise, and a
+ * control input may be read once per control block.
+ */
+enum class PortRate { Audio, Control };
+
 enum class ModuleType {
     Oscillator,
     Filter,
@@ -23,7 +38,7 @@ enum class ModuleType {
     PolySequencer,
     MidiKeyboard,
     PolyMidi,
-    Attenuverter,
+    ModMatrix,
     Delay,
     Distortion,
     Reverb,
@@ -32,9 +47,11 @@ enum class ModuleType {
     Compressor,
     Flanger,
     Limiter,
-    VoiceMixer
+    VoiceMixer // Keep last: kNumModuleTypes counts up to here
 };
 
+constexpr int kNumModuleTypes = (int)ModuleType::VoiceMixer + 1;
+
 class ModuleBase : public juce::AudioProcessor {
 public:
     ModuleBase(const juce::String& name, int numInputs, int numOutputs)
@@ -53,6 +70,7 @@ public:
 
     bool isBypassed() const { return bypassedParam->get(); }
     void setBypassed(bool b) { bypassedParam->setValueNotifyingHost(b ? 1.0f : 0.0f); }
+    juce::AudioParameterBool& getBypassedParameter() { return *bypassedParam; }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override = 0;
     void releaseResources() override {}
@@ -74,7 +92,45 @@ public:
         return {};
     }
     void changeProgramName(int index, const juce::String& newName) override { juce::ignoreUnused(index, newName); }
+    /**
+     * Binary state: a 12-byte header (magic, version, count) followed by one
+     * (paramID hash, normalised value) pair per parameter, all little-endian.
+     * Saving and restoring are linear in the parameter count and allocate only
+     * the output block. setStateInformation() still reads the older XML format.
+     */
+    static constexpr juce::uint32 kStateMagic = 0x534d5347; // "GSMS"
+    static constexpr juce::uint32 kStateVersion = 1;
+    static constexpr int kStateHeaderBytes = 12;
+    static constexpr int kStateEntryBytes = 8;
+
+    /** FNV-1a of the parameter ID's UTF-8 bytes; stable across builds and platforms. */
+    static juce::uint32 hashParameterID(const juce::String& paramID) {
+        juce::uint32 hash = 2166136261u;
+        for (auto* c = paramID.toRawUTF8(); *c != 0; ++c)
+            hash = (hash ^ (juce::uint8)*c) * 16777619u;
+        return hash;
+    }
+
     void getStateInformation(juce::MemoryBlock& destData) override {
+        const auto& slots = getParameterSlots();
+        destData.setSize((size_t)(kStateHeaderBytes + kStateEntryBytes * (int)slots.size()), false);
+        auto* out = static_cast<char*>(destData.getData());
+        writeStateWord(out, kStateMagic);
+        writeStateWord(out + 4, kStateVersion);
+        writeStateWord(out + 8, (juce::uint32)slots.size());
+        out += kStateHeaderBytes;
+        for (const auto& slot : slots) {
+            float value = slot.parameter->getValue();
+            juce::uint32 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            writeStateWord(out, slot.hash);
+            writeStateWord(out + 4, bits);
+            out += kStateEntryBytes;
+        }
+    }
+
+    /** Writes the pre-binary XML state format. setStateInformation() accepts either. */
+    void getXmlStateInformation(juce::MemoryBlock& destData) {
         juce::ValueTree state("ModuleState");
         for (auto* param : getParameters()) {
             if (auto* p = dynamic_cast<juce::AudioProcessorParameterWithID*>(param)) {
@@ -85,6 +141,9 @@ public:
     }
 
     void setStateInformation(const void* data, int sizeInBytes) override {
+        if (setBinaryState(data, sizeInBytes))
+            return;
+
         auto xmlState = getXmlFromBinary(data, sizeInBytes);
         if (xmlState != nullptr) {
             if (xmlState->hasTagName("ModuleState")) {
@@ -110,6 +169,16 @@ public:
     virtual ModulationCategory getModulationCategory() const { return ModulationCategory::Other; }
     virtual ModuleType getModuleType() const = 0;
 
+    static constexpr int kControlBlockSize = 16; // Samples per control-rate value
+    virtual PortRate getInputPortRate(int channelIndex) const {
+        juce::ignoreUnused(channelIndex);
+        return PortRate::Audio;
+    }
+    virtual PortRate getOutputPortRate(int channelIndex) const {
+        juce::ignoreUnused(channelIndex);
+        return PortRate::Audio;
+    }
+
     VisualBuffer* getVisualBuffer() { return visualBuffer.get(); }
     void enableVisualBuffer(bool enable) {
         if (enable && !visualBuffer)
@@ -118,12 +187,123 @@ public:
             visualBuffer = nullptr;
     }
 
+    /**
+     * Link to the voice activity of the Poly MIDI module this module's voices come
+     * from. Bound by gsynth::bindVoiceActivity(); unbound links report all voices.
+     */
+    VoiceActivityLink& getVoiceActivityLink() { return voiceActivityLink; }
+    const VoiceActivityLink& getVoiceActivityLink() const { return voiceActivityLink; }
+
+    /**
+     * Link to the oversampling region this module runs in. Bound by
+     * gsynth::bindOversamplingRegions(), only for modules that support oversampling.
+     */
+    OversamplingLink& getOversamplingLink() { return oversamplingLink; }
+    const OversamplingLink& getOversamplingLink() const { return oversamplingLink; }
+
+    /** Modules that return true render through their OversamplingLink and can join a region. */
+    virtual bool supportsOversampling() const { return false; }
+
+    /** Latency of the module's own processing, in samples at the graph's rate. */
+    virtual int getInternalLatencySamples() const { return 0; }
+
+    /** Reports the module's own latency plus its oversampling region's to the graph. */
+    void refreshLatency() { setLatencySamples(getInternalLatencySamples() + oversamplingLink.getLatencySamples()); }
+
 protected:
     juce::AudioParameterBool* bypassedParam = nullptr;
 
+    /**
+     * For modules that support oversampling: sizes the link for its bound factor and
+     * scales sampleRate and samplesPerBlock to the rate the module's own DSP runs at.
+     */
+    void prepareOversampling(double& sampleRate, int& samplesPerBlock) {
+        oversamplingLink.prepare(samplesPerBlock, getTotalNumInputChannels(), getTotalNumOutputChannels());
+        sampleRate *= oversamplingLink.getFactor();
+        samplesPerBlock *= oversamplingLink.getFactor();
+        refreshLatency();
+    }
+
 private:
     juce::String moduleName;
     std::unique_ptr<VisualBuffer> visualBuffer;
+    VoiceActivityLink voiceActivityLink;
+    OversamplingLink oversamplingLink;
+
+    struct ParameterSlot {
+        juce::uint32 hash = 0;
+        juce::AudioProcessorParameter* parameter = nullptr;
+    };
+    std::vector<ParameterSlot> parameterSlots; // In parameter order
+    std::vector<ParameterSlot> slotsByHash;    // Sorted by hash, for entries that arrive out of order
+
+    // Parameters are added by subclass constructors, so the slots are built on first use
+    const std::vector<ParameterSlot>& getParameterSlots() {
+        const auto& params = getParameters();
+        if (parameterSlots.size() == (size_t)params.size())
+            return parameterSlots;
+
+        parameterSlots.clear();
+        for (auto* param : params)
+            if (auto* p = dynamic_cast<juce::AudioProcessorParameterWithID*>(param))
+                parameterSlots.push_back({hashParameterID(p->paramID), param});
+
+        slotsByHash = parameterSlots;
+        std::sort(slotsByHash.begin(), slotsByHash.end(),
+                  [](const ParameterSlot& a, const ParameterSlot& b) { return a.hash < b.hash; });
+        jassert(std::adjacent_find(slotsByHash.begin(), slotsByHash.end(), [](const auto& a, const auto& b) {
+                    return a.hash == b.hash;
+                }) == slotsByHash.end()); // Two parameter IDs share a hash
+        return parameterSlots;
+    }
+
+    /** Restores binary state. Returns false (leaving parameters untouched) if data isn't binary state. */
+    bool setBinaryState(const void* data, int sizeInBytes) {
+        if (data == nullptr || sizeInBytes < kStateHeaderBytes)
+            return false;
+
+        auto* in = static_cast<const char*>(data);
+        if (readStateWord(in) != kStateMagic)
+            return false;
+
+        // Newer versions may change the entry layout; ignore them rather than misread them
+        auto version = readStateWord(in + 4);
+        auto count = (int)readStateWord(in + 8);
+        if (version == 0 || version > kStateVersion || count < 0 ||
+            count > (sizeInBytes - kStateHeaderBytes) / kStateEntryBytes)
+            return true;
+
+        const auto& slots = getParameterSlots();
+        in += kStateHeaderBytes;
+        for (int i = 0; i < count; ++i, in += kStateEntryBytes) {
+            auto hash = readStateWord(in);
+            juce::uint32 bits = readStateWord(in + 4);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+
+            // Entries are written in parameter order, so the same index almost always matches
+            juce::AudioProcessorParameter* parameter = nullptr;
+            if ((size_t)i < slots.size() && slots[(size_t)i].hash == hash) {
+                parameter = slots[(size_t)i].parameter;
+            } else {
+                auto it = std::lower_bound(slotsByHash.begin(), slotsByHash.end(), hash,
+                                           [](const ParameterSlot& slot, juce::uint32 h) { return slot.hash < h; });
+                if (it != slotsByHash.end() && it->hash == hash)
+                    parameter = it->parameter;
+            }
+
+            if (parameter != nullptr && std::isfinite(value))
+                parameter->setValue(juce::jlimit(0.0f, 1.0f, value));
+        }
+        return true;
+    }
+
+    static void writeStateWord(char* dest, juce::uint32 value) {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(dest, &value, sizeof(value));
+    }
+
+    static juce::uint32 readStateWord(const char* src) { return juce::ByteOrder::littleEndianInt(src); }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModuleBase)
 };
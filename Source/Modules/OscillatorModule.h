@@ -1,13 +1,14 @@
 #pragma once
 
 #include "ModuleBase.h"
+#include "VoicePool.h"
 #include <cmath>
 
 class OscillatorModule : public ModuleBase {
 public:
     OscillatorModule()
-        : ModuleBase("Oscillator", 14,
-                     8) // 8 per-voice pitch CV inputs, 6 shared mod CV inputs (8-13), 8 per-voice audio outputs
+        : ModuleBase("Oscillator", kMaxPolyVoices + NUM_SHARED_CV,
+                     kMaxPolyVoices) // per-voice pitch CV inputs, 6 shared mod CV inputs after them, per-voice outputs
     {
         addParameter(waveformParam = new juce::AudioParameterChoice("waveform", "Waveform",
                                                                     {"Sine", "Square", "Saw", "Triangle"}, 0));
@@ -23,20 +24,57 @@ public:
     }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
-        juce::ignoreUnused(samplesPerBlock);
+        prepareOversampling(sampleRate, samplesPerBlock);
         currentSampleRate = sampleRate;
 
         float initPitch = voices[0].lastMidiNote + (octaveParam->get() * 12.0f) + (float)coarseParam->get() +
                           (fineParam->get() / 100.0f);
         float initFreq = 440.0f * std::pow(2.0f, (initPitch - 69.0f) / 12.0f);
 
-        for (int v = 0; v < MAX_VOICES; ++v) {
+        for (int v = 0; v < kMaxPolyVoices; ++v) {
             voices[v].smoothedFreq.reset(sampleRate, 0.005);
             voices[v].smoothedFreq.setCurrentAndTargetValue(initFreq);
         }
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        getOversamplingLink().process(buffer, midiMessages, [this](auto& b, auto& m) { render(b, m); });
+    }
+
+    float getTargetFrequency() const {
+        float totalPitch = voices[0].lastMidiNote + (octaveParam->get() * 12.0f) + (float)coarseParam->get() +
+                           (fineParam->get() / 100.0f);
+        return 440.0f * std::pow(2.0f, (totalPitch - 69.0f) / 12.0f);
+    }
+
+    std::vector<ModulationTarget> getModulationTargets() const override {
+        if (polyParam->get())
+            return {{"Waveform", kMaxPolyVoices},
+                    {"Octave", kMaxPolyVoices + 1},
+                    {"Coarse", kMaxPolyVoices + 2},
+                    {"Fine", kMaxPolyVoices + 3},
+                    {"Level", kMaxPolyVoices + 4}};
+        return {{"Pitch", 0}, {"Waveform", 1}, {"Octave", 2}, {"Coarse", 3}, {"Fine", 4}, {"Level", 5}};
+    }
+    juce::String getInputPortLabel(int i) const override {
+        const juce::String labels[] = {"Pitch", "Waveform", "Octave", "Coarse", "Fine", "Level"};
+        return (i >= 0 && i < 6) ? labels[i] : ModuleBase::getInputPortLabel(i);
+    }
+    juce::String getOutputPortLabel(int) const override { return "Audio"; }
+    PortRate getInputPortRate(int i) const override {
+        // Pitch, waveform and tuning only set the frequency; Level may carry audio-rate AM
+        int level = polyParam->get() ? kMaxPolyVoices + 4 : 5;
+        return i == level ? PortRate::Audio : PortRate::Control;
+    }
+    int getVisibleInputPortCount() const override { return 6; }
+    int getVisibleOutputPortCount() const override { return 1; }
+    ModulationCategory getModulationCategory() const override { return ModulationCategory::Oscillator; }
+    ModuleType getModuleType() const override { return ModuleType::Oscillator; }
+    bool supportsOversampling() const override { return true; }
+
+private:
+    void render(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+        GSYNTH_TRACE_SCOPE("audio", "Oscillator");
         if (isBypassed()) {
             buffer.clear();
             return;
@@ -51,7 +89,7 @@ public:
 
         if (polyParam->get()) {
             // Clear unused channels (if any) before poly processing
-            for (int ch = 14; ch < buffer.getNumChannels(); ++ch)
+            for (int ch = kMaxPolyVoices + NUM_SHARED_CV; ch < buffer.getNumChannels(); ++ch)
                 buffer.clear(ch, 0, buffer.getNumSamples());
             processPolyMode(buffer, buffer.getNumSamples());
         } else {
@@ -62,32 +100,10 @@ public:
         }
     }
 
-    float getTargetFrequency() const {
-        float totalPitch = voices[0].lastMidiNote + (octaveParam->get() * 12.0f) + (float)coarseParam->get() +
-                           (fineParam->get() / 100.0f);
-        return 440.0f * std::pow(2.0f, (totalPitch - 69.0f) / 12.0f);
-    }
-
-    std::vector<ModulationTarget> getModulationTargets() const override {
-        if (polyParam->get())
-            return {{"Waveform", 8}, {"Octave", 9}, {"Coarse", 10}, {"Fine", 11}, {"Level", 12}};
-        return {{"Pitch", 0}, {"Waveform", 1}, {"Octave", 2}, {"Coarse", 3}, {"Fine", 4}, {"Level", 5}};
-    }
-    juce::String getInputPortLabel(int i) const override {
-        const juce::String labels[] = {"Pitch", "Waveform", "Octave", "Coarse", "Fine", "Level"};
-        return (i >= 0 && i < 6) ? labels[i] : ModuleBase::getInputPortLabel(i);
-    }
-    juce::String getOutputPortLabel(int) const override { return "Audio"; }
-    int getVisibleInputPortCount() const override { return 6; }
-    int getVisibleOutputPortCount() const override { return 1; }
-    ModulationCategory getModulationCategory() const override { return ModulationCategory::Oscillator; }
-    ModuleType getModuleType() const override { return ModuleType::Oscillator; }
-
-private:
     // -------------------------------------------------------------------------
     // Constants
     // -------------------------------------------------------------------------
-    static constexpr int MAX_VOICES = 8;
+    static constexpr int NUM_SHARED_CV = 6;
     static constexpr int MAX_UNISON = 8;
     static constexpr int CROSSFADE_SAMPLES = 64;
 
@@ -107,7 +123,7 @@ private:
         int crossfadeSamplesRemaining = 0;
     };
 
-    VoiceState voices[MAX_VOICES];
+    VoiceState voices[kMaxPolyVoices];
 
     // -------------------------------------------------------------------------
     // Mono mode processing (voice 0 only, MIDI driven)
@@ -269,15 +285,15 @@ private:
     }
 
     // -------------------------------------------------------------------------
-    // Poly mode processing (voices 0-7, pitch CV driven)
+    // Poly mode processing (one voice per pitch CV channel)
     // -------------------------------------------------------------------------
     void processPolyMode(juce::AudioBuffer<float>& buffer, int numSamples) {
         int numChannels = buffer.getNumChannels();
         float level = levelParam->get();
         int ns = std::min(numSamples, 4096);
 
-        // Save pitch CVs (channels 0-7) before clearing buffer
-        for (int v = 0; v < MAX_VOICES; ++v) {
+        // Save per-voice pitch CVs before clearing buffer
+        for (int v = 0; v < kMaxPolyVoices; ++v) {
             if (v < numChannels)
                 std::copy_n(buffer.getReadPointer(v), ns, pitchCVCache[v].data());
             else
@@ -286,7 +302,11 @@ private:
 
         buffer.clear();
 
-        for (int v = 0; v < MAX_VOICES && v < numChannels; ++v) {
+        const VoiceMask sounding = getVoiceActivityLink().getSoundingVoices();
+        for (int v = 0; v < kMaxPolyVoices && v < numChannels; ++v) {
+            if (((sounding >> v) & 1) == 0)
+                continue; // Released and finished; its channel stays silent
+
             float* output = buffer.getWritePointer(v);
             const float* pitchCVs = pitchCVCache[v].data();
 
@@ -416,7 +436,7 @@ private:
     double currentSampleRate = 44100.0;
 
     // Pre-allocated buffers to avoid heap allocation in audio thread
-    std::array<std::array<float, 4096>, MAX_VOICES> pitchCVCache{};
+    std::array<std::array<float, 4096>, kMaxPolyVoices> pitchCVCache{};
     std::array<float, 4096> waveformCVCache{};
     std::array<float, 4096> octaveCVCache{};
     std::array<float, 4096> coarseCVCache{};
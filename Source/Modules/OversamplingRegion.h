@@ -0,0 +1,359 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <vector>
+
+/**
+ * @class OversamplingFilter
+ * @brief One channel of 2x or 4x interpolation or decimation with halfband FIR stages.
+ *
+ * Each octave is a linear-phase equiripple halfband filter. Upsampling runs the
+ * octaves from the base rate up, downsampling runs them back down; each direction
+ * keeps its own state, so a signal can be upsampled in one module and downsampled
+ * in another.
+ */
+class OversamplingFilter {
+public:
+    enum class Direction { Up, Down };
+
+    static constexpr int kMaxFactor = 4;
+
+    void prepare(int newFactor, Direction newDirection, int maxBaseSamples) {
+        jassert(newFactor == 2 || newFactor == kMaxFactor);
+        factor = newFactor;
+        direction = newDirection;
+
+        stages.clear();
+        for (int octave = 0; (2 << octave) <= factor; ++octave)
+            stages.emplace_back(getDesign(octave, direction), direction);
+
+        // 4x runs through an intermediate 2x block
+        scratch.assign(factor > 2 ? (size_t)maxBaseSamples * 2 : 0, 0.0f);
+    }
+
+    void reset() {
+        for (auto& stage : stages)
+            stage.reset();
+    }
+
+    /** Writes numBaseSamples * factor samples to out. */
+    void upsample(const float* in, float* out, int numBaseSamples) {
+        jassert(direction == Direction::Up);
+        if (stages.size() == 1) {
+            stages[0].upsample(in, out, numBaseSamples);
+        } else {
+            stages[0].upsample(in, scratch.data(), numBaseSamples);
+            stages[1].upsample(scratch.data(), out, numBaseSamples * 2);
+        }
+    }
+
+    /** Reads numBaseSamples * factor samples from in. */
+    void downsample(const float* in, float* out, int numBaseSamples) {
+        jassert(direction == Direction::Down);
+        if (stages.size() == 1) {
+            stages[0].downsample(in, out, numBaseSamples);
+        } else {
+            stages[1].downsample(in, scratch.data(), numBaseSamples * 2);
+            stages[0].downsample(scratch.data(), out, numBaseSamples);
+        }
+    }
+
+    /** The group delay of a factor's filters in one direction, in base-rate samples. */
+    static double getLatencyInSamples(int factor, Direction direction) {
+        double latency = 0.0;
+        for (int octave = 0; (2 << octave) <= factor; ++octave)
+            latency += 0.5 * (double)(getDesign(octave, direction).numTaps - 1) / (double)(2 << octave);
+        return latency;
+    }
+
+private:
+    struct Design {
+        Design(float transitionWidth, float stopbandDb) {
+            auto coefficients =
+                juce::dsp::FilterDesign<float>::designFIRLowpassHalfBandEquirippleMethod(transitionWidth, stopbandDb);
+            const float* h = coefficients->getRawCoefficients();
+            numTaps = (int)coefficients->getFilterOrder() + 1;
+            kernel.assign(h, h + numTaps);
+            std::reverse(kernel.begin(), kernel.end());
+
+            // Zero-stuffing halves the level, so each polyphase branch gets twice the taps
+            phaseLength = (numTaps + 1) / 2;
+            for (int p = 0; p < 2; ++p) {
+                phases[(size_t)p].assign((size_t)phaseLength, 0.0f);
+                for (int i = 0; i < phaseLength; ++i)
+                    if (int tap = 2 * (phaseLength - 1 - i) + p; tap < numTaps)
+                        phases[(size_t)p][(size_t)i] = 2.0f * h[tap];
+            }
+        }
+
+        int numTaps = 0;
+        int phaseLength = 0;
+        std::vector<float> kernel;               // Decimation: the taps, oldest input first
+        std::array<std::vector<float>, 2> phases; // Interpolation: even and odd output branches
+    };
+
+    static const Design& getDesign(int octave, Direction direction) {
+        // The first octave sets the passband; the second only has to clear its images
+        static const std::array<Design, 4> designs{
+            Design(0.10f, -90.0f), Design(0.10f, -75.0f), Design(0.20f, -80.0f), Design(0.20f, -65.0f)};
+        return designs[(size_t)(octave * 2 + (direction == Direction::Down ? 1 : 0))];
+    }
+
+    class Stage {
+    public:
+        Stage(const Design& newDesign, Direction direction)
+            : design(&newDesign)
+            , length(direction == Direction::Up ? newDesign.phaseLength : newDesign.numTaps) {
+            history.assign((size_t)length * 2, 0.0f);
+        }
+
+        void reset() {
+            std::fill(history.begin(), history.end(), 0.0f);
+            pos = 0;
+        }
+
+        void upsample(const float* in, float* out, int numIn) {
+            const float* even = design->phases[0].data();
+            const float* odd = design->phases[1].data();
+            for (int i = 0; i < numIn; ++i) {
+                const float* window = push(in[i]);
+                out[2 * i] = dot(window, even);
+                out[2 * i + 1] = dot(window, odd);
+            }
+        }
+
+        void downsample(const float* in, float* out, int numOut) {
+            const float* kernel = design->kernel.data();
+            for (int i = 0; i < numOut; ++i) {
+                out[i] = dot(push(in[2 * i]), kernel);
+                push(in[2 * i + 1]);
+            }
+        }
+
+    private:
+        // The history is stored twice over, so the latest `length` inputs are always contiguous
+        const float* push(float x) {
+            history[(size_t)pos] = x;
+            history[(size_t)(pos + length)] = x;
+            pos = pos + 1 == length ? 0 : pos + 1;
+            return history.data() + pos;
+        }
+
+        float dot(const float* window, const float* taps) const {
+            float sum = 0.0f;
+            for (int i = 0; i < length; ++i)
+                sum += window[i] * taps[i];
+            return sum;
+        }
+
+        const Design* design;
+        int length;
+        std::vector<float> history;
+        int pos = 0;
+    };
+
+    int factor = 2;
+    Direction direction = Direction::Up;
+    std::vector<Stage> stages;
+    std::vector<float> scratch;
+};
+
+/**
+ * @class OversamplingLink
+ * @brief A module's place in an oversampling region.
+ *
+ * A region is a chain of modules that all run at 2x or 4x the graph's rate. The
+ * graph still calls each member once per block at the base rate; the link turns
+ * that into one call at the oversampled rate:
+ * - inputs from outside the region are upsampled (audio ports through
+ *   OversamplingFilter, control-rate ports by holding each value);
+ * - inputs from other members are read at the oversampled rate straight from
+ *   that member's signal, with no conversion;
+ * - outputs that leave the region are downsampled through OversamplingFilter;
+ *   outputs only other members read are just decimated for the graph.
+ * So a chain pays for one conversion at each end, not one per module.
+ *
+ * Bindings are made by gsynth::bindOversamplingRegions() on the message thread.
+ * It suspends every link it changes (takes their locks) while re-binding and
+ * re-preparing the modules; the audio thread only try-locks, and outputs silence for a block it
+ * can't lock. An unbound link (factor 1) renders at the base rate, as before.
+ */
+class OversamplingLink {
+public:
+    using Signal = juce::AudioBuffer<float>;
+
+    enum class InputKind {
+        Unconnected, // Nothing is connected; the oversampled input is silent
+        Upsampled,   // Comes from outside the region, through an interpolation filter
+        Held,        // A control-rate input from outside the region; each value is repeated
+        Inside       // The sum of other members' oversampled outputs
+    };
+
+    struct InsideSource {
+        std::shared_ptr<const Signal> signal;
+        int channel = 0;
+        bool operator==(const InsideSource&) const = default;
+    };
+
+    struct Input {
+        InputKind kind = InputKind::Upsampled;
+        std::vector<InsideSource> sources; // Inside only
+        bool operator==(const Input&) const = default;
+    };
+
+    struct Binding {
+        int factor = 1;
+        std::vector<Input> inputs;     // Per input channel
+        std::vector<bool> exitOutputs; // Per output channel: read by something outside the region
+        int latencySamples = 0;        // Reported by the module on top of its own latency
+        bool operator==(const Binding&) const = default;
+    };
+
+    /** Message thread: blocks processing until resume(). */
+    void suspend() { lock.enter(); }
+    void resume() { lock.exit(); }
+
+    /** Message thread, while suspended. Returns the previous binding; release it after resume(). */
+    Binding rebind(Binding newBinding) {
+        std::swap(binding, newBinding);
+        factor.store(binding.factor, std::memory_order_relaxed);
+        latencySamples.store(binding.latencySamples, std::memory_order_relaxed);
+        return newBinding;
+    }
+
+    /** Message thread. */
+    const Binding& getBinding() const { return binding; }
+
+    int getFactor() const { return factor.load(std::memory_order_relaxed); }
+    int getLatencySamples() const { return latencySamples.load(std::memory_order_relaxed); }
+    bool isBound() const { return getFactor() > 1; }
+
+    /** The module's last block at the oversampled rate, which downstream members read. */
+    std::shared_ptr<const Signal> getSignal() const { return signal; }
+
+    /**
+     * Sizes the buffers and filters for the bound factor. Called from the module's
+     * prepareToPlay(), when the audio thread isn't processing it.
+     */
+    void prepare(int samplesPerBlock, int numInputs, int numOutputs) {
+        const int f = binding.factor;
+        maxBaseSamples = samplesPerBlock;
+        if (f == 1) {
+            signal->setSize(0, 0);
+            upsamplers.clear();
+            downsamplers.clear();
+            return;
+        }
+
+        signal->setSize(std::max(numInputs, numOutputs), samplesPerBlock * f);
+        upsamplers.resize((size_t)numInputs);
+        for (auto& filter : upsamplers)
+            filter.prepare(f, OversamplingFilter::Direction::Up, samplesPerBlock);
+        downsamplers.resize((size_t)numOutputs);
+        for (auto& filter : downsamplers)
+            filter.prepare(f, OversamplingFilter::Direction::Down, samplesPerBlock);
+        scaledMidi.ensureSize(2048);
+    }
+
+    /** Audio thread: runs render(buffer, midi) at the bound rate. */
+    template <typename Render>
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi, Render&& render) {
+        const juce::SpinLock::ScopedTryLockType tl(lock);
+        if (!tl.isLocked()) {
+            buffer.clear();
+            return;
+        }
+
+        const int f = binding.factor;
+        if (f == 1) {
+            render(buffer, midi);
+            return;
+        }
+
+        const int numChannels = buffer.getNumChannels();
+        const int numSamples = buffer.getNumSamples();
+        if (numSamples > maxBaseSamples || numChannels > signal->getNumChannels()) {
+            jassertfalse; // Not prepared for this block
+            buffer.clear();
+            return;
+        }
+
+        const int n = numSamples * f;
+        Signal work(signal->getArrayOfWritePointers(), numChannels, n);
+        readInputs(buffer, work, numSamples, f);
+
+        scaledMidi.clear();
+        for (const auto metadata : midi)
+            scaledMidi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition * f);
+
+        render(work, scaledMidi);
+
+        midi.clear();
+        for (const auto metadata : scaledMidi)
+            midi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition / f);
+
+        writeOutputs(work, buffer, numSamples, f);
+    }
+
+private:
+    void readInputs(const juce::AudioBuffer<float>& buffer, Signal& work, int numSamples, int f) {
+        const int n = numSamples * f;
+        for (int ch = 0; ch < work.getNumChannels(); ++ch) {
+            float* dest = work.getWritePointer(ch);
+            const auto kind = (size_t)ch < binding.inputs.size() ? binding.inputs[(size_t)ch].kind
+                                                                 : InputKind::Unconnected;
+            switch (kind) {
+            case InputKind::Unconnected:
+                juce::FloatVectorOperations::clear(dest, n);
+                break;
+            case InputKind::Upsampled:
+                upsamplers[(size_t)ch].upsample(buffer.getReadPointer(ch), dest, numSamples);
+                break;
+            case InputKind::Held: {
+                const float* src = buffer.getReadPointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                    juce::FloatVectorOperations::fill(dest + i * f, src[i], f);
+                break;
+            }
+            case InputKind::Inside:
+                juce::FloatVectorOperations::clear(dest, n);
+                for (const auto& source : binding.inputs[(size_t)ch].sources)
+                    if (source.channel < source.signal->getNumChannels() && source.signal->getNumSamples() >= n)
+                        juce::FloatVectorOperations::add(dest, source.signal->getReadPointer(source.channel), n);
+                break;
+            }
+        }
+    }
+
+    void writeOutputs(const Signal& work, juce::AudioBuffer<float>& buffer, int numSamples, int f) {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+            float* dest = buffer.getWritePointer(ch);
+            if ((size_t)ch >= downsamplers.size()) {
+                juce::FloatVectorOperations::clear(dest, numSamples);
+            } else if ((size_t)ch < binding.exitOutputs.size() && binding.exitOutputs[(size_t)ch]) {
+                downsamplers[(size_t)ch].downsample(work.getReadPointer(ch), dest, numSamples);
+            } else {
+                // Only other members read this output, and they read the oversampled signal
+                const float* src = work.getReadPointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                    dest[i] = src[i * f];
+            }
+        }
+    }
+
+    juce::SpinLock lock;
+    Binding binding;
+    std::atomic<int> factor{1};
+    std::atomic<int> latencySamples{0};
+
+    std::shared_ptr<Signal> signal = std::make_shared<Signal>();
+    std::vector<OversamplingFilter> upsamplers;   // Per input channel
+    std::vector<OversamplingFilter> downsamplers; // Per output channel
+    juce::MidiBuffer scaledMidi;
+    int maxBaseSamples = 0;
+};
@@ -1,42 +1,46 @@
 #pragma once
 
 #include "ModuleBase.h"
+#include "VoicePool.h"
+#include <array>
+#include <memory>
 
 class PolyMidiModule : public ModuleBase {
 public:
     PolyMidiModule()
-        : ModuleBase("Poly MIDI", 0, 16) {
-        // Port 0: Pitch CV (8 channels)
-        // Port 1: Gate CV (8 channels)
+        : ModuleBase("Poly MIDI", 0, 2 * kMaxPolyVoices) {
+        // Channels 0..N-1: Pitch CV (one per voice)
+        // Channels N..2N-1: Gate CV (one per voice)
         enableVisualBuffer(true);
     }
 
     bool acceptsMidi() const override { return true; }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
-        juce::ignoreUnused(sampleRate, samplesPerBlock);
-        for (auto& v : voices) {
-            v.note = -1;
-            v.active = false;
-            v.lastUsedTime = 0;
-            v.currentFreq = 0.0f;
-            v.smoothedGate.reset(sampleRate, 0.005); // 5ms smoothing for gates
-            v.smoothedFreq.reset(sampleRate, 0.005); // 5ms smoothing for pitch
+        juce::ignoreUnused(samplesPerBlock);
+        pool.reset();
+        samplePosition = 0;
+        currentFreq.fill(0.0f);
+        for (int v = 0; v < kMaxPolyVoices; ++v) {
+            smoothedGate[v].reset(sampleRate, 0.005); // 5ms smoothing for gates
+            smoothedFreq[v].reset(sampleRate, 0.005); // 5ms smoothing for pitch
         }
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "Poly MIDI");
         if (isBypassed()) {
             buffer.clear();
+            voiceActivity->publishGates(VoiceActivity::kAllVoices);
             return;
         }
 
         buffer.clear();
+        const VoiceMask gatesAtStart = getOpenGateMask();
 
         int numSamples = buffer.getNumSamples();
         int currentSample = 0;
 
-        int midiEventCount = 0;
         for (const auto metadata : midiMessages) {
             auto msg = metadata.getMessage();
             int triggerSample = msg.getTimeStamp();
@@ -48,15 +52,17 @@ public:
                 currentSample = triggerSample;
             }
 
+            // Stealing is ordered by absolute sample position, not wall-clock time
+            auto eventPosition = samplePosition + (uint64_t)triggerSample;
+
             if (msg.isNoteOn()) {
-                handleNoteOn(msg.getNoteNumber(), msg.getFloatVelocity());
-                ++midiEventCount;
+                int v = pool.noteOn(msg.getNoteNumber(), msg.getFloatVelocity(), eventPosition);
+                if (v != VoicePool<kMaxPolyVoices>::kNoVoice)
+                    currentFreq[v] = (float)juce::MidiMessage::getMidiNoteInHertz(msg.getNoteNumber());
             } else if (msg.isNoteOff()) {
-                handleNoteOff(msg.getNoteNumber());
-                ++midiEventCount;
+                pool.noteOff(msg.getNoteNumber()); // Frequency is held so the release tail keeps its pitch
             } else if (msg.isAllNotesOff()) {
-                allNotesOff();
-                ++midiEventCount;
+                pool.allNotesOff();
             }
         }
 
@@ -64,6 +70,9 @@ public:
             renderChunk(buffer, currentSample, numSamples);
         }
 
+        samplePosition += (uint64_t)numSamples;
+        voiceActivity->publishGates(gatesAtStart | getOpenGateMask());
+
         // Push to visual buffer (Pitch Channel 0)
         if (auto* vb = getVisualBuffer()) {
             auto* ch = buffer.getWritePointer(0); // Pitch Voice 0
@@ -74,112 +83,61 @@ public:
     }
 
     // API for UI
-    uint8_t getActiveVoiceMask() const {
-        uint8_t mask = 0;
-        for (int i = 0; i < MAX_VOICES; ++i) {
-            if (voices[i].active) {
-                mask |= (1 << i);
-            }
-        }
-        return mask;
-    }
+    VoiceMask getActiveVoiceMask() const { return pool.getActiveMask(); }
+    const VoicePool<kMaxPolyVoices>& getVoicePool() const { return pool; }
+
+    /** The voice activity shared with the modules this one drives (see gsynth::bindVoiceActivity()). */
+    const std::shared_ptr<VoiceActivity>& getVoiceActivity() const { return voiceActivity; }
+
     ModuleType getModuleType() const override { return ModuleType::PolyMidi; }
     int getVisibleOutputPortCount() const override { return 1; }
     juce::String getOutputPortLabel(int) const override { return "Poly Out"; }
     int getVisibleInputPortCount() const override { return 0; }
 
 private:
-    static constexpr int MAX_VOICES = 8;
-
-    struct Voice {
-        int note = -1;
-        bool active = false;
-        juce::int64 lastUsedTime = 0;
-        float currentFreq = 0.0f; // Store freq to hold it on NoteOff
-        juce::SmoothedValue<float> smoothedGate;
-        juce::SmoothedValue<float> smoothedFreq;
-    };
-    Voice voices[MAX_VOICES];
+    VoicePool<kMaxPolyVoices> pool;
+    uint64_t samplePosition = 0;
+
+    // Per-voice render state (SoA, indexed by pool voice)
+    std::array<float, kMaxPolyVoices> currentFreq{}; // Held on NoteOff
+    std::array<juce::SmoothedValue<float>, kMaxPolyVoices> smoothedGate;
+    std::array<juce::SmoothedValue<float>, kMaxPolyVoices> smoothedFreq;
+
+    std::shared_ptr<VoiceActivity> voiceActivity = std::make_shared<VoiceActivity>();
+
+    // Held voices, plus released voices whose gate is still closing
+    VoiceMask getOpenGateMask() const {
+        VoiceMask mask = pool.getActiveMask();
+        for (int v = 0; v < kMaxPolyVoices; ++v)
+            if (smoothedGate[v].getCurrentValue() > 0.0f)
+                mask |= VoiceMask{1} << v;
+        return mask;
+    }
 
     // Helper to render state to buffer
     void renderChunk(juce::AudioBuffer<float>& buffer, int startSample, int endSample) {
         if (endSample <= startSample)
             return;
 
-        for (int i = 0; i < MAX_VOICES; ++i) {
-            float* pitchCh = buffer.getWritePointer(i);
-            float* gateCh = buffer.getWritePointer(i + 8);
+        int numChannels = buffer.getNumChannels();
 
-            voices[i].smoothedFreq.setTargetValue(voices[i].currentFreq);
-            voices[i].smoothedGate.setTargetValue(voices[i].active ? 1.0f : 0.0f);
+        for (int v = 0; v < kMaxPolyVoices; ++v) {
+            if (v >= numChannels)
+                break;
 
-            for (int s = startSample; s < endSample; ++s) {
-                pitchCh[s] = voices[i].smoothedFreq.getNextValue();
-                gateCh[s] = voices[i].smoothedGate.getNextValue();
-            }
-        }
-    }
+            float* pitchCh = buffer.getWritePointer(v);
+            float* gateCh = (v + kMaxPolyVoices < numChannels) ? buffer.getWritePointer(v + kMaxPolyVoices) : nullptr;
 
-    void handleNoteOn(int note, float velocity) {
-        juce::ignoreUnused(velocity);
-        juce::int64 now = juce::Time::getMillisecondCounter();
-        float freq = juce::MidiMessage::getMidiNoteInHertz(note);
-
-        // Try to find existing note to re-trigger
-        for (int i = 0; i < MAX_VOICES; ++i) {
-            if (voices[i].active && voices[i].note == note) {
-                voices[i].lastUsedTime = now;
-                voices[i].currentFreq = freq;
-                return;
-            }
-        }
+            smoothedFreq[v].setTargetValue(currentFreq[v]);
+            smoothedGate[v].setTargetValue(pool.isActive(v) ? 1.0f : 0.0f);
 
-        // Find empty voice
-        for (int i = 0; i < MAX_VOICES; ++i) {
-            if (!voices[i].active) {
-                voices[i].note = note;
-                voices[i].active = true;
-                voices[i].lastUsedTime = now;
-                voices[i].currentFreq = freq;
-                return;
-            }
-        }
-
-        // Steal least recently used voice
-        int oldestIdx = findOldestVoiceIndex();
-        voices[oldestIdx].note = note;
-        voices[oldestIdx].active = true;
-        voices[oldestIdx].lastUsedTime = now;
-        voices[oldestIdx].currentFreq = freq;
-    }
-
-    void handleNoteOff(int note) {
-        for (int i = 0; i < MAX_VOICES; ++i) {
-            if (voices[i].active && voices[i].note == note) {
-                voices[i].active = false;
-            }
-        }
-    }
-
-    void allNotesOff() {
-        for (int i = 0; i < MAX_VOICES; ++i) {
-            voices[i].active = false;
-            voices[i].note = -1;
-        }
-    }
-
-    int findOldestVoiceIndex() const {
-        int oldestIdx = 0;
-        juce::int64 oldestTime = voices[0].lastUsedTime;
-
-        for (int i = 1; i < MAX_VOICES; ++i) {
-            if (voices[i].lastUsedTime < oldestTime) {
-                oldestTime = voices[i].lastUsedTime;
-                oldestIdx = i;
+            for (int s = startSample; s < endSample; ++s) {
+                pitchCh[s] = smoothedFreq[v].getNextValue();
+                float gate = smoothedGate[v].getNextValue();
+                if (gateCh != nullptr)
+                    gateCh[s] = gate;
             }
         }
-
-        return oldestIdx;
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolyMidiModule)
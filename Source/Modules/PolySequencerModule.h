@@ -65,6 +65,7 @@ public:
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "Poly Sequencer");
         if (isBypassed()) {
             buffer.clear();
             return;
@@ -70,6 +70,7 @@ public:
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "Sequencer");
         if (isBypassed()) {
             buffer.clear();
             return;
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "ModuleBase.h"
+#include "VoicePool.h"
 #include <cmath>
 
 class VCAModule : public ModuleBase {
 public:
     VCAModule()
-        : ModuleBase("VCA", 16,
-                     8) // 0-7: per-voice audio, 8-15: per-voice CV, outputs 0-7: gated audio (poly sums to ch0/1)
+        : ModuleBase("VCA", 2 * kMaxPolyVoices,
+                     kMaxPolyVoices) // per-voice audio, then per-voice CV; per-voice outputs (poly sums to ch0/1)
     {
         addParameter(gainParam = new juce::AudioParameterFloat("gain", "Gain", 0.0f, 1.0f, 0.5f));
         addParameter(polyParam = new juce::AudioParameterBool("poly", "Poly", false));
@@ -15,12 +16,26 @@ public:
     }
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
-        juce::ignoreUnused(samplesPerBlock);
+        prepareOversampling(sampleRate, samplesPerBlock);
         smoothedGain.reset(sampleRate, 0.01);
         smoothedGain.setCurrentAndTargetValue(*gainParam);
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        getOversamplingLink().process(buffer, midiMessages, [this](auto& b, auto& m) { render(b, m); });
+    }
+
+    std::vector<ModulationTarget> getModulationTargets() const override { return {{"CV", 1}}; }
+    juce::String getInputPortLabel(int i) const override { return (i == 0) ? "Audio" : "CV"; }
+    juce::String getOutputPortLabel(int) const override { return "Audio"; }
+    int getVisibleInputPortCount() const override { return 2; }
+    int getVisibleOutputPortCount() const override { return 1; }
+    ModuleType getModuleType() const override { return ModuleType::VCA; }
+    bool supportsOversampling() const override { return true; }
+
+private:
+    void render(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+        GSYNTH_TRACE_SCOPE("audio", "VCA");
         juce::ignoreUnused(midiMessages);
 
         int numSamples = buffer.getNumSamples();
@@ -29,8 +44,8 @@ public:
             return;
 
         if (isBypassed()) {
-            // Clear CV channels (CV starts at 1 in mono, 8 in poly)
-            int cvStart = polyParam->get() ? 8 : 1;
+            // Clear CV channels (CV starts at 1 in mono, after the voices in poly)
+            int cvStart = polyParam->get() ? kMaxPolyVoices : 1;
             for (int ch = cvStart; ch < numChannels; ++ch)
                 buffer.clear(ch, 0, numSamples);
             return;
@@ -39,17 +54,17 @@ public:
         smoothedGain.setTargetValue(*gainParam);
 
         if (!polyParam->get()) {
-            // --- Mono mode: read CV from ch1 (legacy) or ch8 (poly layout fallback) ---
+            // --- Mono mode: read CV from ch1 (legacy) or the first poly CV channel (fallback) ---
             auto* audioData = buffer.getWritePointer(0);
             const float* cvData = (numChannels > 1) ? buffer.getReadPointer(1) : nullptr;
 
-            // If ch1 has no signal, try ch8 (poly envelope routing)
-            if (cvData != nullptr && numChannels > 8) {
+            // If ch1 has no signal, try the poly envelope routing
+            if (cvData != nullptr && numChannels > kMaxPolyVoices) {
                 float rms1 = 0.0f;
                 for (int s = 0; s < std::min(numSamples, 64); ++s)
                     rms1 += cvData[s] * cvData[s];
                 if (rms1 < 1e-6f)
-                    cvData = buffer.getReadPointer(8);
+                    cvData = buffer.getReadPointer(kMaxPolyVoices);
             }
 
             for (int s = 0; s < numSamples; ++s) {
@@ -64,32 +79,46 @@ public:
                 for (int s = 0; s < numSamples; ++s)
                     vb->pushSample(buffer.getSample(0, s));
         } else {
-            // --- Poly mode: 8 voices summed to stereo (ch0/ch1) ---
+            // --- Poly mode: all voices summed to stereo (ch0/ch1) ---
             // Each voice is multiplied by its envelope CV and the master gain,
             // then all voices are accumulated into a single stereo sum.
-            // A fixed 1/MAX_VOICES normalization prevents hot signals from clipping,
+            // A fixed 1/8 normalization prevents hot signals from clipping; it is
+            // independent of the build's polyphony so patches keep their level,
             // and std::tanh provides gentle soft saturation as a safety net.
-            static constexpr float kNorm = 1.0f / static_cast<float>(MAX_VOICES);
+            static constexpr float kNorm = 1.0f / 8.0f;
 
             if (numChannels >= 2) {
                 auto* outL = buffer.getWritePointer(0);
                 auto* outR = buffer.getWritePointer(1);
 
+                // Only sounding voices are summed; released voices cost nothing
+                const VoiceMask sounding = getVoiceActivityLink().getSoundingVoices();
+                const float* audioIn[kMaxPolyVoices];
+                const float* cvIn[kMaxPolyVoices];
+                int numSounding = 0;
+                for (int v = 0; v < kMaxPolyVoices && v < numChannels; ++v) {
+                    if (((sounding >> v) & 1) == 0)
+                        continue;
+                    audioIn[numSounding] = buffer.getReadPointer(v);
+                    cvIn[numSounding] = (v + kMaxPolyVoices < numChannels) ? buffer.getReadPointer(v + kMaxPolyVoices)
+                                                                             : nullptr;
+                    ++numSounding;
+                }
+
                 for (int s = 0; s < numSamples; ++s) {
                     float gain = smoothedGain.getNextValue();
                     float sum = 0.0f;
-                    for (int v = 0; v < MAX_VOICES && v < numChannels; ++v) {
-                        float audio = buffer.getSample(v, s);
-                        float cv = (v + MAX_VOICES < numChannels) ? buffer.getSample(v + MAX_VOICES, s) : 1.0f;
-                        sum += audio * gain * cv;
+                    for (int i = 0; i < numSounding; ++i) {
+                        float cv = (cvIn[i] != nullptr) ? cvIn[i][s] : 1.0f;
+                        sum += audioIn[i][s] * gain * cv;
                     }
                     float mixed = std::tanh(sum * kNorm);
                     outL[s] = mixed;
                     outR[s] = mixed;
                 }
 
-                // Zero out voice channels 2-7 so they don't leak downstream
-                for (int v = 2; v < MAX_VOICES && v < numChannels; ++v)
+                // Zero out the remaining voice channels so they don't leak downstream
+                for (int v = 2; v < kMaxPolyVoices && v < numChannels; ++v)
                     buffer.clear(v, 0, numSamples);
             }
             if (auto* vb = getVisualBuffer())
@@ -98,24 +127,14 @@ public:
         }
 
         // Clear CV channels to prevent leaking to downstream modules
-        int cvStart = polyParam->get() ? 8 : 1;
         // Exception: in mono mode we copy audio to ch1 for visual feedback,
         // so we only clear from ch2 onwards if it exists.
         // If we want absolute cleanliness, we should clear ch1 too, but that breaks VCA viz.
         // We'll stick to the existing behavior for VCA ch1 but clear others.
-        for (int ch = (polyParam->get() ? 8 : 2); ch < numChannels; ++ch)
+        for (int ch = (polyParam->get() ? kMaxPolyVoices : 2); ch < numChannels; ++ch)
             buffer.clear(ch, 0, numSamples);
     }
 
-    std::vector<ModulationTarget> getModulationTargets() const override { return {{"CV", 1}}; }
-    juce::String getInputPortLabel(int i) const override { return (i == 0) ? "Audio" : "CV"; }
-    juce::String getOutputPortLabel(int) const override { return "Audio"; }
-    int getVisibleInputPortCount() const override { return 2; }
-    int getVisibleOutputPortCount() const override { return 1; }
-    ModuleType getModuleType() const override { return ModuleType::VCA; }
-
-private:
-    static constexpr int MAX_VOICES = 8;
     juce::AudioParameterFloat* gainParam = nullptr;
     juce::AudioParameterBool* polyParam = nullptr;
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedGain;
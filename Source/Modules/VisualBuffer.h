@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <cmath>
 #include <juce_core/juce_core.h>
 
 /**
@@ -11,12 +12,24 @@ class VisualBuffer {
 public:
     static constexpr int DEFAULT_SIZE = 1024;
 
+    /** Notified when the buffer is destroyed, so background readers can let go of it first. */
+    class Observer {
+    public:
+        virtual ~Observer() = default;
+        virtual void visualBufferDeleted(VisualBuffer& buffer) = 0;
+    };
+
     VisualBuffer(int size = DEFAULT_SIZE)
         : bufferSize(size)
         , buffer(size) {
         writePos.store(0);
     }
 
+    ~VisualBuffer() { observers.call([this](Observer& o) { o.visualBufferDeleted(*this); }); }
+
+    void addObserver(Observer* observer) { observers.add(observer); }
+    void removeObserver(Observer* observer) { observers.remove(observer); }
+
     /** Pushes a single sample into the circular buffer. */
     void pushSample(float sample) {
         int pos = writePos.load();
@@ -37,12 +50,26 @@ public:
         }
     }
 
+    /** RMS over the whole buffer, read in place (no copy). */
+    float getRMS() const {
+        float sum = 0.0f;
+        for (auto& s : buffer) {
+            float v = s.load(std::memory_order_relaxed);
+            sum += v * v;
+        }
+        return std::sqrt(sum / (float)bufferSize);
+    }
+
+    /** Current write index; unchanged between two reads means no new samples arrived. */
+    int getWritePosition() const { return writePos.load(); }
+
     int getSize() const { return bufferSize; }
 
 private:
     int bufferSize;
     std::vector<std::atomic<float>> buffer;
     std::atomic<int> writePos;
+    juce::ListenerList<Observer> observers;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VisualBuffer)
 };
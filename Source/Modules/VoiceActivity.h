@@ -0,0 +1,113 @@
+#pragma once
+
+#include "VoicePool.h"
+#include <array>
+#include <atomic>
+#include <juce_core/juce_core.h>
+#include <memory>
+
+/**
+ * @class VoiceActivity
+ * @brief Which voices of one Poly MIDI module are currently sounding.
+ *
+ * The Poly MIDI module publishes the voices whose gate is open or still closing,
+ * and each poly ADSR it drives publishes the voices whose envelope has not yet
+ * reached Idle. A voice is sounding while either says so. Modules downstream of
+ * the Poly MIDI module read the combined mask and skip every other voice, so a
+ * fully released voice costs nothing until it is triggered again.
+ *
+ * Each publisher reports every voice that was active at any point in its block,
+ * so a reader that runs before the publisher in the same block never drops a
+ * voice that is still audible in that block. Masks are single atomics: any
+ * thread may read them, and only the audio thread writes them.
+ */
+class VoiceActivity {
+public:
+    static constexpr int kMaxEnvelopes = 16;
+    static constexpr VoiceMask kAllVoices = VoicePool<kMaxPolyVoices>::kAllVoicesMask;
+
+    void publishGates(VoiceMask mask) { gateMask.store(mask, std::memory_order_relaxed); }
+
+    void publishEnvelope(int slot, VoiceMask mask) {
+        if (slot >= 0 && slot < kMaxEnvelopes)
+            envelopeMasks[(size_t)slot].store(mask, std::memory_order_relaxed);
+    }
+
+    VoiceMask getSoundingVoices() const {
+        VoiceMask mask = gateMask.load(std::memory_order_relaxed);
+        const int count = numEnvelopes.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; ++i)
+            mask |= envelopeMasks[(size_t)i].load(std::memory_order_relaxed);
+        return mask;
+    }
+
+    /**
+     * Sets how many envelope slots are read. Every slot starts out reporting all
+     * voices, so an envelope that has not published yet never silences anything.
+     * Called when the graph is re-bound.
+     */
+    void setNumEnvelopes(int count) {
+        for (auto& envelope : envelopeMasks)
+            envelope.store(kAllVoices, std::memory_order_relaxed);
+        numEnvelopes.store(juce::jlimit(0, kMaxEnvelopes, count), std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<VoiceMask> gateMask{kAllVoices};
+    std::array<std::atomic<VoiceMask>, kMaxEnvelopes> envelopeMasks{};
+    std::atomic<int> numEnvelopes{0};
+};
+
+/**
+ * @class VoiceActivityLink
+ * @brief A module's connection to the VoiceActivity of the Poly MIDI module driving it.
+ *
+ * Unbound links report every voice as sounding, so modules outside a Poly MIDI
+ * chain behave exactly as before. bind() runs on the message thread; the audio
+ * thread only try-locks, and treats a busy lock like an unbound link for that
+ * block. A replaced VoiceActivity is released by bind(), never on the audio thread.
+ */
+class VoiceActivityLink {
+public:
+    /** Binds to activity; envelopeSlot is the slot this module publishes to, or -1 if it doesn't. */
+    void bind(std::shared_ptr<VoiceActivity> newActivity, int newEnvelopeSlot = -1) {
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            std::swap(activity, newActivity);
+            envelopeSlot = newEnvelopeSlot;
+        }
+        // newActivity now holds the previous binding and is released here
+    }
+
+    void unbind() { bind(nullptr); }
+
+    bool isBound() const {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        return activity != nullptr;
+    }
+
+    int getEnvelopeSlot() const {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        return envelopeSlot;
+    }
+
+    /** Audio thread: the voices to render this block. */
+    VoiceMask getSoundingVoices() const {
+        const juce::SpinLock::ScopedTryLockType tl(lock);
+        if (!tl.isLocked() || activity == nullptr)
+            return VoiceActivity::kAllVoices;
+        return activity->getSoundingVoices();
+    }
+
+    /** Audio thread: publishes this module's envelope mask, if it has a slot. */
+    void publishEnvelope(VoiceMask mask) {
+        const juce::SpinLock::ScopedTryLockType tl(lock);
+        if (tl.isLocked() && activity != nullptr)
+            activity->publishEnvelope(envelopeSlot, mask);
+    }
+
+private:
+    mutable juce::SpinLock lock;
+    std::shared_ptr<VoiceActivity> activity;
+    int envelopeSlot = -1;
+};
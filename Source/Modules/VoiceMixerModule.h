@@ -1,11 +1,12 @@
 #pragma once
 
 #include "ModuleBase.h"
+#include "VoicePool.h"
 
 class VoiceMixerModule : public ModuleBase {
 public:
     VoiceMixerModule()
-        : ModuleBase("Voice Mixer", 8, 2) // 8 voice channels in, stereo out
+        : ModuleBase("Voice Mixer", kMaxPolyVoices, 2) // one channel per voice in, stereo out
     {
         addParameter(levelParam = new juce::AudioParameterFloat("level", "Level", 0.0f, 1.0f, 0.125f));
     }
@@ -17,25 +18,31 @@ public:
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        GSYNTH_TRACE_SCOPE("audio", "Voice Mixer");
         juce::ignoreUnused(midiMessages);
 
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
-        int voiceCount = std::min(8, numChannels);
+        int voiceCount = std::min(kMaxPolyVoices, numChannels);
 
         if (numSamples == 0 || voiceCount == 0)
             return;
 
-        // Save all voice input data before overwriting (channels 0-7 are both input and output)
+        // Only sounding voices are mixed; released voices cost nothing
+        const VoiceMask sounding = getVoiceActivityLink().getSoundingVoices();
+
+        // Save the voice input data before overwriting (voice channels are both input and output)
         if (inputCopy.getNumChannels() < voiceCount || inputCopy.getNumSamples() < numSamples)
             inputCopy.setSize(voiceCount, numSamples, false, false, true);
         for (int ch = 0; ch < voiceCount; ++ch)
-            inputCopy.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+            if ((sounding >> ch) & 1)
+                inputCopy.copyFrom(ch, 0, buffer, ch, 0, numSamples);
 
-        // Sum all voices into channel 0
+        // Sum the voices into channel 0
         buffer.clear(0, 0, numSamples);
         for (int ch = 0; ch < voiceCount; ++ch) {
-            buffer.addFrom(0, 0, inputCopy, ch, 0, numSamples);
+            if ((sounding >> ch) & 1)
+                buffer.addFrom(0, 0, inputCopy, ch, 0, numSamples);
         }
 
         // Apply smoothed level and soft-clip to prevent distortion
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Compile-time polyphony shared by every poly-capable module. Poly bus layouts
+// (per-voice channels first, shared CV after) are derived from this value.
+// Configure with -DGRAVISYNTH_MAX_VOICES=<8|16|32|64> (see CMakeLists.txt).
+#ifndef GRAVISYNTH_MAX_VOICES
+#define GRAVISYNTH_MAX_VOICES 8
+#endif
+
+inline constexpr int kMaxPolyVoices = GRAVISYNTH_MAX_VOICES;
+
+static_assert(kMaxPolyVoices == 8 || kMaxPolyVoices == 16 || kMaxPolyVoices == 32 || kMaxPolyVoices == 64,
+              "GRAVISYNTH_MAX_VOICES must be 8, 16, 32 or 64");
+
+// One bit per voice; wide enough for the largest supported polyphony.
+using VoiceMask = uint64_t;
+
+/**
+ * @brief Structure-of-arrays voice pool with O(1) allocation and stealing.
+ *
+ * Free voices live in a FIFO ring so the voice released longest ago is reused
+ * first, giving release tails the most time to finish. Held voices live in an
+ * intrusive doubly-linked list ordered by trigger time (sample counter); the
+ * head is always the least recently triggered voice and is the one stolen when
+ * the pool is full. A note → voice table makes retrigger and note-off O(1).
+ *
+ * Not thread-safe: owned and driven by the audio thread only.
+ */
+template <int NumVoices>
+class VoicePool {
+public:
+    static_assert(NumVoices > 0 && NumVoices <= 64 && (NumVoices & (NumVoices - 1)) == 0,
+                  "NumVoices must be a power of two no larger than 64");
+
+    static constexpr int kNumVoices = NumVoices;
+    static constexpr int kNoVoice = -1;
+    static constexpr VoiceMask kAllVoicesMask =
+        NumVoices == 64 ? ~VoiceMask{0} : ((VoiceMask{1} << NumVoices) - 1);
+
+    VoicePool() { reset(); }
+
+    void reset() {
+        notes.fill(kNoVoice);
+        velocities.fill(0.0f);
+        startSamples.fill(0);
+        lruPrev.fill(kNoVoice);
+        lruNext.fill(kNoVoice);
+        noteToVoice.fill(kNoVoice);
+
+        for (int v = 0; v < NumVoices; ++v)
+            freeRing[v] = (int8_t)v;
+        freeHead = 0;
+        freeCount = NumVoices;
+
+        lruHead = lruTail = kNoVoice;
+        numActive = 0;
+        activeMask = 0;
+    }
+
+    /** Starts (or retriggers) a note at the given absolute sample position.
+        Returns the voice index the note now occupies. */
+    int noteOn(int note, float velocity, uint64_t samplePosition) {
+        if (note < 0 || note > 127)
+            return kNoVoice;
+
+        int v = noteToVoice[note];
+
+        if (v == kNoVoice) {
+            if (freeCount > 0) {
+                v = freeRing[freeHead];
+                freeHead = (freeHead + 1) & (NumVoices - 1);
+                --freeCount;
+            } else {
+                // Steal the least recently triggered voice
+                v = lruHead;
+                noteToVoice[notes[v]] = kNoVoice;
+                unlink(v);
+                --numActive;
+            }
+
+            notes[v] = (int8_t)note;
+            noteToVoice[note] = (int8_t)v;
+            activeMask |= VoiceMask{1} << v;
+            ++numActive;
+        } else {
+            unlink(v);
+        }
+
+        velocities[v] = velocity;
+        startSamples[v] = samplePosition;
+        linkTail(v);
+        return v;
+    }
+
+    /** Releases the voice holding the note. Returns the voice index or kNoVoice. */
+    int noteOff(int note) {
+        if (note < 0 || note > 127)
+            return kNoVoice;
+
+        int v = noteToVoice[note];
+        if (v != kNoVoice)
+            release(v);
+        return v;
+    }
+
+    void allNotesOff() {
+        // Oldest first, so the free ring keeps release order
+        while (lruHead != kNoVoice)
+            release(lruHead);
+    }
+
+    bool isActive(int v) const { return (activeMask >> v) & 1u; }
+    int getNote(int v) const { return notes[v]; }
+    float getVelocity(int v) const { return velocities[v]; }
+    uint64_t getStartSample(int v) const { return startSamples[v]; }
+    int getVoiceForNote(int note) const { return (note >= 0 && note <= 127) ? noteToVoice[note] : kNoVoice; }
+    int getOldestVoice() const { return lruHead; }
+    int getNumActive() const { return numActive; }
+    int getNumFree() const { return freeCount; }
+    VoiceMask getActiveMask() const { return activeMask; }
+
+private:
+    void release(int v) {
+        noteToVoice[notes[v]] = kNoVoice;
+        notes[v] = kNoVoice;
+        unlink(v);
+        --numActive;
+        activeMask &= ~(VoiceMask{1} << v);
+
+        freeRing[(freeHead + freeCount) & (NumVoices - 1)] = (int8_t)v;
+        ++freeCount;
+    }
+
+    void linkTail(int v) {
+        lruPrev[v] = (int8_t)lruTail;
+        lruNext[v] = kNoVoice;
+        if (lruTail != kNoVoice)
+            lruNext[lruTail] = (int8_t)v;
+        else
+            lruHead = v;
+        lruTail = v;
+    }
+
+    void unlink(int v) {
+        int prev = lruPrev[v];
+        int next = lruNext[v];
+        if (prev != kNoVoice)
+            lruNext[prev] = (int8_t)next;
+        else
+            lruHead = next;
+        if (next != kNoVoice)
+            lruPrev[next] = (int8_t)prev;
+        else
+            lruTail = prev;
+        lruPrev[v] = lruNext[v] = kNoVoice;
+    }
+
+    // Per-voice state (SoA)
+    std::array<int8_t, NumVoices> notes{};
+    std::array<float, NumVoices> velocities{};
+    std::array<uint64_t, NumVoices> startSamples{};
+    std::array<int8_t, NumVoices> lruPrev{};
+    std::array<int8_t, NumVoices> lruNext{};
+
+    // Free voices, oldest release at freeHead
+    std::array<int8_t, NumVoices> freeRing{};
+    int freeHead = 0;
+    int freeCount = 0;
+
+    std::array<int8_t, 128> noteToVoice{};
+
+    int lruHead = kNoVoice;
+    int lruTail = kNoVoice;
+    int numActive = 0;
+    VoiceMask activeMask = 0;
+};
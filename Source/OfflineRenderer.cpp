@@ -0,0 +1,83 @@
+#include "OfflineRenderer.h"
+#include "Modules/MidiKeyboardModule.h"
+#include "OversamplingBinder.h"
+#include "VoiceActivityBinder.h"
+
+namespace gsynth {
+
+OfflineRenderer::OfflineRenderer(juce::AudioProcessorGraph& g, double sr, int bs, int channels)
+    : graph(g)
+    , sampleRate(sr)
+    , blockSize(bs)
+    , numChannels(channels) {}
+
+OfflineRenderer::~OfflineRenderer() {
+    if (prepared)
+        graph.releaseResources();
+}
+
+void OfflineRenderer::prepare() {
+    graph.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+    graph.prepareToPlay(sampleRate, blockSize);
+    graph.rebuild();
+    bindVoiceActivity(graph);
+    bindOversamplingRegions(graph);
+    prepared = true;
+
+    keyboards.clear();
+    for (auto* node : graph.getNodes()) {
+        if (auto* keyboard = dynamic_cast<MidiKeyboardModule*>(node->getProcessor()))
+            keyboards.push_back(keyboard);
+    }
+
+    midiBuffer.ensureSize(256);
+    pendingMidi.ensureSize(256);
+}
+
+void OfflineRenderer::processBlock(juce::AudioBuffer<float>& buffer) {
+    buffer.clear();
+    midiBuffer.clear();
+    midiBuffer.swapWith(pendingMidi);
+    graph.processBlock(buffer, midiBuffer);
+}
+
+juce::AudioBuffer<float> OfflineRenderer::render(int numSamples, const std::vector<NoteEvent>& script) {
+    juce::AudioBuffer<float> output(numChannels, numSamples);
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+    size_t nextEvent = 0;
+
+    for (int pos = 0; pos < numSamples; pos += blockSize) {
+        int len = std::min(blockSize, numSamples - pos);
+
+        while (nextEvent < script.size() && script[nextEvent].samplePosition < pos + len) {
+            const auto& e = script[nextEvent++];
+            if (e.velocity > 0.0f)
+                noteOn(e.note, e.velocity);
+            else
+                noteOff(e.note);
+        }
+
+        block.setSize(numChannels, len, false, false, true);
+        processBlock(block);
+        for (int ch = 0; ch < numChannels; ++ch)
+            output.copyFrom(ch, pos, block, ch, 0, len);
+    }
+
+    return output;
+}
+
+void OfflineRenderer::noteOn(int note, float velocity) {
+    if (keyboards.empty())
+        pendingMidi.addEvent(juce::MidiMessage::noteOn(1, note, velocity), 0);
+    for (auto* keyboard : keyboards)
+        keyboard->getKeyboardState().noteOn(1, note, velocity);
+}
+
+void OfflineRenderer::noteOff(int note) {
+    if (keyboards.empty())
+        pendingMidi.addEvent(juce::MidiMessage::noteOff(1, note), 0);
+    for (auto* keyboard : keyboards)
+        keyboard->getKeyboardState().noteOff(1, note, 0.0f);
+}
+
+} // namespace gsynth
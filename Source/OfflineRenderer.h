@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+
+class MidiKeyboardModule;
+
+namespace gsynth {
+
+/**
+ * @class OfflineRenderer
+ * @brief Drives an AudioProcessorGraph without an audio device.
+ *
+ * Used by the benchmark suite and golden-render tests to render presets
+ * headlessly. Notes are injected through every MIDI Keyboard node in the graph,
+ * exactly as the on-screen keyboard does, so presets render as they play live.
+ * Graphs without a MIDI Keyboard (such as AI-generated patches driven by a Midi
+ * Input node) receive the notes as graph MIDI input instead.
+ */
+class OfflineRenderer {
+public:
+    /** A scripted note event. A velocity of 0 means note-off. */
+    struct NoteEvent {
+        int samplePosition = 0;
+        int note = 60;
+        float velocity = 0.8f;
+    };
+
+    OfflineRenderer(juce::AudioProcessorGraph& graph, double sampleRate, int blockSize, int numChannels = 2);
+    ~OfflineRenderer();
+
+    /**
+     * @brief Prepares the graph for rendering. Call after the patch is loaded.
+     */
+    void prepare();
+
+    /**
+     * @brief Renders one block into the buffer (cleared first).
+     */
+    void processBlock(juce::AudioBuffer<float>& buffer);
+
+    /**
+     * @brief Renders numSamples, applying the script's note events.
+     *
+     * Events must be sorted by samplePosition. Each is applied at the start of
+     * the block containing it, matching how the on-screen keyboard delivers notes.
+     */
+    juce::AudioBuffer<float> render(int numSamples, const std::vector<NoteEvent>& script);
+
+    void noteOn(int note, float velocity);
+    void noteOff(int note);
+
+    double getSampleRate() const { return sampleRate; }
+    int getBlockSize() const { return blockSize; }
+
+private:
+    juce::AudioProcessorGraph& graph;
+    double sampleRate;
+    int blockSize;
+    int numChannels;
+    bool prepared = false;
+
+    juce::MidiBuffer midiBuffer;
+    juce::MidiBuffer pendingMidi; // Notes for the graph's MIDI input when there is no keyboard
+    std::vector<MidiKeyboardModule*> keyboards;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
+
+} // namespace gsynth
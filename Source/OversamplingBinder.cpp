@@ -0,0 +1,205 @@
+#include "OversamplingBinder.h"
+#include "Modules/ModuleBase.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace gsynth {
+
+namespace {
+const juce::Identifier kOversamplingProperty{"oversampling"};
+
+struct Member {
+    ModuleBase* module = nullptr;
+    int factor = 1;
+    OversamplingLink::Binding binding;
+    bool hasExit = false;
+    bool hasUpsampledInput = false;
+    std::vector<juce::uint32> insideSources; // Members read through an Inside input
+    juce::uint32 region = 0;
+};
+} // namespace
+
+int getOversamplingFactor(const juce::AudioProcessorGraph::Node& node) {
+    const int factor = node.properties.getWithDefault(kOversamplingProperty, 1);
+    return factor == 2 || factor == OversamplingFilter::kMaxFactor ? factor : 1;
+}
+
+void setOversamplingFactor(juce::AudioProcessorGraph::Node& node, int factor) {
+    if (factor == 2 || factor == OversamplingFilter::kMaxFactor)
+        node.properties.set(kOversamplingProperty, factor);
+    else
+        node.properties.remove(kOversamplingProperty);
+}
+
+bool bindOversamplingRegions(juce::AudioProcessorGraph& graph) {
+    GSYNTH_TRACE_SCOPE("graph", "bindOversamplingRegions");
+
+    std::unordered_map<juce::uint32, Member> members;
+    std::vector<std::pair<juce::uint32, ModuleBase*>> modules; // Every module that can oversample
+    for (auto* node : graph.getNodes()) {
+        auto* module = dynamic_cast<ModuleBase*>(node->getProcessor());
+        if (module == nullptr || !module->supportsOversampling())
+            continue;
+        modules.emplace_back(node->nodeID.uid, module);
+        if (const int factor = getOversamplingFactor(*node); factor > 1)
+            members[node->nodeID.uid] = Member{module, factor, {}, false, false, {}, node->nodeID.uid};
+    }
+
+    auto isBound = [](const auto& entry) { return entry.second->getOversamplingLink().isBound(); };
+    if (members.empty() && std::none_of(modules.begin(), modules.end(), isBound))
+        return false;
+
+    // What feeds each audio input of each member
+    using Port = std::pair<juce::uint32, int>;
+    struct PortHash {
+        size_t operator()(const Port& p) const {
+            return std::hash<juce::uint64>()(((juce::uint64)p.first << 32) | (juce::uint32)p.second);
+        }
+    };
+    std::unordered_map<Port, std::vector<Port>, PortHash> feeds;
+    for (const auto& connection : graph.getConnections())
+        if (!connection.destination.isMIDI() && members.count(connection.destination.nodeID.uid) != 0)
+            feeds[{connection.destination.nodeID.uid, connection.destination.channelIndex}].push_back(
+                {connection.source.nodeID.uid, connection.source.channelIndex});
+
+    // An input is inside the region only if every source is a member at the same factor;
+    // a mix of inside and outside sources is treated as coming from outside
+    auto isInsideInput = [&](juce::uint32 nodeID, int channel) {
+        auto it = feeds.find({nodeID, channel});
+        if (it == feeds.end())
+            return false;
+        const int factor = members.at(nodeID).factor;
+        return std::all_of(it->second.begin(), it->second.end(), [&](const Port& source) {
+            auto member = members.find(source.first);
+            return member != members.end() && member->second.factor == factor;
+        });
+    };
+
+    std::function<juce::uint32(juce::uint32)> findRegion = [&](juce::uint32 nodeID) {
+        auto& region = members[nodeID].region;
+        if (region != nodeID)
+            region = findRegion(region);
+        return region;
+    };
+
+    for (auto& [nodeID, member] : members) {
+        auto& binding = member.binding;
+        binding.factor = member.factor;
+        binding.inputs.resize((size_t)member.module->getTotalNumInputChannels());
+        binding.exitOutputs.assign((size_t)member.module->getTotalNumOutputChannels(), false);
+
+        for (int ch = 0; ch < (int)binding.inputs.size(); ++ch) {
+            auto& input = binding.inputs[(size_t)ch];
+            if (feeds.count({nodeID, ch}) == 0) {
+                input.kind = OversamplingLink::InputKind::Unconnected;
+            } else if (isInsideInput(nodeID, ch)) {
+                input.kind = OversamplingLink::InputKind::Inside;
+                for (const auto& [sourceID, sourceChannel] : feeds[{nodeID, ch}]) {
+                    auto& source = members[sourceID];
+                    input.sources.push_back({source.module->getOversamplingLink().getSignal(), sourceChannel});
+                    member.insideSources.push_back(sourceID);
+                    members[findRegion(sourceID)].region = findRegion(nodeID);
+                }
+            } else if (member.module->getInputPortRate(ch) == PortRate::Control) {
+                input.kind = OversamplingLink::InputKind::Held;
+            } else {
+                input.kind = OversamplingLink::InputKind::Upsampled;
+                member.hasUpsampledInput = true;
+            }
+        }
+    }
+
+    // An output leaves the region if anything but an inside input reads it
+    for (const auto& connection : graph.getConnections()) {
+        if (connection.source.isMIDI())
+            continue;
+        auto it = members.find(connection.source.nodeID.uid);
+        const auto& destination = connection.destination;
+        if (it == members.end() || isInsideInput(destination.nodeID.uid, destination.channelIndex))
+            continue;
+        if ((size_t)connection.source.channelIndex < it->second.binding.exitOutputs.size()) {
+            it->second.binding.exitOutputs[(size_t)connection.source.channelIndex] = true;
+            it->second.hasExit = true;
+        }
+    }
+
+    // A region delays what leaves it by its downsampling filters, plus its upsampling filters
+    // if any audio enters it. The first member with an exit on each path reports that delay,
+    // so members after it on the same path don't count it twice
+    std::unordered_map<juce::uint32, bool> regionUpsamples;
+    for (auto& [nodeID, member] : members)
+        if (member.hasUpsampledInput)
+            regionUpsamples[findRegion(nodeID)] = true;
+
+    std::unordered_map<juce::uint32, bool> reportedUpstream;
+    std::function<bool(juce::uint32)> isReportedUpstream = [&](juce::uint32 nodeID) {
+        if (auto it = reportedUpstream.find(nodeID); it != reportedUpstream.end())
+            return it->second;
+        bool reported = false;
+        for (auto source : members[nodeID].insideSources)
+            reported = reported || members[source].hasExit || isReportedUpstream(source);
+        return reportedUpstream[nodeID] = reported;
+    };
+
+    for (auto& [nodeID, member] : members) {
+        if (!member.hasExit || isReportedUpstream(nodeID))
+            continue;
+        using Direction = OversamplingFilter::Direction;
+        double latency = OversamplingFilter::getLatencyInSamples(member.factor, Direction::Down);
+        if (regionUpsamples[findRegion(nodeID)])
+            latency += OversamplingFilter::getLatencyInSamples(member.factor, Direction::Up);
+        member.binding.latencySamples = (int)std::lround(latency);
+    }
+
+    struct Change {
+        ModuleBase* module = nullptr;
+        OversamplingLink::Binding binding;
+        bool factorChanged = false;
+        int oldLatency = 0;
+    };
+    std::vector<Change> changes;
+    for (auto [nodeID, module] : modules) {
+        OversamplingLink::Binding binding; // Factor 1 for modules outside any region
+        if (auto it = members.find(nodeID); it != members.end())
+            binding = std::move(it->second.binding);
+
+        const auto& link = module->getOversamplingLink();
+        if (binding == link.getBinding())
+            continue;
+        const bool factorChanged = binding.factor != link.getFactor();
+        changes.push_back({module, std::move(binding), factorChanged, module->getLatencySamples()});
+    }
+
+    // Members read each other's signals, and re-preparing a module resizes its signal, so every
+    // changed link is suspended before any is re-bound, and none resumes until all are ready
+    for (auto& change : changes)
+        change.module->getOversamplingLink().suspend();
+
+    for (auto& change : changes) {
+        change.binding = change.module->getOversamplingLink().rebind(std::move(change.binding));
+        if (change.factorChanged && graph.getSampleRate() > 0.0)
+            change.module->prepareToPlay(graph.getSampleRate(), graph.getBlockSize());
+        else
+            change.module->refreshLatency();
+    }
+
+    for (auto& change : changes)
+        change.module->getOversamplingLink().resume();
+
+    // The old bindings' signals are released with changes, off the audio thread
+    const bool changed = !changes.empty();
+    const bool latencyChanged = std::any_of(changes.begin(), changes.end(), [](const Change& change) {
+        return change.module->getLatencySamples() != change.oldLatency;
+    });
+    changes.clear();
+
+    if (latencyChanged)
+        graph.rebuild();
+    return changed;
+}
+
+} // namespace gsynth
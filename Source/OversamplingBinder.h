@@ -0,0 +1,31 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace gsynth {
+
+/** The oversampling factor chosen for a node (1, 2 or 4), kept in its "oversampling" property. */
+int getOversamplingFactor(const juce::AudioProcessorGraph::Node& node);
+
+/** Stores the factor in the node's properties; any other value than 2 or 4 turns oversampling off. */
+void setOversamplingFactor(juce::AudioProcessorGraph::Node& node, int factor);
+
+/**
+ * @brief Groups the modules marked for oversampling into regions and binds their OversamplingLinks.
+ *
+ * Only modules that support oversampling can be marked. Marked modules joined by
+ * audio connections and sharing a factor form one region, which upsamples once where
+ * signals enter it and downsamples once where they leave. The up and down filters'
+ * delay is reported as latency by the first member on each path out of the region,
+ * so the graph's delay compensation lines the region up with parallel paths.
+ *
+ * Every module whose binding changes is suspended before any is re-bound, and
+ * re-prepared at the graph's rate if its factor changed; none resumes until all are. If a reported latency
+ * changed, the graph is rebuilt so its delay compensation picks it up. Returns
+ * true if any binding changed.
+ *
+ * Run after every topology change and whenever a factor is set. Message thread only.
+ */
+bool bindOversamplingRegions(juce::AudioProcessorGraph& graph);
+
+} // namespace gsynth
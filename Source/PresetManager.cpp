@@ -1,5 +1,6 @@
 #include "PresetManager.h"
 #include "AI/AIStateMapper.h"
+#include "Modules/VoicePool.h"
 
 namespace gsynth {
 
@@ -52,8 +53,6 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"id": 10, "type": "Distortion", "position": {"x": 1250, "y": 10}, "params": {"drive": 0.5, "mix": 0.5}},
     {"id": 11, "type": "Delay", "position": {"x": 1250, "y": 250}, "params": {"time": 0.3, "feedback": 0.4, "mix": 0.3}},
     {"id": 12, "type": "Reverb", "position": {"x": 1250, "y": 550}, "params": {"roomSize": 0.5, "damping": 0.5, "wet": 0.33, "dry": 0.4, "width": 1.0}},
-    {"id": 13, "type": "Attenuverter", "position": {"x": 950, "y": 350}, "params": {"amount": 1.0}},
-    {"id": 14, "type": "Attenuverter", "position": {"x": 650, "y": 350}, "params": {"amount": 1.0}},
     {"id": 15, "type": "MIDI Keyboard", "position": {"x": 10, "y": 850}}
   ],
   "connections": [
@@ -67,10 +66,6 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"src": 15, "srcPort": -1, "dst": 4, "dstPort": -1},
     {"src": 3, "srcPort": 0, "dst": 4, "dstPort": 0},
     {"src": 4, "srcPort": 0, "dst": 5, "dstPort": 0},
-    {"src": 6, "srcPort": 0, "dst": 13, "dstPort": 0},
-    {"src": 13, "srcPort": 0, "dst": 5, "dstPort": 1},
-    {"src": 7, "srcPort": 0, "dst": 14, "dstPort": 0},
-    {"src": 14, "srcPort": 0, "dst": 4, "dstPort": 1},
     {"src": 5, "srcPort": 0, "dst": 10, "dstPort": 0},
     {"src": 5, "srcPort": 0, "dst": 10, "dstPort": 1},
     {"src": 10, "srcPort": 0, "dst": 11, "dstPort": 0},
@@ -79,6 +74,10 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"src": 11, "srcPort": 1, "dst": 12, "dstPort": 1},
     {"src": 12, "srcPort": 0, "dst": 2, "dstPort": 0},
     {"src": 12, "srcPort": 1, "dst": 2, "dstPort": 1}
+  ],
+  "modulations": [
+    {"source": 6, "sourcePort": 0, "dest": 5, "destPort": 1, "amount": 1.0},
+    {"source": 7, "sourcePort": 0, "dest": 4, "destPort": 1, "amount": 1.0}
   ]
 })";
 
@@ -93,8 +92,6 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"id": 6, "type": "Amp Env", "position": {"x": 350, "y": 450}, "params": {"attack": 0.01, "decay": 0.2, "sustain": 0.7, "release": 0.3}},
     {"id": 7, "type": "Filter Env", "position": {"x": 650, "y": 450}, "params": {"attack": 0.01, "decay": 0.3, "sustain": 0.3, "release": 0.2}},
     {"id": 8, "type": "MIDI Keyboard", "position": {"x": 10, "y": 850}},
-    {"id": 9, "type": "Attenuverter", "position": {"x": 950, "y": 350}, "params": {"amount": 1.0}},
-    {"id": 10, "type": "Attenuverter", "position": {"x": 650, "y": 350}, "params": {"amount": 0.7}},
     {"id": 11, "type": "Sequencer", "position": {"x": 10, "y": 450}, "params": {"run": false}}
   ],
   "connections": [
@@ -106,12 +103,12 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"src": 11, "srcPort": -1, "dst": 7, "dstPort": -1},
     {"src": 3, "srcPort": 0, "dst": 4, "dstPort": 0},
     {"src": 4, "srcPort": 0, "dst": 5, "dstPort": 0},
-    {"src": 6, "srcPort": 0, "dst": 9, "dstPort": 0},
-    {"src": 9, "srcPort": 0, "dst": 5, "dstPort": 1},
-    {"src": 7, "srcPort": 0, "dst": 10, "dstPort": 0},
-    {"src": 10, "srcPort": 0, "dst": 4, "dstPort": 1},
     {"src": 5, "srcPort": 0, "dst": 2, "dstPort": 0},
     {"src": 5, "srcPort": 0, "dst": 2, "dstPort": 1}
+  ],
+  "modulations": [
+    {"source": 6, "sourcePort": 0, "dest": 5, "destPort": 1, "amount": 1.0},
+    {"source": 7, "sourcePort": 0, "dest": 4, "destPort": 1, "amount": 0.7}
   ]
 })";
 
@@ -127,7 +124,6 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"id": 7, "type": "Delay", "position": {"x": 1250, "y": 10}, "params": {"time": 0.5, "feedback": 0.6, "mix": 0.4}},
     {"id": 8, "type": "Reverb", "position": {"x": 1250, "y": 400}, "params": {"roomSize": 0.9, "damping": 0.3, "wet": 0.5}},
     {"id": 9, "type": "MIDI Keyboard", "position": {"x": 10, "y": 850}},
-    {"id": 10, "type": "Attenuverter", "position": {"x": 950, "y": 350}, "params": {"amount": 1.0}},
     {"id": 11, "type": "Sequencer", "position": {"x": 10, "y": 450}, "params": {"run": false}}
   ],
   "connections": [
@@ -137,14 +133,15 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"src": 11, "srcPort": -1, "dst": 6, "dstPort": -1},
     {"src": 3, "srcPort": 0, "dst": 4, "dstPort": 0},
     {"src": 4, "srcPort": 0, "dst": 5, "dstPort": 0},
-    {"src": 6, "srcPort": 0, "dst": 10, "dstPort": 0},
-    {"src": 10, "srcPort": 0, "dst": 5, "dstPort": 1},
     {"src": 5, "srcPort": 0, "dst": 7, "dstPort": 0},
     {"src": 5, "srcPort": 0, "dst": 7, "dstPort": 1},
     {"src": 7, "srcPort": 0, "dst": 8, "dstPort": 0},
     {"src": 7, "srcPort": 1, "dst": 8, "dstPort": 1},
     {"src": 8, "srcPort": 0, "dst": 2, "dstPort": 0},
     {"src": 8, "srcPort": 1, "dst": 2, "dstPort": 1}
+  ],
+  "modulations": [
+    {"source": 6, "sourcePort": 0, "dest": 5, "destPort": 1, "amount": 1.0}
   ]
 })";
 
@@ -159,8 +156,6 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"id": 6, "type": "LFO", "position": {"x": 950, "y": 450}, "params": {"rateHz": 1.5, "shape": "Triangle", "level": 1.0, "bipolar": true}},
     {"id": 7, "type": "ADSR", "position": {"x": 650, "y": 450}, "params": {"attack": 0.01, "decay": 0.3, "sustain": 0.8, "release": 0.3}},
     {"id": 8, "type": "MIDI Keyboard", "position": {"x": 10, "y": 850}},
-    {"id": 9, "type": "Attenuverter", "position": {"x": 650, "y": 350}, "params": {"amount": 0.4}},
-    {"id": 10, "type": "Attenuverter", "position": {"x": 950, "y": 350}, "params": {"amount": 1.0}},
     {"id": 11, "type": "Sequencer", "position": {"x": 10, "y": 450}, "params": {"run": false}}
   ],
   "connections": [
@@ -170,12 +165,12 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"src": 11, "srcPort": -1, "dst": 7, "dstPort": -1},
     {"src": 3, "srcPort": 0, "dst": 4, "dstPort": 0},
     {"src": 4, "srcPort": 0, "dst": 5, "dstPort": 0},
-    {"src": 6, "srcPort": 0, "dst": 9, "dstPort": 0},
-    {"src": 9, "srcPort": 0, "dst": 4, "dstPort": 1},
-    {"src": 7, "srcPort": 0, "dst": 10, "dstPort": 0},
-    {"src": 10, "srcPort": 0, "dst": 5, "dstPort": 1},
     {"src": 5, "srcPort": 0, "dst": 2, "dstPort": 0},
     {"src": 5, "srcPort": 0, "dst": 2, "dstPort": 1}
+  ],
+  "modulations": [
+    {"source": 6, "sourcePort": 0, "dest": 4, "destPort": 1, "amount": 0.4},
+    {"source": 7, "sourcePort": 0, "dest": 5, "destPort": 1, "amount": 1.0}
   ]
 })";
 
@@ -189,7 +184,6 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"id": 5, "type": "Filter", "position": {"x": 650, "y": 10}, "params": {"cutoff": 1500.0, "resonance": 0.2}},
     {"id": 6, "type": "VCA", "position": {"x": 950, "y": 10}, "params": {"gain": 0.8}},
     {"id": 7, "type": "ADSR", "position": {"x": 650, "y": 450}, "params": {"attack": 0.01, "decay": 0.15, "sustain": 0.0, "release": 0.05}},
-    {"id": 8, "type": "Attenuverter", "position": {"x": 950, "y": 350}, "params": {"amount": 1.0}},
     {"id": 9, "type": "MIDI Keyboard", "position": {"x": 10, "y": 850}}
   ],
   "connections": [
@@ -199,10 +193,11 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"src": 9, "srcPort": -1, "dst": 7, "dstPort": -1},
     {"src": 4, "srcPort": 0, "dst": 5, "dstPort": 0},
     {"src": 5, "srcPort": 0, "dst": 6, "dstPort": 0},
-    {"src": 7, "srcPort": 0, "dst": 8, "dstPort": 0},
-    {"src": 8, "srcPort": 0, "dst": 6, "dstPort": 1},
     {"src": 6, "srcPort": 0, "dst": 2, "dstPort": 0},
     {"src": 6, "srcPort": 0, "dst": 2, "dstPort": 1}
+  ],
+  "modulations": [
+    {"source": 7, "sourcePort": 0, "dest": 6, "destPort": 1, "amount": 1.0}
   ]
 })";
 
@@ -217,9 +212,7 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"id": 6, "type": "MIDI Keyboard", "position": {"x": 10, "y": 850}},
     {"id": 7, "type": "Sequencer", "position": {"x": 10, "y": 450}, "params": {"run": false}},
     {"id": 8, "type": "Amp Env", "position": {"x": 350, "y": 450}, "params": {"attack": 0.01, "decay": 0.4, "sustain": 0.4, "release": 0.5}},
-    {"id": 9, "type": "Filter Env", "position": {"x": 650, "y": 450}, "params": {"attack": 0.01, "decay": 0.2, "sustain": 0.1, "release": 0.3}},
-    {"id": 10, "type": "Attenuverter", "position": {"x": 950, "y": 350}, "params": {"amount": 1.0}},
-    {"id": 11, "type": "Attenuverter", "position": {"x": 650, "y": 350}, "params": {"amount": 0.6}}
+    {"id": 9, "type": "Filter Env", "position": {"x": 650, "y": 450}, "params": {"attack": 0.01, "decay": 0.2, "sustain": 0.1, "release": 0.3}}
   ],
   "connections": [
     {"src": 6, "srcPort": -1, "dst": 3, "dstPort": -1},
@@ -230,18 +223,54 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"src": 7, "srcPort": -1, "dst": 9, "dstPort": -1},
     {"src": 3, "srcPort": 0, "dst": 4, "dstPort": 0},
     {"src": 4, "srcPort": 0, "dst": 5, "dstPort": 0},
-    {"src": 8, "srcPort": 0, "dst": 10, "dstPort": 0},
-    {"src": 10, "srcPort": 0, "dst": 5, "dstPort": 1},
-    {"src": 9, "srcPort": 0, "dst": 11, "dstPort": 0},
-    {"src": 11, "srcPort": 0, "dst": 4, "dstPort": 1},
     {"src": 5, "srcPort": 0, "dst": 2, "dstPort": 0},
     {"src": 5, "srcPort": 0, "dst": 2, "dstPort": 1}
+  ],
+  "modulations": [
+    {"source": 8, "sourcePort": 0, "dest": 5, "destPort": 1, "amount": 1.0},
+    {"source": 9, "sourcePort": 0, "dest": 4, "destPort": 1, "amount": 0.6}
   ]
 })";
 
-    case 6: // Poly Pad - 8-voice polyphonic pad
-        // VCA sums all 8 voices to stereo (ch0/ch1) internally; no VoiceMixer needed.
-        return R"({
+    case 6: // Poly Pad - polyphonic pad using every voice of the build's polyphony
+        // VCA sums all voices to stereo (ch0/ch1) internally; no VoiceMixer needed.
+        return getPolyPadPresetJSON();
+
+    default:
+        return "";
+    }
+}
+
+juce::String PresetManager::getPolyPadPresetJSON() {
+    // Per-voice wiring depends on the compile-time polyphony, so the connection
+    // list is generated rather than hand-written.
+    juce::String connections = R"(
+    {"src": 3, "srcPort": -1, "dst": 4, "dstPort": -1},
+    {"src": 3, "srcPort": -1, "dst": 5, "dstPort": -1},
+    {"src": 3, "srcPort": -1, "dst": 8, "dstPort": -1})";
+
+    auto addConnection = [&connections](int src, int srcPort, int dst, int dstPort) {
+        connections << ",\n    {\"src\": " << src << ", \"srcPort\": " << srcPort << ", \"dst\": " << dst
+                    << ", \"dstPort\": " << dstPort << "}";
+    };
+
+    for (int v = 0; v < kMaxPolyVoices; ++v)
+        addConnection(4, v, 5, v); // Poly MIDI pitch -> Oscillator
+    for (int v = 0; v < kMaxPolyVoices; ++v)
+        addConnection(4, kMaxPolyVoices + v, 8, v); // Poly MIDI gate -> Amp Env
+    for (int v = 0; v < kMaxPolyVoices; ++v)
+        addConnection(5, v, 6, v); // Oscillator -> Filter
+    for (int v = 0; v < kMaxPolyVoices; ++v)
+        addConnection(6, v, 7, v); // Filter -> VCA audio
+    for (int v = 0; v < kMaxPolyVoices; ++v)
+        addConnection(8, v, 7, kMaxPolyVoices + v); // Amp Env -> VCA CV
+
+    addConnection(7, 0, 10, 0);
+    addConnection(7, 1, 10, 1);
+    addConnection(10, 0, 2, 0);
+    addConnection(10, 1, 2, 1);
+
+    return R"({
   "nodes": [
     {"id": 1, "type": "Audio Input", "position": {"x": 10, "y": 10}},
     {"id": 2, "type": "Audio Output", "position": {"x": 1400, "y": 450}},
@@ -253,60 +282,10 @@ juce::String PresetManager::getPresetJSON(int index) {
     {"id": 8, "type": "Amp Env", "position": {"x": 350, "y": 450}, "params": {"attack": 0.3, "decay": 0.4, "sustain": 0.7, "release": 1.5, "poly": true}},
     {"id": 10, "type": "Reverb", "position": {"x": 1200, "y": 10}, "params": {"roomSize": 0.8, "damping": 0.3, "wet": 0.5, "dry": 0.5, "width": 1.0}}
   ],
-  "connections": [
-    {"src": 3, "srcPort": -1, "dst": 4, "dstPort": -1},
-    {"src": 3, "srcPort": -1, "dst": 5, "dstPort": -1},
-    {"src": 3, "srcPort": -1, "dst": 8, "dstPort": -1},
-    {"src": 4, "srcPort": 0, "dst": 5, "dstPort": 0},
-    {"src": 4, "srcPort": 1, "dst": 5, "dstPort": 1},
-    {"src": 4, "srcPort": 2, "dst": 5, "dstPort": 2},
-    {"src": 4, "srcPort": 3, "dst": 5, "dstPort": 3},
-    {"src": 4, "srcPort": 4, "dst": 5, "dstPort": 4},
-    {"src": 4, "srcPort": 5, "dst": 5, "dstPort": 5},
-    {"src": 4, "srcPort": 6, "dst": 5, "dstPort": 6},
-    {"src": 4, "srcPort": 7, "dst": 5, "dstPort": 7},
-    {"src": 4, "srcPort": 8, "dst": 8, "dstPort": 0},
-    {"src": 4, "srcPort": 9, "dst": 8, "dstPort": 1},
-    {"src": 4, "srcPort": 10, "dst": 8, "dstPort": 2},
-    {"src": 4, "srcPort": 11, "dst": 8, "dstPort": 3},
-    {"src": 4, "srcPort": 12, "dst": 8, "dstPort": 4},
-    {"src": 4, "srcPort": 13, "dst": 8, "dstPort": 5},
-    {"src": 4, "srcPort": 14, "dst": 8, "dstPort": 6},
-    {"src": 4, "srcPort": 15, "dst": 8, "dstPort": 7},
-    {"src": 5, "srcPort": 0, "dst": 6, "dstPort": 0},
-    {"src": 5, "srcPort": 1, "dst": 6, "dstPort": 1},
-    {"src": 5, "srcPort": 2, "dst": 6, "dstPort": 2},
-    {"src": 5, "srcPort": 3, "dst": 6, "dstPort": 3},
-    {"src": 5, "srcPort": 4, "dst": 6, "dstPort": 4},
-    {"src": 5, "srcPort": 5, "dst": 6, "dstPort": 5},
-    {"src": 5, "srcPort": 6, "dst": 6, "dstPort": 6},
-    {"src": 5, "srcPort": 7, "dst": 6, "dstPort": 7},
-    {"src": 6, "srcPort": 0, "dst": 7, "dstPort": 0},
-    {"src": 6, "srcPort": 1, "dst": 7, "dstPort": 1},
-    {"src": 6, "srcPort": 2, "dst": 7, "dstPort": 2},
-    {"src": 6, "srcPort": 3, "dst": 7, "dstPort": 3},
-    {"src": 6, "srcPort": 4, "dst": 7, "dstPort": 4},
-    {"src": 6, "srcPort": 5, "dst": 7, "dstPort": 5},
-    {"src": 6, "srcPort": 6, "dst": 7, "dstPort": 6},
-    {"src": 6, "srcPort": 7, "dst": 7, "dstPort": 7},
-    {"src": 8, "srcPort": 0, "dst": 7, "dstPort": 8},
-    {"src": 8, "srcPort": 1, "dst": 7, "dstPort": 9},
-    {"src": 8, "srcPort": 2, "dst": 7, "dstPort": 10},
-    {"src": 8, "srcPort": 3, "dst": 7, "dstPort": 11},
-    {"src": 8, "srcPort": 4, "dst": 7, "dstPort": 12},
-    {"src": 8, "srcPort": 5, "dst": 7, "dstPort": 13},
-    {"src": 8, "srcPort": 6, "dst": 7, "dstPort": 14},
-    {"src": 8, "srcPort": 7, "dst": 7, "dstPort": 15},
-    {"src": 7, "srcPort": 0, "dst": 10, "dstPort": 0},
-    {"src": 7, "srcPort": 1, "dst": 10, "dstPort": 1},
-    {"src": 10, "srcPort": 0, "dst": 2, "dstPort": 0},
-    {"src": 10, "srcPort": 1, "dst": 2, "dstPort": 1}
+  "connections": [)" +
+           connections + R"(
   ]
 })";
-
-    default:
-        return "";
-    }
 }
 
 } // namespace gsynth
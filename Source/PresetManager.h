@@ -20,6 +20,7 @@ public:
 
 private:
     static juce::String getPresetJSON(int index);
+    static juce::String getPolyPadPresetJSON();
 };
 
 } // namespace gsynth
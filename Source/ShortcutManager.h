@@ -3,7 +3,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 
 namespace GravisynthCommands {
-enum CommandIDs { openSettings = 0x100, savePreset, openPreset, undo, redo };
+enum CommandIDs { openSettings = 0x100, savePreset, openPreset, undo, redo, toggleTrace };
 
 inline juce::CommandID getCommandForAction(const juce::String& actionId) {
     if (actionId == "openSettings")
@@ -16,6 +16,8 @@ inline juce::CommandID getCommandForAction(const juce::String& actionId) {
         return undo;
     if (actionId == "redo")
         return redo;
+    if (actionId == "toggleTrace")
+        return toggleTrace;
     return 0;
 }
 } // namespace GravisynthCommands
@@ -85,6 +87,8 @@ public:
         bindings["undo"] = juce::KeyPress('z', juce::ModifierKeys::commandModifier, 0);
         bindings["redo"] =
             juce::KeyPress('z', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0);
+        bindings["toggleTrace"] =
+            juce::KeyPress('t', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0);
     }
 
     static juce::String keyPressToDisplayString(const juce::KeyPress& key) {
@@ -145,6 +149,8 @@ public:
             return "Undo";
         if (actionId == "redo")
             return "Redo";
+        if (actionId == "toggleTrace")
+            return "Start/Stop Trace Capture";
         return actionId;
     }
 
@@ -167,7 +173,7 @@ private:
     std::map<juce::String, juce::KeyPress> bindings;
     juce::ApplicationProperties* appProperties = nullptr;
 
-    juce::StringArray actionIds{"openSettings", "savePreset", "openPreset", "undo", "redo"};
+    juce::StringArray actionIds{"openSettings", "savePreset", "openPreset", "undo", "redo", "toggleTrace"};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ShortcutManager)
 };
@@ -0,0 +1,131 @@
+#include "SpectrumAnalyser.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+
+namespace gsynth {
+
+namespace {
+// A hop is ~5.8 ms at 44.1 kHz; polling a little faster keeps frames evenly spaced
+constexpr int kPollIntervalMs = 4;
+} // namespace
+
+SpectrumAnalyser::SpectrumAnalyser()
+    : juce::Thread("Spectrum Analyser")
+    , samples((size_t)kFftSize, 0.0f)
+    , fftData((size_t)kFftSize * 2, 0.0f) {}
+
+SpectrumAnalyser::~SpectrumAnalyser() {
+    stopThread(1000);
+
+    const juce::ScopedLock sl(lock);
+    for (auto& source : sources)
+        source.buffer->removeObserver(this);
+}
+
+SpectrumAnalyser::SubscriptionPtr SpectrumAnalyser::subscribe(VisualBuffer& buffer) {
+    auto subscription = std::make_shared<Subscription>();
+
+    {
+        const juce::ScopedLock sl(lock);
+        auto it = std::find_if(sources.begin(), sources.end(), [&](const Source& s) { return s.buffer == &buffer; });
+        if (it == sources.end()) {
+            Source source;
+            source.buffer = &buffer;
+            sources.push_back(std::move(source));
+            buffer.addObserver(this);
+            it = sources.end() - 1;
+        }
+        it->subscribers.push_back(subscription);
+    }
+
+    if (!isThreadRunning())
+        startThread(juce::Thread::Priority::low);
+    return subscription;
+}
+
+void SpectrumAnalyser::unsubscribe(const SubscriptionPtr& subscription) {
+    if (subscription == nullptr)
+        return;
+
+    const juce::ScopedLock sl(lock);
+    for (auto it = sources.begin(); it != sources.end(); ++it) {
+        auto& subs = it->subscribers;
+        subs.erase(std::remove(subs.begin(), subs.end(), subscription), subs.end());
+        if (subs.empty()) {
+            it->buffer->removeObserver(this);
+            sources.erase(it);
+            break;
+        }
+    }
+}
+
+int SpectrumAnalyser::getNumSources() const {
+    const juce::ScopedLock sl(lock);
+    return (int)sources.size();
+}
+
+int SpectrumAnalyser::analysePending() {
+    const juce::ScopedLock sl(lock);
+    int published = 0;
+
+    for (auto& source : sources) {
+        int size = source.buffer->getSize();
+        int writePos = source.buffer->getWritePosition();
+        if (source.lastWritePos < 0)
+            source.pendingSamples = kHopSize; // First frame as soon as possible
+        else
+            source.pendingSamples += (writePos - source.lastWritePos + size) % size;
+        source.lastWritePos = writePos;
+
+        if (source.pendingSamples < kHopSize)
+            continue;
+        source.pendingSamples = 0;
+
+        analyse(source);
+        ++published;
+    }
+    return published;
+}
+
+void SpectrumAnalyser::analyse(Source& source) {
+    GSYNTH_TRACE_SCOPE("ui", "SpectrumAnalyser::analyse");
+
+    // Most recent kFftSize samples, oldest first (zero-padded if the buffer is shorter)
+    std::fill(samples.begin(), samples.end(), 0.0f);
+    source.buffer->copyTo(samples);
+
+    std::fill(fftData.begin(), fftData.end(), 0.0f);
+    std::copy(samples.begin(), samples.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)kFftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    const float normFactor = 2.0f / (float)kFftSize;
+    const auto sequence = ++frameCounter;
+    for (auto& subscriber : source.subscribers) {
+        auto& frame = subscriber->frames.getWriteBuffer();
+        for (int bin = 0; bin < kNumBins; ++bin)
+            frame.magnitudes[(size_t)bin] = fftData[(size_t)bin] * normFactor;
+        frame.sequence = sequence;
+        subscriber->frames.publish();
+    }
+}
+
+void SpectrumAnalyser::run() {
+    TraceRecorder::getInstance().setCurrentThreadName("Spectrum Analyser");
+
+    while (!threadShouldExit()) {
+        analysePending();
+        wait(kPollIntervalMs);
+    }
+}
+
+void SpectrumAnalyser::visualBufferDeleted(VisualBuffer& buffer) {
+    // Taking the lock waits out any analysis pass that is reading this buffer.
+    // Its subscribers stay valid but receive no further frames.
+    const juce::ScopedLock sl(lock);
+    auto it = std::find_if(sources.begin(), sources.end(), [&](const Source& s) { return s.buffer == &buffer; });
+    if (it != sources.end())
+        sources.erase(it);
+}
+
+} // namespace gsynth
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Modules/VisualBuffer.h"
+#include "TripleBuffer.h"
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <vector>
+
+namespace gsynth {
+
+/**
+ * @class SpectrumAnalyser
+ * @brief Shared background FFT service for VisualBuffer sources.
+ *
+ * Views subscribe() to any module's VisualBuffer and poll their Subscription for
+ * new magnitude frames from the UI thread. A single worker thread analyses every
+ * subscribed buffer with a Hann window each time kHopSize new samples have arrived
+ * (75% overlap), using one preallocated workspace. Frames are handed to each
+ * subscriber through its own TripleBuffer, so readers never block the worker and
+ * nothing is allocated per frame. Several views on the same buffer share one FFT.
+ *
+ * Obtain it via juce::SharedResourcePointer<SpectrumAnalyser>. subscribe() and
+ * unsubscribe() are message-thread only.
+ */
+class SpectrumAnalyser
+    : private juce::Thread
+    , private VisualBuffer::Observer {
+public:
+    static constexpr int kFftOrder = 10;
+    static constexpr int kFftSize = 1 << kFftOrder;
+    static constexpr int kNumBins = kFftSize / 2;
+    static constexpr int kHopSize = kFftSize / 4;
+
+    struct Frame {
+        /** Linear magnitude per bin, scaled so a full-scale sine peaks near 1. */
+        std::array<float, kNumBins> magnitudes{};
+        juce::uint64 sequence = 0;
+    };
+
+    class Subscription {
+    public:
+        /** UI thread. The newest frame if one arrived since the last call, else nullptr. */
+        const Frame* readLatest() { return frames.update() ? &frames.getReadBuffer() : nullptr; }
+
+    private:
+        friend class SpectrumAnalyser;
+        TripleBuffer<Frame> frames;
+    };
+
+    using SubscriptionPtr = std::shared_ptr<Subscription>;
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    SubscriptionPtr subscribe(VisualBuffer& buffer);
+    void unsubscribe(const SubscriptionPtr& subscription);
+
+    /** Analyses every source with a hop's worth of new samples. Returns frames published. */
+    int analysePending();
+
+    int getNumSources() const;
+
+private:
+    struct Source {
+        VisualBuffer* buffer = nullptr;
+        int lastWritePos = -1;
+        int pendingSamples = 0;
+        std::vector<SubscriptionPtr> subscribers;
+    };
+
+    void run() override;
+    void visualBufferDeleted(VisualBuffer& buffer) override;
+    void analyse(Source& source);
+
+    juce::CriticalSection lock;
+    std::vector<Source> sources;
+    juce::uint64 frameCounter = 0;
+
+    // Worker workspace, sized once
+    juce::dsp::FFT fft{kFftOrder};
+    juce::dsp::WindowingFunction<float> window{(size_t)kFftSize, juce::dsp::WindowingFunction<float>::hann};
+    std::vector<float> samples;
+    std::vector<float> fftData;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
+
+} // namespace gsynth
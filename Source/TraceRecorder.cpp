@@ -0,0 +1,157 @@
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <juce_events/juce_events.h>
+#include <vector>
+
+namespace gsynth {
+
+thread_local TraceRecorder::ThreadLease TraceRecorder::lease;
+
+TraceRecorder::ThreadLease::~ThreadLease() {
+    if (ring != nullptr)
+        ring->inUse.store(false, std::memory_order_release);
+}
+
+TraceRecorder& TraceRecorder::getInstance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+void TraceRecorder::start() {
+    if (!allocated) {
+        for (auto& ring : rings)
+            ring.events = std::make_unique<Event[]>((size_t)kEventsPerThread);
+        allocated = true;
+    }
+
+    // Rings are never rewound (a writer may be mid-record); the epoch filters out older events instead
+    epochTicks.store(now(), std::memory_order_relaxed);
+    recording.store(true, std::memory_order_release);
+}
+
+TraceRecorder::ThreadRing* TraceRecorder::getRingForCurrentThread() noexcept {
+    if (lease.owner == this && lease.ring != nullptr)
+        return lease.ring;
+
+    // A thread that found every ring taken tries again, since rings come back as threads exit
+    lease.owner = this;
+    lease.ring = claimRing();
+    return lease.ring;
+}
+
+TraceRecorder::ThreadRing* TraceRecorder::claimRing() noexcept {
+    for (int index = 0; index < kMaxThreads; ++index) {
+        auto& ring = rings[(size_t)index];
+        bool expected = false;
+        if (ring.inUse.load(std::memory_order_relaxed) ||
+            !ring.inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            continue;
+
+        // Whatever an earlier owner left in the ring isn't this thread's
+        ring.firstIndex.store(ring.writeIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        ring.nameOverride.store(nullptr, std::memory_order_relaxed);
+
+        juce::String name;
+        if (juce::MessageManager::getInstanceWithoutCreating() != nullptr &&
+            juce::MessageManager::getInstanceWithoutCreating()->isThisTheMessageThread())
+            name = "Message";
+        else if (auto* thread = juce::Thread::getCurrentThread())
+            name = thread->getThreadName();
+        else
+            name = "Thread " + juce::String(index);
+        {
+            const juce::SpinLock::ScopedLockType lock(ring.nameLock);
+            name.copyToUTF8(ring.defaultName, sizeof(ring.defaultName));
+        }
+
+        ring.everClaimed.store(true, std::memory_order_release);
+        return &ring;
+    }
+    return nullptr; // Out of rings: this thread goes untraced until one is given back
+}
+
+void TraceRecorder::record(const char* category, const char* name, juce::int64 startTicks,
+                           juce::int64 endTicks) noexcept {
+    if (!recording.load(std::memory_order_acquire))
+        return;
+
+    auto* ring = getRingForCurrentThread();
+    if (ring == nullptr)
+        return;
+
+    auto w = ring->writeIndex.load(std::memory_order_relaxed);
+    ring->events[(size_t)(w & (kEventsPerThread - 1))] = {category, name, startTicks, endTicks};
+    ring->writeIndex.store(w + 1, std::memory_order_release);
+}
+
+void TraceRecorder::setCurrentThreadName(const char* name) noexcept {
+    if (!recording.load(std::memory_order_acquire))
+        return;
+
+    if (auto* ring = getRingForCurrentThread())
+        ring->nameOverride.store(name, std::memory_order_relaxed);
+}
+
+juce::String TraceRecorder::toChromeTraceJSON() const {
+    const auto epoch = epochTicks.load(std::memory_order_relaxed);
+    const double ticksToMicros = 1.0e6 / (double)juce::Time::getHighResolutionTicksPerSecond();
+
+    juce::MemoryOutputStream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&] {
+        if (!first)
+            out << ",";
+        first = false;
+    };
+
+    std::vector<Event> snapshot;
+    snapshot.reserve((size_t)kEventsPerThread);
+
+    for (int tid = 0; tid < kMaxThreads; ++tid) {
+        auto& ring = rings[(size_t)tid];
+        if (!ring.everClaimed.load(std::memory_order_acquire) || ring.events == nullptr)
+            continue;
+
+        juce::String threadName(ring.nameOverride.load(std::memory_order_relaxed));
+        if (threadName.isEmpty()) {
+            const juce::SpinLock::ScopedLockType lock(ring.nameLock);
+            threadName = ring.defaultName;
+        }
+        separator();
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":"
+            << juce::JSON::toString(threadName) << "}}";
+
+        // Copy the live window, then drop anything the writer may have overwritten meanwhile
+        auto end = ring.writeIndex.load(std::memory_order_acquire);
+        auto begin = end > (juce::uint64)kEventsPerThread ? end - (juce::uint64)kEventsPerThread : 0;
+        begin = std::max(begin, ring.firstIndex.load(std::memory_order_relaxed));
+        snapshot.clear();
+        for (auto i = begin; i < end; ++i)
+            snapshot.push_back(ring.events[(size_t)(i & (kEventsPerThread - 1))]);
+
+        // The writer may be mid-way through event `after`, which reuses the slot of after - kEventsPerThread
+        auto after = ring.writeIndex.load(std::memory_order_acquire);
+        auto firstIntact = after >= (juce::uint64)kEventsPerThread ? after - (juce::uint64)kEventsPerThread + 1 : 0;
+        auto skip = firstIntact > begin ? (size_t)(firstIntact - begin) : 0;
+
+        for (size_t i = skip; i < snapshot.size(); ++i) {
+            auto& e = snapshot[i];
+            if (e.startTicks < epoch)
+                continue;
+            separator();
+            auto ts = (double)(e.startTicks - epoch) * ticksToMicros;
+            auto dur = (double)(e.endTicks - e.startTicks) * ticksToMicros;
+            out << "{\"ph\":\"X\",\"cat\":\"" << e.category << "\",\"name\":\"" << e.name
+                << "\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << juce::String(ts, 3)
+                << ",\"dur\":" << juce::String(dur, 3) << "}";
+        }
+    }
+
+    out << "]}";
+    return out.toString();
+}
+
+bool TraceRecorder::writeChromeTrace(const juce::File& file) const { return file.replaceWithText(toChromeTraceJSON()); }
+
+} // namespace gsynth
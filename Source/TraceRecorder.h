@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_core/juce_core.h>
+#include <memory>
+
+#ifndef GRAVISYNTH_TRACING
+#define GRAVISYNTH_TRACING 1
+#endif
+
+namespace gsynth {
+
+/**
+ * @class TraceRecorder
+ * @brief Lock-free timeline recorder for the audio, UI and AI threads.
+ *
+ * Each thread writes completed scopes into its own fixed-size ring, so recording
+ * never locks or allocates once a thread has claimed its ring. A ring is given back
+ * when its thread exits and is reused by the next thread that needs one, so threads
+ * that come and go (audio device restarts, AI workers) don't use the rings up. Rings
+ * are allocated by start() on the calling thread; while stopped, a trace scope costs
+ * one relaxed atomic load. The collected timeline is exported as Chrome trace JSON, which opens
+ * in chrome://tracing and ui.perfetto.dev.
+ *
+ * Event names and categories must have static storage duration (string literals).
+ */
+class TraceRecorder {
+public:
+    static constexpr int kMaxThreads = 16;
+    static constexpr int kEventsPerThread = 1 << 13; // Per-thread ring; oldest events are overwritten
+
+    struct Event {
+        const char* category;
+        const char* name;
+        juce::int64 startTicks;
+        juce::int64 endTicks;
+    };
+
+    static TraceRecorder& getInstance();
+
+    /** Allocates the rings (first call only), discards earlier events and begins recording. */
+    void start();
+    void stop() { recording.store(false, std::memory_order_release); }
+    bool isRecording() const noexcept { return recording.load(std::memory_order_relaxed); }
+
+    /** Appends a completed scope to the calling thread's ring. Real-time safe. */
+    void record(const char* category, const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+
+    /** Labels the calling thread in the exported timeline (e.g. "Audio"). */
+    void setCurrentThreadName(const char* name) noexcept;
+
+    /**
+     * Snapshot of everything recorded since start(), as Chrome trace JSON. Safe while recording.
+     * A full ring exports its newest kEventsPerThread - 1 events: the oldest slot is the one a
+     * writer reuses next, and a write in progress doesn't move the write index until it's done.
+     */
+    juce::String toChromeTraceJSON() const;
+    bool writeChromeTrace(const juce::File& file) const;
+
+    static juce::int64 now() noexcept { return juce::Time::getHighResolutionTicks(); }
+
+private:
+    TraceRecorder() = default;
+
+    struct ThreadRing {
+        std::unique_ptr<Event[]> events;
+        std::atomic<juce::uint64> writeIndex{0};
+        std::atomic<juce::uint64> firstIndex{0}; // Earlier events belong to a thread that has exited
+        std::atomic<bool> inUse{false};
+        std::atomic<bool> everClaimed{false};
+        std::atomic<const char*> nameOverride{nullptr};
+        juce::SpinLock nameLock; // Guards defaultName, which is rewritten when the ring is reused
+        char defaultName[32] = {};
+    };
+
+    // Gives the calling thread's ring back when the thread exits
+    struct ThreadLease {
+        TraceRecorder* owner = nullptr;
+        ThreadRing* ring = nullptr;
+        ~ThreadLease();
+    };
+
+    ThreadRing* getRingForCurrentThread() noexcept;
+    ThreadRing* claimRing() noexcept;
+
+    static thread_local ThreadLease lease;
+
+    std::array<ThreadRing, kMaxThreads> rings;
+    std::atomic<bool> recording{false};
+    std::atomic<juce::int64> epochTicks{0};
+    bool allocated = false;
+
+    JUCE_DECLARE_NON_COPYABLE(TraceRecorder)
+};
+
+/** Records the enclosing scope as one complete event when tracing is active. */
+class ScopedTrace {
+public:
+    ScopedTrace(const char* category, const char* name) noexcept
+        : category(category)
+        , name(name)
+        , startTicks(TraceRecorder::getInstance().isRecording() ? TraceRecorder::now() : 0) {}
+
+    ~ScopedTrace() {
+        if (startTicks != 0)
+            TraceRecorder::getInstance().record(category, name, startTicks, TraceRecorder::now());
+    }
+
+private:
+    const char* category;
+    const char* name;
+    juce::int64 startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedTrace)
+};
+
+} // namespace gsynth
+
+#if GRAVISYNTH_TRACING
+#define GSYNTH_TRACE_SCOPE(category, name) gsynth::ScopedTrace JUCE_JOIN_MACRO(gsynthTrace_, __LINE__)(category, name)
+#else
+#define GSYNTH_TRACE_SCOPE(category, name)
+#endif
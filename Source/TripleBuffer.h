@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+namespace gsynth {
+
+/**
+ * @class TripleBuffer
+ * @brief Lock-free latest-value handoff between one writer and one reader.
+ *
+ * The writer fills getWriteBuffer() and publish()es it; the reader calls update()
+ * and then reads getReadBuffer(). Three slots mean neither side ever waits or sees
+ * a half-written value: the writer always owns one slot, the reader another, and the
+ * third holds the most recent publication. Intermediate frames the reader never
+ * picked up are simply overwritten.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /** Writer only. Slot to fill before publish(); contents are whatever was there before. */
+    T& getWriteBuffer() { return slots[writeIndex]; }
+
+    /** Writer only. Makes the write buffer the latest value and takes a free slot to write next. */
+    void publish() {
+        int previous = middle.exchange(writeIndex | kFreshBit, std::memory_order_acq_rel);
+        writeIndex = previous & kIndexMask;
+    }
+
+    /** Reader only. Picks up the latest published value; returns false if nothing new arrived. */
+    bool update() {
+        if ((middle.load(std::memory_order_acquire) & kFreshBit) == 0)
+            return false;
+        int previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & kIndexMask;
+        return true;
+    }
+
+    /** Reader only. The value picked up by the last successful update(). */
+    const T& getReadBuffer() const { return slots[readIndex]; }
+
+private:
+    static constexpr int kFreshBit = 4;
+    static constexpr int kIndexMask = 3;
+
+    std::array<T, 3> slots{};
+    int writeIndex = 0;
+    alignas(64) std::atomic<int> middle{1};
+    alignas(64) int readIndex = 2;
+};
+
+} // namespace gsynth
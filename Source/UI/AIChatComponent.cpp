@@ -26,9 +26,17 @@ juce::StringArray extractJSONBlocks(const juce::String& text) {
 //==============================================================================
 class AIChatComponent::PatchCard : public juce::Component {
 public:
-    PatchCard(const juce::String& json, std::function<void()> applyCallback, bool isMerge)
+    struct Actions {
+        std::function<void()> apply;
+        std::function<void()> audition;
+        std::function<void()> play;
+    };
+
+    PatchCard(const juce::String& json, Actions cardActions, bool isMerge, bool isAuditioning,
+              std::shared_ptr<const AuditionReport> auditionReport)
         : patchJson(json)
-        , onApply(applyCallback) {
+        , actions(std::move(cardActions))
+        , report(std::move(auditionReport)) {
 
         addAndMakeVisible(headerLabel);
         headerLabel.setText(isMerge ? "Patch Update" : "New Patch", juce::dontSendNotification);
@@ -50,7 +58,32 @@ public:
         applyButton.setButtonText(isMerge ? "Merge" : "New Patch");
         applyButton.setColour(juce::TextButton::buttonColourId,
                               isMerge ? juce::Colour(0xFF8B6914) : juce::Colours::darkgreen);
-        applyButton.onClick = onApply;
+        applyButton.onClick = actions.apply;
+
+        addAndMakeVisible(auditionButton);
+        auditionButton.setButtonText("Audition");
+        auditionButton.setTooltip("Render a preview in a sandbox and check it before applying");
+        auditionButton.setEnabled(!isAuditioning);
+        auditionButton.onClick = actions.audition;
+
+        addChildComponent(playButton);
+        playButton.setButtonText("Play");
+        playButton.onClick = actions.play;
+        playButton.setVisible(report != nullptr && report->built);
+
+        addChildComponent(auditionLabel);
+        auditionLabel.setFont(juce::Font(11.0f));
+        if (isAuditioning) {
+            auditionLabel.setText("Auditioning...", juce::dontSendNotification);
+            auditionLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+            auditionLabel.setVisible(true);
+        } else if (report != nullptr) {
+            auditionLabel.setText(report->getSummary(), juce::dontSendNotification);
+            auditionLabel.setTooltip(report->getSummary());
+            auditionLabel.setColour(juce::Label::textColourId,
+                                    report->safe ? juce::Colours::lightgreen : juce::Colours::orange);
+            auditionLabel.setVisible(true);
+        }
 
         addAndMakeVisible(jsonDisplay);
         jsonDisplay.setMultiLine(true);
@@ -65,10 +98,15 @@ public:
         auto header = b.removeFromTop(25);
         headerLabel.setBounds(header.removeFromLeft(120));
 
-        auto buttons = header.removeFromRight(180);
+        auto buttons = header.removeFromRight(310);
         applyButton.setBounds(buttons.removeFromRight(80).reduced(2));
+        auditionButton.setBounds(buttons.removeFromRight(80).reduced(2));
+        playButton.setBounds(buttons.removeFromRight(50).reduced(2));
         expandButton.setBounds(buttons.removeFromRight(90).reduced(2));
 
+        if (auditionLabel.isVisible())
+            auditionLabel.setBounds(b.removeFromTop(kAuditionLineHeight));
+
         if (isExpanded) {
             b.removeFromTop(5);
             jsonDisplay.setVisible(true);
@@ -78,23 +116,31 @@ public:
         }
     }
 
-    int getRequiredHeight() const { return isExpanded ? 200 : 35; }
+    int getRequiredHeight() const {
+        return (isExpanded ? 200 : 35) + (auditionLabel.isVisible() ? kAuditionLineHeight : 0);
+    }
 
 private:
+    static constexpr int kAuditionLineHeight = 20;
+
     juce::String patchJson;
-    std::function<void()> onApply;
+    Actions actions;
+    std::shared_ptr<const AuditionReport> report;
     bool isExpanded = false;
 
     juce::Label headerLabel;
     juce::TextButton expandButton;
+    juce::TextButton auditionButton;
+    juce::TextButton playButton;
     juce::TextButton applyButton;
+    juce::Label auditionLabel;
     juce::TextEditor jsonDisplay;
 };
 
 //==============================================================================
 class AIChatComponent::MessageBubble : public juce::Component {
 public:
-    MessageBubble(const MessageData& data, std::function<void(const juce::String&)> applyPatch, bool isMerge) {
+    MessageBubble(const MessageData& data, PatchCard::Actions patchActions, bool isMerge) {
         role = data.role;
         text = data.text;
 
@@ -104,8 +150,8 @@ public:
         textLabel.setJustificationType(juce::Justification::topLeft);
 
         if (data.jsonPatch.isNotEmpty()) {
-            patchCard = std::make_unique<PatchCard>(
-                data.jsonPatch, [applyPatch, json = data.jsonPatch]() { applyPatch(json); }, isMerge);
+            patchCard = std::make_unique<PatchCard>(data.jsonPatch, std::move(patchActions), isMerge,
+                                                    data.isAuditioning, data.audition);
             addAndMakeVisible(*patchCard);
         }
     }
@@ -187,6 +233,7 @@ AIChatComponent::AIChatComponent(AIIntegrationService& service)
     toggleDebugButton.onClick = [this]() {
         debugConsoleVisible = !debugConsoleVisible;
         debugConsole.setVisible(debugConsoleVisible);
+        AIStateMapper::setVerboseLogging(debugConsoleVisible);
         resized();
     };
     addAndMakeVisible(toggleDebugButton);
@@ -243,6 +290,7 @@ AIChatComponent::~AIChatComponent() {
 void AIChatComponent::timerCallback() {
     // If the timer fires, the request has timed out
     stopTimer();
+    aiService.cancelPendingRequests(); // Free the provider's worker for the next request
     sendButton.setEnabled(true);
     inputField.setReadOnly(false);
     isWaitingForResponse = false;
@@ -318,6 +366,7 @@ void AIChatComponent::sendButtonClicked() {
     // Add user message to local state immediately
     messages.push_back({"user", text, ""});
     isWaitingForResponse = true;
+    streamingText.clear();
     updateChatDisplay();
 
     sendButton.setEnabled(false);
@@ -326,6 +375,8 @@ void AIChatComponent::sendButtonClicked() {
     // Start timeout timer (120 seconds)
     startTimer(120000);
 
+    // Tokens already arrive on the message thread, so the UI is updated in place
+    juce::Component::SafePointer<AIChatComponent> safeThis(this);
     aiService.sendMessage(
         text,
         [this, useStructuredOutput](const juce::String& response, bool success) {
@@ -341,6 +392,7 @@ void AIChatComponent::sendButtonClicked() {
 
                 self->stopTimer(); // Cancel timeout
                 self->isWaitingForResponse = false;
+                self->streamingText.clear();
                 self->sendButton.setEnabled(true);
                 self->inputField.setReadOnly(false);
 
@@ -379,11 +431,35 @@ void AIChatComponent::sendButtonClicked() {
                 self->inputField.grabKeyboardFocus();
             });
         },
-        useStructuredOutput);
+        useStructuredOutput,
+        [safeThis](const juce::String& token) {
+            if (auto* self = safeThis.getComponent(); self != nullptr && self->isWaitingForResponse) {
+                self->streamingText += token;
+                self->updateStreamingLabel();
+            }
+        });
+}
+
+void AIChatComponent::updateStreamingLabel() {
+    if (streamingLabel == nullptr)
+        return;
+
+    if (streamingText.isEmpty()) {
+        streamingLabel->setText("AI is thinking...", juce::dontSendNotification);
+        return;
+    }
+
+    // Show the tail of the text as it streams in; the full reply replaces it when complete
+    constexpr int kPreviewChars = 80;
+    auto preview = streamingText.replaceCharacters("\r\n", "  ").trimStart();
+    if (preview.length() > kPreviewChars)
+        preview = "..." + preview.getLastCharacters(kPreviewChars);
+    streamingLabel->setText(preview, juce::dontSendNotification);
 }
 
 void AIChatComponent::updateChatDisplay() {
     messageList.deleteAllChildren();
+    streamingLabel = nullptr;
 
     for (size_t i = 0; i < messages.size(); ++i) {
         const auto& data = messages[i];
@@ -424,30 +500,66 @@ void AIChatComponent::updateChatDisplay() {
             }
         }
 
-        auto* bubble = new MessageBubble(
-            data,
-            [this, isMerge](const juce::String& json) {
-                juce::Logger::writeToLog("--- Applying patch (merge=" + juce::String(isMerge ? "true" : "false") +
-                                         ") ---");
-                juce::Logger::writeToLog("JSON: " + json);
-                aiService.applyPatch(json, isMerge);
-                juce::Logger::writeToLog("--- Patch applied ---");
-            },
-            isMerge);
+        PatchCard::Actions actions;
+        actions.apply = [this, isMerge, json = data.jsonPatch]() {
+            juce::Logger::writeToLog("--- Applying patch (merge=" + juce::String(isMerge ? "true" : "false") + ") ---");
+            juce::Logger::writeToLog("JSON: " + json);
+            aiService.applyPatch(json, isMerge);
+            juce::Logger::writeToLog("--- Patch applied ---");
+        };
+        actions.audition = [this, i, isMerge]() { auditionMessagePatch(i, isMerge); };
+        actions.play = [this, report = data.audition]() {
+            if (report != nullptr && onPlayPreview)
+                onPlayPreview(report->preview, report->sampleRate);
+        };
+
+        auto* bubble = new MessageBubble(data, std::move(actions), isMerge);
         messageList.addAndMakeVisible(bubble);
     }
 
     if (isWaitingForResponse) {
         auto* loading = new juce::Label();
         messageList.addAndMakeVisible(loading);
-        loading->setText("AI is thinking...", juce::dontSendNotification);
         loading->setColour(juce::Label::textColourId, juce::Colours::grey);
+        streamingLabel = loading;
+        updateStreamingLabel();
     }
 
     resized();
     scrollToBottom();
 }
 
+void AIChatComponent::auditionMessagePatch(size_t messageIndex, bool isMerge) {
+    if (messageIndex >= messages.size() || messages[messageIndex].isAuditioning)
+        return;
+
+    auto& data = messages[messageIndex];
+    data.isAuditioning = true;
+    data.audition = nullptr;
+    juce::Logger::writeToLog("--- Auditioning patch (merge=" + juce::String(isMerge ? "true" : "false") + ") ---");
+
+    aiService.auditionPatch(
+        data.jsonPatch, isMerge,
+        [safeThis = juce::Component::SafePointer<AIChatComponent>(this), messageIndex,
+         json = data.jsonPatch](std::shared_ptr<const AuditionReport> report) {
+            if (safeThis == nullptr || messageIndex >= safeThis->messages.size())
+                return;
+            auto& message = safeThis->messages[messageIndex];
+            if (message.jsonPatch != json)
+                return; // The chat was cleared or replaced meanwhile
+            message.isAuditioning = false;
+            message.audition = std::move(report);
+            juce::Logger::writeToLog("Audition: " + message.audition->getSummary());
+            safeThis->updateChatDisplay();
+        });
+
+    // Rebuilding the bubbles deletes the button that got us here, so do it once the click has returned
+    juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<AIChatComponent>(this)]() {
+        if (safeThis != nullptr)
+            safeThis->updateChatDisplay();
+    });
+}
+
 void AIChatComponent::scrollToBottom() { viewport.setViewPosition(0, messageList.getHeight()); }
 
 void AIChatComponent::refreshModels() {
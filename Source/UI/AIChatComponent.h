@@ -27,6 +27,9 @@ public:
 
     void refreshModels();
 
+    /** Called with an audition's preview when the user presses Play on a patch card. */
+    std::function<void(const juce::AudioBuffer<float>& preview, double sampleRate)> onPlayPreview;
+
 private:
     void timerCallback() override;
     class MessageBubble;
@@ -34,6 +37,8 @@ private:
 
     AIIntegrationService& aiService;
     bool isWaitingForResponse = false;
+    juce::String streamingText;           // Partial response received so far
+    juce::Label* streamingLabel = nullptr; // Owned by messageList while waiting
 
     juce::Viewport viewport;
     juce::Component messageList;
@@ -43,13 +48,17 @@ private:
 
     void sendButtonClicked();
     void updateChatDisplay();
+    void updateStreamingLabel();
     void scrollToBottom();
+    void auditionMessagePatch(size_t messageIndex, bool isMerge);
 
     struct MessageData {
         juce::String role;
         juce::String text;
         juce::String jsonPatch;
         bool isExpanded = false;
+        bool isAuditioning = false;
+        std::shared_ptr<const AuditionReport> audition;
     };
     std::vector<MessageData> messages;
 
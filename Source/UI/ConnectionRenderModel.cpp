@@ -0,0 +1,143 @@
+#include "ConnectionRenderModel.h"
+#include "../ModMatrixRoutes.h"
+#include "../Modules/ModMatrixModule.h"
+#include "../TraceRecorder.h"
+#include "ModuleComponent.h"
+
+namespace {
+
+struct NodeInfo {
+    ModuleComponent* component = nullptr;
+    juce::AudioProcessorGraph::Node* node = nullptr;
+    ModMatrixModule* matrix = nullptr;
+    int visibleInputs = -1; // -1: not a ModuleBase, no limit
+    int visibleOutputs = -1;
+};
+
+bool isHiddenPort(int channel, int visibleCount) {
+    return channel != juce::AudioProcessorGraph::midiChannelIndex && visibleCount >= 0 && channel >= visibleCount;
+}
+
+juce::Point<float> portPosition(ModuleComponent& comp, int channel, bool isInput) {
+    juce::Point<int> local;
+    if (channel == juce::AudioProcessorGraph::midiChannelIndex)
+        local = isInput ? juce::Point<int>(10, 30) : comp.getPortCenter(0, false);
+    else
+        local = comp.getPortCenter(channel, isInput);
+    return (comp.getBounds().getPosition() + local).toFloat();
+}
+
+juce::uint64 slotKey(const juce::AudioProcessorGraph::NodeAndChannel& slot) {
+    return ((juce::uint64)slot.nodeID.uid << 32) | (juce::uint32)slot.channelIndex;
+}
+
+} // namespace
+
+bool ConnectionRenderModel::ensureUpToDate(const juce::AudioProcessorGraph& graph,
+                                           const juce::OwnedArray<ModuleComponent>& modules) {
+    if (!dirty)
+        return false;
+    rebuild(graph, modules);
+    dirty = false;
+    return true;
+}
+
+void ConnectionRenderModel::rebuild(const juce::AudioProcessorGraph& graph,
+                                    const juce::OwnedArray<ModuleComponent>& modules) {
+    GSYNTH_TRACE_SCOPE("ui", "ConnectionRenderModel::rebuild");
+    cables.clear();
+
+    std::unordered_map<juce::AudioProcessor*, ModuleComponent*> componentForProcessor;
+    for (auto* comp : modules)
+        componentForProcessor[comp->getModule()] = comp;
+
+    std::unordered_map<juce::uint32, NodeInfo> nodes;
+    for (auto* node : graph.getNodes()) {
+        NodeInfo info;
+        auto* processor = node->getProcessor();
+        auto it = componentForProcessor.find(processor);
+        info.component = it != componentForProcessor.end() ? it->second : nullptr;
+        info.node = node;
+        info.matrix = dynamic_cast<ModMatrixModule*>(processor);
+        if (auto* mb = dynamic_cast<ModuleBase*>(processor)) {
+            info.visibleInputs = mb->getVisibleInputPortCount();
+            info.visibleOutputs = mb->getVisibleOutputPortCount();
+        }
+        nodes[node->nodeID.uid] = info;
+    }
+
+    auto connections = graph.getConnections();
+
+    // First outgoing connection of each mod matrix slot: where its route lands
+    std::unordered_map<juce::uint64, juce::AudioProcessorGraph::NodeAndChannel> slotTarget;
+    for (auto& c : connections) {
+        auto it = nodes.find(c.source.nodeID.uid);
+        if (it != nodes.end() && it->second.matrix != nullptr)
+            slotTarget.emplace(slotKey(c.source), c.destination);
+    }
+
+    auto addCable = [this](juce::Point<float> p1, juce::Point<float> p2) -> Cable& {
+        Cable cable;
+        cable.line = {p1, p2};
+        cable.path.startNewSubPath(p1);
+        cable.path.lineTo(p2);
+        return cables.emplace_back(std::move(cable));
+    };
+
+    cables.reserve(connections.size());
+    for (auto& c : connections) {
+        auto srcIt = nodes.find(c.source.nodeID.uid);
+        auto dstIt = nodes.find(c.destination.nodeID.uid);
+        if (srcIt == nodes.end() || dstIt == nodes.end())
+            continue;
+        auto& src = srcIt->second;
+        auto& dst = dstIt->second;
+
+        // Hide poly connections that exceed visible port counts
+        if (isHiddenPort(c.source.channelIndex, src.visibleOutputs) ||
+            isHiddenPort(c.destination.channelIndex, dst.visibleInputs))
+            continue;
+
+        if (dst.matrix != nullptr) {
+            // Draw source -> final destination, skipping the (hidden) mod matrix
+            auto target = slotTarget.find(slotKey(c.destination));
+            if (target == slotTarget.end())
+                continue;
+            auto realDst = nodes.find(target->second.nodeID.uid);
+            if (src.component == nullptr || realDst == nodes.end() || realDst->second.component == nullptr)
+                continue;
+            auto& cable = addCable(portPosition(*src.component, c.source.channelIndex, false),
+                                   portPosition(*realDst->second.component, target->second.channelIndex, true));
+            cable.isModulation = true;
+            cable.routeID = gsynth::makeModRouteID(c.destination.nodeID, c.destination.channelIndex);
+            cable.amount = &dst.matrix->getAmountParameter(c.destination.channelIndex);
+            cable.matrixNode = dst.node;
+            continue;
+        }
+
+        if (src.matrix != nullptr || src.component == nullptr || dst.component == nullptr)
+            continue;
+
+        addCable(portPosition(*src.component, c.source.channelIndex, false),
+                 portPosition(*dst.component, c.destination.channelIndex, true));
+    }
+}
+
+const ConnectionRenderModel::Cable* ConnectionRenderModel::findModulationCableAt(juce::Point<float> pos,
+                                                                                 float radius) const {
+    for (auto& cable : cables)
+        if (cable.isModulation && cable.line.getPointAlongLineProportionally(0.5f).getDistanceFrom(pos) <= radius)
+            return &cable;
+    return nullptr;
+}
+
+void ConnectionRenderModel::setModulationDisplayInfo(const std::vector<AudioEngine::ModulationDisplayInfo>& info) {
+    modPeaks.clear();
+    for (auto& i : info)
+        modPeaks[i.routeID.uid] = i.modSignalPeak;
+}
+
+float ConnectionRenderModel::getModulationPeak(NodeID routeID) const {
+    auto it = modPeaks.find(routeID.uid);
+    return it != modPeaks.end() ? it->second : 0.0f;
+}
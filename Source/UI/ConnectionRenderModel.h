@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../AudioEngine.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <unordered_map>
+#include <vector>
+
+class ModuleComponent;
+
+/**
+ * @class ConnectionRenderModel
+ * @brief Cached cable geometry for GraphEditor.
+ *
+ * Resolves every visible connection to content-space endpoints once, using
+ * NodeID-keyed indices, so painting and hit-testing are O(cables) instead of
+ * rescanning the graph and module components per connection. Call invalidate()
+ * on topology or layout changes; the next ensureUpToDate() rebuilds in O(N + E).
+ */
+class ConnectionRenderModel {
+public:
+    using NodeID = juce::AudioProcessorGraph::NodeID;
+
+    struct Cable {
+        juce::Line<float> line;
+        juce::Path path;
+        bool isModulation = false;
+        NodeID routeID; // Modulation cables only: the mod matrix route the cable stands for
+
+        // Modulation cables only: the route's Amount, resolved at rebuild so painting never looks it up.
+        // The node reference keeps the parameter alive until the next rebuild, even if the matrix is removed.
+        juce::AudioParameterFloat* amount = nullptr;
+        juce::AudioProcessorGraph::Node::Ptr matrixNode;
+    };
+
+    void invalidate() { dirty = true; }
+    bool isDirty() const { return dirty; }
+
+    /** Rebuilds the cables if invalidated. Returns true if a rebuild happened. */
+    bool ensureUpToDate(const juce::AudioProcessorGraph& graph, const juce::OwnedArray<ModuleComponent>& modules);
+
+    const std::vector<Cable>& getCables() const { return cables; }
+
+    /** Modulation cable whose midpoint knob lies within radius of pos, or nullptr. */
+    const Cable* findModulationCableAt(juce::Point<float> pos, float radius) const;
+
+    /** Latest per-route signal peaks, refreshed from the editor's timer. */
+    void setModulationDisplayInfo(const std::vector<AudioEngine::ModulationDisplayInfo>& info);
+    float getModulationPeak(NodeID routeID) const;
+
+private:
+    void rebuild(const juce::AudioProcessorGraph& graph, const juce::OwnedArray<ModuleComponent>& modules);
+
+    std::vector<Cable> cables;
+    std::unordered_map<juce::uint32, float> modPeaks;
+    bool dirty = true;
+};
@@ -0,0 +1,123 @@
+#include "FrameClock.h"
+#include "../TraceRecorder.h"
+#include <algorithm>
+
+namespace {
+// After this long without a vblank (window hidden, display asleep) the timer takes over
+constexpr double kVBlankTimeoutMs = 100.0;
+} // namespace
+
+FrameClock::FrameClock() = default;
+
+FrameClock::~FrameClock() {
+    stopTimer();
+    vblank.reset();
+}
+
+void FrameClock::addClient(Client& client, int hz, juce::Component* visibleComponent) {
+    jassert(hz > 0);
+    removeClient(client);
+
+    Entry entry;
+    entry.client = &client;
+    entry.visibleComponent = visibleComponent;
+    entry.hasVisibleComponent = visibleComponent != nullptr;
+    entry.intervalMs = 1000.0 / (double)std::max(1, hz);
+    entry.nextDueMs = 0.0; // Due on the next frame
+    entries.push_back(entry);
+    updateTimer();
+}
+
+void FrameClock::removeClient(Client& client) {
+    for (auto& entry : entries) {
+        if (entry.client == &client) {
+            // Clients may unregister from inside onFrame(); compact once the pass is over
+            entry.client = nullptr;
+            needsCompaction = true;
+        }
+    }
+
+    if (!ticking && needsCompaction) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry& e) { return e.client == nullptr; }),
+                      entries.end());
+        needsCompaction = false;
+    }
+    updateTimer();
+}
+
+int FrameClock::getNumClients() const {
+    return (int)std::count_if(entries.begin(), entries.end(), [](const Entry& e) { return e.client != nullptr; });
+}
+
+void FrameClock::attachToDisplay(juce::Component& host) {
+    vblank = std::make_unique<juce::VBlankAttachment>(&host, [this] {
+        lastVBlankMs = juce::Time::getMillisecondCounterHiRes();
+        tick(lastVBlankMs);
+    });
+}
+
+void FrameClock::detachFromDisplay() { vblank.reset(); }
+
+void FrameClock::tick(double nowMs) {
+    GSYNTH_TRACE_SCOPE("ui", "FrameClock::tick");
+
+    if (lastTickMs > 0.0 && nowMs > lastTickMs)
+        frameDeltaMs = nowMs - lastTickMs;
+    lastTickMs = nowMs;
+
+    // Fire anything due within half a frame, so a 30 Hz client on a 60 Hz display
+    // lands on every other vblank despite jitter
+    const double horizonMs = nowMs + frameDeltaMs * 0.5;
+
+    ticking = true;
+    const size_t count = entries.size(); // Clients added during the pass start next frame
+    for (size_t i = 0; i < count; ++i) {
+        auto& entry = entries[i];
+        if (entry.client == nullptr || horizonMs < entry.nextDueMs)
+            continue;
+
+        if (entry.hasVisibleComponent) {
+            auto* comp = entry.visibleComponent.getComponent();
+            if (comp == nullptr || !isOnScreen(*comp))
+                continue; // Stays due, so it refreshes as soon as it becomes visible
+        }
+
+        entry.nextDueMs += entry.intervalMs;
+        if (entry.nextDueMs <= nowMs)
+            entry.nextDueMs = nowMs + entry.intervalMs;
+
+        entries[i].client->onFrame(nowMs);
+    }
+    ticking = false;
+
+    if (needsCompaction) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry& e) { return e.client == nullptr; }),
+                      entries.end());
+        needsCompaction = false;
+    }
+}
+
+bool FrameClock::isOnScreen(juce::Component& component) {
+    if (!component.isShowing())
+        return false;
+
+    juce::RectangleList<int> visible;
+    component.getVisibleArea(visible, false);
+    return !visible.isEmpty();
+}
+
+void FrameClock::timerCallback() {
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    if (vblank != nullptr && now - lastVBlankMs < kVBlankTimeoutMs)
+        return;
+    tick(now);
+}
+
+void FrameClock::updateTimer() {
+    if (getNumClients() > 0) {
+        if (!isTimerRunning())
+            startTimerHz(kFallbackHz);
+    } else {
+        stopTimer();
+    }
+}
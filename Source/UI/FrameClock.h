@@ -0,0 +1,78 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <memory>
+#include <vector>
+
+/**
+ * @class FrameClock
+ * @brief Single display-aligned frame scheduler shared by all animated UI.
+ *
+ * Instead of every component running its own juce::Timer, clients register with
+ * the shared clock and a target rate. Each frame the clock walks its clients in one
+ * pass, calling only those that are due and whose component is actually visible on
+ * screen. Clients poll their visual sources in onFrame() and call repaint() on just
+ * the regions that changed; the window's peer merges those into one dirty region
+ * and paints it once per frame.
+ *
+ * Frames come from a juce::VBlankAttachment once attachToDisplay() is given a
+ * component on the desktop, with a 60 Hz timer as the fallback (e.g. before the
+ * window is shown, or headless in tests). Obtain it via
+ * juce::SharedResourcePointer<FrameClock>. Message thread only.
+ */
+class FrameClock : private juce::Timer {
+public:
+    class Client {
+    public:
+        virtual ~Client() = default;
+
+        /** Called on the message thread when this client is due. nowMs is the frame's timestamp. */
+        virtual void onFrame(double nowMs) = 0;
+    };
+
+    static constexpr int kFallbackHz = 60;
+
+    FrameClock();
+    ~FrameClock() override;
+
+    /**
+     * Registers a client at the given rate. If visibleComponent is set, the client is
+     * skipped while that component is hidden or scrolled/clipped out of view.
+     */
+    void addClient(Client& client, int hz, juce::Component* visibleComponent = nullptr);
+    void removeClient(Client& client);
+    int getNumClients() const;
+
+    /** Drives frames from the display's vertical blank of the window containing host. */
+    void attachToDisplay(juce::Component& host);
+    void detachFromDisplay();
+
+    /** Runs one frame. Called by the vblank/timer sources; public so tests can step time. */
+    void tick(double nowMs);
+
+    /** True if the component is showing and some part of it is inside its window. */
+    static bool isOnScreen(juce::Component& component);
+
+private:
+    struct Entry {
+        Client* client = nullptr;
+        juce::Component::SafePointer<juce::Component> visibleComponent;
+        bool hasVisibleComponent = false;
+        double intervalMs = 0.0;
+        double nextDueMs = 0.0;
+    };
+
+    void timerCallback() override;
+    void updateTimer();
+
+    std::vector<Entry> entries;
+    bool ticking = false;
+    bool needsCompaction = false;
+
+    std::unique_ptr<juce::VBlankAttachment> vblank;
+    double lastVBlankMs = 0.0;
+    double lastTickMs = 0.0;
+    double frameDeltaMs = 1000.0 / kFallbackHz;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameClock)
+};
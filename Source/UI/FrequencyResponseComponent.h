@@ -2,31 +2,43 @@
 
 #include "../Modules/FilterModule.h"
 #include "../Modules/VisualBuffer.h"
+#include "../SpectrumAnalyser.h"
+#include "FrameClock.h"
 #include <cmath>
-#include <juce_dsp/juce_dsp.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 
 class FrequencyResponseComponent
     : public juce::Component
-    , public juce::Timer {
+    , public FrameClock::Client {
 public:
     FrequencyResponseComponent(FilterModule& filter)
         : filterModule(filter) {
         magnitudes.resize(numPoints, 0.0f);
-        fftData.resize(fftSize * 2, 0.0f);
         spectrumMagnitudes.resize(numPoints, -80.0f);
-        startTimerHz(30);
+        binPositions.resize(numPoints, 0.0f);
+        frameClock->addClient(*this, 30, this);
     }
 
-    ~FrequencyResponseComponent() override { stopTimer(); }
+    ~FrequencyResponseComponent() override {
+        frameClock->removeClient(*this);
+        analyser->unsubscribe(spectrum);
+    }
 
     void setShowSpectrum(bool show) {
         showSpectrum = show;
+        // Only subscribed while visible, so hidden spectra cost the analyser nothing
+        if (show && spectrum == nullptr) {
+            if (auto* vb = filterModule.getVisualBuffer())
+                spectrum = analyser->subscribe(*vb);
+        } else if (!show && spectrum != nullptr) {
+            analyser->unsubscribe(spectrum);
+            spectrum = nullptr;
+        }
         repaint();
     }
     bool getShowSpectrum() const { return showSpectrum; }
 
-    void timerCallback() override {
+    void onFrame(double) override {
         float cutoff = filterModule.getCurrentCutoff();
         float resonance = filterModule.getCurrentResonance();
         float drive = filterModule.getCurrentDrive();
@@ -41,49 +53,33 @@ public:
             repaint();
         }
 
-        // Update spectrum from audio data
-        if (showSpectrum && filterModule.getVisualBuffer()) {
-            auto* vb = filterModule.getVisualBuffer();
-            std::vector<float> samples(vb->getSize(), 0.0f);
-            vb->copyTo(samples);
-
-            // Fill FFT buffer (zero-pad if needed)
-            std::fill(fftData.begin(), fftData.end(), 0.0f);
-            int copySize = std::min((int)samples.size(), fftSize);
-            for (int i = 0; i < copySize; ++i)
-                fftData[i] = samples[i];
-
-            // Apply window and perform FFT
-            window.multiplyWithWindowingTable(fftData.data(), fftSize);
-            fft.performFrequencyOnlyForwardTransform(fftData.data());
-
-            // Convert to dB at log-spaced frequency points
-            double sampleRate = filterModule.getLastSampleRate();
-            float binWidth = static_cast<float>(sampleRate) / static_cast<float>(fftSize);
-            float normFactor = 2.0f / static_cast<float>(fftSize);
-
-            for (int i = 0; i < numPoints; ++i) {
-                float freq = indexToFreq(i);
-                float exactBin = freq / binWidth;
-                int bin0 = static_cast<int>(exactBin);
-                int bin1 = bin0 + 1;
-                float frac = exactBin - static_cast<float>(bin0);
-
-                float mag = 0.0f;
-                if (bin0 >= 0 && bin1 < fftSize / 2) {
-                    mag = fftData[bin0] * (1.0f - frac) + fftData[bin1] * frac;
-                } else if (bin0 >= 0 && bin0 < fftSize / 2) {
-                    mag = fftData[bin0];
+        // Pick up the newest analysed frame, if any (FFT runs on the shared analyser thread)
+        if (spectrum != nullptr) {
+            if (auto* frame = spectrum->readLatest()) {
+                updateBinPositions(filterModule.getLastSampleRate());
+                constexpr float normFloor = 0.00001f;
+
+                for (int i = 0; i < numPoints; ++i) {
+                    float exactBin = binPositions[(size_t)i];
+                    int bin0 = static_cast<int>(exactBin);
+                    int bin1 = bin0 + 1;
+                    float frac = exactBin - static_cast<float>(bin0);
+
+                    float mag = 0.0f;
+                    if (bin0 >= 0 && bin1 < kNumBins) {
+                        mag = frame->magnitudes[(size_t)bin0] * (1.0f - frac) + frame->magnitudes[(size_t)bin1] * frac;
+                    } else if (bin0 >= 0 && bin0 < kNumBins) {
+                        mag = frame->magnitudes[(size_t)bin0];
+                    }
+
+                    float db = 20.0f * std::log10(std::max(mag, normFloor));
+                    float target = juce::jlimit(-80.0f, 0.0f, db);
+                    // Smooth the spectrum (exponential moving average)
+                    spectrumMagnitudes[i] += 0.3f * (target - spectrumMagnitudes[i]);
                 }
-                mag *= normFactor;
 
-                float db = 20.0f * std::log10(std::max(mag, 0.00001f));
-                float target = juce::jlimit(-80.0f, 0.0f, db);
-                // Smooth the spectrum (exponential moving average)
-                spectrumMagnitudes[i] += 0.3f * (target - spectrumMagnitudes[i]);
+                repaint();
             }
-
-            repaint();
         }
     }
 
@@ -187,6 +183,7 @@ public:
     }
 
 private:
+    juce::SharedResourcePointer<FrameClock> frameClock;
     FilterModule& filterModule;
     std::vector<float> magnitudes;
     static constexpr int numPoints = 1024;
@@ -201,13 +198,22 @@ private:
     int lastFilterType = -1;
 
     // Spectrum analyzer
+    static constexpr int kNumBins = gsynth::SpectrumAnalyser::kNumBins;
+    juce::SharedResourcePointer<gsynth::SpectrumAnalyser> analyser;
+    gsynth::SpectrumAnalyser::SubscriptionPtr spectrum;
     bool showSpectrum = false;
-    static constexpr int fftOrder = 10; // 1024-point FFT
-    static constexpr int fftSize = 1 << fftOrder;
-    juce::dsp::FFT fft{fftOrder};
-    juce::dsp::WindowingFunction<float> window{fftSize, juce::dsp::WindowingFunction<float>::hann};
-    std::vector<float> fftData;
     std::vector<float> spectrumMagnitudes;
+    std::vector<float> binPositions; // Fractional FFT bin of each display point
+    double binSampleRate = 0.0;
+
+    void updateBinPositions(double sampleRate) {
+        if (sampleRate == binSampleRate)
+            return;
+        binSampleRate = sampleRate;
+        float binWidth = static_cast<float>(sampleRate) / static_cast<float>(gsynth::SpectrumAnalyser::kFftSize);
+        for (int i = 0; i < numPoints; ++i)
+            binPositions[(size_t)i] = indexToFreq(i) / binWidth;
+    }
 
     float indexToFreq(int i) const {
         float t = static_cast<float>(i) / static_cast<float>(numPoints - 1);
@@ -1,7 +1,6 @@
 #include "GraphEditor.h"
 #include "../AI/AIStateMapper.h"
 #include "../Modules/ADSRModule.h"
-#include "../Modules/AttenuverterModule.h"
 #include "../Modules/FX/ChorusModule.h"
 #include "../Modules/FX/CompressorModule.h"
 #include "../Modules/FX/DelayModule.h"
@@ -18,7 +17,11 @@
 #include "../Modules/SequencerModule.h"
 #include "../Modules/VCAModule.h"
 #include "../Modules/VoiceMixerModule.h"
+#include "../GraphTransaction.h"
+#include "../ModMatrixRoutes.h"
+#include "../TraceRecorder.h"
 #include "ModuleComponent.h"
+#include <unordered_map>
 
 GraphEditor::GraphEditor(AudioEngine& engine, GravisynthUndoManager* undoMgr)
     : audioEngine(engine)
@@ -28,158 +31,59 @@ GraphEditor::GraphEditor(AudioEngine& engine, GravisynthUndoManager* undoMgr)
     addAndMakeVisible(content);
     addAndMakeVisible(modMatrix);
     content.setInterceptsMouseClicks(false, true); // Fallback clicks to parent
-    startTimerHz(30);
+    audioEngine.getGraph().addChangeListener(this);
+    frameClock->addClient(*this, 30, this);
 }
 
-GraphEditor::~GraphEditor() { stopTimer(); }
+GraphEditor::~GraphEditor() {
+    frameClock->removeClient(*this);
+    audioEngine.getGraph().removeChangeListener(this);
+}
 
 GraphEditor::GraphContentComponent::GraphContentComponent(GraphEditor& ed)
     : editor(ed) {}
 
 void GraphEditor::GraphContentComponent::paint(juce::Graphics& g) {
+    GSYNTH_TRACE_SCOPE("ui", "GraphEditor::paint");
     g.fillAll(juce::Colours::darkgrey);
 
     // Draw connections
-    auto& graph = editor.audioEngine.getGraph();
-    g.setColour(juce::Colours::yellow);
-
-    for (auto& connection : graph.getConnections()) {
-        auto* node1 = graph.getNodeForId(connection.source.nodeID);
-        auto* node2 = graph.getNodeForId(connection.destination.nodeID);
-
-        if (!node1 || !node2)
-            continue;
-
-        // Hide poly connections that exceed visible port counts
-        // Skip drawing if source channel exceeds visible output ports
-        if (connection.source.channelIndex != juce::AudioProcessorGraph::midiChannelIndex) {
-            if (auto* srcMb = dynamic_cast<ModuleBase*>(node1->getProcessor())) {
-                if (connection.source.channelIndex >= srcMb->getVisibleOutputPortCount())
-                    continue;
-            }
-        }
-
-        // Skip drawing if destination channel exceeds visible input ports
-        if (connection.destination.channelIndex != juce::AudioProcessorGraph::midiChannelIndex) {
-            if (auto* dstMb = dynamic_cast<ModuleBase*>(node2->getProcessor())) {
-                if (connection.destination.channelIndex >= dstMb->getVisibleInputPortCount())
-                    continue;
-            }
-        }
-
-        if (dynamic_cast<AttenuverterModule*>(node2->getProcessor()) != nullptr) {
-            juce::AudioProcessorGraph::Node* realDstNode = nullptr;
-            int realDstPort = 0;
-            for (auto& c : graph.getConnections()) {
-                if (c.source.nodeID == node2->nodeID) {
-                    realDstNode = graph.getNodeForId(c.destination.nodeID);
-                    realDstPort = c.destination.channelIndex;
-                    break;
-                }
-            }
-
-            if (realDstNode) {
-                juce::Point<int> p1, p2;
-                bool found1 = false, found2 = false;
-                for (auto* comp : moduleComponents) {
-                    if (comp->getModule() == node1->getProcessor()) {
-                        auto localP = comp->getPortCenter(connection.source.channelIndex, false);
-                        p1 = comp->getBounds().getPosition() + localP;
-                        found1 = true;
-                    }
-                    if (comp->getModule() == realDstNode->getProcessor()) {
-                        auto localP = comp->getPortCenter(realDstPort, true);
-                        p2 = comp->getBounds().getPosition() + localP;
-                        found2 = true;
-                    }
-                }
-
-                if (found1 && found2) {
-                    // Pulse modulation line based on signal activity
-                    float modPeak = 0.0f;
-                    for (auto& info : editor.cachedModDisplayInfo) {
-                        if (info.attenuverterNodeID == node2->nodeID) {
-                            modPeak = info.modSignalPeak;
-                            break;
-                        }
-                    }
-                    float lineWidth = 2.0f + modPeak * 2.0f;
-                    float brightness = juce::jlimit(0.5f, 1.0f, 0.5f + modPeak * 0.5f);
-                    g.setColour(juce::Colours::yellow.withMultipliedBrightness(brightness));
-                    g.drawLine(p1.toFloat().x, p1.toFloat().y, p2.toFloat().x, p2.toFloat().y, lineWidth);
-
-                    float amt = 0.0f;
-                    if (auto* p = node2->getProcessor()->getParameters()[1]) {
-                        amt = p->getValue();
-                        amt = amt * 2.0f - 1.0f; // 0 to 1 back to -1.0 to 1.0
-                    }
-
-                    auto mid = (p1 + p2) / 2;
-                    juce::Rectangle<float> knobArea(mid.toFloat().x - 10, mid.toFloat().y - 10, 20, 20);
-                    g.setColour(juce::Colours::darkgrey);
-                    g.fillEllipse(knobArea);
-                    g.setColour(juce::Colours::white);
-                    g.drawEllipse(knobArea, 1.0f);
-
-                    float angle = juce::jmap(amt, -1.0f, 1.0f, -juce::MathConstants<float>::pi * 0.75f,
-                                             juce::MathConstants<float>::pi * 0.75f);
-                    float dx = std::sin(angle) * 8.0f;
-                    float dy = -std::cos(angle) * 8.0f;
-                    g.drawLine(mid.toFloat().x, mid.toFloat().y, mid.toFloat().x + dx, mid.toFloat().y + dy, 2.0f);
-
-                    // Animated dots along modulation connection
-                    for (int d = 0; d < 3; ++d) {
-                        float t = std::fmod(connectionAnimPhase + (float)d / 3.0f, 1.0f);
-                        float dotX = p1.toFloat().x + (p2.toFloat().x - p1.toFloat().x) * t;
-                        float dotY = p1.toFloat().y + (p2.toFloat().y - p1.toFloat().y) * t;
-                        g.setColour(juce::Colours::cyan.withAlpha(0.7f));
-                        g.fillEllipse(dotX - 2.5f, dotY - 2.5f, 5.0f, 5.0f);
-                    }
-                }
-            }
-            continue;
-        } else if (dynamic_cast<AttenuverterModule*>(node1->getProcessor()) != nullptr) {
-            continue;
-        }
-
-        juce::Point<int> p1, p2;
-        bool found1 = false;
-        bool found2 = false;
-
-        for (auto* comp : moduleComponents) {
-            if (comp->getModule() == node1->getProcessor()) {
-                juce::Point<int> localP;
-                if (connection.source.channelIndex == juce::AudioProcessorGraph::midiChannelIndex) {
-                    localP = comp->getPortCenter(0, false);
-                } else {
-                    localP = comp->getPortCenter(connection.source.channelIndex, false);
-                }
-                p1 = comp->getBounds().getPosition() + localP;
-                found1 = true;
-            }
-            if (comp->getModule() == node2->getProcessor()) {
-                juce::Point<int> localP;
-                if (connection.destination.channelIndex == juce::AudioProcessorGraph::midiChannelIndex) {
-                    localP = juce::Point<int>(10, 30);
-                } else {
-                    localP = comp->getPortCenter(connection.destination.channelIndex, true);
-                }
-                p2 = comp->getBounds().getPosition() + localP;
-                found2 = true;
-            }
+    connectionModel.ensureUpToDate(editor.audioEngine.getGraph(), moduleComponents);
+
+    for (auto& cable : connectionModel.getCables()) {
+        if (cable.isModulation) {
+            // Pulse modulation line based on signal activity
+            float modPeak = connectionModel.getModulationPeak(cable.routeID);
+            float lineWidth = 2.0f + modPeak * 2.0f;
+            float brightness = juce::jlimit(0.5f, 1.0f, 0.5f + modPeak * 0.5f);
+            g.setColour(juce::Colours::yellow.withMultipliedBrightness(brightness));
+            g.strokePath(cable.path, juce::PathStrokeType(lineWidth));
+
+            float amt = cable.amount != nullptr ? cable.amount->get() : 0.0f;
+
+            auto mid = cable.line.getPointAlongLineProportionally(0.5f);
+            juce::Rectangle<float> knobArea(mid.x - 10, mid.y - 10, 20, 20);
+            g.setColour(juce::Colours::darkgrey);
+            g.fillEllipse(knobArea);
+            g.setColour(juce::Colours::white);
+            g.drawEllipse(knobArea, 1.0f);
+
+            float angle = juce::jmap(amt, -1.0f, 1.0f, -juce::MathConstants<float>::pi * 0.75f,
+                                     juce::MathConstants<float>::pi * 0.75f);
+            float dx = std::sin(angle) * 8.0f;
+            float dy = -std::cos(angle) * 8.0f;
+            g.drawLine(mid.x, mid.y, mid.x + dx, mid.y + dy, 2.0f);
+        } else {
+            g.setColour(juce::Colours::yellow);
+            g.strokePath(cable.path, juce::PathStrokeType(2.0f));
         }
 
-        if (found1 && found2) {
-            g.drawLine(p1.toFloat().x, p1.toFloat().y, p2.toFloat().x, p2.toFloat().y, 2.0f);
-
-            // Animated dots along audio connection
-            for (int d = 0; d < 3; ++d) {
-                float t = std::fmod(connectionAnimPhase + (float)d / 3.0f, 1.0f);
-                float dotX = p1.toFloat().x + (p2.toFloat().x - p1.toFloat().x) * t;
-                float dotY = p1.toFloat().y + (p2.toFloat().y - p1.toFloat().y) * t;
-                g.setColour(juce::Colours::white.withAlpha(0.7f));
-                g.fillEllipse(dotX - 2.5f, dotY - 2.5f, 5.0f, 5.0f);
-            }
+        // Animated dots along the connection
+        g.setColour((cable.isModulation ? juce::Colours::cyan : juce::Colours::white).withAlpha(0.7f));
+        for (int d = 0; d < 3; ++d) {
+            float t = std::fmod(connectionAnimPhase + (float)d / 3.0f, 1.0f);
+            auto dot = cable.line.getPointAlongLineProportionally(t);
+            g.fillEllipse(dot.x - 2.5f, dot.y - 2.5f, 5.0f, 5.0f);
         }
     }
 
@@ -256,68 +160,45 @@ void GraphEditor::endConnectionDrag(juce::Point<int> screenPos) {
                 continue;
 
             auto& graph = audioEngine.getGraph();
-            juce::AudioProcessorGraph::Node* srcNode = nullptr;
-            juce::AudioProcessorGraph::Node* dstNode = nullptr;
-
-            for (auto* n : graph.getNodes()) {
-                if (n->getProcessor() == dragSourceModule->getModule())
-                    srcNode = n;
-                if (n->getProcessor() == comp->getModule())
-                    dstNode = n;
-            }
+            auto* srcNode = findNode(dragSourceModule);
+            auto* dstNode = findNode(comp);
 
             if (srcNode && dstNode) {
                 auto* realSrc = dragSourceIsInput ? dstNode : srcNode;
                 auto* realDst = dragSourceIsInput ? srcNode : dstNode;
                 int sPort = dragSourceIsInput ? port->index : dragSourceChannel;
                 int dPort = dragSourceIsInput ? dragSourceChannel : port->index;
-
-                if (undoManager) {
-                    auto srcId = realSrc->nodeID;
-                    auto dstId = realDst->nodeID;
-                    bool isMidiConn = dragSourceIsMidi;
-                    bool isCV = false;
-                    if (!isMidiConn) {
-                        if (auto* modBase = dynamic_cast<ModuleBase*>(realDst->getProcessor())) {
-                            for (const auto& t : modBase->getModulationTargets()) {
-                                if (t.channelIndex == dPort) {
-                                    isCV = true;
-                                    break;
-                                }
+                auto srcId = realSrc->nodeID;
+                auto dstId = realDst->nodeID;
+                bool isMidiConn = dragSourceIsMidi;
+                bool isCV = false;
+                if (!isMidiConn) {
+                    if (auto* modBase = dynamic_cast<ModuleBase*>(realDst->getProcessor())) {
+                        for (const auto& t : modBase->getModulationTargets()) {
+                            if (t.channelIndex == dPort) {
+                                isCV = true;
+                                break;
                             }
                         }
                     }
-                    undoManager->recordStructuralChange(
-                        graph, [this, &graph, srcId, dstId, sPort, dPort, isMidiConn, isCV] {
-                            if (isMidiConn) {
-                                graph.addConnection({{srcId, juce::AudioProcessorGraph::midiChannelIndex},
-                                                     {dstId, juce::AudioProcessorGraph::midiChannelIndex}});
-                            } else if (isCV) {
-                                audioEngine.addModRouting(srcId, sPort, dstId, dPort);
-                            } else {
-                                graph.addConnection({{srcId, sPort}, {dstId, dPort}});
-                            }
-                        });
-                } else {
-                    if (dragSourceIsMidi) {
-                        graph.addConnection({{realSrc->nodeID, juce::AudioProcessorGraph::midiChannelIndex},
-                                             {realDst->nodeID, juce::AudioProcessorGraph::midiChannelIndex}});
+                }
+
+                auto doConnect = [this, &graph, srcId, dstId, sPort, dPort, isMidiConn, isCV] {
+                    gsynth::GraphTransaction txn(graph);
+                    if (isMidiConn) {
+                        txn.addConnection({{srcId, juce::AudioProcessorGraph::midiChannelIndex},
+                                           {dstId, juce::AudioProcessorGraph::midiChannelIndex}});
+                    } else if (isCV) {
+                        audioEngine.addModRouting(srcId, sPort, dstId, dPort);
                     } else {
-                        bool isCV = false;
-                        if (auto* modBase = dynamic_cast<ModuleBase*>(realDst->getProcessor())) {
-                            for (const auto& t : modBase->getModulationTargets()) {
-                                if (t.channelIndex == dPort) {
-                                    isCV = true;
-                                    break;
-                                }
-                            }
-                        }
-                        if (isCV) {
-                            audioEngine.addModRouting(realSrc->nodeID, sPort, realDst->nodeID, dPort);
-                        } else {
-                            graph.addConnection({{realSrc->nodeID, sPort}, {realDst->nodeID, dPort}});
-                        }
+                        txn.addConnection({{srcId, sPort}, {dstId, dPort}});
                     }
+                };
+
+                if (undoManager) {
+                    undoManager->recordStructuralChange(graph, doConnect);
+                } else {
+                    doConnect();
                 }
             }
         }
@@ -332,52 +213,47 @@ void GraphEditor::detachAllModuleComponents() {
     for (auto* comp : content.getModules())
         comp->detachFromProcessor();
     content.getModules().clear(); // Remove after detach so ~ModuleComponent doesn't double-detach freed params
+    invalidateConnections();
     modMatrix.detachAllRows();
     modMatrix.clearRows();
 }
 
 void GraphEditor::updateComponents() {
-    auto& graph = audioEngine.getGraph();
+    const auto& registry = audioEngine.getModuleRegistry();
     auto& modules = content.getModules();
+    invalidateConnections();
 
     // 1. Remove components for nodes that no longer exist
+    std::unordered_map<juce::AudioProcessor*, ModuleComponent*> componentForProcessor;
     for (int i = modules.size(); --i >= 0;) {
         auto* comp = modules.getUnchecked(i);
-        bool stillExists = false;
-        for (auto* node : graph.getNodes()) {
-            if (node->getProcessor() == comp->getModule()) {
-                stillExists = true;
-                break;
-            }
-        }
-        if (!stillExists) {
+        auto* entry = registry.find(comp->getNodeId());
+        if (entry == nullptr || entry->node->getProcessor() != comp->getModule()) {
             content.removeChildComponent(comp);
             modules.remove(i);
+        } else {
+            componentForProcessor[comp->getModule()] = comp;
         }
     }
 
     // 2. Add components for new nodes
     int moduleIndex = 0;
-    for (auto* node : graph.getNodes()) {
+    for (auto& entry : registry.getEntries()) {
+        auto* node = entry.node;
         auto* processor = node->getProcessor();
         if (!processor)
             continue;
 
-        if (dynamic_cast<AttenuverterModule*>(processor) != nullptr)
+        if (entry.module != nullptr && entry.module->getModuleType() == ModuleType::ModMatrix)
             continue;
 
-        // Check if we already have a component for this module
-        ModuleComponent* existingComp = nullptr;
-        for (auto* comp : modules) {
-            if (comp->getModule() == processor) {
-                existingComp = comp;
-                break;
-            }
-        }
+        auto it = componentForProcessor.find(processor);
+        ModuleComponent* existingComp = it != componentForProcessor.end() ? it->second : nullptr;
 
         if (existingComp == nullptr) {
             auto* newComp = modules.add(new ModuleComponent(processor, node->nodeID, *this, undoManager));
             content.addAndMakeVisible(newComp);
+            newComp->addComponentListener(this);
             existingComp = newComp;
         }
 
@@ -395,7 +271,7 @@ void GraphEditor::updateComponents() {
         moduleIndex++;
     }
 
-    // Refresh mod matrix to pick up any new/removed attenuverter routings
+    // Refresh mod matrix to pick up any new/removed routings
     // Use callAsync to avoid re-entrancy during graph modification
     // SafePointer guards against the GraphEditor being destroyed before the callback fires
     juce::Component::SafePointer<GraphEditor> safeThis(this);
@@ -465,30 +341,26 @@ void GraphEditor::mouseDown(const juce::MouseEvent& e) {
         lastMousePos = e.getPosition();
 
         auto localPos = content.getLocalPoint(this, e.getPosition());
-        auto attenId = getAttenuverterNodeAt(localPos.toFloat());
-        if (attenId.uid != 0) {
-            draggingAttenuverterNodeId = attenId;
+        auto routeId = getModRouteAt(localPos.toFloat());
+        if (routeId.uid != 0) {
+            draggingModRouteId = routeId;
             if (undoManager)
                 undoManager->captureBeforeState(audioEngine.getGraph());
         } else {
-            draggingAttenuverterNodeId = juce::AudioProcessorGraph::NodeID();
+            draggingModRouteId = juce::AudioProcessorGraph::NodeID();
         }
     }
 }
 
 void GraphEditor::mouseDrag(const juce::MouseEvent& e) {
     if (e.mods.isLeftButtonDown() && !isDraggingConnection) {
-        if (draggingAttenuverterNodeId.uid != 0) {
-            auto& graph = audioEngine.getGraph();
-            auto* node = graph.getNodeForId(draggingAttenuverterNodeId);
-            if (node) {
-                if (auto* p = dynamic_cast<juce::AudioParameterFloat*>(node->getProcessor()->getParameters()[1])) {
-                    float delta = (e.getPosition().y - lastMousePos.y) * -0.01f;
-                    float currentVal = p->get(); // -1 to 1
-                    currentVal = juce::jlimit(-1.0f, 1.0f, currentVal + delta);
-                    p->setValueNotifyingHost(p->convertTo0to1(currentVal));
-                    content.repaint();
-                }
+        if (draggingModRouteId.uid != 0) {
+            if (auto* p = audioEngine.getModAmountParameter(draggingModRouteId)) {
+                float delta = (e.getPosition().y - lastMousePos.y) * -0.01f;
+                float currentVal = p->convertFrom0to1(p->getValue()); // -1 to 1
+                currentVal = juce::jlimit(-1.0f, 1.0f, currentVal + delta);
+                p->setValueNotifyingHost(p->convertTo0to1(currentVal));
+                content.repaint();
             }
             lastMousePos = e.getPosition();
             return;
@@ -502,73 +374,31 @@ void GraphEditor::mouseDrag(const juce::MouseEvent& e) {
 }
 
 void GraphEditor::mouseUp(const juce::MouseEvent& e) {
-    if (draggingAttenuverterNodeId.uid != 0 && undoManager) {
+    if (draggingModRouteId.uid != 0 && undoManager) {
         undoManager->pushSnapshotFromCapture(audioEngine.getGraph());
     }
-    draggingAttenuverterNodeId = juce::AudioProcessorGraph::NodeID();
+    draggingModRouteId = juce::AudioProcessorGraph::NodeID();
 }
 
 void GraphEditor::mouseDoubleClick(const juce::MouseEvent& e) {
     auto localPos = content.getLocalPoint(this, e.getPosition());
-    auto attenId = getAttenuverterNodeAt(localPos.toFloat());
-    if (attenId.uid != 0) {
+    auto routeId = getModRouteAt(localPos.toFloat());
+    if (routeId.uid != 0) {
         if (undoManager) {
             undoManager->recordStructuralChange(audioEngine.getGraph(),
-                                                [this, attenId] { audioEngine.removeModRouting(attenId); });
+                                                [this, routeId] { audioEngine.removeModRouting(routeId); });
         } else {
-            audioEngine.removeModRouting(attenId);
+            audioEngine.removeModRouting(routeId);
         }
         content.repaint();
     }
 }
 
-juce::AudioProcessorGraph::NodeID GraphEditor::getAttenuverterNodeAt(juce::Point<float> localPos) {
-    auto& graph = audioEngine.getGraph();
-    for (auto& connection : graph.getConnections()) {
-        auto* node1 = graph.getNodeForId(connection.source.nodeID);
-        auto* node2 = graph.getNodeForId(connection.destination.nodeID);
-
-        if (!node1 || !node2)
-            continue;
-
-        // An attenuverter always has a source connection into its port 0
-        if (dynamic_cast<AttenuverterModule*>(node2->getProcessor()) != nullptr) {
-            juce::AudioProcessorGraph::Node* realDstNode = nullptr;
-            int realDstPort = 0;
-            // Find the output connection FROM this attenuverter
-            for (auto& c : graph.getConnections()) {
-                if (c.source.nodeID == node2->nodeID) {
-                    realDstNode = graph.getNodeForId(c.destination.nodeID);
-                    realDstPort = c.destination.channelIndex;
-                    break;
-                }
-            }
-
-            if (realDstNode) {
-                juce::Point<int> p1, p2;
-                bool found1 = false, found2 = false;
-                for (auto* comp : content.getModules()) {
-                    if (comp->getModule() == node1->getProcessor()) {
-                        auto localP = comp->getPortCenter(connection.source.channelIndex, false);
-                        p1 = comp->getBounds().getPosition() + localP;
-                        found1 = true;
-                    }
-                    if (comp->getModule() == realDstNode->getProcessor()) {
-                        auto localP = comp->getPortCenter(realDstPort, true);
-                        p2 = comp->getBounds().getPosition() + localP;
-                        found2 = true;
-                    }
-                }
-
-                if (found1 && found2) {
-                    auto mid = (p1 + p2) / 2;
-                    if (juce::Point<float>(mid.toFloat().x, mid.toFloat().y).getDistanceFrom(localPos) <= 15.0f) {
-                        return node2->nodeID;
-                    }
-                }
-            }
-        }
-    }
+juce::AudioProcessorGraph::NodeID GraphEditor::getModRouteAt(juce::Point<float> localPos) {
+    auto& model = content.getConnectionModel();
+    model.ensureUpToDate(audioEngine.getGraph(), content.getModules());
+    if (auto* cable = model.findModulationCableAt(localPos, 15.0f))
+        return cable->routeID;
     return {};
 }
 
@@ -586,28 +416,24 @@ void GraphEditor::updateModulePosition(ModuleComponent* module) {
 
 void GraphEditor::deleteModule(ModuleComponent* module) {
     auto& graph = audioEngine.getGraph();
-    juce::AudioProcessorGraph::NodeID nodeId;
+    auto* node = findNode(module);
+    if (node == nullptr)
+        return;
+    auto nodeId = node->nodeID;
 
-    for (auto* n : graph.getNodes()) {
-        if (n->getProcessor() == module->getModule()) {
-            nodeId = n->nodeID;
-            break;
+    auto doDelete = [this, nodeId, &graph] {
+        modMatrix.clearRows();
+        {
+            gsynth::GraphTransaction txn(graph);
+            txn.removeNode(nodeId);
         }
-    }
-
-    if (nodeId.uid == 0)
-        return;
+        updateComponents();
+    };
 
     if (undoManager) {
-        undoManager->recordStructuralChange(graph, [this, nodeId, &graph] {
-            modMatrix.clearRows();
-            graph.removeNode(nodeId);
-            updateComponents();
-        });
+        undoManager->recordStructuralChange(graph, doDelete);
     } else {
-        modMatrix.clearRows();
-        graph.removeNode(nodeId);
-        updateComponents();
+        doDelete();
     }
     repaint();
 }
@@ -615,16 +441,10 @@ void GraphEditor::deleteModule(ModuleComponent* module) {
 void GraphEditor::replaceModule(ModuleComponent* moduleComp, const juce::String& newModuleType) {
     auto& graph = audioEngine.getGraph();
 
-    // Find the old node by processor pointer (same pattern as deleteModule)
-    juce::AudioProcessorGraph::NodeID oldNodeId;
-    for (auto* n : graph.getNodes()) {
-        if (n->getProcessor() == moduleComp->getModule()) {
-            oldNodeId = n->nodeID;
-            break;
-        }
-    }
-    if (oldNodeId.uid == 0)
+    auto* node = findNode(moduleComp);
+    if (node == nullptr)
         return;
+    auto oldNodeId = node->nodeID;
 
     // Use shared_ptr to make the lambda copyable (std::function requires it)
     auto newModuleTypeCopy = newModuleType;
@@ -634,6 +454,9 @@ void GraphEditor::replaceModule(ModuleComponent* moduleComp, const juce::String&
         if (!oldNode)
             return;
 
+        const auto& registry = audioEngine.getModuleRegistry();
+        gsynth::GraphTransaction txn(graph);
+
         // 1. Create the new module
         auto newProcessor = gsynth::AIStateMapper::createModule(newModuleTypeCopy);
         if (!newProcessor)
@@ -665,11 +488,18 @@ void GraphEditor::replaceModule(ModuleComponent* moduleComp, const juce::String&
         std::vector<ConnectionInfo> directConnections;
 
         struct ModRoutingRewire {
-            juce::AudioProcessorGraph::NodeID attenuverterId;
+            juce::AudioProcessorGraph::NodeID matrixId;
+            int slot;
             int channelOnOldModule;
             bool oldModuleIsSource;
         };
         std::vector<ModRoutingRewire> modRoutings;
+        for (const auto& route : gsynth::getModRoutes(graph)) {
+            if (route.source && route.source->nodeID == oldNodeId)
+                modRoutings.push_back({route.matrixID, route.slot, route.source->channelIndex, true});
+            if (route.dest && route.dest->nodeID == oldNodeId)
+                modRoutings.push_back({route.matrixID, route.slot, route.dest->channelIndex, false});
+        }
 
         for (auto& conn : graph.getConnections()) {
             bool srcIsOld = (conn.source.nodeID == oldNodeId);
@@ -677,31 +507,11 @@ void GraphEditor::replaceModule(ModuleComponent* moduleComp, const juce::String&
             if (!srcIsOld && !dstIsOld)
                 continue;
 
-            // Check if this involves an attenuverter
-            if (srcIsOld) {
-                auto* dstNode = graph.getNodeForId(conn.destination.nodeID);
-                if (dstNode && dynamic_cast<AttenuverterModule*>(dstNode->getProcessor())) {
-                    ModRoutingRewire rw;
-                    rw.attenuverterId = conn.destination.nodeID;
-                    rw.channelOnOldModule = conn.source.channelIndex;
-                    rw.oldModuleIsSource = true;
-                    modRoutings.push_back(rw);
-                    continue;
-                }
-            }
-            if (dstIsOld) {
-                auto* srcNode = graph.getNodeForId(conn.source.nodeID);
-                if (srcNode && dynamic_cast<AttenuverterModule*>(srcNode->getProcessor())) {
-                    ModRoutingRewire rw;
-                    rw.attenuverterId = conn.source.nodeID;
-                    rw.channelOnOldModule = conn.destination.channelIndex;
-                    rw.oldModuleIsSource = false;
-                    modRoutings.push_back(rw);
-                    continue;
-                }
-            }
+            // Routings through a mod matrix were collected above
+            if (registry.isModuleType(srcIsOld ? conn.destination.nodeID : conn.source.nodeID, ModuleType::ModMatrix))
+                continue;
 
-            // Direct connection (not attenuverter-mediated)
+            // Direct connection (not through a mod matrix)
             ConnectionInfo ci;
             bool isMidiConn =
                 (srcIsOld && conn.source.channelIndex == juce::AudioProcessorGraph::midiChannelIndex) ||
@@ -722,7 +532,7 @@ void GraphEditor::replaceModule(ModuleComponent* moduleComp, const juce::String&
         }
 
         // 5. Add the new node to the graph
-        auto newNode = graph.addNode(std::move(newProcessor));
+        auto newNode = txn.addNode(std::move(newProcessor));
         if (!newNode)
             return;
         auto newNodeId = newNode->nodeID;
@@ -731,41 +541,41 @@ void GraphEditor::replaceModule(ModuleComponent* moduleComp, const juce::String&
 
         // 6. Remove the old node (this removes all its connections)
         modMatrix.clearRows();
-        graph.removeNode(oldNodeId);
+        txn.removeNode(oldNodeId);
 
         // 7. Re-create compatible direct connections
         for (auto& ci : directConnections) {
             if (ci.isMidi) {
                 if (ci.isIncoming && newAcceptsMidi) {
-                    graph.addConnection({{ci.otherNodeId, juce::AudioProcessorGraph::midiChannelIndex},
-                                         {newNodeId, juce::AudioProcessorGraph::midiChannelIndex}});
+                    txn.addConnection({{ci.otherNodeId, juce::AudioProcessorGraph::midiChannelIndex},
+                                       {newNodeId, juce::AudioProcessorGraph::midiChannelIndex}});
                 } else if (!ci.isIncoming && newProducesMidi) {
-                    graph.addConnection({{newNodeId, juce::AudioProcessorGraph::midiChannelIndex},
-                                         {ci.otherNodeId, juce::AudioProcessorGraph::midiChannelIndex}});
+                    txn.addConnection({{newNodeId, juce::AudioProcessorGraph::midiChannelIndex},
+                                       {ci.otherNodeId, juce::AudioProcessorGraph::midiChannelIndex}});
                 }
             } else {
                 if (ci.isIncoming && ci.oldChannelIndex < newNumInputs) {
-                    graph.addConnection({{ci.otherNodeId, ci.otherChannelIndex}, {newNodeId, ci.oldChannelIndex}});
+                    txn.addConnection({{ci.otherNodeId, ci.otherChannelIndex}, {newNodeId, ci.oldChannelIndex}});
                 } else if (!ci.isIncoming && ci.oldChannelIndex < newNumOutputs) {
-                    graph.addConnection({{newNodeId, ci.oldChannelIndex}, {ci.otherNodeId, ci.otherChannelIndex}});
+                    txn.addConnection({{newNodeId, ci.oldChannelIndex}, {ci.otherNodeId, ci.otherChannelIndex}});
                 }
             }
         }
 
         // 8. Re-create compatible modulation routings
         // removeNode(oldNodeId) only removes connections TO/FROM oldNodeId.
-        // For mod routings: source->attenuverter->dest
-        // If old was source: old->atten connection is removed, atten->dest survives
-        // If old was dest: atten->old connection is removed, source->atten survives
+        // For mod routings: source->matrix slot->dest
+        // If old was source: old->slot connection is removed, slot->dest survives
+        // If old was dest: slot->old connection is removed, source->slot survives
         // We only need to re-add the destroyed leg.
         for (auto& rw : modRoutings) {
             if (rw.oldModuleIsSource) {
                 if (rw.channelOnOldModule < newNumOutputs) {
-                    graph.addConnection({{newNodeId, rw.channelOnOldModule}, {rw.attenuverterId, 0}});
+                    txn.addConnection({{newNodeId, rw.channelOnOldModule}, {rw.matrixId, rw.slot}});
                 }
             } else {
                 if (rw.channelOnOldModule < newNumInputs) {
-                    graph.addConnection({{rw.attenuverterId, 0}, {newNodeId, rw.channelOnOldModule}});
+                    txn.addConnection({{rw.matrixId, rw.slot}, {newNodeId, rw.channelOnOldModule}});
                 }
             }
         }
@@ -785,45 +595,41 @@ void GraphEditor::replaceModule(ModuleComponent* moduleComp, const juce::String&
 
 void GraphEditor::disconnectPort(ModuleComponent* module, int portIndex, bool isInput, bool isMidi) {
     auto& graph = audioEngine.getGraph();
-    juce::AudioProcessorGraph::NodeID nodeId;
-
-    for (auto* n : graph.getNodes()) {
-        if (n->getProcessor() == module->getModule()) {
-            nodeId = n->nodeID;
-            break;
-        }
-    }
-
-    if (nodeId.uid == 0)
+    auto* node = findNode(module);
+    if (node == nullptr)
         return;
+    auto nodeId = node->nodeID;
 
     auto doDisconnect = [this, &graph, nodeId, portIndex, isInput, isMidi] {
+        const auto& registry = audioEngine.getModuleRegistry();
+        gsynth::GraphTransaction txn(graph);
         std::vector<juce::AudioProcessorGraph::Connection> toRemove;
+        std::vector<juce::AudioProcessorGraph::NodeID> modRoutingsToRemove;
         int targetChannel = isMidi ? juce::AudioProcessorGraph::midiChannelIndex : portIndex;
 
         for (auto& c : graph.getConnections()) {
             if (isInput) {
                 if (c.destination.nodeID == nodeId && c.destination.channelIndex == targetChannel) {
-                    if (auto* srcNode = graph.getNodeForId(c.source.nodeID)) {
-                        if (dynamic_cast<AttenuverterModule*>(srcNode->getProcessor()) != nullptr)
-                            audioEngine.removeModRouting(srcNode->nodeID);
-                        else
-                            toRemove.push_back(c);
-                    }
+                    if (registry.isModuleType(c.source.nodeID, ModuleType::ModMatrix))
+                        modRoutingsToRemove.push_back(gsynth::makeModRouteID(c.source.nodeID, c.source.channelIndex));
+                    else if (registry.find(c.source.nodeID) != nullptr)
+                        toRemove.push_back(c);
                 }
             } else {
                 if (c.source.nodeID == nodeId && c.source.channelIndex == targetChannel) {
-                    if (auto* dstNode = graph.getNodeForId(c.destination.nodeID)) {
-                        if (dynamic_cast<AttenuverterModule*>(dstNode->getProcessor()) != nullptr)
-                            audioEngine.removeModRouting(dstNode->nodeID);
-                        else
-                            toRemove.push_back(c);
-                    }
+                    if (registry.isModuleType(c.destination.nodeID, ModuleType::ModMatrix))
+                        modRoutingsToRemove.push_back(
+                            gsynth::makeModRouteID(c.destination.nodeID, c.destination.channelIndex));
+                    else if (registry.find(c.destination.nodeID) != nullptr)
+                        toRemove.push_back(c);
                 }
             }
         }
+        // Removed after the scan, while the registry still describes the graph
+        for (auto routeID : modRoutingsToRemove)
+            audioEngine.removeModRouting(routeID);
         for (auto& c : toRemove)
-            graph.removeConnection(c);
+            txn.removeConnection(c);
     };
 
     if (undoManager) {
@@ -834,12 +640,39 @@ void GraphEditor::disconnectPort(ModuleComponent* module, int portIndex, bool is
     repaint();
 }
 
-void GraphEditor::timerCallback() {
+void GraphEditor::onFrame(double) {
+    GSYNTH_TRACE_SCOPE("ui", "GraphEditor::onFrame");
     cachedModDisplayInfo = audioEngine.getModulationDisplayInfo();
+    content.getConnectionModel().setModulationDisplayInfo(cachedModDisplayInfo);
     content.connectionAnimPhase += 0.02f;
     if (content.connectionAnimPhase >= 1.0f)
         content.connectionAnimPhase -= 1.0f;
-    content.repaint();
+
+    // Only the cables animate: invalidate their bounds rather than the whole canvas,
+    // so modules that don't overlap a cable aren't repainted every frame
+    auto& model = content.getConnectionModel();
+    model.ensureUpToDate(audioEngine.getGraph(), content.getModules());
+    for (auto& cable : model.getCables())
+        content.repaint(cable.path.getBounds().expanded(12.0f).getSmallestIntegerContainer()); // Knob radius + stroke
+}
+
+void GraphEditor::changeListenerCallback(juce::ChangeBroadcaster* source) {
+    if (source == &audioEngine.getGraph()) {
+        invalidateConnections();
+        content.repaint();
+    }
+}
+
+void GraphEditor::componentMovedOrResized(juce::Component&, bool, bool) {
+    invalidateConnections();
+    content.repaint(); // Cables attached to the module span beyond its own bounds
+}
+
+void GraphEditor::invalidateConnections() { content.getConnectionModel().invalidate(); }
+
+juce::AudioProcessorGraph::Node* GraphEditor::findNode(const ModuleComponent* component) {
+    auto* entry = audioEngine.getModuleRegistry().find(component->getNodeId());
+    return entry != nullptr && entry->node->getProcessor() == component->getModule() ? entry->node : nullptr;
 }
 
 bool GraphEditor::isInterestedInDragSource(const SourceDetails& dragSourceDetails) { return true; }
@@ -868,8 +701,6 @@ void GraphEditor::itemDropped(const SourceDetails& dragSourceDetails) {
         newProcessor = std::make_unique<ReverbModule>();
     else if (name == "MidiKeyboard")
         newProcessor = std::make_unique<MidiKeyboardModule>();
-    else if (name == "Attenuverter")
-        newProcessor = std::make_unique<AttenuverterModule>();
     else if (name == "Chorus")
         newProcessor = std::make_unique<ChorusModule>();
     else if (name == "Phaser")
@@ -889,26 +720,23 @@ void GraphEditor::itemDropped(const SourceDetails& dragSourceDetails) {
         auto& graph = audioEngine.getGraph();
         auto dropPos = content.getLocalPoint(this, dragSourceDetails.localPosition);
 
-        if (undoManager) {
-            // Use shared_ptr to make the lambda copyable (std::function requires it)
-            auto proc = std::make_shared<std::unique_ptr<juce::AudioProcessor>>(std::move(newProcessor));
-            undoManager->recordStructuralChange(graph, [this, proc, dropPos] {
-                if (*proc) {
-                    auto node = audioEngine.getGraph().addNode(std::move(*proc));
-                    if (node) {
-                        node->properties.set("x", dropPos.x);
-                        node->properties.set("y", dropPos.y);
-                    }
+        // Use shared_ptr to make the lambda copyable (std::function requires it)
+        auto proc = std::make_shared<std::unique_ptr<juce::AudioProcessor>>(std::move(newProcessor));
+        auto doAdd = [this, &graph, proc, dropPos] {
+            if (*proc) {
+                gsynth::GraphTransaction txn(graph);
+                if (auto node = txn.addNode(std::move(*proc))) {
+                    node->properties.set("x", dropPos.x);
+                    node->properties.set("y", dropPos.y);
                 }
-                updateComponents();
-            });
-        } else {
-            auto node = graph.addNode(std::move(newProcessor));
-            if (node) {
-                node->properties.set("x", dropPos.x);
-                node->properties.set("y", dropPos.y);
-                updateComponents();
             }
+            updateComponents();
+        };
+
+        if (undoManager) {
+            undoManager->recordStructuralChange(graph, doAdd);
+        } else {
+            doAdd();
         }
     }
 }
@@ -2,6 +2,8 @@
 
 #include "../AudioEngine.h"
 #include "../GravisynthUndoManager.h"
+#include "ConnectionRenderModel.h"
+#include "FrameClock.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 
 class ModuleComponent;
@@ -9,8 +11,10 @@ class ModuleComponent;
 
 class GraphEditor
     : public juce::Component
-    , public juce::Timer
-    , public juce::DragAndDropTarget {
+    , public FrameClock::Client
+    , public juce::DragAndDropTarget
+    , public juce::ChangeListener
+    , public juce::ComponentListener {
 public:
     GraphEditor(AudioEngine& engine, GravisynthUndoManager* undoMgr = nullptr);
     ~GraphEditor() override;
@@ -18,12 +22,15 @@ public:
     AudioEngine& getAudioEngine() { return audioEngine; }
     ModMatrixComponent& getModMatrix() { return modMatrix; }
     juce::OwnedArray<ModuleComponent>& getModuleComponents() { return content.getModules(); }
+    ConnectionRenderModel& getConnectionModel() { return content.getConnectionModel(); }
     void detachAllModuleComponents();
 
     void paint(juce::Graphics& g) override;
     void resized() override;
 
-    void timerCallback() override;
+    void onFrame(double nowMs) override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void componentMovedOrResized(juce::Component& component, bool wasMoved, bool wasResized) override;
     void updateComponents();
     void toggleModMatrixVisibility();
     bool isModMatrixVisible() const { return isMatrixVisible; }
@@ -53,7 +60,7 @@ public:
     void mouseUp(const juce::MouseEvent& e) override;
     void mouseDoubleClick(const juce::MouseEvent& e) override;
 
-    juce::AudioProcessorGraph::NodeID getAttenuverterNodeAt(juce::Point<float> localPos);
+    juce::AudioProcessorGraph::NodeID getModRouteAt(juce::Point<float> localPos);
 
 private:
     class GraphContentComponent : public juce::Component {
@@ -63,14 +70,17 @@ private:
         void resized() override;
 
         juce::OwnedArray<ModuleComponent>& getModules() { return moduleComponents; }
+        ConnectionRenderModel& getConnectionModel() { return connectionModel; }
 
         float connectionAnimPhase = 0.0f;
 
     private:
         GraphEditor& editor;
         juce::OwnedArray<ModuleComponent> moduleComponents;
+        ConnectionRenderModel connectionModel;
     };
 
+    juce::SharedResourcePointer<FrameClock> frameClock;
     AudioEngine& audioEngine;
     GraphContentComponent content;
     ModMatrixComponent modMatrix;
@@ -89,13 +99,17 @@ private:
     bool dragSourceIsMidi = false;
     juce::Point<int> dragCurrentPos;
 
-    juce::AudioProcessorGraph::NodeID draggingAttenuverterNodeId;
+    juce::AudioProcessorGraph::NodeID draggingModRouteId;
     float attenDragStartValue = 0.0f;
 
     GravisynthUndoManager* undoManager = nullptr;
     std::vector<AudioEngine::ModulationDisplayInfo> cachedModDisplayInfo;
 
     void updateTransform();
+    void invalidateConnections();
+
+    // The graph node behind a component, or nullptr if it has been removed
+    juce::AudioProcessorGraph::Node* findNode(const ModuleComponent* component);
 
 public:
     const std::vector<AudioEngine::ModulationDisplayInfo>& getCachedModDisplayInfo() const {
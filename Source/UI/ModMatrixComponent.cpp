@@ -1,5 +1,5 @@
 #include "ModMatrixComponent.h"
-#include "../Modules/AttenuverterModule.h"
+#include "../ModMatrixRoutes.h"
 #include <algorithm>
 #include <map>
 
@@ -17,10 +17,10 @@ ModMatrixComponent::ModMatrixComponent(AudioEngine& engine, GravisynthUndoManage
     flatToggle.onClick = [this] { setFlatSourceMenu(flatToggle.getToggleState()); };
     flatToggle.setToggleState(isSourceMenuFlat, juce::dontSendNotification);
 
-    startTimerHz(10);
+    frameClock->addClient(*this, 10, this);
 }
 
-ModMatrixComponent::~ModMatrixComponent() { stopTimer(); }
+ModMatrixComponent::~ModMatrixComponent() { frameClock->removeClient(*this); }
 
 void ModMatrixComponent::setFlatSourceMenu(bool shouldBeFlat) {
     if (isSourceMenuFlat != shouldBeFlat) {
@@ -90,47 +90,32 @@ void ModMatrixComponent::resized() {
     }
 }
 
-void ModMatrixComponent::timerCallback() { updateRowsFromGraph(); }
+void ModMatrixComponent::onFrame(double) {
+    // Idle patches cost two version compares per frame
+    if (audioEngine.getModRoutingVersion() != lastRoutingVersion ||
+        audioEngine.getNodeSetVersion() != lastNodeSetVersion)
+        updateRowsFromGraph();
+}
 
 void ModMatrixComponent::updateRowsFromGraph() {
-    auto activeRoutings = audioEngine.getActiveModRoutings();
-
-    // Stable sort by NodeID so row numbers are consistent
-    std::sort(activeRoutings.begin(), activeRoutings.end(),
-              [](const AudioEngine::ModRoutingInfo& a, const AudioEngine::ModRoutingInfo& b) {
-                  return a.attenuverterNodeID.uid < b.attenuverterNodeID.uid;
-              });
+    auto activeRoutings = audioEngine.getActiveModRoutings(); // Sorted by route ID, so row numbers are stable
+    lastRoutingVersion = audioEngine.getModRoutingVersion();
 
     bool componentsChanged = false;
 
-    // Check for removed rows
-    for (int i = (int)rows.size() - 1; i >= 0; --i) {
-        bool found = false;
-        for (const auto& routing : activeRoutings) {
-            if (routing.attenuverterNodeID == rows[i]->attenuverterId) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            rows.erase(rows.begin() + i);
-            componentsChanged = true;
-        }
-    }
+    // Rebuild the row list in routing order, reusing rows that still exist
+    std::map<juce::uint32, std::unique_ptr<ModRow>> existingRows;
+    for (auto& row : rows)
+        existingRows[row->routeId.uid] = std::move(row);
+    rows.clear();
 
-    // Check for new or changed rows
     for (const auto& routing : activeRoutings) {
-        bool existingFound = false;
-        for (auto& row : rows) {
-            if (row->attenuverterId == routing.attenuverterNodeID) {
-                row->refresh(routing);
-                existingFound = true;
-                break;
-            }
-        }
-
-        if (!existingFound) {
-            auto newRow = std::make_unique<ModRow>(*this, routing.attenuverterNodeID);
+        auto it = existingRows.find(routing.routeID.uid);
+        if (it != existingRows.end()) {
+            rows.push_back(std::move(it->second));
+            existingRows.erase(it);
+        } else {
+            auto newRow = std::make_unique<ModRow>(*this, routing.routeID);
             newRow->populateCombos();
             contentContainer.addAndMakeVisible(*newRow);
             rows.push_back(std::move(newRow));
@@ -138,25 +123,22 @@ void ModMatrixComponent::updateRowsFromGraph() {
         }
     }
 
-    // Assign indices for display
-    for (int i = 0; i < (int)rows.size(); ++i) {
-        rows[i]->setRowIndex(i);
-        // Find corresponding routing for refresh
-        for (const auto& r : activeRoutings) {
-            if (r.attenuverterNodeID == rows[i]->attenuverterId) {
-                rows[i]->refresh(r);
-                break;
-            }
-        }
-    }
+    if (!existingRows.empty())
+        componentsChanged = true; // Leftovers are deleted rows, destroyed with the map
 
-    // Refresh combo items if the number of nodes in graph changed
-    int currentNodeCount = audioEngine.getGraph().getNumNodes();
-    if (currentNodeCount != lastNodeCount) {
+    // Refresh combo items if nodes were added or removed
+    auto nodeSetVersion = audioEngine.getNodeSetVersion();
+    if (nodeSetVersion != lastNodeSetVersion) {
         audioEngine.updateModuleNames();
         for (auto& row : rows)
             row->populateCombos();
-        lastNodeCount = currentNodeCount;
+        lastNodeSetVersion = nodeSetVersion;
+    }
+
+    // Assign indices for display and sync selections (after any combo repopulation)
+    for (int i = 0; i < (int)rows.size(); ++i) {
+        rows[i]->setRowIndex(i);
+        rows[i]->refresh(activeRoutings[(size_t)i]);
     }
 
     if (componentsChanged) {
@@ -166,7 +148,7 @@ void ModMatrixComponent::updateRowsFromGraph() {
 }
 
 void ModMatrixComponent::addModulation() {
-    // Just add an unconnected attenuverter node to create an "empty" row
+    // Just add a route with no ends to create an "empty" row
     audioEngine.addEmptyModRouting();
     updateRowsFromGraph();
 }
@@ -175,7 +157,7 @@ void ModMatrixComponent::addModulation() {
 
 ModMatrixComponent::ModRow::ModRow(ModMatrixComponent& o, juce::AudioProcessorGraph::NodeID id)
     : owner(o)
-    , attenuverterId(id) {
+    , routeId(id) {
     addAndMakeVisible(sourceCombo);
     addAndMakeVisible(destCombo);
     addAndMakeVisible(amountSlider);
@@ -196,9 +178,9 @@ ModMatrixComponent::ModRow::ModRow(ModMatrixComponent& o, juce::AudioProcessorGr
     deleteButton.onClick = [this] {
         if (owner.undoManager) {
             owner.undoManager->recordStructuralChange(owner.audioEngine.getGraph(),
-                                                      [this] { owner.audioEngine.removeModRouting(attenuverterId); });
+                                                      [this] { owner.audioEngine.removeModRouting(routeId); });
         } else {
-            owner.audioEngine.removeModRouting(attenuverterId);
+            owner.audioEngine.removeModRouting(routeId);
         }
     };
 
@@ -211,24 +193,19 @@ ModMatrixComponent::ModRow::ModRow(ModMatrixComponent& o, juce::AudioProcessorGr
     bypassToggle.setComponentID("modBypass");
     deleteButton.setComponentID("modDelete");
 
-    // Attach to attenuverter params
-    if (auto* node = owner.audioEngine.getGraph().getNodeForId(attenuverterId)) {
-        const auto& params = node->getProcessor()->getParameters();
-        if (params.size() > 1) {
-            if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(params[1])) {
-                amountAttachment = std::make_unique<juce::SliderParameterAttachment>(*param, amountSlider);
-            }
-        }
-        if (params.size() > 2) {
-            if (auto* bParam = dynamic_cast<juce::AudioParameterBool*>(params[2])) {
-                bypassAttachment = std::make_unique<juce::ButtonParameterAttachment>(*bParam, bypassToggle);
-            }
-        }
+    // Attach to the route's slot in its mod matrix
+    if (auto route = gsynth::findModRoute(owner.audioEngine.getGraph(), routeId))
+        matrixId = route->matrixID;
+    auto* amountParam = owner.audioEngine.getModAmountParameter(routeId);
+    auto* bypassParam = owner.audioEngine.getModBypassParameter(routeId);
+    if (amountParam != nullptr && bypassParam != nullptr) {
+        amountAttachment = std::make_unique<juce::SliderParameterAttachment>(*amountParam, amountSlider);
+        bypassAttachment = std::make_unique<juce::ButtonParameterAttachment>(*bypassParam, bypassToggle);
 
         // Register as parameter listener for undo tracking
         if (owner.undoManager) {
-            for (auto* p : params)
-                p->addListener(this);
+            amountParam->addListener(this);
+            bypassParam->addListener(this);
         }
     }
 }
@@ -264,7 +241,8 @@ void ModMatrixComponent::ModRow::detach() {
     amountAttachment.reset();
     bypassAttachment.reset();
 
-    if (auto* node = owner.audioEngine.getGraph().getNodeForId(attenuverterId)) {
+    // Through the matrix node rather than the route, which may already be gone
+    if (auto* node = owner.audioEngine.getGraph().getNodeForId(matrixId)) {
         for (auto* p : node->getProcessor()->getParameters())
             p->removeListener(this);
     }
@@ -299,7 +277,6 @@ void ModMatrixComponent::ModRow::populateCombos() {
     sourceCombo.clear(juce::dontSendNotification);
     destCombo.clear(juce::dontSendNotification);
 
-    auto& graph = owner.audioEngine.getGraph();
     bool useGroups = !owner.isSourceMenuFlat;
 
     std::map<ModulationCategory, juce::String> categoryNames = {{ModulationCategory::Envelope, "Envelopes"},
@@ -312,10 +289,9 @@ void ModMatrixComponent::ModRow::populateCombos() {
 
     std::map<ModulationCategory, std::vector<juce::AudioProcessorGraph::Node*>> modulesByCategory;
 
-    for (auto* node : graph.getNodes()) {
-        if (auto* module = dynamic_cast<ModuleBase*>(node->getProcessor())) {
-            modulesByCategory[module->getModulationCategory()].push_back(node);
-        }
+    for (const auto& entry : owner.audioEngine.getModuleRegistry().getEntries()) {
+        if (entry.module != nullptr && entry.module->getModuleType() != ModuleType::ModMatrix)
+            modulesByCategory[entry.module->getModulationCategory()].push_back(entry.node);
     }
 
     if (!useGroups) {
@@ -416,27 +392,8 @@ void ModMatrixComponent::ModRow::comboBoxChanged(juce::ComboBox* comboBox) {
 
         if (srcNodeId != 0 || dstNodeId != 0) {
             auto doReroute = [this, srcNodeId, srcChannel, dstNodeId, dstChannel] {
-                auto& graph = owner.audioEngine.getGraph();
-
-                for (auto& conn : graph.getConnections()) {
-                    if (conn.destination.nodeID == attenuverterId && conn.destination.channelIndex == 0) {
-                        graph.removeConnection(conn);
-                        break;
-                    }
-                }
-                if (srcNodeId != 0)
-                    graph.addConnection(
-                        {{juce::AudioProcessorGraph::NodeID(srcNodeId), srcChannel}, {attenuverterId, 0}});
-
-                for (auto& conn : graph.getConnections()) {
-                    if (conn.source.nodeID == attenuverterId && conn.source.channelIndex == 0) {
-                        graph.removeConnection(conn);
-                        break;
-                    }
-                }
-                if (dstNodeId != 0)
-                    graph.addConnection(
-                        {{attenuverterId, 0}, {juce::AudioProcessorGraph::NodeID(dstNodeId), dstChannel}});
+                owner.audioEngine.rerouteModRouting(routeId, juce::AudioProcessorGraph::NodeID(srcNodeId), srcChannel,
+                                                    juce::AudioProcessorGraph::NodeID(dstNodeId), dstChannel);
             };
 
             if (owner.undoManager) {
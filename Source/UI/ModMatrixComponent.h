@@ -2,19 +2,20 @@
 
 #include "../AudioEngine.h"
 #include "../GravisynthUndoManager.h"
+#include "FrameClock.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <map>
 
 class ModMatrixComponent
     : public juce::Component
-    , public juce::Timer {
+    , public FrameClock::Client {
 public:
     ModMatrixComponent(AudioEngine& engine, GravisynthUndoManager* undoMgr = nullptr);
     ~ModMatrixComponent() override;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
-    void timerCallback() override;
+    void onFrame(double nowMs) override;
 
     void setFlatSourceMenu(bool shouldBeFlat);
 
@@ -27,6 +28,7 @@ public:
     void detachAllRows();
 
 private:
+    juce::SharedResourcePointer<FrameClock> frameClock;
     AudioEngine& audioEngine;
     GravisynthUndoManager* undoManager = nullptr;
     bool isSourceMenuFlat = false;
@@ -55,7 +57,8 @@ private:
         void comboBoxChanged(juce::ComboBox* comboBox) override;
 
         ModMatrixComponent& owner;
-        juce::AudioProcessorGraph::NodeID attenuverterId;
+        juce::AudioProcessorGraph::NodeID routeId;
+        juce::AudioProcessorGraph::NodeID matrixId; // The mod matrix holding the route's slot
 
         juce::ComboBox sourceCombo;
         juce::ComboBox destCombo;
@@ -83,7 +86,8 @@ public:
     void updateRowsFromGraph();
 
 private:
-    int lastNodeCount = 0;
+    juce::uint32 lastRoutingVersion = 0;
+    juce::uint32 lastNodeSetVersion = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModMatrixComponent)
 };
@@ -1,6 +1,7 @@
 #include "ModuleComponent.h"
 #include "../Modules/ModuleBase.h"
 #include "../Modules/SequencerModule.h"
+#include "../TraceRecorder.h"
 #include "GraphEditor.h"
 
 static ModuleType getType(juce::AudioProcessor* module) {
@@ -43,28 +44,26 @@ ModuleComponent::ModuleComponent(juce::AudioProcessor* m, juce::AudioProcessorGr
         addAndMakeVisible(spectrumToggle.get());
     }
 
-    if (getType(module) != ModuleType::Attenuverter) {
-        bypassButton = std::make_unique<juce::TextButton>("B");
-        bypassButton->setClickingTogglesState(true);
-        bypassButton->setColour(juce::TextButton::buttonColourId, juce::Colours::darkgrey);
-        bypassButton->setColour(juce::TextButton::buttonOnColourId, juce::Colours::orange);
-        bypassButton->setColour(juce::TextButton::textColourOffId, juce::Colours::white);
-        bypassButton->setColour(juce::TextButton::textColourOnId, juce::Colours::black);
-        addAndMakeVisible(*bypassButton);
-    }
+    bypassButton = std::make_unique<juce::TextButton>("B");
+    bypassButton->setClickingTogglesState(true);
+    bypassButton->setColour(juce::TextButton::buttonColourId, juce::Colours::darkgrey);
+    bypassButton->setColour(juce::TextButton::buttonOnColourId, juce::Colours::orange);
+    bypassButton->setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    bypassButton->setColour(juce::TextButton::textColourOnId, juce::Colours::black);
+    addAndMakeVisible(*bypassButton);
 
     setTitle(module->getName());
     createControls();
-    startTimerHz(30); // 30 FPS for step visualization
+    frameClock->addClient(*this, 30, this); // 30 FPS for step visualization
 }
 
 ModuleComponent::~ModuleComponent() { detachFromProcessor(); }
 
 void ModuleComponent::detachFromProcessor() {
-    stopTimer();
+    frameClock->removeClient(*this);
     setVisible(false);
 
-    // Destroy scope component first — it has its own timer reading from the module's VisualBuffer
+    // Destroy scope component first — it has its own frame client reading from the module's VisualBuffer
     scopeComponent.reset();
     scopeToggle.reset();
     keyboardComponent.reset();
@@ -75,15 +74,10 @@ void ModuleComponent::detachFromProcessor() {
     // Destroy attachments ONLY if the processor is still alive (node exists in graph).
     // During undo, graph.clear() may have already freed the processor and its parameters.
     // If the processor is gone, release ownership to avoid use-after-free in ~ParameterAttachment.
-    bool processorAlive = false;
-    if (module != nullptr) {
-        for (auto* node : owner.getAudioEngine().getGraph().getNodes()) {
-            if (node->getProcessor() == module) {
-                processorAlive = true;
-                break;
-            }
-        }
-    }
+    // Looked up by ID straight from the graph: teardown can run before the graph's change
+    // message has reached the module registry.
+    auto* node = module != nullptr ? owner.getAudioEngine().getGraph().getNodeForId(nodeId) : nullptr;
+    bool processorAlive = node != nullptr && node->getProcessor() == module;
     if (processorAlive) {
         bypassAttachment.reset();
         sliderAttachments.clear();
@@ -104,30 +98,63 @@ void ModuleComponent::detachFromProcessor() {
     if (module == nullptr)
         return;
 
-    if (auto* node = owner.getAudioEngine().getGraph().getNodeForId(nodeId)) {
+    if (node != nullptr) {
         for (auto* param : node->getProcessor()->getParameters())
             param->removeListener(this);
     }
 
     module = nullptr;
 }
-void ModuleComponent::timerCallback() {
+void ModuleComponent::onFrame(double) {
+    GSYNTH_TRACE_SCOPE("ui", "ModuleComponent::onFrame");
     if (module == nullptr)
         return;
 
     if (auto* modBase = dynamic_cast<ModuleBase*>(module)) {
+        // Bypass can change from automation or undo, not just our button
+        bool bypassed = modBase->isBypassed();
+        if (bypassed != paintedBypassed) {
+            paintedBypassed = bypassed;
+            repaint();
+        }
+
         if (auto* vb = modBase->getVisualBuffer()) {
-            if (rmsReadBuffer.empty())
-                rmsReadBuffer.resize(vb->getSize(), 0.0f);
-            vb->copyTo(rmsReadBuffer);
-            float sum = 0.0f;
-            for (float s : rmsReadBuffer)
-                sum += s * s;
-            cachedRMS = std::sqrt(sum / (float)rmsReadBuffer.size());
+            float rms = vb->getRMS();
+            // Only the glow/LED depend on RMS; skip imperceptible changes
+            bool wasActive = cachedRMS > 0.01f;
+            bool isActive = rms > 0.01f;
+            if (wasActive != isActive || (isActive && std::abs(rms - cachedRMS) > 0.005f)) {
+                cachedRMS = rms;
+                repaintActivityIndicators();
+            }
         }
     }
 
-    repaint();
+    if (auto* seq = dynamic_cast<SequencerModule*>(module)) {
+        int activeStep = seq->currentActiveStep.load();
+        if (activeStep != paintedActiveStep) {
+            if (paintedActiveStep >= 0)
+                repaint(getStepHighlightArea(paintedActiveStep));
+            repaint(getStepHighlightArea(activeStep));
+            paintedActiveStep = activeStep;
+        }
+    }
+}
+
+juce::Rectangle<int> ModuleComponent::getStepHighlightArea(int step) const {
+    // Coordinates match resized()
+    int startX = 10;
+    int stepWidth = 60;
+    return {startX + step * stepWidth, 110, stepWidth - 5, 220}; // Cover Gate+Pitch+F.Env area
+}
+
+void ModuleComponent::repaintActivityIndicators() {
+    // Header LED plus the glow along the border
+    constexpr int glow = 4;
+    repaint(0, 0, getWidth(), 24);
+    repaint(0, 0, glow, getHeight());
+    repaint(getWidth() - glow, 0, glow, getHeight());
+    repaint(0, getHeight() - glow, getWidth(), glow);
 }
 
 void ModuleComponent::createControls() {
@@ -222,18 +249,6 @@ void ModuleComponent::createControls() {
 }
 
 void ModuleComponent::updateLayout() {
-    if (getType(module) == ModuleType::Attenuverter) {
-        setSize(40, 40);
-        if (sliders.size() > 0) {
-            sliders[0]->setBounds(0, 0, 40, 40);
-            sliders[0]->setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-            sliders[0]->setColour(juce::Slider::rotarySliderFillColourId, juce::Colours::yellow);
-            if (sliderLabels.size() > 0)
-                sliderLabels[0]->setVisible(false);
-        }
-        return;
-    }
-
     if (getType(module) == ModuleType::Sequencer) {
         setSize(510, 380);
         return;
@@ -278,10 +293,6 @@ void ModuleComponent::paint(juce::Graphics& g) {
     if (module == nullptr)
         return;
 
-    if (getType(module) == ModuleType::Attenuverter) {
-        return; // Transparent background, no ports, no header
-    }
-
     auto* mod = dynamic_cast<ModuleBase*>(module);
     bool isBypassed = mod && mod->isBypassed();
 
@@ -297,14 +308,8 @@ void ModuleComponent::paint(juce::Graphics& g) {
     // Highlight Active Step (Sequencer only)
     if (getType(module) == ModuleType::Sequencer) {
         if (auto* seq = dynamic_cast<SequencerModule*>(module)) {
-            int activeStep = seq->currentActiveStep.load();
-            // Coordinates match resized()
-            int startX = 10;
-            int stepWidth = 60;
-            int x = startX + activeStep * stepWidth;
-
             g.setColour(juce::Colours::yellow.withAlpha(0.3f));
-            g.fillRect(x, 110, stepWidth - 5, 220); // Cover Gate+Pitch+F.Env area
+            g.fillRect(getStepHighlightArea(seq->currentActiveStep.load()));
         }
     }
 
@@ -324,6 +329,13 @@ void ModuleComponent::paint(juce::Graphics& g) {
         g.fillEllipse(6.0f, 8.0f, 8.0f, 8.0f);
     }
 
+    // Oversampling region badge
+    if (mod != nullptr && mod->getOversamplingLink().isBound()) {
+        g.setColour(juce::Colours::orange);
+        g.drawText(juce::String(mod->getOversamplingLink().getFactor()) + "x", getWidth() - 30, 0, 24, 24,
+                   juce::Justification::centredRight, false);
+    }
+
     // --- PORTS ---
     int numIns = module->getTotalNumInputChannels();
     int numOuts = module->getTotalNumOutputChannels();
@@ -444,10 +456,6 @@ juce::Point<int> ModuleComponent::getPortCenter(int index, bool isInput) {
     if (module == nullptr)
         return {0, 0};
 
-    if (getType(module) == ModuleType::Attenuverter) {
-        return {getWidth() / 2, getHeight() / 2};
-    }
-
     int yStep = 20;
     int headerHeight = 30;
 
@@ -469,10 +477,6 @@ std::optional<ModuleComponent::Port> ModuleComponent::getPortForPoint(juce::Poin
     if (module == nullptr)
         return std::nullopt;
 
-    if (getType(module) == ModuleType::Attenuverter) {
-        return std::nullopt; // Users cannot manually drag connections from the smart wire knob
-    }
-
     int numIns = module->getTotalNumInputChannels();
     int numOuts = module->getTotalNumOutputChannels();
     if (auto* mb = dynamic_cast<ModuleBase*>(module)) {
@@ -721,9 +725,6 @@ void ModuleComponent::mouseDown(const juce::MouseEvent& e) {
         }
     } else {
         // Click on Body
-        if (getType(module) == ModuleType::Attenuverter)
-            return; // cannot drag
-
         if (e.mods.isPopupMenu()) {
             juce::PopupMenu m;
 
@@ -735,6 +736,19 @@ void ModuleComponent::mouseDown(const juce::MouseEvent& e) {
                         repaint();
                     }
                 });
+
+                if (mod->supportsOversampling()) {
+                    juce::PopupMenu oversamplingMenu;
+                    const int current = owner.getAudioEngine().getOversampling(nodeId);
+                    for (int factor : {1, 2, 4}) {
+                        oversamplingMenu.addItem(factor == 1 ? juce::String("Off") : juce::String(factor) + "x", true,
+                                                 factor == current, [this, factor] {
+                                                     owner.getAudioEngine().setOversampling(nodeId, factor);
+                                                     repaint();
+                                                 });
+                    }
+                    m.addSubMenu("Oversampling", oversamplingMenu);
+                }
                 m.addSeparator();
             }
 
@@ -4,6 +4,7 @@
 #include "../GravisynthUndoManager.h"
 #include "../Modules/FilterModule.h"
 #include "../Modules/MidiKeyboardModule.h"
+#include "FrameClock.h"
 #include "FrequencyResponseComponent.h"
 #include "ScopeComponent.h"
 #include <juce_audio_processors/juce_audio_processors.h>
@@ -15,7 +16,7 @@ class GraphEditor; // Forward declaration
 
 class ModuleComponent
     : public juce::Component
-    , public juce::Timer
+    , public FrameClock::Client
     , public juce::AudioProcessorParameter::Listener {
 public:
     ModuleComponent(juce::AudioProcessor* module, juce::AudioProcessorGraph::NodeID nodeId, GraphEditor& owner,
@@ -27,7 +28,7 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
-    void timerCallback() override;
+    void onFrame(double nowMs) override;
 
     void mouseDown(const juce::MouseEvent& e) override;
     void mouseDrag(const juce::MouseEvent& e) override;
@@ -38,7 +39,7 @@ public:
     juce::AudioProcessorGraph::NodeID getNodeId() const { return nodeId; }
 
     // Safely detach from the processor before graph rebuild.
-    // Removes listeners, destroys attachments, stops timer, nulls module pointer.
+    // Removes listeners, destroys attachments, leaves the frame clock, nulls module pointer.
     void detachFromProcessor();
 
     // Interaction Logic
@@ -53,6 +54,7 @@ public:
     juce::Point<int> getPortCenter(int index, bool isInput);
 
 private:
+    juce::SharedResourcePointer<FrameClock> frameClock;
     juce::AudioProcessor* module;
     juce::AudioProcessorGraph::NodeID nodeId;
     GraphEditor& owner;
@@ -85,7 +87,11 @@ private:
     juce::Point<int> dragStartPosition;
 
     float cachedRMS = 0.0f;
-    std::vector<float> rmsReadBuffer;
+    int paintedActiveStep = -1;
+    bool paintedBypassed = false;
+
+    juce::Rectangle<int> getStepHighlightArea(int step) const;
+    void repaintActivityIndicators();
 
     void createControls();
     void updateLayout();
@@ -1,62 +1,132 @@
 #pragma once
 
 #include "../Modules/VisualBuffer.h"
+#include "FrameClock.h"
+#include "ScopeEnvelope.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 
+/**
+ * Oscilloscope view of a module's VisualBuffer.
+ *
+ * Each frame the buffer is reduced to one min/max span per pixel column and the
+ * stroke path is rebuilt only when that envelope changes, reusing its storage.
+ * In trigger-sync mode (double-click to toggle) the window starts at a rising zero
+ * crossing, so periodic waveforms stand still.
+ */
 class ScopeComponent
     : public juce::Component
-    , public juce::Timer {
+    , public FrameClock::Client {
 public:
     ScopeComponent(VisualBuffer& buffer)
         : visualBuffer(buffer) {
         sampleData.resize(buffer.getSize(), 0.0f);
-        startTimerHz(60); // higher refresh rate for scope
+        frameClock->addClient(*this, 60, this); // higher refresh rate for scope
     }
 
-    ~ScopeComponent() override { stopTimer(); }
+    ~ScopeComponent() override { frameClock->removeClient(*this); }
 
-    void timerCallback() override {
-        visualBuffer.copyTo(sampleData);
+    void setTriggerSync(bool shouldSync) {
+        triggerSync = shouldSync;
+        lastWritePos = -1; // Re-read on the next frame
         repaint();
     }
+    bool getTriggerSync() const { return triggerSync; }
+
+    void onFrame(double) override {
+        // Nothing new from the audio thread: keep the last frame
+        int writePos = visualBuffer.getWritePosition();
+        if (writePos == lastWritePos)
+            return;
+        lastWritePos = writePos;
+
+        visualBuffer.copyTo(sampleData);
+        if (updateEnvelope())
+            repaint();
+    }
+
+    void resized() override {
+        // A new width re-reduces the samples; a new height only rescales the path
+        if (!updateEnvelope())
+            rebuildPath();
+    }
+
+    void mouseDoubleClick(const juce::MouseEvent&) override { setTriggerSync(!triggerSync); }
 
     void paint(juce::Graphics& g) override {
         g.fillAll(juce::Colours::black);
 
-        auto bounds = getLocalBounds().toFloat();
-        auto midY = bounds.getCentreY();
-        auto height = bounds.getHeight();
-        auto width = bounds.getWidth();
-
         g.setColour(juce::Colours::limegreen);
-        juce::Path p;
+        g.strokePath(cachedPath, juce::PathStrokeType(1.5f));
 
-        float peak = 0.01f;
-        for (float s : sampleData) {
-            peak = std::max(peak, std::abs(s));
-        }
-        // Auto-scale to fit within 90% of the height, but never scale up more than a 1.0 amplitude signal
-        float dynamicScale = std::min(1.0f, 1.0f / peak);
-
-        bool first = true;
-        for (int i = 0; i < (int)sampleData.size(); ++i) {
-            float x = juce::jmap((float)i, 0.0f, (float)sampleData.size(), 0.0f, width);
-            float y = midY - (sampleData[i] * dynamicScale * height * 0.45f);
-
-            if (first) {
-                p.startNewSubPath(x, y);
-                first = false;
-            } else {
-                p.lineTo(x, y);
-            }
+        if (triggerSync) {
+            g.setColour(juce::Colours::limegreen.withAlpha(0.6f));
+            g.setFont(10.0f);
+            g.drawText("TRIG", getLocalBounds().reduced(4), juce::Justification::topRight);
         }
-
-        g.strokePath(p, juce::PathStrokeType(1.5f));
     }
 
+    const ScopeEnvelope& getEnvelope() const { return envelope; }
+
 private:
+    juce::SharedResourcePointer<FrameClock> frameClock;
     VisualBuffer& visualBuffer;
     std::vector<float> sampleData;
+    ScopeEnvelope envelope;
+    ScopeEnvelope scratchEnvelope;
+    juce::Path cachedPath;
+    bool triggerSync = false;
+    int lastWritePos = -1;
+
+    /** Reduces the latest samples to the envelope; returns true if the drawing changed. */
+    bool updateEnvelope() {
+        int total = (int)sampleData.size();
+        int start = 0;
+        int count = total;
+        if (triggerSync) {
+            // Show half the buffer, starting at the first rising edge that leaves room for it
+            count = total / 2;
+            int edge = ScopeEnvelope::findRisingEdge(sampleData.data(), total - count);
+            start = edge >= 0 ? edge : total - count;
+        }
+
+        scratchEnvelope.build(sampleData.data() + start, count, getWidth());
+        if (scratchEnvelope == envelope)
+            return false; // e.g. a silent module pushing zeros
+
+        std::swap(envelope, scratchEnvelope);
+        rebuildPath();
+        return true;
+    }
+
+    void rebuildPath() {
+        cachedPath.clear(); // Keeps its allocation
+
+        int columns = envelope.getNumColumns();
+        if (columns == 0)
+            return;
+
+        auto bounds = getLocalBounds().toFloat();
+        auto midY = bounds.getCentreY();
+        auto height = bounds.getHeight();
+        auto columnWidth = bounds.getWidth() / (float)columns;
+
+        // Auto-scale to fit within 90% of the height, but never scale up more than a 1.0 amplitude signal
+        float dynamicScale = std::min(1.0f, 1.0f / std::max(0.01f, envelope.getPeak()));
+        float yScale = dynamicScale * height * 0.45f;
+
+        for (int c = 0; c < columns; ++c) {
+            float x = ((float)c + 0.5f) * columnWidth;
+            float yTop = midY - envelope.getMax(c) * yScale;
+            float yBottom = midY - envelope.getMin(c) * yScale;
+
+            if (c == 0)
+                cachedPath.startNewSubPath(x, yTop);
+            else
+                cachedPath.lineTo(x, yTop);
+            if (yBottom != yTop)
+                cachedPath.lineTo(x, yBottom);
+        }
+    }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeComponent)
 };
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * @class ScopeEnvelope
+ * @brief Per-pixel-column min/max reduction of a scope window.
+ *
+ * A scope never needs more detail than one vertical span per pixel column, so the
+ * window is reduced to numColumns (min, max) pairs before drawing. Storage is
+ * reused between builds, and two envelopes compare equal when a repaint would
+ * draw the same thing.
+ */
+class ScopeEnvelope {
+public:
+    /** Reduces samples[0, count) to numColumns min/max pairs (fewer if count < numColumns). */
+    void build(const float* samples, int count, int numColumns) {
+        columns = std::max(0, std::min(numColumns, count));
+        mins.resize((size_t)columns);
+        maxs.resize((size_t)columns);
+        peak = 0.0f;
+
+        for (int c = 0; c < columns; ++c) {
+            int begin = (int)((long long)c * count / columns);
+            int end = std::max(begin + 1, (int)((long long)(c + 1) * count / columns));
+            float lo = samples[begin];
+            float hi = samples[begin];
+            for (int i = begin + 1; i < end; ++i) {
+                lo = std::min(lo, samples[i]);
+                hi = std::max(hi, samples[i]);
+            }
+            mins[(size_t)c] = lo;
+            maxs[(size_t)c] = hi;
+            peak = std::max(peak, std::max(std::abs(lo), std::abs(hi)));
+        }
+    }
+
+    /**
+     * First rising zero crossing in samples[0, searchEnd), or -1 if there is none.
+     * The signal must first dip below -hysteresis, so noise around zero doesn't retrigger.
+     */
+    static int findRisingEdge(const float* samples, int searchEnd, float hysteresis = 0.01f) {
+        bool armed = false;
+        for (int i = 0; i < searchEnd; ++i) {
+            if (samples[i] < -hysteresis)
+                armed = true;
+            else if (armed && samples[i] >= 0.0f)
+                return i;
+        }
+        return -1;
+    }
+
+    int getNumColumns() const { return columns; }
+    float getMin(int column) const { return mins[(size_t)column]; }
+    float getMax(int column) const { return maxs[(size_t)column]; }
+    float getPeak() const { return peak; }
+
+    bool operator==(const ScopeEnvelope& other) const {
+        return columns == other.columns && mins == other.mins && maxs == other.maxs;
+    }
+    bool operator!=(const ScopeEnvelope& other) const { return !(*this == other); }
+
+private:
+    std::vector<float> mins;
+    std::vector<float> maxs;
+    int columns = 0;
+    float peak = 0.0f;
+};
@@ -29,6 +29,11 @@ public:
         hostEditor.setText(appProperties.getUserSettings()->getValue("ollamaHost", "http://localhost:11434"));
         hostEditor.onReturnKey = [this] { updateSettings(); };
         hostEditor.onFocusLost = [this] { updateSettings(); };
+
+        addAndMakeVisible(cacheToggle);
+        cacheToggle.setButtonText("Cache AI responses on disk");
+        cacheToggle.setToggleState(aiService.getResponseCache() != nullptr, juce::dontSendNotification);
+        cacheToggle.onClick = [this] { updateResponseCache(); };
     }
 
     void paint(juce::Graphics& g) override { g.fillAll(juce::Colours::darkgrey.darker()); }
@@ -44,6 +49,19 @@ public:
         auto hostRow = bounds.removeFromTop(25);
         hostLabel.setBounds(hostRow.removeFromLeft(100));
         hostEditor.setBounds(hostRow);
+
+        bounds.removeFromTop(30);
+        cacheToggle.setBounds(bounds.removeFromTop(25));
+    }
+
+    void updateResponseCache() {
+        bool enabled = cacheToggle.getToggleState();
+        appProperties.getUserSettings()->setValue("aiResponseCache", enabled);
+        appProperties.saveIfNeeded();
+
+        aiService.setResponseCache(enabled ? std::make_unique<gsynth::AIResponseCache>(
+                                                 gsynth::AIResponseCache::getDefaultDirectory(appProperties))
+                                           : nullptr);
     }
 
     void updateSettings() {
@@ -70,6 +88,7 @@ private:
     juce::ComboBox providerCombo;
     juce::Label hostLabel;
     juce::TextEditor hostEditor;
+    juce::ToggleButton cacheToggle;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AISettingsTab)
 };
@@ -0,0 +1,96 @@
+#include "VoiceActivityBinder.h"
+#include "Modules/ADSRModule.h"
+#include "Modules/PolyMidiModule.h"
+#include "Modules/VCAModule.h"
+#include "Modules/VoiceMixerModule.h"
+#include "TraceRecorder.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace gsynth {
+
+void bindVoiceActivity(juce::AudioProcessorGraph& graph) {
+    GSYNTH_TRACE_SCOPE("graph", "bindVoiceActivity");
+
+    // Which nodes feed each node's voice channels
+    std::unordered_map<juce::uint32, std::vector<juce::uint32>> voiceSources;
+    for (const auto& connection : graph.getConnections()) {
+        if (connection.destination.isMIDI() || connection.destination.channelIndex >= kMaxPolyVoices)
+            continue;
+        voiceSources[connection.destination.nodeID.uid].push_back(connection.source.nodeID.uid);
+    }
+
+    // Grow each Poly MIDI module's chain until no node can join; the graph is acyclic,
+    // so this takes at most one pass per node in the longest chain
+    std::vector<PolyMidiModule*> polyMidis;
+    std::unordered_map<juce::uint32, PolyMidiModule*> owners;
+    std::unordered_set<juce::uint32> mixdowns; // Sum their voices, so what they feed is no longer per voice
+    for (auto* node : graph.getNodes()) {
+        auto* processor = node->getProcessor();
+        if (auto* polyMidi = dynamic_cast<PolyMidiModule*>(processor)) {
+            polyMidis.push_back(polyMidi);
+            owners[node->nodeID.uid] = polyMidi;
+        } else if (dynamic_cast<VCAModule*>(processor) != nullptr ||
+                   dynamic_cast<VoiceMixerModule*>(processor) != nullptr) {
+            mixdowns.insert(node->nodeID.uid);
+        }
+    }
+
+    for (bool grew = true; grew;) {
+        grew = false;
+        for (const auto& [nodeID, sources] : voiceSources) {
+            if (owners.count(nodeID) != 0)
+                continue;
+
+            PolyMidiModule* owner = nullptr;
+            for (auto source : sources) {
+                auto it = owners.find(source);
+                if (it == owners.end() || mixdowns.count(source) != 0 || (owner != nullptr && it->second != owner)) {
+                    owner = nullptr;
+                    break;
+                }
+                owner = it->second;
+            }
+
+            if (owner != nullptr) {
+                owners[nodeID] = owner;
+                grew = true;
+            }
+        }
+    }
+
+    // Envelope slots are counted per chain first, so a chain with too many envelopes isn't bound at all
+    std::unordered_map<PolyMidiModule*, int> numEnvelopes;
+    for (auto* node : graph.getNodes())
+        if (dynamic_cast<ADSRModule*>(node->getProcessor()) != nullptr)
+            if (auto it = owners.find(node->nodeID.uid); it != owners.end())
+                ++numEnvelopes[it->second];
+
+    auto isBindable = [&numEnvelopes](PolyMidiModule* polyMidi) {
+        auto it = numEnvelopes.find(polyMidi);
+        return it == numEnvelopes.end() || it->second <= VoiceActivity::kMaxEnvelopes;
+    };
+
+    for (auto* polyMidi : polyMidis)
+        if (isBindable(polyMidi))
+            polyMidi->getVoiceActivity()->setNumEnvelopes(numEnvelopes[polyMidi]);
+
+    std::unordered_map<PolyMidiModule*, int> nextSlot;
+    for (auto* node : graph.getNodes()) {
+        auto* module = dynamic_cast<ModuleBase*>(node->getProcessor());
+        if (module == nullptr || dynamic_cast<PolyMidiModule*>(module) != nullptr)
+            continue;
+
+        auto it = owners.find(node->nodeID.uid);
+        if (it == owners.end() || !isBindable(it->second)) {
+            module->getVoiceActivityLink().unbind();
+            continue;
+        }
+
+        int slot = dynamic_cast<ADSRModule*>(module) != nullptr ? nextSlot[it->second]++ : -1;
+        module->getVoiceActivityLink().bind(it->second->getVoiceActivity(), slot);
+    }
+}
+
+} // namespace gsynth
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace gsynth {
+
+/**
+ * @brief Binds every module's VoiceActivityLink to the Poly MIDI module that drives its voices.
+ *
+ * A module belongs to a Poly MIDI module when every connection into its voice
+ * channels (the first kMaxPolyVoices inputs) comes from that Poly MIDI module or
+ * from another module that belongs to it. CV inputs after the voice channels are
+ * ignored, so modulation from LFOs and other shared sources doesn't break a chain.
+ * Modules fed from two Poly MIDI modules, or from anything outside a chain, are
+ * unbound and keep rendering every voice. A chain ends at a VCA or Voice Mixer,
+ * whose outputs are a mix rather than one channel per voice. Each poly ADSR in a
+ * chain gets an envelope slot, so released voices stay sounding until their
+ * envelope finishes.
+ *
+ * Run after every topology change. Message thread only.
+ */
+void bindVoiceActivity(juce::AudioProcessorGraph& graph);
+
+} // namespace gsynth
@@ -377,3 +377,55 @@ TEST_F(ADSRTest, PolyMode_GateEdgeDetection) {
     adsr.processBlock(polyBuffer, emptyMidi);
     // Envelope should start decaying
 }
+
+TEST_F(ADSRTest, PolyMode_DetectsGateEdgesMidBlock) {
+    *dynamic_cast<juce::AudioParameterBool*>(adsr.getParameters()[5]) = true;
+
+    juce::AudioBuffer<float> polyBuffer(kMaxPolyVoices, 512);
+    polyBuffer.clear();
+    for (int i = 200; i < 512; ++i)
+        polyBuffer.setSample(1, i, 1.0f); // Voice 1 gate rises at sample 200
+
+    juce::MidiBuffer emptyMidi;
+    adsr.processBlock(polyBuffer, emptyMidi);
+
+    EXPECT_EQ(polyBuffer.getMagnitude(1, 0, 200), 0.0f);
+    EXPECT_GT(polyBuffer.getSample(1, 200), 0.0f);
+    EXPECT_GT(polyBuffer.getSample(1, 511), polyBuffer.getSample(1, 300));
+    EXPECT_EQ(polyBuffer.getMagnitude(0, 0, 512), 0.0f); // Other voices untouched
+}
+
+TEST_F(ADSRTest, MonoNoteStartsAtItsSamplePosition) {
+    midiMessages.addEvent(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100), 256);
+    adsr.processBlock(buffer, midiMessages);
+
+    EXPECT_EQ(buffer.getMagnitude(0, 0, 256), 0.0f);
+    EXPECT_GT(buffer.getSample(0, 300), 0.0f);
+    EXPECT_EQ(buffer.getMagnitude(1, 0, 512), 0.0f); // Only the envelope channel is written
+}
+
+TEST_F(ADSRTest, CurvesShareEndpointsButBendDifferently) {
+    ASSERT_NE(dynamic_cast<juce::AudioParameterChoice*>(adsr.getParameters()[6]), nullptr);
+
+    // Attack 1 s, so the whole block is attack
+    auto attackAfter = [&](int curve, int numSamples) {
+        ADSRModule env;
+        *dynamic_cast<juce::AudioParameterFloat*>(env.getParameters()[1]) = 1.0f;
+        *dynamic_cast<juce::AudioParameterChoice*>(env.getParameters()[6]) = curve;
+        env.prepareToPlay(44100.0, numSamples);
+        juce::AudioBuffer<float> out(1, numSamples);
+        juce::MidiBuffer midi;
+        midi.addEvent(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100), 0);
+        env.processBlock(out, midi);
+        return out.getSample(0, numSamples - 1);
+    };
+
+    // A quarter of the way through the attack
+    float linear = attackAfter(0, 11025);
+    float exponential = attackAfter(1, 11025);
+    float analogue = attackAfter(2, 11025);
+    EXPECT_NEAR(linear, 0.25f, 0.01f);
+    EXPECT_GT(exponential, linear); // RC curves rise fast, then bend over into the peak
+    EXPECT_GT(analogue, linear);
+    EXPECT_LT(analogue, 1.0f);
+}
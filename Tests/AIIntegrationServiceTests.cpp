@@ -8,7 +8,9 @@ class MockAIProvider : public AIProvider {
 public:
     void sendPrompt(const std::vector<Message>& conversation, CompletionCallback callback,
                     const juce::var& responseSchema) override {
-        juce::ignoreUnused(conversation, responseSchema);
+        juce::ignoreUnused(responseSchema);
+        lastConversation = conversation;
+        ++numCalls;
         if (shouldFail) {
             callback("Error", false);
         } else {
@@ -30,6 +32,8 @@ public:
     juce::String mockResponse = "{\"nodes\": [], \"connections\": []}";
     bool shouldFail = false;
     juce::String currentModel;
+    std::vector<Message> lastConversation;
+    int numCalls = 0;
 };
 
 class AIIntegrationServiceTest : public ::testing::Test {
@@ -132,4 +136,97 @@ TEST_F(AIIntegrationServiceTest, ApplyPatch_DefaultReplace_ClearsGraph) {
     ASSERT_EQ(graph->getNumNodes(), 1); // Only the Filter from JSON, Oscillator cleared
 }
 
+TEST_F(AIIntegrationServiceTest, PatchRequestsSendCompactSnapshotThenDeltas) {
+    auto provider = std::make_unique<MockAIProvider>();
+    auto* rawProvider = provider.get();
+    service->setProvider(std::move(provider));
+    rawProvider->mockResponse = "ok";
+
+    auto* osc = graph->addNode(std::make_unique<OscillatorModule>());
+
+    service->sendMessage("Make it brighter", nullptr, true);
+    auto first = rawProvider->lastConversation.back().content;
+    EXPECT_TRUE(first.startsWith("Current patch state (compact format)"));
+    EXPECT_TRUE(first.endsWith("User request: Make it brighter"));
+    EXPECT_FALSE(first.contains("position")); // Layout is not sent
+
+    service->sendMessage("Again", nullptr, true);
+    EXPECT_TRUE(rawProvider->lastConversation.back().content.startsWith("Patch unchanged"));
+
+    auto* waveform = dynamic_cast<juce::AudioParameterChoice*>(osc->getProcessor()->getParameters()[1]);
+    ASSERT_NE(waveform, nullptr);
+    *waveform = (waveform->getIndex() + 1) % waveform->choices.size();
+    service->sendMessage("And once more", nullptr, true);
+    auto third = rawProvider->lastConversation.back().content;
+    EXPECT_TRUE(third.startsWith("Patch changes since the last state I sent"));
+    EXPECT_TRUE(third.contains(waveform->paramID));
+}
+
+TEST_F(AIIntegrationServiceTest, HistoryIsTrimmedToTokenBudget) {
+    auto provider = std::make_unique<MockAIProvider>();
+    auto* rawProvider = provider.get();
+    service->setProvider(std::move(provider));
+    rawProvider->mockResponse = "ok";
+    graph->addNode(std::make_unique<OscillatorModule>());
+
+    service->setHistoryTokenBudget(100);
+    service->sendMessage("Patch please", nullptr, true); // Full snapshot
+    for (int i = 0; i < 10; ++i)
+        service->sendMessage(juce::String::repeatedString("chatter ", 20), nullptr);
+
+    const auto& sent = rawProvider->lastConversation;
+    EXPECT_EQ(sent.front().role, "system"); // Always kept, outside the budget
+    EXPECT_LT(sent.size(), service->getHistory().size());
+    int tokens = 0;
+    for (size_t i = 1; i < sent.size(); ++i)
+        tokens += PatchContextEncoder::estimateTokens(sent[i].content);
+    EXPECT_LE(tokens, 100);
+
+    // The snapshot has scrolled out of the window, so the next patch request resends it in full
+    service->sendMessage("Now a patch", nullptr, true);
+    EXPECT_TRUE(rawProvider->lastConversation.back().content.startsWith("Current patch state"));
+}
+
+TEST_F(AIIntegrationServiceTest, ResponseCacheAnswersRepeatedPrompts) {
+    auto provider = std::make_unique<MockAIProvider>();
+    auto* rawProvider = provider.get();
+    service->setProvider(std::move(provider));
+    rawProvider->mockResponse = "Use a saw wave.";
+
+    auto dir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                   .getNonexistentChildFile("GravisynthResponseCacheTest", "");
+    service->setResponseCache(std::make_unique<AIResponseCache>(dir));
+
+    service->sendMessage("How do I get a buzzy tone?", nullptr);
+    EXPECT_EQ(rawProvider->numCalls, 1);
+    EXPECT_EQ(service->getResponseCache()->getNumEntries(), 1);
+
+    // Same model and prompt window: answered from disk, still recorded in the history
+    service->clearHistory();
+    juce::String response;
+    service->sendMessage("How do I get a buzzy tone?", [&](const juce::String& r, bool ok) {
+        EXPECT_TRUE(ok);
+        response = r;
+    });
+    EXPECT_EQ(rawProvider->numCalls, 1);
+    EXPECT_EQ(response, "Use a saw wave.");
+    EXPECT_EQ(service->getHistory().back().content, "Use a saw wave.");
+
+    // A different model is a different key
+    service->clearHistory();
+    service->setModel("other-model");
+    service->sendMessage("How do I get a buzzy tone?", nullptr);
+    EXPECT_EQ(rawProvider->numCalls, 2);
+
+    // Failures are never cached
+    rawProvider->shouldFail = true;
+    service->sendMessage("Something new", nullptr);
+    EXPECT_EQ(service->getResponseCache()->getNumEntries(), 2);
+
+    service->getResponseCache()->clear();
+    EXPECT_EQ(service->getResponseCache()->getNumEntries(), 0);
+    service->setResponseCache(nullptr);
+    dir.deleteRecursively();
+}
+
 } // namespace gsynth
@@ -1,5 +1,5 @@
 #include "../Source/AI/AIStateMapper.h"
-#include "../Source/Modules/AttenuverterModule.h"
+#include "../Source/ModMatrixRoutes.h"
 #include "../Source/Modules/FilterModule.h"
 #include "../Source/Modules/LFOModule.h"
 #include "../Source/Modules/OscillatorModule.h"
@@ -257,8 +257,8 @@ TEST(AIStateMapperTest, FactorySupportsAllModuleTypes) {
     juce::StringArray expectedTypes = {"Audio Input", "Audio Output",   "Midi Input",    "Oscillator", "Filter",
                                        "VCA",         "ADSR",           "Sequencer",     "LFO",        "Distortion",
                                        "Delay",       "Reverb",         "MIDI Keyboard", "Amp Env",    "Filter Env",
-                                       "Poly MIDI",   "Poly Sequencer", "Attenuverter",  "Chorus",     "Phaser",
-                                       "Compressor",  "Flanger",        "Limiter"};
+                                       "Poly MIDI",   "Poly Sequencer", "Chorus",        "Phaser",     "Compressor",
+                                       "Flanger",     "Limiter"};
     for (const auto& type : expectedTypes) {
         auto module = gsynth::AIStateMapper::createModule(type);
         EXPECT_NE(module, nullptr) << "Failed to create module: " << type.toStdString();
@@ -382,17 +382,19 @@ TEST(AIStateMapperTest, Modulation_GraphToJSON_SerializesModulations) {
     auto lfoNode = graph.addNode(std::make_unique<LFOModule>());
     auto filterNode = graph.addNode(std::make_unique<FilterModule>());
 
-    // Create attenuverter-based modulation: LFO -> Attenuverter -> Filter cutoff (channel 1)
-    auto attenNode = graph.addNode(std::make_unique<AttenuverterModule>());
-    // Set amount to 0.7
-    if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(attenNode->getProcessor()->getParameters()[1]))
-        param->setValueNotifyingHost(param->convertTo0to1(0.7f));
-
-    graph.addConnection({{lfoNode->nodeID, 0}, {attenNode->nodeID, 0}});
-    graph.addConnection({{attenNode->nodeID, 0}, {filterNode->nodeID, 1}});
+    // LFO -> Filter cutoff (channel 1) through a mod matrix slot
+    {
+        gsynth::GraphTransaction txn(graph);
+        ASSERT_TRUE(gsynth::addModRoute(txn, juce::AudioProcessorGraph::NodeAndChannel{lfoNode->nodeID, 0},
+                                        juce::AudioProcessorGraph::NodeAndChannel{filterNode->nodeID, 1}, 0.7f));
+    }
 
     auto json = gsynth::AIStateMapper::graphToJSON(graph);
 
+    // The matrix is written as the modulation only, not as a node or connections
+    EXPECT_EQ(json["nodes"].size(), 2);
+    EXPECT_EQ(json["connections"].size(), 0);
+
     // Verify modulations array exists and has one entry
     auto* rootObj = json.getDynamicObject();
     ASSERT_TRUE(rootObj->hasProperty("modulations"));
@@ -426,36 +428,21 @@ TEST(AIStateMapperTest, Modulation_ApplyJSON_CreatesModulationChain) {
     bool success = gsynth::AIStateMapper::applyJSONToGraph(json, graph, true);
     ASSERT_TRUE(success);
 
-    // Should have 3 nodes: LFO, Filter, and auto-created Attenuverter
+    // Should have 3 nodes: LFO, Filter, and the mod matrix
     ASSERT_EQ(graph.getNumNodes(), 3);
 
-    // Find the attenuverter node
-    juce::AudioProcessorGraph::Node* attenNode = nullptr;
-    for (auto* node : graph.getNodes()) {
-        if (dynamic_cast<AttenuverterModule*>(node->getProcessor()) != nullptr) {
-            attenNode = node;
-            break;
-        }
-    }
-    ASSERT_NE(attenNode, nullptr);
+    auto routes = gsynth::getModRoutes(graph);
+    ASSERT_EQ(routes.size(), 1u);
+    const auto& route = routes[0];
 
     // Verify amount parameter is set to 0.5
-    auto* amountParam = dynamic_cast<juce::RangedAudioParameter*>(attenNode->getProcessor()->getParameters()[1]);
-    ASSERT_NE(amountParam, nullptr);
-    float amount = amountParam->getNormalisableRange().convertFrom0to1(amountParam->getValue());
-    EXPECT_NEAR(amount, 0.5f, 0.05f);
-
-    // Verify connections exist: source->atten and atten->dest
-    bool hasSourceToAtten = false;
-    bool hasAttenToDest = false;
-    for (const auto& conn : graph.getConnections()) {
-        if (conn.destination.nodeID == attenNode->nodeID && conn.destination.channelIndex == 0)
-            hasSourceToAtten = true;
-        if (conn.source.nodeID == attenNode->nodeID && conn.destination.channelIndex == 1)
-            hasAttenToDest = true;
-    }
-    EXPECT_TRUE(hasSourceToAtten);
-    EXPECT_TRUE(hasAttenToDest);
+    EXPECT_NEAR(route.matrix->getAmountParameter(route.slot).get(), 0.5f, 0.05f);
+
+    // Verify connections exist: source->slot and slot->dest
+    ASSERT_TRUE(route.source.has_value());
+    ASSERT_TRUE(route.dest.has_value());
+    EXPECT_EQ(route.source->channelIndex, 0);
+    EXPECT_EQ(route.dest->channelIndex, 1);
 }
 
 TEST(AIStateMapperTest, Modulation_RemoveModulations) {
@@ -473,7 +460,7 @@ TEST(AIStateMapperTest, Modulation_RemoveModulations) {
         ]
     })");
     ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(setupJson, graph, true));
-    ASSERT_EQ(graph.getNumNodes(), 3); // LFO + Filter + Attenuverter
+    ASSERT_EQ(gsynth::getModRoutes(graph).size(), 1u);
 
     // Now remove the modulation in merge mode
     // We need the mapped IDs - find LFO and Filter node IDs
@@ -491,13 +478,9 @@ TEST(AIStateMapperTest, Modulation_RemoveModulations) {
 
     ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(juce::JSON::parse(removeJson), graph, false));
 
-    // Attenuverter should be removed, only LFO and Filter remain
-    ASSERT_EQ(graph.getNumNodes(), 2);
-
-    // No attenuverter should exist
-    for (auto* node : graph.getNodes()) {
-        EXPECT_EQ(dynamic_cast<AttenuverterModule*>(node->getProcessor()), nullptr);
-    }
+    // The route's slot is freed; the matrix stays for later routes
+    EXPECT_TRUE(gsynth::getModRoutes(graph).empty());
+    EXPECT_EQ(graph.getNumNodes(), 3);
 }
 
 TEST(AIStateMapperTest, Modulation_MergeMode_AddModulation) {
@@ -520,7 +503,8 @@ TEST(AIStateMapperTest, Modulation_MergeMode_AddModulation) {
 
     bool success = gsynth::AIStateMapper::applyJSONToGraph(juce::JSON::parse(jsonStr), graph, false);
     ASSERT_TRUE(success);
-    ASSERT_EQ(graph.getNumNodes(), 3); // LFO + Filter + new Attenuverter
+    ASSERT_EQ(graph.getNumNodes(), 3); // LFO + Filter + new mod matrix
+    ASSERT_EQ(gsynth::getModRoutes(graph).size(), 1u);
 }
 
 TEST(AIStateMapperTest, Modulation_SchemaIncludesModulationTargets) {
@@ -548,29 +532,85 @@ TEST(AIStateMapperTest, Modulation_DefaultAmount) {
 
     ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(json, graph, true));
 
-    // Find attenuverter and check amount is 1.0
-    for (auto* node : graph.getNodes()) {
-        if (dynamic_cast<AttenuverterModule*>(node->getProcessor())) {
-            auto* amountParam = dynamic_cast<juce::RangedAudioParameter*>(node->getProcessor()->getParameters()[1]);
-            float amount = amountParam->getNormalisableRange().convertFrom0to1(amountParam->getValue());
-            EXPECT_NEAR(amount, 1.0f, 0.05f);
-            return;
-        }
-    }
-    FAIL() << "No attenuverter node found";
+    // Find the route and check amount is 1.0
+    auto routes = gsynth::getModRoutes(graph);
+    ASSERT_EQ(routes.size(), 1u);
+    EXPECT_NEAR(routes[0].matrix->getAmountParameter(routes[0].slot).get(), 1.0f, 0.05f);
 }
 
-TEST(AIStateMapperTest, Modulation_UnconnectedAttenuverterNotSerialized) {
+TEST(AIStateMapperTest, Modulation_EmptyRouteRoundTrips) {
     juce::AudioProcessorGraph graph;
 
-    // Add a standalone attenuverter with no connections
-    graph.addNode(std::make_unique<AttenuverterModule>());
+    // A route with no ends yet, as "Add Modulation" creates
+    {
+        gsynth::GraphTransaction txn(graph);
+        ASSERT_TRUE(gsynth::addModRoute(txn, std::nullopt, std::nullopt, 0.25f, true));
+    }
 
     auto json = gsynth::AIStateMapper::graphToJSON(graph);
-
-    auto* rootObj = json.getDynamicObject();
-    ASSERT_TRUE(rootObj->hasProperty("modulations"));
-    auto* modArr = rootObj->getProperty("modulations").getArray();
+    auto* modArr = json["modulations"].getArray();
     ASSERT_NE(modArr, nullptr);
-    EXPECT_EQ(modArr->size(), 0); // Unconnected attenuverter should NOT appear
+    ASSERT_EQ(modArr->size(), 1);
+    EXPECT_FALSE((*modArr)[0].hasProperty("source"));
+    EXPECT_FALSE((*modArr)[0].hasProperty("dest"));
+
+    juce::AudioProcessorGraph restored;
+    ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(json, restored, true, true));
+    auto routes = gsynth::getModRoutes(restored);
+    ASSERT_EQ(routes.size(), 1u);
+    EXPECT_FALSE(routes[0].source.has_value());
+    EXPECT_FALSE(routes[0].dest.has_value());
+    EXPECT_NEAR(routes[0].matrix->getAmountParameter(routes[0].slot).get(), 0.25f, 0.01f);
+    EXPECT_TRUE(routes[0].matrix->isSlotBypassed(routes[0].slot));
+}
+
+TEST(AIStateMapperTest, Modulation_LegacyAttenuverterNodesBecomeRoutes) {
+    juce::AudioProcessorGraph graph;
+
+    // Patches saved before the mod matrix: one Attenuverter node per modulation
+    juce::var json = juce::JSON::parse(R"({
+        "nodes": [
+            {"id": 1, "type": "LFO"},
+            {"id": 2, "type": "Filter"},
+            {"id": 3, "type": "Attenuverter", "params": {"amount": -0.4, "bypassed": true}},
+            {"id": 4, "type": "Mod Slot 2", "params": {"amount": 0.8}}
+        ],
+        "connections": [
+            {"src": 1, "srcPort": 0, "dst": 3, "dstPort": 0},
+            {"src": 3, "srcPort": 0, "dst": 2, "dstPort": 1},
+            {"src": 1, "srcPort": 0, "dst": 4, "dstPort": 1}
+        ],
+        "modulations": [
+            {"source": 1, "sourcePort": 0, "dest": 2, "destPort": 1, "amount": -0.4, "bypass": true}
+        ]
+    })");
+
+    ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(json, graph, true));
+
+    // The duplicate "modulations" entry is skipped; the unconnected slot stays as an empty route,
+    // its amount CV link dropped
+    auto routes = gsynth::getModRoutes(graph);
+    ASSERT_EQ(routes.size(), 2u);
+    EXPECT_EQ(graph.getNumNodes(), 3); // LFO + Filter + one mod matrix
+
+    const auto& routed = routes[0];
+    ASSERT_TRUE(routed.source.has_value());
+    ASSERT_TRUE(routed.dest.has_value());
+    EXPECT_EQ(routed.dest->channelIndex, 1);
+    EXPECT_NEAR(routed.matrix->getAmountParameter(routed.slot).get(), -0.4f, 0.01f);
+    EXPECT_TRUE(routed.matrix->isSlotBypassed(routed.slot));
+
+    EXPECT_FALSE(routes[1].source.has_value());
+    EXPECT_FALSE(routes[1].dest.has_value());
+    EXPECT_NEAR(routes[1].matrix->getAmountParameter(routes[1].slot).get(), 0.8f, 0.01f);
+}
+
+TEST(AIStateMapperTest, SchemasAreBuiltOnce) {
+    auto first = gsynth::AIStateMapper::getPatchSchema();
+    auto second = gsynth::AIStateMapper::getPatchSchema();
+    EXPECT_EQ(first.getDynamicObject(), second.getDynamicObject()); // Shared, not rebuilt
+
+    auto moduleSchema = gsynth::AIStateMapper::getModuleSchema();
+    EXPECT_EQ(moduleSchema, gsynth::AIStateMapper::getModuleSchema());
+    EXPECT_TRUE(moduleSchema.contains("#### Oscillator"));
 }
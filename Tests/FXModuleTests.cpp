@@ -1,5 +1,4 @@
 #include "Modules/ADSRModule.h"
-#include "Modules/AttenuverterModule.h"
 #include "Modules/FX/ChorusModule.h"
 #include "Modules/FX/CompressorModule.h"
 #include "Modules/FX/DelayModule.h"
@@ -10,99 +9,97 @@
 #include "Modules/FX/ReverbModule.h"
 #include "Modules/FilterModule.h"
 #include "Modules/LFOModule.h"
+#include "Modules/ModMatrixModule.h"
 #include "Modules/OscillatorModule.h"
 #include "Modules/VCAModule.h"
 #include <gtest/gtest.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 
 // ---------------------------------------------------------------------------
-// AttenuverterModule tests
+// ModMatrixModule tests
 // ---------------------------------------------------------------------------
 
-class AttenuverterModuleTest : public ::testing::Test {
+class ModMatrixModuleTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        module = std::make_unique<AttenuverterModule>();
+        module = std::make_unique<ModMatrixModule>();
         module->prepareToPlay(44100.0, 512);
     }
 
-    std::unique_ptr<AttenuverterModule> module;
-};
-
-TEST_F(AttenuverterModuleTest, ProcessBlockAttenuatesSignal) {
-    // 2 channels: ch0 = audio, ch1 = CV amount
-    juce::AudioBuffer<float> buffer(2, 512);
-    buffer.clear();
+    // Every slot's input carries 1.0
+    juce::AudioBuffer<float> makeBuffer() {
+        juce::AudioBuffer<float> buffer(ModMatrixModule::kNumSlots, 512);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), 1.0f, buffer.getNumSamples());
+        return buffer;
+    }
 
-    // Fill audio channel with a constant 1.0f
-    for (int i = 0; i < 512; ++i)
-        buffer.setSample(0, i, 1.0f);
+    std::unique_ptr<ModMatrixModule> module;
+};
 
-    // Set amount param to 0.5 via the first float parameter
-    auto* amountParam = dynamic_cast<juce::AudioParameterFloat*>(module->getParameters()[1]);
-    ASSERT_NE(amountParam, nullptr);
-    amountParam->setValueNotifyingHost(0.75f); // normalized: maps to 0.75 in [-1,1] range => 0.5
+TEST_F(ModMatrixModuleTest, ProcessBlockScalesEachRouteByItsAmount) {
+    int half = module->allocateSlot(0.5f, false);
+    int inverted = module->allocateSlot(-1.0f, false);
+    ASSERT_EQ(half, 0);
+    ASSERT_EQ(inverted, 1);
 
+    auto buffer = makeBuffer();
     juce::MidiBuffer midi;
     module->processBlock(buffer, midi);
 
-    // Output should be attenuated (not the original 1.0f)
-    // We just verify it stays within a reasonable range and is non-zero
-    float lastSample = buffer.getSample(0, 511);
-    EXPECT_GE(lastSample, -1.0f);
-    EXPECT_LE(lastSample, 1.0f);
+    for (int i = 0; i < buffer.getNumSamples(); ++i) {
+        EXPECT_FLOAT_EQ(buffer.getSample(half, i), 0.5f);
+        EXPECT_FLOAT_EQ(buffer.getSample(inverted, i), -1.0f);
+    }
+    EXPECT_FLOAT_EQ(module->getLastOutputPeak(half), 0.5f);
+    EXPECT_FLOAT_EQ(module->getLastOutputPeak(inverted), 1.0f);
 }
 
-TEST_F(AttenuverterModuleTest, ProcessBlockBypassClearsSilent) {
-    juce::AudioBuffer<float> buffer(2, 512);
-    buffer.clear();
-
-    // Fill audio channel with signal
-    for (int i = 0; i < 512; ++i)
-        buffer.setSample(0, i, 1.0f);
-
-    // Enable bypass (parameter index 0 in ModuleBase)
-    auto* bypassParam = dynamic_cast<juce::AudioParameterBool*>(module->getParameters()[0]);
-    ASSERT_NE(bypassParam, nullptr);
-    bypassParam->setValueNotifyingHost(1.0f); // true
+TEST_F(ModMatrixModuleTest, ProcessBlockSilencesUnusedAndBypassedSlots) {
+    int bypassed = module->allocateSlot(1.0f, true);
+    int active = module->allocateSlot(1.0f, false);
 
+    auto buffer = makeBuffer();
     juce::MidiBuffer midi;
     module->processBlock(buffer, midi);
 
-    // With bypass enabled, buffer should be cleared (silent)
-    for (int i = 0; i < 512; ++i) {
-        EXPECT_FLOAT_EQ(buffer.getSample(0, i), 0.0f);
-    }
+    EXPECT_FLOAT_EQ(buffer.getMagnitude(bypassed, 0, buffer.getNumSamples()), 0.0f);
+    EXPECT_FLOAT_EQ(buffer.getMagnitude(active, 0, buffer.getNumSamples()), 1.0f);
+    for (int slot = active + 1; slot < ModMatrixModule::kNumSlots; ++slot)
+        EXPECT_FLOAT_EQ(buffer.getMagnitude(slot, 0, buffer.getNumSamples()), 0.0f) << "slot " << slot;
 }
 
-TEST_F(AttenuverterModuleTest, ProcessBlockWithCVAmountModulation) {
-    // ch0 = audio, ch1 = CV modulation on amount
-    juce::AudioBuffer<float> buffer(2, 1000);
-    buffer.clear();
-
-    // Fill audio channel with 1.0f
-    for (int i = 0; i < 1000; ++i)
-        buffer.setSample(0, i, 1.0f);
-
-    // Set base amount to 0.0 so the CV alone controls the output
-    auto* amountParam = dynamic_cast<juce::AudioParameterFloat*>(module->getParameters()[1]);
-    ASSERT_NE(amountParam, nullptr);
-    amountParam->setValueNotifyingHost(0.5f); // normalized 0.5 => 0.0 in [-1,1]
-
-    // Set CV channel to 0.5
-    for (int i = 0; i < 1000; ++i)
-        buffer.setSample(1, i, 0.5f);
-
+TEST_F(ModMatrixModuleTest, ProcessBlockGlidesToNewAmount) {
+    int slot = module->allocateSlot(0.0f, false);
     juce::MidiBuffer midi;
+    auto buffer = makeBuffer();
+    module->processBlock(buffer, midi);
+
+    auto& amount = module->getAmountParameter(slot);
+    amount.setValueNotifyingHost(amount.convertTo0to1(1.0f));
+    buffer = makeBuffer();
     module->processBlock(buffer, midi);
 
-    // With CV = 0.5 and base amount ~0.0, result should be influenced by CV
-    // Output should be non-zero at the last sample (after smoothing settles)
-    float lastSample = buffer.getSample(0, 999);
-    EXPECT_NE(lastSample, 0.0f);
+    // Smoothed over 10 ms (441 samples): rising from 0, settled by the block's end
+    EXPECT_LT(buffer.getSample(slot, 0), 0.1f);
+    EXPECT_FLOAT_EQ(buffer.getSample(slot, 511), 1.0f);
+}
+
+TEST_F(ModMatrixModuleTest, ReleasedSlotsAreReused) {
+    for (int i = 0; i < ModMatrixModule::kNumSlots; ++i)
+        ASSERT_EQ(module->allocateSlot(1.0f, false), i);
+    EXPECT_FALSE(module->hasFreeSlot());
+    EXPECT_EQ(module->allocateSlot(1.0f, false), -1);
+
+    module->releaseSlot(3);
+    EXPECT_TRUE(module->hasFreeSlot());
+    EXPECT_FALSE(module->isSlotUsed(3));
+    EXPECT_EQ(module->allocateSlot(0.25f, true), 3);
+    EXPECT_FLOAT_EQ(module->getAmountParameter(3).get(), 0.25f);
+    EXPECT_TRUE(module->isSlotBypassed(3));
 }
 
-TEST_F(AttenuverterModuleTest, ProcessBlockEmptyBufferDoesNotCrash) {
+TEST_F(ModMatrixModuleTest, ProcessBlockEmptyBufferDoesNotCrash) {
     juce::AudioBuffer<float> buffer(0, 512);
     juce::MidiBuffer midi;
     // Should return early without crashing
@@ -605,6 +602,33 @@ TEST_F(ChorusModuleTest, ModuleTypeAndCategoryAreCorrect) {
     EXPECT_EQ(module->getModulationCategory(), ModulationCategory::FX);
 }
 
+TEST_F(ChorusModuleTest, OutputDoesNotDependOnBlockSize) {
+    ChorusModule other;
+    other.prepareToPlay(44100.0, 512);
+
+    // Same input and a slow Rate CV sweep, rendered as one 2048-sample block and as 100-sample blocks
+    juce::AudioBuffer<float> whole(4, 2048);
+    for (int i = 0; i < 2048; ++i) {
+        whole.setSample(0, i, std::sin((float)i * 0.05f));
+        whole.setSample(1, i, std::sin((float)i * 0.07f));
+        whole.setSample(2, i, std::sin((float)i * 0.002f));
+        whole.setSample(3, i, 0.0f);
+    }
+    juce::AudioBuffer<float> split(whole);
+
+    juce::MidiBuffer midi;
+    module->processBlock(whole, midi);
+    for (int start = 0; start < 2048; start += 100) {
+        const int n = std::min(100, 2048 - start);
+        juce::AudioBuffer<float> block(split.getArrayOfWritePointers(), 4, start, n);
+        other.processBlock(block, midi);
+    }
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 2048; ++i)
+            ASSERT_EQ(whole.getSample(ch, i), split.getSample(ch, i)) << "channel " << ch << ", sample " << i;
+}
+
 // ---------------------------------------------------------------------------
 // PhaserModule tests
 // ---------------------------------------------------------------------------
@@ -729,6 +753,64 @@ TEST_F(CompressorModuleTest, ModuleTypeAndCategoryAreCorrect) {
     EXPECT_EQ(module->getModulationCategory(), ModulationCategory::FX);
 }
 
+TEST_F(CompressorModuleTest, ThresholdCVIsReadAtControlRate) {
+    EXPECT_EQ(module->getInputPortRate(0), PortRate::Audio);
+    EXPECT_EQ(module->getInputPortRate(4), PortRate::Control);
+
+    // Only the first sample of each control block counts: a CV that is -1 there and 0
+    // elsewhere drops the threshold by 30 dB for the whole block
+    auto render = [this](bool withCV) {
+        module->prepareToPlay(44100.0, 512);
+        juce::AudioBuffer<float> buffer(5, 512);
+        juce::MidiBuffer midi;
+        for (int block = 0; block < 8; ++block) {
+            buffer.clear();
+            for (int i = 0; i < 512; ++i) {
+                buffer.setSample(0, i, 0.25f);
+                buffer.setSample(1, i, 0.25f);
+                if (withCV && i % ModuleBase::kControlBlockSize == 0)
+                    buffer.setSample(4, i, -1.0f);
+            }
+            module->processBlock(buffer, midi);
+        }
+        return module->getGainReductionDb();
+    };
+
+    const float withoutCV = render(false);
+    const float withCV = render(true);
+    EXPECT_LT(withCV, withoutCV - 6.0f);
+}
+
+TEST_F(CompressorModuleTest, ExternalSidechainDrivesGainReduction) {
+    auto* sidechainParam = dynamic_cast<juce::AudioParameterBool*>(module->getParameters()[9]);
+    ASSERT_NE(sidechainParam, nullptr);
+    sidechainParam->setValueNotifyingHost(1.0f);
+
+    // Quiet audio (-20 dB, below the -12 dB threshold) keyed by a full-scale sidechain
+    juce::AudioBuffer<float> buffer(5, 512);
+    juce::MidiBuffer midi;
+    for (int block = 0; block < 8; ++block) {
+        buffer.clear();
+        for (int ch = 0; ch < 2; ++ch)
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), 0.1f, 512);
+        for (int ch = 2; ch < 4; ++ch)
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), 1.0f, 512);
+        module->processBlock(buffer, midi);
+    }
+
+    EXPECT_LT(buffer.getSample(0, 511), 0.05f);
+    EXPECT_LT(module->getGainReductionDb(), -6.0f);
+    EXPECT_EQ(buffer.getMagnitude(2, 0, 512), 0.0f); // Sidechain isn't passed downstream
+}
+
+TEST(DynamicsProcessorTest, FastDecibelConversionMatchesJuce) {
+    for (float dB = -100.0f; dB <= 24.0f; dB += 0.37f) {
+        float gain = juce::Decibels::decibelsToGain(dB, -200.0f);
+        EXPECT_NEAR(DynamicsProcessor::fastGainToDecibels(gain), dB, 1.0e-3f);
+        EXPECT_NEAR(DynamicsProcessor::fastDecibelsToGain(dB) / gain, 1.0f, 2.0e-5f);
+    }
+}
+
 // ---------------------------------------------------------------------------
 // FlangerModule tests
 // ---------------------------------------------------------------------------
@@ -802,6 +884,33 @@ TEST_F(FlangerModuleTest, ModuleTypeAndCategoryAreCorrect) {
     EXPECT_EQ(module->getModulationCategory(), ModulationCategory::FX);
 }
 
+TEST_F(FlangerModuleTest, DepthCVTakesEffectWithinTheBlock) {
+    FlangerModule modulated;
+    modulated.prepareToPlay(44100.0, 512);
+
+    // The Depth CV only moves in the second half of the block
+    juce::AudioBuffer<float> reference(4, 512);
+    reference.clear();
+    for (int i = 0; i < 512; ++i)
+        for (int ch = 0; ch < 2; ++ch)
+            reference.setSample(ch, i, std::sin((float)i * 0.1f));
+    juce::AudioBuffer<float> buffer(reference);
+    for (int i = 256; i < 512; ++i)
+        buffer.setSample(3, i, -1.0f);
+
+    juce::MidiBuffer midi;
+    module->processBlock(reference, midi);
+    modulated.processBlock(buffer, midi);
+
+    for (int i = 0; i < 256; ++i)
+        ASSERT_EQ(buffer.getSample(0, i), reference.getSample(0, i));
+
+    float difference = 0.0f;
+    for (int i = 256; i < 512; ++i)
+        difference = std::max(difference, std::abs(buffer.getSample(0, i) - reference.getSample(0, i)));
+    EXPECT_GT(difference, 0.01f);
+}
+
 // ---------------------------------------------------------------------------
 // LimiterModule tests
 // ---------------------------------------------------------------------------
@@ -853,6 +962,51 @@ TEST_F(LimiterModuleTest, ModuleTypeAndCategoryAreCorrect) {
     EXPECT_EQ(module->getModulationCategory(), ModulationCategory::FX);
 }
 
+TEST_F(LimiterModuleTest, OutputNeverExceedsTheCeiling) {
+    const float ceiling = juce::Decibels::decibelsToGain(-1.0f);
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    juce::Random random(42);
+
+    float peak = 0.0f;
+    for (int block = 0; block < 16; ++block) {
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < 512; ++i)
+                buffer.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * (block % 4 == 0 ? 4.0f : 1.5f));
+        module->processBlock(buffer, midi);
+        peak = std::max(peak, buffer.getMagnitude(0, 512));
+    }
+
+    EXPECT_LE(peak, ceiling);
+    EXPECT_GT(peak, ceiling * 0.9f); // Limited, not just attenuated
+    EXPECT_LT(module->getGainReductionDb(), 0.0f);
+}
+
+TEST_F(LimiterModuleTest, ReportsLookaheadAsLatency) {
+    // 1.5 ms lookahead at 44.1 kHz, plus the true-peak detector's lag
+    EXPECT_EQ(module->getLatencySamples(), 66 + DynamicsProcessor::kTruePeakDelay);
+
+    auto* truePeakParam = dynamic_cast<juce::AudioParameterBool*>(module->getParameters()[5]);
+    ASSERT_NE(truePeakParam, nullptr);
+    truePeakParam->setValueNotifyingHost(0.0f);
+
+    // Processing leaves the reported latency alone; it follows on the message thread
+    juce::AudioBuffer<float> buffer(5, 512);
+    buffer.clear();
+    juce::MidiBuffer midi;
+    module->processBlock(buffer, midi);
+    EXPECT_EQ(module->getLatencySamples(), 66 + DynamicsProcessor::kTruePeakDelay);
+
+    juce::MessageManager::getInstance()->runDispatchLoopUntil(10);
+    EXPECT_EQ(module->getLatencySamples(), 66);
+}
+
+TEST_F(LimiterModuleTest, InputGainCVIsControlRate) {
+    EXPECT_EQ(module->getInputPortRate(0), PortRate::Audio);
+    EXPECT_EQ(module->getInputPortRate(3), PortRate::Audio);
+    EXPECT_EQ(module->getInputPortRate(4), PortRate::Control);
+}
+
 // ---------------------------------------------------------------------------
 // Port Label tests
 // ---------------------------------------------------------------------------
@@ -898,11 +1052,10 @@ TEST(PortLabelTests, LFOPortLabels) {
     EXPECT_EQ(lfo.getOutputPortLabel(0), "CV");
 }
 
-TEST(PortLabelTests, AttenuverterPortLabels) {
-    AttenuverterModule att;
-    EXPECT_EQ(att.getInputPortLabel(0), "Signal");
-    EXPECT_EQ(att.getInputPortLabel(1), "Amount");
-    EXPECT_EQ(att.getOutputPortLabel(0), "Out");
+TEST(PortLabelTests, ModMatrixPortLabels) {
+    ModMatrixModule matrix;
+    EXPECT_EQ(matrix.getInputPortLabel(0), "Source 1");
+    EXPECT_EQ(matrix.getOutputPortLabel(31), "Route 32");
 }
 
 TEST(PortLabelTests, DelayPortLabels) {
@@ -955,6 +1108,9 @@ TEST(PortLabelTests, CompressorPortLabels) {
     CompressorModule comp;
     EXPECT_EQ(comp.getInputPortLabel(0), "Left");
     EXPECT_EQ(comp.getInputPortLabel(1), "Right");
+    EXPECT_EQ(comp.getInputPortLabel(2), "Sidechain L");
+    EXPECT_EQ(comp.getInputPortLabel(3), "Sidechain R");
+    EXPECT_EQ(comp.getInputPortLabel(4), "Threshold");
     EXPECT_EQ(comp.getOutputPortLabel(0), "Left");
     EXPECT_EQ(comp.getOutputPortLabel(1), "Right");
 }
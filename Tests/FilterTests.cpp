@@ -189,3 +189,18 @@ TEST_F(FilterTest, PolyMode_NoBleed) {
     // Voice 1 should remain silent (no bleed)
     EXPECT_NEAR(polyBuffer.getRMSLevel(1, 0, 512), 0.0f, 1e-6f);
 }
+
+TEST_F(FilterTest, CVInputsAreControlRate) {
+    EXPECT_EQ(filter.getInputPortRate(0), PortRate::Audio);
+    for (int ch = 1; ch <= 3; ++ch)
+        EXPECT_EQ(filter.getInputPortRate(ch), PortRate::Control);
+
+    // A CV step partway through the block is picked up at a control block boundary
+    auto* cv1 = buffer.getWritePointer(1);
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+        cv1[i] = i < ModuleBase::kControlBlockSize + 3 ? 0.0f : 0.5f;
+    filter.processBlock(buffer, midiMessages);
+
+    float expected = 440.0f * std::pow(20000.0f / 440.0f, 0.5f);
+    EXPECT_NEAR(filter.getCurrentCutoff(), expected, 1.0f);
+}
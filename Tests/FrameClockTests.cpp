@@ -0,0 +1,93 @@
+#include "UI/FrameClock.h"
+#include <functional>
+#include <gtest/gtest.h>
+
+namespace {
+
+struct CountingClient : FrameClock::Client {
+    void onFrame(double nowMs) override {
+        ++frames;
+        lastFrameMs = nowMs;
+        if (onFrameHook)
+            onFrameHook();
+    }
+
+    int frames = 0;
+    double lastFrameMs = 0.0;
+    std::function<void()> onFrameHook;
+};
+
+// Steps the clock like a display refreshing at hz
+void runFrames(FrameClock& clock, double& nowMs, int numFrames, double hz = 60.0) {
+    for (int i = 0; i < numFrames; ++i) {
+        nowMs += 1000.0 / hz;
+        clock.tick(nowMs);
+    }
+}
+
+} // namespace
+
+TEST(FrameClockTest, ClientsRunAtTheirOwnRateInOnePass) {
+    FrameClock clock;
+    CountingClient fast, half, slow;
+    clock.addClient(fast, 60);
+    clock.addClient(half, 30);
+    clock.addClient(slow, 10);
+    EXPECT_EQ(clock.getNumClients(), 3);
+
+    double now = 1000.0;
+    runFrames(clock, now, 1);
+
+    // Everyone due lands on the same frame, so the UI updates in phase
+    EXPECT_DOUBLE_EQ(fast.lastFrameMs, now);
+    EXPECT_DOUBLE_EQ(half.lastFrameMs, now);
+    EXPECT_DOUBLE_EQ(slow.lastFrameMs, now);
+
+    runFrames(clock, now, 59);
+    EXPECT_EQ(fast.frames, 60);
+    EXPECT_NEAR(half.frames, 30, 1);
+    EXPECT_NEAR(slow.frames, 10, 1);
+}
+
+TEST(FrameClockTest, SkipsClientsWhoseComponentIsNotOnScreen) {
+    FrameClock clock;
+    CountingClient client;
+    juce::Component offscreen; // Never added to the desktop
+    offscreen.setSize(100, 100);
+    clock.addClient(client, 60, &offscreen);
+
+    double now = 1000.0;
+    runFrames(clock, now, 10);
+    EXPECT_EQ(client.frames, 0);
+    EXPECT_FALSE(FrameClock::isOnScreen(offscreen));
+}
+
+TEST(FrameClockTest, ClientsCanUnregisterDuringAFrame) {
+    FrameClock clock;
+    CountingClient first, second;
+    first.onFrameHook = [&] {
+        clock.removeClient(first);
+        clock.removeClient(second);
+    };
+    clock.addClient(first, 60);
+    clock.addClient(second, 60);
+
+    double now = 1000.0;
+    runFrames(clock, now, 3);
+
+    EXPECT_EQ(first.frames, 1);
+    EXPECT_EQ(second.frames, 0);
+    EXPECT_EQ(clock.getNumClients(), 0);
+}
+
+TEST(FrameClockTest, ReRegisteringReplacesTheRate) {
+    FrameClock clock;
+    CountingClient client;
+    clock.addClient(client, 60);
+    clock.addClient(client, 10);
+    EXPECT_EQ(clock.getNumClients(), 1);
+
+    double now = 1000.0;
+    runFrames(clock, now, 60);
+    EXPECT_NEAR(client.frames, 10, 1);
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "Modules/ModuleBase.h"
+#include "OfflineRenderer.h"
+#include "PresetManager.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
+#include <map>
+#include <vector>
+
+// Offline preset rendering and tolerance-based audio comparison for the
+// golden-render regression suite (GoldenRenderTests.cpp).
+namespace golden {
+
+inline constexpr double kSampleRate = 44100.0;
+inline constexpr int kBlockSize = 256;
+inline constexpr int kRenderSamples = 66150; // 1.5 s
+
+inline constexpr int kFftOrder = 10;
+inline constexpr int kFrameSize = 1 << kFftOrder;
+inline constexpr int kNumBands = 24;
+inline constexpr float kFloorDb = -90.0f;
+
+// Chord, release, then a single note: exercises attack, sustain, release and retrigger
+inline const std::vector<gsynth::OfflineRenderer::NoteEvent>& getMidiScript() {
+    static const std::vector<gsynth::OfflineRenderer::NoteEvent> script = {
+        {0, 60, 0.8f},     {0, 64, 0.8f},     {0, 67, 0.8f},      {26460, 60, 0.0f},
+        {26460, 64, 0.0f}, {26460, 67, 0.0f}, {35280, 72, 0.9f}, {52920, 72, 0.0f}};
+    return script;
+}
+
+/** Compact per-signal summary: a time-domain RMS envelope plus an average spectrum. */
+struct Fingerprint {
+    std::vector<float> envelopeDb; // RMS per kFrameSize frame
+    std::vector<float> bandsDb;    // Mean magnitude in kNumBands log-spaced bands, 40 Hz - 16 kHz
+};
+
+struct Divergence {
+    float envelopeErrorDb = 0.0f; // Worst frame-RMS difference
+    float spectralErrorDb = 0.0f; // Worst band difference
+};
+
+inline float toDb(float gain) { return juce::jmax(kFloorDb, juce::Decibels::gainToDecibels(gain, kFloorDb)); }
+
+inline Fingerprint computeFingerprint(const juce::AudioBuffer<float>& audio) {
+    Fingerprint fp;
+    const int numSamples = audio.getNumSamples();
+    const int numChannels = audio.getNumChannels();
+
+    juce::dsp::FFT fft(kFftOrder);
+    juce::dsp::WindowingFunction<float> window((size_t)kFrameSize, juce::dsp::WindowingFunction<float>::hann);
+    std::vector<float> fftData((size_t)kFrameSize * 2);
+    std::vector<double> bandSums((size_t)kNumBands, 0.0);
+    std::vector<int> bandCounts((size_t)kNumBands, 0);
+
+    for (int start = 0; start + kFrameSize <= numSamples; start += kFrameSize) {
+        std::fill(fftData.begin(), fftData.end(), 0.0f);
+        double sumSq = 0.0;
+        for (int i = 0; i < kFrameSize; ++i) {
+            float mono = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+                mono += audio.getSample(ch, start + i);
+            mono /= (float)juce::jmax(1, numChannels);
+            fftData[(size_t)i] = mono;
+            sumSq += (double)mono * mono;
+        }
+        fp.envelopeDb.push_back(toDb((float)std::sqrt(sumSq / kFrameSize)));
+
+        window.multiplyWithWindowingTable(fftData.data(), (size_t)kFrameSize);
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        for (int bin = 1; bin < kFrameSize / 2; ++bin) {
+            double hz = bin * kSampleRate / kFrameSize;
+            if (hz < 40.0 || hz >= 16000.0)
+                continue;
+            int band = (int)(std::log(hz / 40.0) / std::log(16000.0 / 40.0) * kNumBands);
+            band = juce::jlimit(0, kNumBands - 1, band);
+            bandSums[(size_t)band] += fftData[(size_t)bin] / (kFrameSize / 2);
+            ++bandCounts[(size_t)band];
+        }
+    }
+
+    for (int b = 0; b < kNumBands; ++b) {
+        float mean = bandCounts[(size_t)b] > 0 ? (float)(bandSums[(size_t)b] / bandCounts[(size_t)b]) : 0.0f;
+        fp.bandsDb.push_back(toDb(mean));
+    }
+    return fp;
+}
+
+inline Divergence compareFingerprints(const Fingerprint& reference, const Fingerprint& actual) {
+    Divergence d;
+    auto worst = [](const std::vector<float>& a, const std::vector<float>& b) {
+        if (a.size() != b.size())
+            return -kFloorDb; // Shape mismatch counts as maximal divergence
+        float w = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i)
+            w = juce::jmax(w, std::abs(a[i] - b[i]));
+        return w;
+    };
+    d.envelopeErrorDb = worst(reference.envelopeDb, actual.envelopeDb);
+    d.spectralErrorDb = worst(reference.bandsDb, actual.bandsDb);
+    return d;
+}
+
+/** Energy of (actual - reference) relative to the reference, in dB. */
+inline float residualDb(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& actual) {
+    double refEnergy = 0.0, errEnergy = 0.0;
+    int numChannels = juce::jmin(reference.getNumChannels(), actual.getNumChannels());
+    int numSamples = juce::jmin(reference.getNumSamples(), actual.getNumSamples());
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const float* r = reference.getReadPointer(ch);
+        const float* a = actual.getReadPointer(ch);
+        for (int i = 0; i < numSamples; ++i) {
+            refEnergy += (double)r[i] * r[i];
+            double e = (double)a[i] - r[i];
+            errEnergy += e * e;
+        }
+    }
+    if (refEnergy < 1e-12)
+        return errEnergy < 1e-12 ? kFloorDb : 0.0f;
+    return juce::jmax(kFloorDb, (float)(10.0 * std::log10(errEnergy / refEnergy + 1e-30)));
+}
+
+inline juce::var fingerprintToVar(const Fingerprint& fp) {
+    auto* obj = new juce::DynamicObject();
+    juce::Array<juce::var> env, bands;
+    for (float v : fp.envelopeDb)
+        env.add(juce::roundToInt(v * 100.0f) / 100.0);
+    for (float v : fp.bandsDb)
+        bands.add(juce::roundToInt(v * 100.0f) / 100.0);
+    obj->setProperty("envelopeDb", env);
+    obj->setProperty("bandsDb", bands);
+    return juce::var(obj);
+}
+
+inline Fingerprint fingerprintFromVar(const juce::var& v) {
+    Fingerprint fp;
+    if (auto* env = v["envelopeDb"].getArray())
+        for (auto& x : *env)
+            fp.envelopeDb.push_back((float)(double)x);
+    if (auto* bands = v["bandsDb"].getArray())
+        for (auto& x : *bands)
+            fp.bandsDb.push_back((float)(double)x);
+    return fp;
+}
+
+/** A module output that gets its own fingerprint, keyed "<name>#<occurrence>" in graph order. */
+struct Tap {
+    juce::String key;
+    juce::AudioProcessorGraph::NodeID nodeID;
+};
+
+inline std::vector<Tap> findTaps(juce::AudioProcessorGraph& graph) {
+    std::vector<Tap> taps;
+    std::map<juce::String, int> occurrences;
+    for (auto* node : graph.getNodes()) {
+        auto* module = dynamic_cast<ModuleBase*>(node->getProcessor());
+        if (module == nullptr || module->getTotalNumOutputChannels() == 0)
+            continue;
+        int n = ++occurrences[module->getName()];
+        taps.push_back({module->getName() + "#" + juce::String(n), node->nodeID});
+    }
+    return taps;
+}
+
+/** Rewires the Audio Output node to listen to a single module instead of the patch's final stage. */
+inline void soloNode(juce::AudioProcessorGraph& graph, juce::AudioProcessorGraph::NodeID nodeID) {
+    using IO = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+    juce::AudioProcessorGraph::NodeID outputID;
+    for (auto* node : graph.getNodes())
+        if (auto* io = dynamic_cast<IO*>(node->getProcessor()))
+            if (io->getType() == IO::audioOutputNode)
+                outputID = node->nodeID;
+
+    for (auto& c : graph.getConnections())
+        if (c.destination.nodeID == outputID)
+            graph.removeConnection(c);
+
+    auto* node = graph.getNodeForId(nodeID);
+    if (node == nullptr || outputID == juce::AudioProcessorGraph::NodeID())
+        return;
+    int rightSource = node->getProcessor()->getTotalNumOutputChannels() > 1 ? 1 : 0;
+    graph.addConnection({{nodeID, 0}, {outputID, 0}});
+    graph.addConnection({{nodeID, rightSource}, {outputID, 1}});
+}
+
+/** Loads the preset into a fresh graph, optionally soloing one tap, and renders the MIDI script. */
+inline juce::AudioBuffer<float> renderPreset(int presetIndex, const juce::String& soloTapKey = {}) {
+    juce::AudioProcessorGraph graph;
+    if (!gsynth::PresetManager::loadPreset(presetIndex, graph))
+        return {};
+
+    if (soloTapKey.isNotEmpty()) {
+        for (auto& tap : findTaps(graph))
+            if (tap.key == soloTapKey)
+                soloNode(graph, tap.nodeID);
+    }
+
+    gsynth::OfflineRenderer renderer(graph, kSampleRate, kBlockSize);
+    renderer.prepare();
+    return renderer.render(kRenderSamples, getMidiScript());
+}
+
+} // namespace golden
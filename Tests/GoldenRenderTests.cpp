@@ -0,0 +1,170 @@
+#include "GoldenRender.h"
+#include <gtest/gtest.h>
+
+// Golden-render regression suite.
+//
+// Each preset is rendered offline with a fixed MIDI script and compared against
+// references in Tests/golden/:
+//   <Preset>.wav  - master output, compared sample by sample (residual energy)
+//   <Preset>.json - fingerprints (RMS envelope + band spectrum) of every module
+//                   output, so a divergence can be traced to the module causing it
+//
+// Record or refresh references after an intentional sound change with:
+//   GRAVISYNTH_UPDATE_GOLDEN=1 ./build/Tests/GravisynthGoldenTests
+
+namespace {
+
+constexpr float kMasterResidualToleranceDb = -60.0f;
+constexpr float kEnvelopeToleranceDb = 1.0f;
+constexpr float kSpectralToleranceDb = 3.0f;
+
+juce::File getGoldenDir() { return juce::File(GRAVISYNTH_GOLDEN_DIR); }
+
+bool isRecording() { return juce::SystemStats::getEnvironmentVariable("GRAVISYNTH_UPDATE_GOLDEN", {}).isNotEmpty(); }
+
+juce::String fileStem(int presetIndex) {
+    return gsynth::PresetManager::getPresetNames()[presetIndex].replaceCharacter(' ', '_');
+}
+
+bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio) {
+    file.deleteFile();
+    auto stream = file.createOutputStream();
+    if (stream == nullptr)
+        return false;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wav.createWriterFor(stream.get(), golden::kSampleRate, (unsigned int)audio.getNumChannels(), 24, {}, 0));
+    if (writer == nullptr)
+        return false;
+    stream.release(); // Owned by the writer now
+
+    return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+}
+
+bool readWav(const juce::File& file, juce::AudioBuffer<float>& audio) {
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+    if (reader == nullptr)
+        return false;
+
+    audio.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
+    return reader->read(&audio, 0, (int)reader->lengthInSamples, 0, true, true);
+}
+
+} // namespace
+
+class GoldenRenderTest : public ::testing::TestWithParam<int> {};
+
+TEST_P(GoldenRenderTest, MatchesReference) {
+    const int presetIndex = GetParam();
+    const auto stem = fileStem(presetIndex);
+    const auto wavFile = getGoldenDir().getChildFile(stem + ".wav");
+    const auto jsonFile = getGoldenDir().getChildFile(stem + ".json");
+
+    auto master = golden::renderPreset(presetIndex);
+    ASSERT_EQ(master.getNumSamples(), golden::kRenderSamples) << "Preset failed to render";
+
+    // Fingerprint every module output in isolation
+    juce::AudioProcessorGraph probe;
+    ASSERT_TRUE(gsynth::PresetManager::loadPreset(presetIndex, probe));
+    std::vector<std::pair<juce::String, golden::Fingerprint>> taps;
+    for (auto& tap : golden::findTaps(probe))
+        taps.emplace_back(tap.key, golden::computeFingerprint(golden::renderPreset(presetIndex, tap.key)));
+
+    if (isRecording()) {
+        getGoldenDir().createDirectory();
+        ASSERT_TRUE(writeWav(wavFile, master));
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty("sampleRate", golden::kSampleRate);
+        root->setProperty("numSamples", golden::kRenderSamples);
+        root->setProperty("master", golden::fingerprintToVar(golden::computeFingerprint(master)));
+        auto* tapObj = new juce::DynamicObject();
+        for (auto& [key, fp] : taps)
+            tapObj->setProperty(key, golden::fingerprintToVar(fp));
+        root->setProperty("taps", juce::var(tapObj));
+        ASSERT_TRUE(jsonFile.replaceWithText(juce::JSON::toString(juce::var(root))));
+
+        GTEST_SKIP() << "Recorded reference for " << stem;
+    }
+
+    // Skipped, not failed, until the references are recorded and committed
+    if (!wavFile.existsAsFile() || !jsonFile.existsAsFile())
+        GTEST_SKIP() << "No reference for " << stem << " in " << getGoldenDir().getFullPathName()
+                     << "; record with GRAVISYNTH_UPDATE_GOLDEN=1 and commit it";
+
+    juce::AudioBuffer<float> reference;
+    ASSERT_TRUE(readWav(wavFile, reference));
+    auto refJson = juce::JSON::parse(jsonFile);
+    ASSERT_TRUE(refJson.isObject());
+
+    // Time domain: sample-accurate residual on the master output
+    float residual = golden::residualDb(reference, master);
+
+    // Per-module divergence report
+    juce::String report;
+    int divergentModules = 0;
+    for (auto& [key, fp] : taps) {
+        auto refTap = refJson["taps"][juce::Identifier(key)];
+        if (refTap.isVoid()) {
+            report << "  " << key << ": not in reference (patch topology changed?)\n";
+            ++divergentModules;
+            continue;
+        }
+        auto d = golden::compareFingerprints(golden::fingerprintFromVar(refTap), fp);
+        bool diverged = d.envelopeErrorDb > kEnvelopeToleranceDb || d.spectralErrorDb > kSpectralToleranceDb;
+        if (diverged)
+            ++divergentModules;
+        report << "  " << (diverged ? "DIVERGED " : "ok       ") << key << ": envelope "
+               << juce::String(d.envelopeErrorDb, 2) << " dB, spectrum " << juce::String(d.spectralErrorDb, 2)
+               << " dB\n";
+    }
+
+    auto masterDiv = golden::compareFingerprints(golden::fingerprintFromVar(refJson["master"]),
+                                                 golden::computeFingerprint(master));
+
+    EXPECT_LE(residual, kMasterResidualToleranceDb) << stem << " master residual " << residual << " dB\n" << report;
+    EXPECT_LE(masterDiv.envelopeErrorDb, kEnvelopeToleranceDb) << stem << " master envelope\n" << report;
+    EXPECT_LE(masterDiv.spectralErrorDb, kSpectralToleranceDb) << stem << " master spectrum\n" << report;
+    EXPECT_EQ(divergentModules, 0) << stem << " per-module divergence:\n" << report;
+}
+
+INSTANTIATE_TEST_SUITE_P(AllPresets, GoldenRenderTest,
+                         ::testing::Range(0, gsynth::PresetManager::getPresetNames().size()),
+                         [](const ::testing::TestParamInfo<int>& info) {
+                             return fileStem(info.param).removeCharacters("_").toStdString();
+                         });
+
+// The comparison metrics themselves must catch the changes the suite is meant to catch
+TEST(GoldenRenderMetricsTest, IdenticalSignalsDoNotDiverge) {
+    juce::AudioBuffer<float> a(2, golden::kFrameSize * 8);
+    for (int i = 0; i < a.getNumSamples(); ++i)
+        for (int ch = 0; ch < 2; ++ch)
+            a.setSample(ch, i, 0.5f * std::sin(0.05f * (float)i));
+
+    auto d = golden::compareFingerprints(golden::computeFingerprint(a), golden::computeFingerprint(a));
+    EXPECT_FLOAT_EQ(d.envelopeErrorDb, 0.0f);
+    EXPECT_FLOAT_EQ(d.spectralErrorDb, 0.0f);
+    EXPECT_LE(golden::residualDb(a, a), golden::kFloorDb);
+}
+
+TEST(GoldenRenderMetricsTest, DetectsGainAndTimbreChanges) {
+    juce::AudioBuffer<float> ref(1, golden::kFrameSize * 8);
+    juce::AudioBuffer<float> louder(1, ref.getNumSamples());
+    juce::AudioBuffer<float> brighter(1, ref.getNumSamples());
+    for (int i = 0; i < ref.getNumSamples(); ++i) {
+        float s = 0.25f * std::sin(0.05f * (float)i);
+        ref.setSample(0, i, s);
+        louder.setSample(0, i, s * 2.0f);
+        brighter.setSample(0, i, s + 0.1f * std::sin(1.5f * (float)i));
+    }
+
+    auto refFp = golden::computeFingerprint(ref);
+    auto gain = golden::compareFingerprints(refFp, golden::computeFingerprint(louder));
+    EXPECT_NEAR(gain.envelopeErrorDb, 6.02f, 0.1f);
+
+    auto timbre = golden::compareFingerprints(refFp, golden::computeFingerprint(brighter));
+    EXPECT_GT(timbre.spectralErrorDb, kSpectralToleranceDb);
+    EXPECT_GT(golden::residualDb(ref, brighter), kMasterResidualToleranceDb);
+}
@@ -1,4 +1,5 @@
 #include "../Source/GravisynthUndoManager.h"
+#include "../Source/ModMatrixRoutes.h"
 #include "../Source/Modules/ADSRModule.h"
 #include "../Source/Modules/FilterModule.h"
 #include "../Source/Modules/LFOModule.h"
@@ -47,9 +48,11 @@ TEST_F(GraphEditorTest, DropModuleCreatesNode) {
     EXPECT_TRUE(editor.isInterestedInDragSource(details));
 
     auto initialNodeCount = engine.getGraph().getNodes().size();
+    int rebuildsBefore = gsynth::GraphTransaction::getNumRebuilds();
     editor.itemDropped(details);
 
     EXPECT_EQ(engine.getGraph().getNodes().size(), initialNodeCount + 1);
+    EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds(), rebuildsBefore + 1);
 
     bool foundOsc = false;
     for (auto* node : engine.getGraph().getNodes()) {
@@ -99,7 +102,9 @@ TEST_F(GraphEditorTest, DragConnectionCreatesLink) {
     editor.dragConnection(juce::Point<int>(50, 0));
 
     auto filterTargetPoint = filterComp->getBounds().getPosition() + filterComp->getPortCenter(0, true);
+    int rebuildsBefore = gsynth::GraphTransaction::getNumRebuilds();
     editor.endConnectionDrag(filterTargetPoint);
+    EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds(), rebuildsBefore + 1);
 
     bool connectionFound = false;
     for (auto& conn : engine.getGraph().getConnections()) {
@@ -360,3 +365,50 @@ TEST_F(GraphEditorTest, ReplaceModuleIsUndoable) {
     EXPECT_FALSE(hasFilter);
     EXPECT_TRUE(hasOsc);
 }
+
+TEST_F(GraphEditorTest, ConnectionModelCachesCableGeometry) {
+    AudioEngine engine;
+    GraphEditor editor(engine);
+    editor.setSize(800, 600);
+    auto& graph = engine.getGraph();
+
+    editor.updateComponents();
+    ConnectionRenderModel model;
+    model.ensureUpToDate(graph, editor.getModuleComponents());
+    auto baselineCables = model.getCables().size();
+
+    auto oscNode = graph.addNode(std::make_unique<OscillatorModule>());
+    auto filterNode = graph.addNode(std::make_unique<FilterModule>());
+    auto lfoNode = graph.addNode(std::make_unique<LFOModule>());
+    graph.addConnection({{oscNode->nodeID, 0}, {filterNode->nodeID, 0}});
+    engine.addModRouting(lfoNode->nodeID, 0, filterNode->nodeID, 1);
+    editor.updateComponents();
+
+    // Nothing changes until the model is invalidated
+    EXPECT_FALSE(model.ensureUpToDate(graph, editor.getModuleComponents()));
+    model.invalidate();
+    EXPECT_TRUE(model.ensureUpToDate(graph, editor.getModuleComponents()));
+    EXPECT_FALSE(model.isDirty());
+    ASSERT_EQ(model.getCables().size(), baselineCables + 2);
+
+    const ConnectionRenderModel::Cable* modCable = nullptr;
+    for (auto& cable : model.getCables())
+        if (cable.isModulation && gsynth::findModRoute(graph, cable.routeID).has_value())
+            modCable = &cable;
+    ASSERT_NE(modCable, nullptr);
+    EXPECT_EQ(modCable->amount, engine.getModAmountParameter(modCable->routeID)); // Resolved for paint()
+
+    auto mid = modCable->line.getPointAlongLineProportionally(0.5f);
+    EXPECT_EQ(model.findModulationCableAt(mid, 15.0f), modCable);
+    EXPECT_EQ(editor.getModRouteAt(mid), modCable->routeID);
+
+    // Moving a module invalidates the editor's cached geometry
+    ModuleComponent* oscComp = nullptr;
+    for (auto* comp : editor.getModuleComponents())
+        if (comp->getModule() == oscNode->getProcessor())
+            oscComp = comp;
+    ASSERT_NE(oscComp, nullptr);
+    EXPECT_FALSE(editor.getConnectionModel().isDirty());
+    oscComp->setTopLeftPosition(oscComp->getX() + 40, oscComp->getY());
+    EXPECT_TRUE(editor.getConnectionModel().isDirty());
+}
@@ -0,0 +1,82 @@
+#include "../Source/AudioEngine.h"
+#include "../Source/GraphTransaction.h"
+#include "../Source/Modules/FilterModule.h"
+#include "../Source/Modules/LFOModule.h"
+#include "../Source/Modules/OscillatorModule.h"
+#include <gtest/gtest.h>
+
+class GraphTransactionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        graph.setPlayConfigDetails(0, 2, 44100.0, 512);
+        graph.prepareToPlay(44100.0, 512);
+    }
+
+    void TearDown() override { graph.releaseResources(); }
+
+    juce::AudioProcessorGraph graph;
+};
+
+TEST_F(GraphTransactionTest, BatchesEditsIntoOneRebuild) {
+    int rebuildsBefore = gsynth::GraphTransaction::getNumRebuilds();
+    {
+        gsynth::GraphTransaction txn(graph);
+        auto osc = txn.addNode(std::make_unique<OscillatorModule>());
+        auto filter = txn.addNode(std::make_unique<FilterModule>());
+        ASSERT_NE(osc, nullptr);
+        ASSERT_NE(filter, nullptr);
+        EXPECT_TRUE(txn.addConnection({{osc->nodeID, 0}, {filter->nodeID, 0}}));
+
+        // Topology is visible before the commit
+        EXPECT_EQ(graph.getNumNodes(), 2);
+        EXPECT_EQ(graph.getConnections().size(), 1u);
+        EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds(), rebuildsBefore);
+    }
+    EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds(), rebuildsBefore + 1);
+    EXPECT_FALSE(gsynth::GraphTransaction::isOpen(graph));
+}
+
+TEST_F(GraphTransactionTest, NestedTransactionsDeferToOutermost) {
+    int rebuildsBefore = gsynth::GraphTransaction::getNumRebuilds();
+    {
+        gsynth::GraphTransaction outer(graph);
+        EXPECT_TRUE(outer.isOutermost());
+        {
+            gsynth::GraphTransaction inner(graph);
+            EXPECT_FALSE(inner.isOutermost());
+            inner.addNode(std::make_unique<LFOModule>());
+        }
+        EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds(), rebuildsBefore);
+        outer.addNode(std::make_unique<LFOModule>());
+    }
+    EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds(), rebuildsBefore + 1);
+    EXPECT_EQ(graph.getNumNodes(), 2);
+}
+
+TEST_F(GraphTransactionTest, EmptyTransactionDoesNotRebuild) {
+    int rebuildsBefore = gsynth::GraphTransaction::getNumRebuilds();
+    { gsynth::GraphTransaction txn(graph); }
+    EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds(), rebuildsBefore);
+}
+
+TEST_F(GraphTransactionTest, RemovingNodeDropsItsConnections) {
+    gsynth::GraphTransaction txn(graph);
+    auto osc = txn.addNode(std::make_unique<OscillatorModule>());
+    auto filter = txn.addNode(std::make_unique<FilterModule>());
+    txn.addConnection({{osc->nodeID, 0}, {filter->nodeID, 0}});
+    EXPECT_TRUE(txn.removeNode(osc->nodeID));
+    EXPECT_TRUE(graph.getConnections().empty());
+    EXPECT_FALSE(txn.removeNode(osc->nodeID));
+}
+
+TEST(AudioEngineGraphEditTest, AddModRoutingRebuildsOnce) {
+    AudioEngine engine;
+    auto& graph = engine.getGraph();
+    auto lfo = graph.addNode(std::make_unique<LFOModule>());
+    auto filter = graph.addNode(std::make_unique<FilterModule>());
+
+    int rebuildsBefore = gsynth::GraphTransaction::getNumRebuilds();
+    engine.addModRouting(lfo->nodeID, 0, filter->nodeID, 1);
+    EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds(), rebuildsBefore + 1);
+    EXPECT_EQ(engine.getActiveModRoutings().size(), 1u);
+}
@@ -1,5 +1,6 @@
 #include "AI/AIStateMapper.h"
 #include "AudioEngine.h"
+#include "ModMatrixRoutes.h"
 #include "Modules/ADSRModule.h"
 #include "Modules/FilterModule.h"
 #include "Modules/LFOModule.h"
@@ -89,16 +90,13 @@ TEST_F(IntegrationTest, PresetLoadRestoresModRoutings) {
     auto& graph = engine.getGraph();
     ASSERT_TRUE(gsynth::PresetManager::loadDefaultPreset(graph));
 
-    // The default preset has Attenuverter nodes for mod routing
-    bool hasAttenuverter = false;
-    for (auto* node : graph.getNodes()) {
-        if (node->getProcessor()->getName().contains("Attenuverter") ||
-            node->getProcessor()->getName().contains("Mod Slot")) {
-            hasAttenuverter = true;
-            break;
-        }
+    // The default preset routes its modulations through the mod matrix
+    auto routes = gsynth::getModRoutes(graph);
+    EXPECT_FALSE(routes.empty()) << "Default preset should contain mod routings";
+    for (const auto& route : routes) {
+        EXPECT_TRUE(route.source.has_value());
+        EXPECT_TRUE(route.dest.has_value());
     }
-    EXPECT_TRUE(hasAttenuverter) << "Default preset should contain Attenuverter nodes for modulation routing";
 
     // Verify connections exist
     EXPECT_GT(graph.getConnections().size(), 0);
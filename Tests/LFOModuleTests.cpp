@@ -286,3 +286,61 @@ TEST_F(LFOModuleTest, SampleAndHold) {
     // S&H should stay constant for a while depending on rate
     EXPECT_EQ(buffer.getSample(0, 0), buffer.getSample(0, 1));
 }
+
+TEST_F(LFOModuleTest, ControlRateOutputRampsBetweenControlPoints) {
+    EXPECT_EQ(lfo->getOutputPortRate(0), PortRate::Control);
+
+    auto params = lfo->getParameters();
+    dynamic_cast<juce::AudioParameterBool*>(params[2])->setValueNotifyingHost(0.0f); // Hz mode
+    auto* rateHz = dynamic_cast<juce::AudioParameterFloat*>(params[4]);
+    rateHz->setValueNotifyingHost(rateHz->getNormalisableRange().convertTo0to1(5.0f));
+
+    juce::AudioBuffer<float> buffer(1, 4410);
+    juce::MidiBuffer midi;
+    lfo->processBlock(buffer, midi);
+
+    // Piecewise linear between control points, and within a hair of the true sine everywhere
+    const int k = ModuleBase::kControlBlockSize;
+    const float inc = 5.0f / 44100.0f;
+    for (int i = 0; i + k < buffer.getNumSamples(); ++i) {
+        float exact = std::sin(juce::MathConstants<float>::twoPi * inc * (float)i);
+        EXPECT_NEAR(buffer.getSample(0, i), exact, 1.0e-3f) << "sample " << i;
+    }
+    for (int i = 1; i < k - 1; ++i) {
+        float d0 = buffer.getSample(0, i) - buffer.getSample(0, i - 1);
+        float d1 = buffer.getSample(0, i + 1) - buffer.getSample(0, i);
+        EXPECT_NEAR(d0, d1, 1.0e-6f);
+    }
+}
+
+TEST_F(LFOModuleTest, FastSineMatchesStdSin) {
+    for (int i = 0; i < 1000; ++i) {
+        float phase = (float)i / 1000.0f;
+        EXPECT_NEAR(LFOModule::fastSin2Pi(phase), std::sin(juce::MathConstants<float>::twoPi * phase), 1.0e-5f);
+    }
+}
+
+TEST_F(LFOModuleTest, PolySpreadFansOutVoicePhases) {
+    ASSERT_EQ(lfo->getTotalNumOutputChannels(), kMaxPolyVoices);
+    auto params = lfo->getParameters();
+    params[1]->setValueNotifyingHost(2.0f / 4.0f); // Sawtooth: the output reads back the phase
+    params[9]->setValueNotifyingHost(1.0f);        // Poly
+    params[10]->setValueNotifyingHost(1.0f);       // Spread
+
+    juce::AudioBuffer<float> buffer(kMaxPolyVoices, 64);
+    juce::MidiBuffer midi;
+    lfo->processBlock(buffer, midi);
+
+    // Sample 0 is the exact start of a ramp: voice v sits spread * v / N ahead of voice 0
+    for (int v = 0; v < kMaxPolyVoices; ++v) {
+        float expected = 2.0f * ((float)v / (float)kMaxPolyVoices - 0.5f);
+        EXPECT_NEAR(buffer.getSample(v, 0), expected, 1.0e-5f) << "voice " << v;
+    }
+
+    // Mono mode runs output 0 only
+    params[9]->setValueNotifyingHost(0.0f);
+    buffer.applyGain(0.0f);
+    buffer.setSample(1, 0, 0.5f);
+    lfo->processBlock(buffer, midi);
+    EXPECT_EQ(buffer.getMagnitude(1, 0, 64), 0.0f);
+}
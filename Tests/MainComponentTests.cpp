@@ -58,10 +58,10 @@ TEST_F(MainComponentTest, ToggleModMatrixHidesAndShows) {
 TEST_F(MainComponentTest, CommandManagerHasCommands) {
     MainComponent mainComp(std::make_unique<MockProvider>());
     auto& cm = mainComp.getCommandManager();
-    // Verify all 5 commands are registered
+    // Verify all 6 commands are registered
     juce::Array<juce::CommandID> commands;
     mainComp.getAllCommands(commands);
-    EXPECT_EQ(commands.size(), 5);
+    EXPECT_EQ(commands.size(), 6);
 }
 
 TEST_F(MainComponentTest, RedoShortcutViaKeyPressed) {
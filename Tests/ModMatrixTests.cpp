@@ -1,8 +1,9 @@
 #include "../Source/AudioEngine.h"
+#include "../Source/ModMatrixRoutes.h"
 #include "../Source/Modules/ADSRModule.h"
-#include "../Source/Modules/AttenuverterModule.h"
 #include "../Source/Modules/FilterModule.h"
 #include "../Source/Modules/LFOModule.h"
+#include "../Source/Modules/ModMatrixModule.h"
 #include "../Source/Modules/OscillatorModule.h"
 #include "../Source/Modules/VCAModule.h"
 #include <gtest/gtest.h>
@@ -46,7 +47,7 @@ TEST_F(ModMatrixTest, RemoveModRoutingWorks) {
     auto routings = engine.getActiveModRoutings();
     ASSERT_EQ(routings.size(), 1);
 
-    engine.removeModRouting(routings[0].attenuverterNodeID);
+    engine.removeModRouting(routings[0].routeID);
     EXPECT_EQ(engine.getActiveModRoutings().size(), 0);
 }
 
@@ -61,38 +62,92 @@ TEST_F(ModMatrixTest, MetadataPopulation) {
     }
     EXPECT_TRUE(foundPitch);
 }
-TEST_F(ModMatrixTest, SidechainModulationWorks) {
+TEST_F(ModMatrixTest, RoutesShareOneMatrix) {
     auto& graph = engine.getGraph();
     graph.clear();
 
     auto lfoNode = graph.addNode(std::make_unique<LFOModule>());
     auto envNode = graph.addNode(std::make_unique<ADSRModule>("Env"));
     auto filterNode = graph.addNode(std::make_unique<FilterModule>());
+    auto vcaNode = graph.addNode(std::make_unique<VCAModule>());
 
-    // 1. Primary Routing: LFO -> Attenuverter A -> Filter Cutoff
     engine.addModRouting(lfoNode->nodeID, 0, filterNode->nodeID, 1);
-    auto routings = engine.getActiveModRoutings();
-    ASSERT_EQ(routings.size(), 1);
-    auto attenuverterA = routings[0].attenuverterNodeID;
+    engine.addModRouting(envNode->nodeID, 0, vcaNode->nodeID, 1);
+    engine.addModRouting(lfoNode->nodeID, 0, filterNode->nodeID, 2);
 
-    // 2. Sidechain Routing: Env -> Attenuverter B -> Attenuverter A (Amount)
-    engine.addModRouting(envNode->nodeID, 0, attenuverterA, 1); // 1 = Amount target
-    routings = engine.getActiveModRoutings();
-    ASSERT_EQ(routings.size(), 2);
-
-    // Verify connections
-    bool foundSidechain = false;
-    for (const auto& r : routings) {
-        if (r.destNodeID == attenuverterA && r.destChannelIndex == 1) {
-            foundSidechain = true;
-            EXPECT_EQ(r.sourceNodeID, envNode->nodeID);
-        }
+    auto routes = gsynth::getModRoutes(graph);
+    ASSERT_EQ(routes.size(), 3u);
+    EXPECT_EQ(routes[1].matrixID, routes[0].matrixID);
+    EXPECT_EQ(routes[2].matrixID, routes[0].matrixID);
+    EXPECT_EQ(engine.getModuleRegistry().getNodesOfType(ModuleType::ModMatrix).size(), 1u);
+
+    // Each route is a slot of the matrix, wired straight to its destination's CV input
+    for (const auto& route : routes) {
+        ASSERT_TRUE(route.dest.has_value());
+        EXPECT_TRUE(graph.isConnected({{route.matrixID, route.slot}, *route.dest}));
     }
-    EXPECT_TRUE(foundSidechain);
+}
+
+TEST_F(ModMatrixTest, ModulatedSourceSpillsIntoSecondMatrix) {
+    auto& graph = engine.getGraph();
+    graph.clear();
+
+    auto lfoNode = graph.addNode(std::make_unique<LFOModule>());
+    auto oscNode = graph.addNode(std::make_unique<OscillatorModule>());
+    auto filterNode = graph.addNode(std::make_unique<FilterModule>());
+
+    // The oscillator is both modulated and a modulation source: one matrix would feed itself
+    engine.addModRouting(lfoNode->nodeID, 0, oscNode->nodeID, 0); // Pitch
+    engine.addModRouting(oscNode->nodeID, 0, filterNode->nodeID, 1);
+
+    auto routes = gsynth::getModRoutes(graph);
+    ASSERT_EQ(routes.size(), 2u);
+    EXPECT_NE(routes[0].matrixID, routes[1].matrixID);
+    EXPECT_EQ(engine.getActiveModRoutings().size(), 2u);
+}
+
+TEST_F(ModMatrixTest, RoutingThatFeedsItsOwnSourceIsRejected) {
+    auto& graph = engine.getGraph();
+    graph.clear();
+
+    auto oscNode = graph.addNode(std::make_unique<OscillatorModule>());
+    auto filterNode = graph.addNode(std::make_unique<FilterModule>());
+    graph.addConnection({{oscNode->nodeID, 0}, {filterNode->nodeID, 0}});
+
+    engine.addModRouting(filterNode->nodeID, 0, oscNode->nodeID, 0);
+    EXPECT_TRUE(engine.getActiveModRoutings().empty());
+}
+
+TEST_F(ModMatrixTest, RerouteKeepsAmountAndBypass) {
+    auto& graph = engine.getGraph();
+    graph.clear();
+
+    auto lfoNode = graph.addNode(std::make_unique<LFOModule>());
+    auto oscNode = graph.addNode(std::make_unique<OscillatorModule>());
+    auto filterNode = graph.addNode(std::make_unique<FilterModule>());
 
-    // 3. Process verification (Mock)
-    // We could push samples through the graph here, but a connectivity test
-    // already proves the Matrix is doing its job. The rest is internal to AttenuverterModule.
+    engine.addModRouting(lfoNode->nodeID, 0, oscNode->nodeID, 0);
+    engine.addEmptyModRouting();
+    auto routings = engine.getActiveModRoutings();
+    ASSERT_EQ(routings.size(), 2u);
+    auto emptyID = routings[1].routeID;
+    auto* amount = engine.getModAmountParameter(emptyID);
+    ASSERT_NE(amount, nullptr);
+    amount->setValueNotifyingHost(amount->convertTo0to1(-0.5f));
+    engine.toggleModBypass(emptyID);
+
+    // Oscillator -> filter can't share the LFO's matrix, so the route moves to a new one
+    engine.rerouteModRouting(emptyID, oscNode->nodeID, 0, filterNode->nodeID, 1);
+
+    routings = engine.getActiveModRoutings();
+    ASSERT_EQ(routings.size(), 2u);
+    const auto& moved = routings[1];
+    EXPECT_NE(moved.routeID, emptyID);
+    EXPECT_EQ(moved.sourceNodeID, oscNode->nodeID);
+    EXPECT_EQ(moved.destNodeID, filterNode->nodeID);
+    EXPECT_EQ(moved.destChannelIndex, 1);
+    EXPECT_TRUE(moved.isBypassed);
+    EXPECT_FLOAT_EQ(engine.getModAmountParameter(moved.routeID)->get(), -0.5f);
 }
 
 TEST_F(ModMatrixTest, BypassModRoutingWorks) {
@@ -105,18 +160,18 @@ TEST_F(ModMatrixTest, BypassModRoutingWorks) {
     engine.addModRouting(lfoNode->nodeID, 0, filterNode->nodeID, 1);
     auto routings = engine.getActiveModRoutings();
     ASSERT_EQ(routings.size(), 1);
-    auto attNodeID = routings[0].attenuverterNodeID;
+    auto routeID = routings[0].routeID;
 
-    EXPECT_FALSE(engine.isModBypassed(attNodeID));
+    EXPECT_FALSE(engine.isModBypassed(routeID));
 
-    engine.toggleModBypass(attNodeID);
-    EXPECT_TRUE(engine.isModBypassed(attNodeID));
+    engine.toggleModBypass(routeID);
+    EXPECT_TRUE(engine.isModBypassed(routeID));
 
     routings = engine.getActiveModRoutings();
     EXPECT_TRUE(routings[0].isBypassed);
 
-    engine.toggleModBypass(attNodeID);
-    EXPECT_FALSE(engine.isModBypassed(attNodeID));
+    engine.toggleModBypass(routeID);
+    EXPECT_FALSE(engine.isModBypassed(routeID));
 }
 
 TEST_F(ModMatrixTest, UpdateModuleNamesAssignsUniqueNames) {
@@ -179,38 +234,7 @@ TEST_F(ModMatrixTest, UpdateModuleNamesStripsExistingNumbers) {
     EXPECT_TRUE(newName.endsWith("1"));
 }
 
-TEST_F(ModMatrixTest, UpdateModuleNamesHandlesAttenuvertersAsModSlots) {
-    auto& graph = engine.getGraph();
-    graph.clear();
-
-    auto lfoNode = graph.addNode(std::make_unique<LFOModule>());
-    auto filterNode = graph.addNode(std::make_unique<FilterModule>());
-
-    ASSERT_NE(lfoNode, nullptr);
-    ASSERT_NE(filterNode, nullptr);
-
-    // Add a routing, which creates an Attenuverter module
-    engine.addModRouting(lfoNode->nodeID, 0, filterNode->nodeID, 1);
-
-    auto routings = engine.getActiveModRoutings();
-    ASSERT_EQ(routings.size(), 1);
-
-    auto attNodeID = routings[0].attenuverterNodeID;
-    auto* attNode = graph.getNodeForId(attNodeID);
-    ASSERT_NE(attNode, nullptr);
-
-    auto att = dynamic_cast<AttenuverterModule*>(attNode->getProcessor());
-    ASSERT_NE(att, nullptr);
-
-    // Update module names
-    engine.updateModuleNames();
-
-    juce::String attName = att->getName();
-    // Attenuverter modules should be renamed to "Mod Slot"
-    EXPECT_TRUE(attName.contains("Mod Slot"));
-}
-
-TEST_F(ModMatrixTest, AddEmptyModRoutingCreatesAttenuverter) {
+TEST_F(ModMatrixTest, AddEmptyModRoutingCreatesEmptyRoute) {
     auto& graph = engine.getGraph();
     graph.clear();
 
@@ -218,7 +242,7 @@ TEST_F(ModMatrixTest, AddEmptyModRoutingCreatesAttenuverter) {
 
     engine.addEmptyModRouting();
 
-    // Should have created an Attenuverter node with no connections
+    // Should have claimed a matrix slot with no connections
     auto routings = engine.getActiveModRoutings();
     EXPECT_EQ(routings.size(), 1);
     // Empty routing should have null/zero node IDs for source and dest
@@ -328,7 +352,7 @@ TEST_F(ModMatrixTest, ToggleModBypassWithNonExistentID) {
     EXPECT_FALSE(routings[0].isBypassed);
 }
 
-TEST_F(ModMatrixTest, AttenuverterAmountParameterIsAtIndex1) {
+TEST_F(ModMatrixTest, ModParametersAreTheRoutesSlotParameters) {
     auto& graph = engine.getGraph();
     graph.clear();
 
@@ -340,26 +364,20 @@ TEST_F(ModMatrixTest, AttenuverterAmountParameterIsAtIndex1) {
 
     engine.addModRouting(lfoNode->nodeID, 0, filterNode->nodeID, 1);
 
-    auto routings = engine.getActiveModRoutings();
-    ASSERT_EQ(routings.size(), 1);
-
-    auto attNodeID = routings[0].attenuverterNodeID;
-    auto* attNode = graph.getNodeForId(attNodeID);
-    ASSERT_NE(attNode, nullptr);
+    auto routes = gsynth::getModRoutes(graph);
+    ASSERT_EQ(routes.size(), 1u);
 
-    auto* attProcessor = attNode->getProcessor();
-    ASSERT_NE(attProcessor, nullptr);
-
-    auto params = attProcessor->getParameters();
-    ASSERT_GE(params.size(), 2);
-
-    // Verify params[1] is AudioParameterFloat
-    auto* amountParam = dynamic_cast<juce::AudioParameterFloat*>(params[1]);
+    auto* amountParam = engine.getModAmountParameter(routes[0].id);
+    auto* bypassParam = engine.getModBypassParameter(routes[0].id);
     ASSERT_NE(amountParam, nullptr);
+    ASSERT_NE(bypassParam, nullptr);
+    EXPECT_EQ(amountParam, &routes[0].matrix->getAmountParameter(routes[0].slot));
+    EXPECT_EQ(bypassParam, &routes[0].matrix->getBypassParameter(routes[0].slot));
+    EXPECT_TRUE(amountParam->getParameterID().containsIgnoreCase("amount"));
 
-    // Verify parameter ID contains "amount"
-    juce::String paramID = amountParam->getParameterID();
-    EXPECT_TRUE(paramID.containsIgnoreCase("amount"));
+    // Unknown routes have no parameters
+    EXPECT_EQ(engine.getModAmountParameter(juce::AudioProcessorGraph::NodeID(9999)), nullptr);
+    EXPECT_EQ(engine.getModBypassParameter(juce::AudioProcessorGraph::NodeID(9999)), nullptr);
 }
 
 TEST_F(ModMatrixTest, ModAmountDefaultIsOne) {
@@ -377,17 +395,7 @@ TEST_F(ModMatrixTest, ModAmountDefaultIsOne) {
     auto routings = engine.getActiveModRoutings();
     ASSERT_EQ(routings.size(), 1);
 
-    auto attNodeID = routings[0].attenuverterNodeID;
-    auto* attNode = graph.getNodeForId(attNodeID);
-    ASSERT_NE(attNode, nullptr);
-
-    auto* attProcessor = attNode->getProcessor();
-    ASSERT_NE(attProcessor, nullptr);
-
-    auto params = attProcessor->getParameters();
-    ASSERT_GE(params.size(), 2);
-
-    auto* amountParam = dynamic_cast<juce::AudioParameterFloat*>(params[1]);
+    auto* amountParam = engine.getModAmountParameter(routings[0].routeID);
     ASSERT_NE(amountParam, nullptr);
 
     // Default amount should be 1.0
@@ -409,17 +417,7 @@ TEST_F(ModMatrixTest, AmountParameterRoundTrip) {
     auto routings = engine.getActiveModRoutings();
     ASSERT_EQ(routings.size(), 1);
 
-    auto attNodeID = routings[0].attenuverterNodeID;
-    auto* attNode = graph.getNodeForId(attNodeID);
-    ASSERT_NE(attNode, nullptr);
-
-    auto* attProcessor = attNode->getProcessor();
-    ASSERT_NE(attProcessor, nullptr);
-
-    auto params = attProcessor->getParameters();
-    ASSERT_GE(params.size(), 2);
-
-    auto* amountParam = dynamic_cast<juce::AudioParameterFloat*>(params[1]);
+    auto* amountParam = engine.getModAmountParameter(routings[0].routeID);
     ASSERT_NE(amountParam, nullptr);
 
     // Test various values
@@ -431,7 +429,7 @@ TEST_F(ModMatrixTest, AmountParameterRoundTrip) {
     }
 }
 
-TEST_F(ModMatrixTest, BypassParameterIsAtIndex0) {
+TEST_F(ModMatrixTest, BypassParameterRoundTrip) {
     auto& graph = engine.getGraph();
     graph.clear();
 
@@ -446,18 +444,8 @@ TEST_F(ModMatrixTest, BypassParameterIsAtIndex0) {
     auto routings = engine.getActiveModRoutings();
     ASSERT_EQ(routings.size(), 1);
 
-    auto attNodeID = routings[0].attenuverterNodeID;
-    auto* attNode = graph.getNodeForId(attNodeID);
-    ASSERT_NE(attNode, nullptr);
-
-    auto* attProcessor = attNode->getProcessor();
-    ASSERT_NE(attProcessor, nullptr);
-
-    auto params = attProcessor->getParameters();
-    ASSERT_GE(params.size(), 1);
-
-    // Verify params[0] is AudioParameterBool (inherited from ModuleBase)
-    auto* bypassParam = dynamic_cast<juce::AudioParameterBool*>(params[0]);
+    auto routeID = routings[0].routeID;
+    auto* bypassParam = engine.getModBypassParameter(routeID);
     ASSERT_NE(bypassParam, nullptr);
 
     // Verify initial value is false
@@ -466,8 +454,51 @@ TEST_F(ModMatrixTest, BypassParameterIsAtIndex0) {
     // Set to true and verify
     bypassParam->setValueNotifyingHost(1.0f);
     EXPECT_TRUE(bypassParam->get());
+    EXPECT_TRUE(engine.isModBypassed(routeID));
 
     // Set back to false and verify
     bypassParam->setValueNotifyingHost(0.0f);
     EXPECT_FALSE(bypassParam->get());
 }
+
+TEST_F(ModMatrixTest, RoutingIndexVersionsTrackTopologyChanges) {
+    auto& graph = engine.getGraph();
+    graph.clear();
+
+    auto lfoNode = graph.addNode(std::make_unique<LFOModule>());
+    auto filterNode = graph.addNode(std::make_unique<FilterModule>());
+
+    auto routingVersion = engine.getModRoutingVersion();
+    auto nodeSetVersion = engine.getNodeSetVersion();
+
+    // Idle: nothing changes
+    EXPECT_EQ(engine.getModRoutingVersion(), routingVersion);
+    EXPECT_EQ(engine.getNodeSetVersion(), nodeSetVersion);
+
+    // A plain audio connection touches neither routings nor nodes
+    auto oscNode = graph.addNode(std::make_unique<OscillatorModule>());
+    EXPECT_EQ(engine.getModRoutingVersion(), routingVersion);
+    EXPECT_NE(engine.getNodeSetVersion(), nodeSetVersion);
+    nodeSetVersion = engine.getNodeSetVersion();
+
+    graph.addConnection({{oscNode->nodeID, 0}, {filterNode->nodeID, 0}});
+    EXPECT_EQ(engine.getModRoutingVersion(), routingVersion);
+    EXPECT_EQ(engine.getNodeSetVersion(), nodeSetVersion);
+
+    engine.addModRouting(lfoNode->nodeID, 0, filterNode->nodeID, 1);
+    EXPECT_NE(engine.getModRoutingVersion(), routingVersion);
+    routingVersion = engine.getModRoutingVersion();
+
+    // Rerouting the same slot is a routing change
+    auto routeID = engine.getActiveModRoutings()[0].routeID;
+    engine.rerouteModRouting(routeID, lfoNode->nodeID, 0, filterNode->nodeID, 2);
+    EXPECT_NE(engine.getModRoutingVersion(), routingVersion);
+    EXPECT_EQ(engine.getActiveModRoutings()[0].routeID, routeID);
+    EXPECT_EQ(engine.getActiveModRoutings()[0].destChannelIndex, 2);
+
+    // Bypass is read live, without a topology change
+    routingVersion = engine.getModRoutingVersion();
+    engine.toggleModBypass(routeID);
+    EXPECT_TRUE(engine.getActiveModRoutings()[0].isBypassed);
+    EXPECT_EQ(engine.getModRoutingVersion(), routingVersion);
+}
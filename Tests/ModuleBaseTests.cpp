@@ -1,5 +1,6 @@
 #include "Modules/ModuleBase.h"
 #include <gtest/gtest.h>
+#include <iterator>
 
 // Concrete implementation for testing
 class TestModule : public ModuleBase {
@@ -80,6 +81,64 @@ TEST_F(ModuleBaseTest, StateSerialization) {
     // Should not crash
 }
 
+TEST_F(ModuleBaseTest, BinaryStateIsCompactAndVersioned) {
+    juce::MemoryBlock savedData;
+    module.getStateInformation(savedData);
+
+    // Header plus one (hash, value) pair per parameter: bypassed and gain
+    ASSERT_EQ(savedData.getSize(), (size_t)(ModuleBase::kStateHeaderBytes + 2 * ModuleBase::kStateEntryBytes));
+    auto* bytes = static_cast<const char*>(savedData.getData());
+    EXPECT_EQ(juce::ByteOrder::littleEndianInt(bytes), ModuleBase::kStateMagic);
+    EXPECT_EQ(juce::ByteOrder::littleEndianInt(bytes + 4), ModuleBase::kStateVersion);
+    EXPECT_EQ(juce::ByteOrder::littleEndianInt(bytes + 8), 2u);
+
+    // A state from a newer version is ignored rather than misread
+    auto* param = module.getParameters()[1];
+    param->setValueNotifyingHost(0.3f);
+    juce::MemoryBlock newer(savedData);
+    auto newerVersion = juce::ByteOrder::swapIfBigEndian(ModuleBase::kStateVersion + 1);
+    newer.copyFrom(&newerVersion, 4, sizeof(newerVersion));
+    module.setStateInformation(newer.getData(), (int)newer.getSize());
+    EXPECT_FLOAT_EQ(param->getValue(), 0.3f);
+
+    module.setStateInformation(savedData.getData(), (int)savedData.getSize());
+    EXPECT_FLOAT_EQ(param->getValue(), 0.5f);
+}
+
+TEST_F(ModuleBaseTest, BinaryStateMatchesParametersByHash) {
+    // Entries out of order, plus one for a parameter this module doesn't have
+    struct Entry {
+        juce::uint32 hash;
+        float value;
+    };
+    const Entry entries[] = {{ModuleBase::hashParameterID("unknown"), 1.0f},
+                             {ModuleBase::hashParameterID("gain"), 0.25f},
+                             {ModuleBase::hashParameterID("bypassed"), 1.0f}};
+
+    juce::MemoryOutputStream stream;
+    stream.writeInt((int)ModuleBase::kStateMagic);
+    stream.writeInt((int)ModuleBase::kStateVersion);
+    stream.writeInt((int)std::size(entries));
+    for (auto& e : entries) {
+        stream.writeInt((int)e.hash);
+        stream.writeFloat(e.value);
+    }
+
+    module.setStateInformation(stream.getData(), (int)stream.getDataSize());
+    EXPECT_FLOAT_EQ(module.getParameters()[1]->getValue(), 0.25f);
+    EXPECT_TRUE(module.isBypassed());
+}
+
+TEST_F(ModuleBaseTest, LegacyXmlStateStillLoads) {
+    module.getParameters()[1]->setValueNotifyingHost(0.7f);
+    juce::MemoryBlock xmlData;
+    module.getXmlStateInformation(xmlData);
+
+    module.getParameters()[1]->setValueNotifyingHost(0.1f);
+    module.setStateInformation(xmlData.getData(), (int)xmlData.getSize());
+    EXPECT_FLOAT_EQ(module.getParameters()[1]->getValue(), 0.7f);
+}
+
 TEST_F(ModuleBaseTest, ProgramMethods) {
     // These are boilerplate but we should cover them
     module.setCurrentProgram(10); // Should ignore
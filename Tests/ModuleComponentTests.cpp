@@ -42,11 +42,11 @@ TEST_F(ModuleComponentTest, ParameterAttachmentLinksUI) {
     EXPECT_GE(foundSlider->getValue(), minVal);
 }
 
-TEST_F(ModuleComponentTest, TimerCallbackDoesNotCrash) {
+TEST_F(ModuleComponentTest, FrameCallbackDoesNotCrash) {
     AudioEngine engine;
     GraphEditor editor(engine);
     OscillatorModule processor;
     ModuleComponent moduleComponent(&processor, juce::AudioProcessorGraph::NodeID(1), editor);
 
-    EXPECT_NO_THROW(moduleComponent.timerCallback());
+    EXPECT_NO_THROW(moduleComponent.onFrame(0.0));
 }
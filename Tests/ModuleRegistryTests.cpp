@@ -0,0 +1,70 @@
+#include "ModuleRegistry.h"
+#include "Modules/FilterModule.h"
+#include "Modules/ModMatrixModule.h"
+#include "Modules/OscillatorModule.h"
+#include <gtest/gtest.h>
+
+using NodeID = juce::AudioProcessorGraph::NodeID;
+
+TEST(ModuleRegistryTest, IndexesNodesByIdAndType) {
+    juce::AudioProcessorGraph graph;
+    using IOProcessor = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+    auto input = graph.addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode));
+    auto osc1 = graph.addNode(std::make_unique<OscillatorModule>());
+    auto filter = graph.addNode(std::make_unique<FilterModule>());
+    auto osc2 = graph.addNode(std::make_unique<OscillatorModule>());
+
+    gsynth::ModuleRegistry registry;
+    registry.rebuild(graph);
+
+    EXPECT_EQ(registry.getNumNodes(), 4);
+    ASSERT_NE(registry.find(input->nodeID), nullptr);
+    EXPECT_EQ(registry.find(input->nodeID)->module, nullptr);
+    EXPECT_EQ(registry.getModule(filter->nodeID), filter->getProcessor());
+    EXPECT_TRUE(registry.isModuleType(osc2->nodeID, ModuleType::Oscillator));
+    EXPECT_FALSE(registry.isModuleType(filter->nodeID, ModuleType::Oscillator));
+    EXPECT_EQ(registry.find(NodeID{9999}), nullptr);
+
+    const auto& oscillators = registry.getNodesOfType(ModuleType::Oscillator);
+    ASSERT_EQ(oscillators.size(), 2u);
+    EXPECT_EQ(oscillators[0], osc1.get());
+    EXPECT_EQ(oscillators[1], osc2.get());
+    EXPECT_TRUE(registry.getNodesOfType(ModuleType::ModMatrix).empty());
+}
+
+TEST(ModuleRegistryTest, FindsParametersById) {
+    juce::AudioProcessorGraph graph;
+    auto first = graph.addNode(std::make_unique<ModMatrixModule>());
+    auto second = graph.addNode(std::make_unique<ModMatrixModule>());
+
+    auto* matrix = static_cast<ModMatrixModule*>(second->getProcessor());
+    auto& amount = matrix->getAmountParameter(2);
+    amount.setValueNotifyingHost(amount.convertTo0to1(-0.5f));
+
+    gsynth::ModuleRegistry registry;
+    registry.rebuild(graph);
+
+    // Both matrices share the table built from the first
+    EXPECT_EQ(registry.getParameter(second->nodeID, "amount3"), &amount);
+    EXPECT_NE(registry.getParameter(first->nodeID, "amount3"), &amount);
+    EXPECT_EQ(registry.getParameter(second->nodeID, "bypassed"), &matrix->getBypassedParameter());
+    EXPECT_EQ(registry.getParameter(second->nodeID, "cutoff"), nullptr);
+    EXPECT_EQ(registry.getParameter(NodeID{9999}, "amount3"), nullptr);
+}
+
+TEST(ModuleRegistryTest, FollowsTheGraphAcrossRebuilds) {
+    juce::AudioProcessorGraph graph;
+    auto osc = graph.addNode(std::make_unique<OscillatorModule>());
+    auto far = graph.addNode(std::make_unique<FilterModule>(), NodeID{100000}); // Beyond the dense table
+
+    gsynth::ModuleRegistry registry;
+    registry.rebuild(graph);
+    EXPECT_EQ(registry.getModule(far->nodeID), far->getProcessor());
+
+    graph.removeNode(osc->nodeID);
+    registry.rebuild(graph);
+    EXPECT_EQ(registry.find(osc->nodeID), nullptr);
+    EXPECT_TRUE(registry.getNodesOfType(ModuleType::Oscillator).empty());
+    EXPECT_EQ(registry.getNodesOfType(ModuleType::Filter).size(), 1u);
+    EXPECT_TRUE(registry.isModuleType(NodeID{100000}, ModuleType::Filter));
+}
@@ -1,5 +1,6 @@
 #include "../Source/AI/OllamaProvider.h" // Correct path
-#include <future>                        // For std::promise/std::future
+#include <atomic>
+#include <future> // For std::promise/std::future
 #include <gtest/gtest.h>
 #include <juce_core/juce_core.h>
 
@@ -99,6 +100,109 @@ private:
     bool readCalled = false;
 };
 
+// Minimal HTTP server on 127.0.0.1 that answers every request with the given NDJSON
+// lines, pausing between them like a model generating tokens.
+class MockOllamaServer : public juce::Thread {
+public:
+    MockOllamaServer(juce::StringArray ndjsonLines, int delayBetweenLinesMs)
+        : juce::Thread("MockOllamaServer")
+        , lines(std::move(ndjsonLines))
+        , delayMs(delayBetweenLinesMs) {
+        listener.createListener(0, "127.0.0.1");
+        startThread();
+    }
+
+    ~MockOllamaServer() override {
+        signalThreadShouldExit();
+        listener.close(); // Unblocks waitForNextConnection()
+        stopThread(5000);
+    }
+
+    juce::String getHost() const { return "http://127.0.0.1:" + juce::String(listener.getBoundPort()); }
+
+    juce::String getLastRequestBody() {
+        const juce::ScopedLock sl(lock);
+        return lastRequestBody;
+    }
+
+private:
+    void run() override {
+        while (!threadShouldExit()) {
+            std::unique_ptr<juce::StreamingSocket> client(listener.waitForNextConnection());
+            if (client == nullptr || threadShouldExit())
+                break;
+            serve(*client);
+        }
+    }
+
+    void serve(juce::StreamingSocket& client) {
+        std::string request;
+        size_t headerEnd = std::string::npos;
+        size_t contentLength = 0;
+        char buffer[1024];
+
+        while (!threadShouldExit() && client.waitUntilReady(true, 2000) == 1) {
+            int bytesRead = client.read(buffer, (int)sizeof(buffer), false);
+            if (bytesRead <= 0)
+                break;
+            request.append(buffer, (size_t)bytesRead);
+
+            if (headerEnd == std::string::npos && (headerEnd = request.find("\r\n\r\n")) != std::string::npos) {
+                juce::String headers(request.substr(0, headerEnd));
+                for (auto& header : juce::StringArray::fromLines(headers)) {
+                    if (header.startsWithIgnoreCase("Content-Length:"))
+                        contentLength = (size_t)header.fromFirstOccurrenceOf(":", false, false).trim().getLargeIntValue();
+                    if (header.containsIgnoreCase("100-continue"))
+                        send(client, "HTTP/1.1 100 Continue\r\n\r\n");
+                }
+            }
+            if (headerEnd != std::string::npos && request.size() >= headerEnd + 4 + contentLength)
+                break;
+        }
+
+        if (headerEnd != std::string::npos) {
+            const juce::ScopedLock sl(lock);
+            lastRequestBody = request.substr(headerEnd + 4);
+        }
+
+        if (!send(client, "HTTP/1.1 200 OK\r\nContent-Type: application/x-ndjson\r\nConnection: close\r\n\r\n"))
+            return;
+        for (auto& line : lines) {
+            if (threadShouldExit() || clientHungUp(client) || !send(client, line + "\n"))
+                return;
+            wait(delayMs);
+        }
+    }
+
+    // Stop writing once the client has closed its end, rather than writing into a reset connection
+    static bool clientHungUp(juce::StreamingSocket& client) {
+        char byte;
+        return client.waitUntilReady(true, 0) == 1 && client.read(&byte, 1, false) <= 0;
+    }
+
+    static bool send(juce::StreamingSocket& client, const juce::String& text) {
+        auto numBytes = (int)text.getNumBytesAsUTF8();
+        return client.write(text.toRawUTF8(), numBytes) == numBytes;
+    }
+
+    juce::StreamingSocket listener;
+    juce::StringArray lines;
+    int delayMs;
+    juce::CriticalSection lock;
+    juce::String lastRequestBody;
+};
+
+static juce::String ndjsonToken(const juce::String& content, bool done = false) {
+    juce::DynamicObject::Ptr message = new juce::DynamicObject();
+    message->setProperty("role", "assistant");
+    message->setProperty("content", content);
+    juce::DynamicObject::Ptr chunk = new juce::DynamicObject();
+    chunk->setProperty("model", "mock-model");
+    chunk->setProperty("message", juce::var(message.get()));
+    chunk->setProperty("done", done);
+    return juce::JSON::toString(juce::var(chunk.get()), true);
+}
+
 class OllamaProviderTest : public ::testing::Test {
 protected:
     // This is set to an invalid host so it tries to connect and fails,
@@ -224,3 +328,85 @@ TEST_F(OllamaProviderTest, SendPromptTimeoutFails) {
     // So we can check for that string or a part of it.
     ASSERT_TRUE(std::get<0>(result).isEmpty()); // The response text should be empty string on timeout
 }
+
+TEST(OllamaProviderStreamingTest, StreamsTokensFromMockServer) {
+    MockOllamaServer server({ndjsonToken("Hel"), ndjsonToken("lo, "), ndjsonToken("world"), ndjsonToken("", true)}, 10);
+    gsynth::OllamaProvider provider{server.getHost()};
+    provider.setTestMode(true);
+    provider.setModel("mock-model");
+
+    juce::StringArray tokens; // Only touched by the provider's worker until the result arrives
+    MockCompletionCallback callback;
+    auto id = provider.sendPromptStreaming(
+        {{"user", "Say hello"}}, [&tokens](const juce::String& token) { tokens.add(token); },
+        [&callback](const juce::String& response, bool success) { callback(response, success); });
+    EXPECT_NE(id, 0);
+
+    auto result = callback.getResult();
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(result.first, "Hello, world");
+    EXPECT_EQ(tokens, juce::StringArray({"Hel", "lo, ", "world"}));
+
+    juce::var body = juce::JSON::parse(server.getLastRequestBody());
+    EXPECT_TRUE((bool)body["stream"]);
+    EXPECT_EQ(body["model"].toString(), "mock-model");
+    provider.stopThread(5000);
+}
+
+TEST(OllamaProviderStreamingTest, CancelsInFlightAndQueuedRequests) {
+    // A long, slow completion: left alone it would occupy the worker for ~10 s
+    juce::StringArray lines;
+    for (int i = 0; i < 200; ++i)
+        lines.add(ndjsonToken("token "));
+    MockOllamaServer server(lines, 50);
+
+    gsynth::OllamaProvider provider{server.getHost()};
+    provider.setTestMode(true);
+
+    std::promise<void> firstToken;
+    std::atomic<bool> sawToken{false};
+    MockCompletionCallback inFlight;
+    MockCompletionCallback queued;
+
+    provider.sendPromptStreaming(
+        {{"user", "Go on forever"}},
+        [&](const juce::String&) {
+            if (!sawToken.exchange(true))
+                firstToken.set_value();
+        },
+        [&inFlight](const juce::String& response, bool success) { inFlight(response, success); });
+    provider.sendPrompt({{"user", "Never sent"}},
+                        [&queued](const juce::String& response, bool success) { queued(response, success); });
+
+    ASSERT_EQ(firstToken.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    auto start = juce::Time::getMillisecondCounter();
+    provider.cancelAllRequests();
+
+    auto queuedResult = queued.getResult();
+    EXPECT_FALSE(queuedResult.second);
+    EXPECT_EQ(queuedResult.first, "Cancelled");
+
+    auto inFlightResult = inFlight.getResult();
+    EXPECT_FALSE(inFlightResult.second);
+    EXPECT_EQ(inFlightResult.first, "Cancelled");
+    EXPECT_LT(juce::Time::getMillisecondCounter() - start, 2000u); // Stopped at the next chunk, not the end
+    provider.stopThread(5000);
+}
+
+TEST(OllamaProviderStreamingTest, ReportsErrorLines) {
+    auto factory = [](const juce::URL&, const juce::URL::InputStreamOptions&) -> std::unique_ptr<juce::InputStream> {
+        return std::make_unique<MockInputStream>("{\"error\":\"model 'missing' not found\"}\n", false);
+    };
+    gsynth::OllamaProvider provider{"http://mock-host:11434", factory};
+    provider.setTestMode(true);
+
+    MockCompletionCallback callback;
+    provider.sendPrompt({{"user", "Hi"}},
+                        [&callback](const juce::String& response, bool success) { callback(response, success); });
+
+    auto result = callback.getResult();
+    EXPECT_FALSE(result.second);
+    EXPECT_TRUE(result.first.contains("not found"));
+    provider.stopThread(5000);
+}
@@ -188,6 +188,19 @@ TEST_F(OscillatorTest, PolyMode_IndependentVoices) {
     EXPECT_GT(polyBuffer.getRMSLevel(1, 0, 512), 0.0f);
 }
 
+TEST_F(OscillatorTest, PitchAndTuningInputsAreControlRate) {
+    for (int ch = 0; ch <= 4; ++ch)
+        EXPECT_EQ(oscillator.getInputPortRate(ch), PortRate::Control);
+    EXPECT_EQ(oscillator.getInputPortRate(5), PortRate::Audio); // Level
+
+    auto* polyP = dynamic_cast<juce::AudioParameterBool*>(oscillator.getParameters()[6]);
+    ASSERT_NE(polyP, nullptr);
+    *polyP = true;
+    for (int ch = 0; ch < kMaxPolyVoices + 4; ++ch)
+        EXPECT_EQ(oscillator.getInputPortRate(ch), PortRate::Control);
+    EXPECT_EQ(oscillator.getInputPortRate(kMaxPolyVoices + 4), PortRate::Audio);
+}
+
 TEST_F(OscillatorTest, MonoMode_BackwardsCompatible) {
     // Default: poly should be off
     auto noteOn = juce::MidiMessage::noteOn(1, 69, (juce::uint8)100);
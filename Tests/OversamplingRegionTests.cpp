@@ -0,0 +1,131 @@
+#include "Modules/FX/DistortionModule.h"
+#include "Modules/FilterModule.h"
+#include "Modules/OscillatorModule.h"
+#include "Modules/VCAModule.h"
+#include "OversamplingBinder.h"
+#include <cmath>
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kFrequency = 1000.0;
+
+float sine(double sample) {
+    return (float)std::sin(juce::MathConstants<double>::twoPi * kFrequency * sample / kSampleRate);
+}
+
+double getRoundTripLatency(int factor) {
+    return OversamplingFilter::getLatencyInSamples(factor, OversamplingFilter::Direction::Up) +
+           OversamplingFilter::getLatencyInSamples(factor, OversamplingFilter::Direction::Down);
+}
+
+} // namespace
+
+TEST(OversamplingFilterTest, RoundTripPassesALowSineDelayedByItsLatency) {
+    for (int factor : {2, 4}) {
+        constexpr int numSamples = 2048;
+        OversamplingFilter up, down;
+        up.prepare(factor, OversamplingFilter::Direction::Up, numSamples);
+        down.prepare(factor, OversamplingFilter::Direction::Down, numSamples);
+
+        std::vector<float> in(numSamples), oversampled((size_t)(numSamples * factor)), out(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            in[(size_t)i] = sine(i);
+        up.upsample(in.data(), oversampled.data(), numSamples);
+        down.downsample(oversampled.data(), out.data(), numSamples);
+
+        const double latency = getRoundTripLatency(factor);
+        EXPECT_GT(latency, 0.0);
+        for (int i = 256; i < numSamples; ++i)
+            ASSERT_NEAR(out[(size_t)i], sine(i - latency), 1.0e-2f) << "factor " << factor << ", sample " << i;
+    }
+}
+
+TEST(OversamplingBinderTest, MarkedChainBecomesOneRegion) {
+    using IOProcessor = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+    juce::AudioProcessorGraph graph;
+    auto osc = graph.addNode(std::make_unique<OscillatorModule>());
+    auto filter = graph.addNode(std::make_unique<FilterModule>());
+    auto distortion = graph.addNode(std::make_unique<DistortionModule>());
+    auto output = graph.addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode));
+    graph.addConnection({{osc->nodeID, 0}, {filter->nodeID, 0}});
+    graph.addConnection({{filter->nodeID, 0}, {distortion->nodeID, 0}});
+    graph.addConnection({{filter->nodeID, 0}, {distortion->nodeID, 1}});
+    graph.addConnection({{distortion->nodeID, 0}, {output->nodeID, 0}});
+
+    for (auto& node : {osc, filter, distortion})
+        gsynth::setOversamplingFactor(*node, 2);
+    gsynth::setOversamplingFactor(*output, 2); // Not a module; ignored
+    EXPECT_TRUE(gsynth::bindOversamplingRegions(graph));
+    EXPECT_FALSE(gsynth::bindOversamplingRegions(graph)); // Nothing changed
+
+    auto linkOf = [](auto& node) -> const OversamplingLink& {
+        return static_cast<ModuleBase*>(node->getProcessor())->getOversamplingLink();
+    };
+    for (auto& node : {osc, filter, distortion})
+        EXPECT_EQ(linkOf(node).getFactor(), 2);
+
+    using Kind = OversamplingLink::InputKind;
+    EXPECT_EQ(linkOf(filter).getBinding().inputs[0].kind, Kind::Inside);
+    EXPECT_EQ(linkOf(filter).getBinding().inputs[1].kind, Kind::Unconnected);
+    EXPECT_EQ(linkOf(distortion).getBinding().inputs[1].kind, Kind::Inside);
+    EXPECT_FALSE(linkOf(filter).getBinding().exitOutputs[0]);
+    EXPECT_TRUE(linkOf(distortion).getBinding().exitOutputs[0]);
+
+    // Nothing enters the region, so only the downsampling at its exit delays it
+    const auto downLatency = OversamplingFilter::getLatencyInSamples(2, OversamplingFilter::Direction::Down);
+    const int latency = (int)std::lround(downLatency);
+    EXPECT_EQ(osc->getProcessor()->getLatencySamples(), 0);
+    EXPECT_EQ(filter->getProcessor()->getLatencySamples(), 0);
+    EXPECT_EQ(distortion->getProcessor()->getLatencySamples(), latency);
+
+    // Taking the filter out splits the chain: the oscillator now exits into it
+    gsynth::setOversamplingFactor(*filter, 1);
+    EXPECT_TRUE(gsynth::bindOversamplingRegions(graph));
+    EXPECT_EQ(linkOf(filter).getFactor(), 1);
+    EXPECT_TRUE(linkOf(osc).getBinding().exitOutputs[0]);
+    EXPECT_EQ(osc->getProcessor()->getLatencySamples(), latency);
+    EXPECT_EQ(linkOf(distortion).getBinding().inputs[0].kind, Kind::Upsampled);
+    EXPECT_EQ(distortion->getProcessor()->getLatencySamples(), (int)std::lround(getRoundTripLatency(2)));
+}
+
+TEST(OversamplingRegionTest, BoundModuleRendersAtTheOversampledRate) {
+    constexpr int blockSize = 256;
+    VCAModule vca;
+
+    OversamplingLink::Binding binding;
+    binding.factor = 4;
+    binding.inputs.assign((size_t)vca.getTotalNumInputChannels(), {OversamplingLink::InputKind::Unconnected, {}});
+    binding.inputs[0].kind = OversamplingLink::InputKind::Upsampled;
+    binding.inputs[1].kind = OversamplingLink::InputKind::Held;
+    binding.exitOutputs.assign((size_t)vca.getTotalNumOutputChannels(), false);
+    binding.exitOutputs[0] = true;
+    binding.latencySamples = (int)std::lround(getRoundTripLatency(4));
+
+    auto& link = vca.getOversamplingLink();
+    link.suspend();
+    link.rebind(binding);
+    link.resume();
+
+    auto& gain = *dynamic_cast<juce::RangedAudioParameter*>(vca.getParameters()[0]);
+    gain.setValueNotifyingHost(1.0f);
+    vca.prepareToPlay(kSampleRate, blockSize);
+    EXPECT_EQ(vca.getLatencySamples(), binding.latencySamples);
+
+    juce::AudioBuffer<float> buffer(vca.getTotalNumInputChannels(), blockSize);
+    const double latency = getRoundTripLatency(4);
+    for (int block = 0; block < 8; ++block) {
+        buffer.clear();
+        for (int i = 0; i < blockSize; ++i) {
+            buffer.setSample(0, i, sine(block * blockSize + i));
+            buffer.setSample(1, i, 1.0f);
+        }
+        juce::MidiBuffer midi;
+        vca.processBlock(buffer, midi);
+
+        if (block > 0)
+            for (int i = 0; i < blockSize; ++i)
+                ASSERT_NEAR(buffer.getSample(0, i), sine(block * blockSize + i - latency), 1.0e-2f);
+    }
+}
@@ -0,0 +1,95 @@
+#include "AI/AIIntegrationService.h"
+#include "AI/PatchAudition.h"
+#include <gtest/gtest.h>
+#include <limits>
+
+namespace {
+
+// A free-running oscillator straight into the left output
+const char* kOscillatorPatch = R"({
+    "nodes": [
+        {"id": 1, "type": "Oscillator", "params": {"waveform": "Sine"}},
+        {"id": 2, "type": "Audio Output"}
+    ],
+    "connections": [{"src": 1, "srcPort": 0, "dst": 2, "dstPort": 0}]
+})";
+
+gsynth::PatchAuditioner::Settings shortSettings() {
+    gsynth::PatchAuditioner::Settings settings;
+    settings.seconds = 0.25;
+    settings.noteSeconds = 0.2;
+    settings.maxCpuPercent = 1000.0; // Don't let a slow CI machine fail the level checks
+    return settings;
+}
+
+} // namespace
+
+TEST(PatchAuditionTest, RendersPreviewAndMeasuresLevels) {
+    auto settings = shortSettings();
+    auto report = gsynth::PatchAuditioner::auditionNow(juce::JSON::parse(kOscillatorPatch), settings);
+
+    ASSERT_TRUE(report.built) << report.error;
+    EXPECT_EQ(report.preview.getNumSamples(), (int)(settings.seconds * settings.sampleRate));
+    EXPECT_GT(report.peak, 0.5f);
+    EXPECT_LE(report.peak, 1.01f);
+    EXPECT_GT(report.rms, 0.1f);
+    EXPECT_LT(std::abs(report.dcOffset), 0.05f);
+    EXPECT_EQ(report.nonFiniteSamples, 0);
+    EXPECT_TRUE(report.safe) << report.getSummary();
+
+    ASSERT_EQ(report.nodeCosts.size(), 1u); // I/O nodes aren't costed
+    EXPECT_TRUE(report.nodeCosts[0].name.startsWith("Oscillator"));
+    EXPECT_GE(report.nodeCosts[0].cpuPercent, 0.0);
+}
+
+TEST(PatchAuditionTest, ReportsPatchesThatCannotBeBuilt) {
+    auto report = gsynth::PatchAuditioner::auditionNow(juce::var("not a patch"), shortSettings());
+
+    EXPECT_FALSE(report.built);
+    EXPECT_FALSE(report.safe);
+    EXPECT_TRUE(report.getSummary().startsWith("Audition failed"));
+}
+
+TEST(PatchAuditionTest, FlagsNonFiniteAndRunawaySignals) {
+    auto settings = shortSettings();
+    juce::AudioBuffer<float> rendered(2, 64);
+    rendered.clear();
+    rendered.setSample(0, 3, std::numeric_limits<float>::quiet_NaN());
+    rendered.setSample(1, 7, std::numeric_limits<float>::infinity());
+    rendered.setSample(0, 10, 5.0f);
+
+    gsynth::AuditionReport report;
+    report.built = true;
+    gsynth::PatchAuditioner::analyse(report, rendered, settings);
+
+    EXPECT_EQ(report.nonFiniteSamples, 2);
+    EXPECT_FLOAT_EQ(report.peak, 5.0f);
+    EXPECT_FALSE(report.safe);
+    EXPECT_EQ(report.warnings.size(), 2);
+
+    // The preview is safe to play: non-finite samples zeroed, the rest clipped
+    EXPECT_EQ(report.preview.getSample(0, 3), 0.0f);
+    EXPECT_EQ(report.preview.getSample(1, 7), 0.0f);
+    EXPECT_EQ(report.preview.getSample(0, 10), 1.0f);
+}
+
+TEST(PatchAuditionTest, AuditionLeavesTheLiveGraphUntouched) {
+    juce::AudioProcessorGraph liveGraph;
+    ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(juce::JSON::parse(kOscillatorPatch), liveGraph, true, true));
+    auto before = juce::JSON::toString(gsynth::AIStateMapper::graphToJSON(liveGraph));
+
+    gsynth::AIIntegrationService service(liveGraph);
+    service.getAuditioner().setSettings(shortSettings());
+
+    std::shared_ptr<const gsynth::AuditionReport> result;
+    service.auditionPatch(R"({"mode": "merge", "nodes": [{"id": 3, "type": "Reverb"}]})", true,
+                          [&](std::shared_ptr<const gsynth::AuditionReport> report) { result = std::move(report); });
+
+    for (int i = 0; i < 200 && result == nullptr; ++i)
+        juce::MessageManager::getInstance()->runDispatchLoopUntil(10);
+
+    ASSERT_NE(result, nullptr);
+    EXPECT_TRUE(result->built) << result->error;
+    EXPECT_EQ(result->nodeCosts.size(), 2u); // The oscillator copied from the live patch, plus the reverb
+    EXPECT_EQ(juce::JSON::toString(gsynth::AIStateMapper::graphToJSON(liveGraph)), before);
+}
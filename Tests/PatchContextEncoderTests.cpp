@@ -0,0 +1,130 @@
+#include "AI/AIStateMapper.h"
+#include "AI/PatchContextEncoder.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+// Oscillator -> Filter -> Output with an LFO modulating the filter cutoff
+juce::var buildPatch(juce::AudioProcessorGraph& graph) {
+    auto json = juce::JSON::parse(R"({
+        "nodes": [
+            {"id": 1, "type": "Oscillator", "params": {"waveform": "Saw"}},
+            {"id": 2, "type": "Filter", "params": {"cutoff": 1200.0}},
+            {"id": 3, "type": "LFO"},
+            {"id": 4, "type": "Audio Output"}
+        ],
+        "connections": [
+            {"src": 1, "srcPort": 0, "dst": 2, "dstPort": 0},
+            {"src": 2, "srcPort": 0, "dst": 4, "dstPort": 0}
+        ],
+        "modulations": [{"source": 3, "dest": 2, "destPort": 1, "amount": 0.5}]
+    })");
+    EXPECT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(json, graph, true, true));
+    return gsynth::PatchContextEncoder::encode(graph);
+}
+
+const juce::var* findNode(const juce::var& snapshot, const juce::String& type) {
+    if (auto* nodes = snapshot["n"].getArray())
+        for (auto& n : *nodes)
+            if (n["t"].toString() == type)
+                return &n;
+    return nullptr;
+}
+
+} // namespace
+
+TEST(PatchContextEncoderTest, SnapshotKeepsOnlyNonDefaultState) {
+    juce::AudioProcessorGraph graph;
+    auto snapshot = buildPatch(graph);
+
+    EXPECT_EQ(snapshot["n"].size(), 4); // The mod matrix is folded into "m"
+    EXPECT_EQ(snapshot["c"].size(), 2);
+    ASSERT_EQ(snapshot["m"].size(), 1);
+    EXPECT_DOUBLE_EQ((double)snapshot["m"][0][4], 0.5);
+
+    auto* filter = findNode(snapshot, "Filter");
+    ASSERT_NE(filter, nullptr);
+    EXPECT_EQ((int)(*filter)["p"]["cutoff"], 1200);
+    EXPECT_EQ((*filter)["p"].getDynamicObject()->getProperties().size(), 1); // Defaults omitted
+
+    auto* lfo = findNode(snapshot, "LFO");
+    ASSERT_NE(lfo, nullptr);
+    EXPECT_FALSE(lfo->hasProperty("p"));
+
+    auto compactSize = juce::JSON::toString(snapshot, true).length();
+    auto fullSize = juce::JSON::toString(gsynth::AIStateMapper::graphToJSON(graph), true).length();
+    EXPECT_LT(compactSize * 2, fullSize);
+}
+
+TEST(PatchContextEncoderTest, SnapshotRebuildsTheSamePatch) {
+    juce::AudioProcessorGraph graph;
+    auto snapshot = buildPatch(graph);
+
+    juce::AudioProcessorGraph rebuilt;
+    ASSERT_TRUE(gsynth::PatchContextEncoder::isCompact(snapshot));
+    ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(snapshot, rebuilt, true, true));
+
+    EXPECT_EQ(rebuilt.getNumNodes(), graph.getNumNodes());
+    EXPECT_EQ(rebuilt.getConnections().size(), graph.getConnections().size());
+
+    auto again = gsynth::PatchContextEncoder::encode(rebuilt);
+    auto* filter = findNode(again, "Filter");
+    ASSERT_NE(filter, nullptr);
+    EXPECT_EQ((int)(*filter)["p"]["cutoff"], 1200);
+    ASSERT_EQ(again["m"].size(), 1);
+    EXPECT_DOUBLE_EQ((double)again["m"][0][4], 0.5);
+}
+
+TEST(PatchContextEncoderTest, DeltaListsOnlyChangesAndAppliesAsMerge) {
+    juce::AudioProcessorGraph graph;
+    auto before = buildPatch(graph);
+    EXPECT_TRUE(gsynth::PatchContextEncoder::diff(before, before).isVoid());
+
+    // Target state: new cutoff, Oscillator -> Filter cable gone, shallower modulation
+    auto after = juce::JSON::parse(juce::JSON::toString(before));
+    auto* filterNode = findNode(after, "Filter");
+    ASSERT_NE(filterNode, nullptr);
+    (*filterNode)["p"].getDynamicObject()->setProperty("cutoff", 900);
+    int filterId = (*filterNode)["i"];
+    auto* connections = after["c"].getArray();
+    for (int i = connections->size(); --i >= 0;)
+        if ((int)(*connections)[i][2] == filterId)
+            connections->remove(i);
+    after["m"][0].getArray()->set(4, 0.25);
+
+    auto delta = gsynth::PatchContextEncoder::diff(before, after);
+    ASSERT_TRUE(delta.isObject());
+    ASSERT_EQ(delta["n"].size(), 1);
+    EXPECT_EQ((int)delta["n"][0]["p"]["cutoff"], 900);
+    EXPECT_EQ(delta["n"][0]["p"].getDynamicObject()->getProperties().size(), 1);
+    EXPECT_EQ(delta["rc"].size(), 1);
+    EXPECT_EQ(delta["m"].size(), 1);
+    EXPECT_EQ(delta["rmm"].size(), 1);
+    EXPECT_FALSE(delta.hasProperty("rm"));
+    EXPECT_FALSE(delta.hasProperty("c"));
+
+    ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(delta, graph, false, true));
+    EXPECT_TRUE(gsynth::PatchContextEncoder::diff(gsynth::PatchContextEncoder::encode(graph), after).isVoid());
+}
+
+TEST(PatchContextEncoderTest, DeltaRemovesNodesWithoutListingTheirCables) {
+    juce::AudioProcessorGraph graph;
+    auto before = buildPatch(graph);
+
+    auto after = juce::JSON::parse(juce::JSON::toString(before));
+    int lfoId = (*findNode(after, "LFO"))["i"];
+    auto* nodes = after["n"].getArray();
+    for (int i = nodes->size(); --i >= 0;)
+        if ((int)(*nodes)[i]["i"] == lfoId)
+            nodes->remove(i);
+    after["m"].getArray()->clear();
+
+    auto delta = gsynth::PatchContextEncoder::diff(before, after);
+    ASSERT_EQ(delta["rm"].size(), 1);
+    EXPECT_EQ((int)delta["rm"][0], lfoId);
+    EXPECT_FALSE(delta.hasProperty("rmm")); // Implied by the node removal
+
+    auto expanded = gsynth::PatchContextEncoder::expand(delta);
+    EXPECT_EQ(expanded["mode"].toString(), "merge");
+    EXPECT_EQ(expanded["remove"].size(), 1);
+}
@@ -0,0 +1,118 @@
+#include "AI/AIStateMapper.h"
+#include "GraphTransaction.h"
+#include "ModMatrixRoutes.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+// numVoices chains of LFO -> (mod) Filter cutoff, Oscillator -> Filter -> VCA -> Output: four nodes,
+// three connections and one modulation per voice, plus the output
+juce::var buildLargePatch(int numVoices) {
+    juce::Array<juce::var> nodes, connections, modulations;
+    constexpr int kOutputId = 1;
+
+    auto addNode = [&nodes](int id, const char* type, juce::var params = {}) {
+        juce::DynamicObject::Ptr node = new juce::DynamicObject();
+        node->setProperty("id", id);
+        node->setProperty("type", type);
+        if (params.isObject())
+            node->setProperty("params", params);
+        nodes.add(juce::var(node.get()));
+    };
+    auto addConnection = [&connections](int src, int dst) {
+        juce::DynamicObject::Ptr c = new juce::DynamicObject();
+        c->setProperty("src", src);
+        c->setProperty("srcPort", 0);
+        c->setProperty("dst", dst);
+        c->setProperty("dstPort", 0);
+        connections.add(juce::var(c.get()));
+    };
+
+    addNode(kOutputId, "Audio Output");
+    for (int v = 0; v < numVoices; ++v) {
+        int lfo = 10 + v * 4, osc = lfo + 1, filter = lfo + 2, vca = lfo + 3;
+        addNode(lfo, "LFO", juce::JSON::parse(R"({"rateHz": 2.5})"));
+        addNode(osc, "Oscillator", juce::JSON::parse(R"({"waveform": "Saw", "fine": 5.0, "level": 0.8})"));
+        addNode(filter, "Filter", juce::JSON::parse(R"({"cutoff": 1200.0, "resonance": 0.3})"));
+        addNode(vca, "VCA", juce::JSON::parse(R"({"gain": 0.7})"));
+        addConnection(osc, filter);
+        addConnection(filter, vca);
+        addConnection(vca, kOutputId);
+
+        juce::DynamicObject::Ptr mod = new juce::DynamicObject();
+        mod->setProperty("source", lfo);
+        mod->setProperty("dest", filter);
+        mod->setProperty("destPort", 1);
+        mod->setProperty("amount", 0.5);
+        modulations.add(juce::var(mod.get()));
+    }
+
+    juce::DynamicObject::Ptr patch = new juce::DynamicObject();
+    patch->setProperty("nodes", nodes);
+    patch->setProperty("connections", connections);
+    patch->setProperty("modulations", modulations);
+    return juce::var(patch.get());
+}
+
+} // namespace
+
+// Load time against patch size is measured by the PatchLoad benchmark in GravisynthBench
+TEST(PatchLoadTest, LargePatchLoadsWithOneRebuild) {
+    juce::AudioProcessorGraph graph;
+    int rebuildsBefore = gsynth::GraphTransaction::getNumRebuilds();
+    ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(buildLargePatch(50), graph, true, true));
+    // The modulations share mod matrices of ModMatrixModule::kNumSlots routes each
+    EXPECT_EQ(graph.getNumNodes(), 1 + 50 * 4 + 2);
+    EXPECT_EQ(gsynth::getModRoutes(graph).size(), 50u);
+    EXPECT_EQ(gsynth::GraphTransaction::getNumRebuilds() - rebuildsBefore, 1);
+}
+
+TEST(PatchLoadTest, ModulationIndexHandlesDuplicatesAndRemovals) {
+    juce::AudioProcessorGraph graph;
+    ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(buildLargePatch(3), graph, true, true));
+
+    // Merges address nodes by their graph IDs
+    auto mods = gsynth::AIStateMapper::graphToJSON(graph)["modulations"];
+    ASSERT_EQ(mods.size(), 3);
+    auto kept = mods[0];
+    auto removed = mods[1];
+
+    // Re-sending an existing modulation adds nothing; removing one frees exactly its route
+    juce::DynamicObject::Ptr removal = new juce::DynamicObject();
+    removal->setProperty("source", removed["source"]);
+    removal->setProperty("dest", removed["dest"]);
+    removal->setProperty("destPort", removed["destPort"]);
+
+    juce::DynamicObject::Ptr merge = new juce::DynamicObject();
+    merge->setProperty("mode", "merge");
+    merge->setProperty("modulations", juce::Array<juce::var>{kept});
+    merge->setProperty("removeModulations", juce::Array<juce::var>{juce::var(removal.get())});
+    ASSERT_TRUE(gsynth::AIStateMapper::applyJSONToGraph(juce::var(merge.get()), graph, false, true));
+    EXPECT_EQ(gsynth::getModRoutes(graph).size(), 2u);
+
+    auto after = gsynth::AIStateMapper::graphToJSON(graph)["modulations"];
+    ASSERT_EQ(after.size(), 2);
+    for (auto& m : *after.getArray())
+        EXPECT_NE((int)m["source"], (int)removed["source"]);
+}
+
+TEST(PatchLoadTest, PerParameterLoggingIsOptIn) {
+    struct LogCounter : public juce::Logger {
+        LogCounter() { juce::Logger::setCurrentLogger(this); }
+        ~LogCounter() override { juce::Logger::setCurrentLogger(nullptr); }
+        void logMessage(const juce::String& message) override { count += message.contains("setting") ? 1 : 0; }
+        int count = 0;
+    } logger;
+
+    auto patch = juce::JSON::parse(R"({"nodes": [{"id": 1, "type": "Filter", "params": {"cutoff": 800.0}}]})");
+    juce::AudioProcessorGraph graph;
+
+    ASSERT_FALSE(gsynth::AIStateMapper::isVerboseLogging());
+    gsynth::AIStateMapper::applyJSONToGraph(patch, graph, true, true);
+    EXPECT_EQ(logger.count, 0);
+
+    gsynth::AIStateMapper::setVerboseLogging(true);
+    gsynth::AIStateMapper::applyJSONToGraph(patch, graph, true, true);
+    gsynth::AIStateMapper::setVerboseLogging(false);
+    EXPECT_EQ(logger.count, 1);
+}
@@ -17,82 +17,114 @@ TEST_F(PolyMidiModuleTest, NoteOnAllocatesVoice) {
     juce::MidiBuffer midi;
     midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0);
 
-    juce::AudioBuffer<float> buffer(16, 512);
+    juce::AudioBuffer<float> buffer(2 * kMaxPolyVoices, 512);
     module->processBlock(buffer, midi);
 
     // After Note On, at least one voice should be active
-    uint8_t mask = module->getActiveVoiceMask();
-    EXPECT_NE(mask, 0);
+    VoiceMask mask = module->getActiveVoiceMask();
+    EXPECT_NE(mask, 0u);
 }
 
 TEST_F(PolyMidiModuleTest, NoteOffDeactivatesVoice) {
     juce::MidiBuffer midi;
     midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0);
 
-    juce::AudioBuffer<float> buffer(16, 512);
+    juce::AudioBuffer<float> buffer(2 * kMaxPolyVoices, 512);
     module->processBlock(buffer, midi);
 
-    EXPECT_NE(module->getActiveVoiceMask(), 0);
+    EXPECT_NE(module->getActiveVoiceMask(), 0u);
 
     midi.clear();
     midi.addEvent(juce::MidiMessage::noteOff(1, 60), 0);
     module->processBlock(buffer, midi);
 
     // Note off should immediately set voice inactive (though it might still have smoothed release in audio)
-    EXPECT_EQ(module->getActiveVoiceMask(), 0);
+    EXPECT_EQ(module->getActiveVoiceMask(), 0u);
 }
 
 TEST_F(PolyMidiModuleTest, VoiceStealingLRU) {
-    juce::AudioBuffer<float> buffer(16, 512);
+    juce::AudioBuffer<float> buffer(2 * kMaxPolyVoices, 512);
 
-    // Switch on 8 voices
-    for (int i = 0; i < 8; ++i) {
+    constexpr VoiceMask allVoices = VoicePool<kMaxPolyVoices>::kAllVoicesMask;
+
+    // Switch on every voice, one block apart so sample positions differ
+    for (int i = 0; i < kMaxPolyVoices; ++i) {
         juce::MidiBuffer midi;
-        midi.addEvent(juce::MidiMessage::noteOn(1, 60 + i, 0.8f), 0);
+        midi.addEvent(juce::MidiMessage::noteOn(1, 20 + i, 0.8f), 0);
         module->processBlock(buffer, midi);
-        juce::Thread::sleep(2); // Ensure timestamps differ
     }
 
-    EXPECT_EQ(module->getActiveVoiceMask(), 0xFF);
+    EXPECT_EQ(module->getActiveVoiceMask(), allVoices);
 
-    // Add 9th voice - should steal the first one (note 60)
+    // One more note - should steal the oldest one (note 20 on voice 0)
     juce::MidiBuffer midi;
-    midi.addEvent(juce::MidiMessage::noteOn(1, 72, 0.8f), 0);
+    midi.addEvent(juce::MidiMessage::noteOn(1, 20 + kMaxPolyVoices, 0.8f), 0);
     module->processBlock(buffer, midi);
 
-    // We can't easily check which one was stolen without exposing voices,
-    // but we can check if it stays at 8 active voices
-    EXPECT_EQ(module->getActiveVoiceMask(), 0xFF);
+    EXPECT_EQ(module->getActiveVoiceMask(), allVoices);
+    EXPECT_EQ(module->getVoicePool().getVoiceForNote(20), VoicePool<kMaxPolyVoices>::kNoVoice);
+    EXPECT_EQ(module->getVoicePool().getVoiceForNote(20 + kMaxPolyVoices), 0);
 }
 
 TEST_F(PolyMidiModuleTest, AllNotesOff) {
-    juce::AudioBuffer<float> buffer(16, 512);
+    juce::AudioBuffer<float> buffer(2 * kMaxPolyVoices, 512);
     juce::MidiBuffer midi;
     midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0);
     midi.addEvent(juce::MidiMessage::noteOn(1, 64, 0.8f), 0);
     module->processBlock(buffer, midi);
 
-    EXPECT_NE(module->getActiveVoiceMask(), 0);
+    EXPECT_NE(module->getActiveVoiceMask(), 0u);
 
     midi.clear();
     midi.addEvent(juce::MidiMessage::allNotesOff(1), 0);
     module->processBlock(buffer, midi);
 
-    EXPECT_EQ(module->getActiveVoiceMask(), 0);
+    EXPECT_EQ(module->getActiveVoiceMask(), 0u);
 }
 
 TEST_F(PolyMidiModuleTest, RenderChunk) {
-    juce::AudioBuffer<float> buffer(16, 512);
+    juce::AudioBuffer<float> buffer(2 * kMaxPolyVoices, 512);
     juce::MidiBuffer midi;
 
     // Note 60 = 261.63 Hz
     midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 0);
     module->processBlock(buffer, midi);
 
-    // Voice 0 should have frequency (~261) in pitch channel (0) and 1.0 in gate (8)
+    // Voice 0 should have frequency (~261) in pitch channel (0) and 1.0 in its gate channel
     // Wait, smoothed value takes time. Let's check after some samples.
     EXPECT_GT(buffer.getSample(0, 511), 200.0f);
-    EXPECT_GT(buffer.getSample(8, 511), 0.9f);
+    EXPECT_GT(buffer.getSample(kMaxPolyVoices, 511), 0.9f);
+}
+
+TEST_F(PolyMidiModuleTest, HasPitchAndGateChannelPerVoice) {
+    EXPECT_EQ(module->getTotalNumOutputChannels(), 2 * kMaxPolyVoices);
+}
+
+TEST_F(PolyMidiModuleTest, StealingUsesSamplePositionWithinBlock) {
+    juce::AudioBuffer<float> buffer(2 * kMaxPolyVoices, 512);
+    juce::MidiBuffer midi;
+
+    // All notes land in one block; order comes from the sample offsets alone
+    for (int i = 0; i < kMaxPolyVoices; ++i)
+        midi.addEvent(juce::MidiMessage::noteOn(1, 40 + i, 0.8f), i);
+    midi.addEvent(juce::MidiMessage::noteOn(1, 100, 0.8f), kMaxPolyVoices);
+    module->processBlock(buffer, midi);
+
+    EXPECT_EQ(module->getVoicePool().getVoiceForNote(40), VoicePool<kMaxPolyVoices>::kNoVoice);
+    EXPECT_EQ(module->getVoicePool().getVoiceForNote(100), 0);
+    EXPECT_EQ(module->getVoicePool().getStartSample(0), static_cast<uint64_t>(kMaxPolyVoices));
 }
 
-TEST_F(PolyMidiModuleTest, HasSixteenOutputChannels) { EXPECT_EQ(module->getTotalNumOutputChannels(), 16); }
+TEST_F(PolyMidiModuleTest, ReleasedVoiceHoldsPitch) {
+    juce::AudioBuffer<float> buffer(2 * kMaxPolyVoices, 512);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(1, 69, 1.0f), 0);
+    module->processBlock(buffer, midi);
+
+    midi.clear();
+    midi.addEvent(juce::MidiMessage::noteOff(1, 69), 0);
+    module->processBlock(buffer, midi);
+
+    EXPECT_NEAR(buffer.getSample(0, 511), 440.0f, 1.0f);
+    EXPECT_LT(buffer.getSample(kMaxPolyVoices, 511), 0.1f);
+}
@@ -0,0 +1,64 @@
+#include "UI/ScopeComponent.h"
+#include "UI/ScopeEnvelope.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+std::vector<float> sine(int numSamples, float cycles, float phase = 0.0f) {
+    std::vector<float> samples((size_t)numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        samples[(size_t)i] = std::sin(juce::MathConstants<float>::twoPi * cycles * (float)i / (float)numSamples + phase);
+    return samples;
+}
+
+} // namespace
+
+TEST(ScopeEnvelopeTest, ReducesToOneSpanPerColumn) {
+    auto samples = sine(1024, 4.0f);
+    ScopeEnvelope envelope;
+    envelope.build(samples.data(), (int)samples.size(), 200);
+
+    ASSERT_EQ(envelope.getNumColumns(), 200);
+    EXPECT_NEAR(envelope.getPeak(), 1.0f, 1.0e-3f);
+    for (int c = 0; c < envelope.getNumColumns(); ++c)
+        EXPECT_LE(envelope.getMin(c), envelope.getMax(c));
+
+    // Fewer samples than pixels: one column per sample
+    envelope.build(samples.data(), 50, 200);
+    EXPECT_EQ(envelope.getNumColumns(), 50);
+    EXPECT_FLOAT_EQ(envelope.getMin(7), samples[7]);
+    EXPECT_FLOAT_EQ(envelope.getMax(7), samples[7]);
+}
+
+TEST(ScopeEnvelopeTest, FindsRisingZeroCrossingPastNoise) {
+    auto samples = sine(1024, 8.0f, 1.0f); // Starts mid-cycle, period 128 samples
+    int edge = ScopeEnvelope::findRisingEdge(samples.data(), 512);
+    ASSERT_GE(edge, 0);
+    EXPECT_GE(samples[(size_t)edge], 0.0f);
+    EXPECT_LT(samples[(size_t)edge - 1], 0.0f);
+
+    std::vector<float> noise(256, 0.001f);
+    noise[10] = -0.001f;
+    EXPECT_EQ(ScopeEnvelope::findRisingEdge(noise.data(), (int)noise.size()), -1);
+}
+
+TEST(ScopeEnvelopeTest, TriggerSyncHoldsPeriodicWaveformsStill) {
+    VisualBuffer buffer;
+    ScopeComponent scope(buffer);
+    scope.setSize(200, 100);
+
+    auto samples = sine(VisualBuffer::DEFAULT_SIZE, 8.0f, 1.0f);
+    for (float s : samples)
+        buffer.pushSample(s);
+    scope.onFrame(0.0);
+    ASSERT_EQ(scope.getEnvelope().getNumColumns(), 200);
+
+    // Trigger sync: successive frames of a periodic signal land on the same phase
+    scope.setTriggerSync(true);
+    scope.onFrame(0.0);
+    auto firstMax = scope.getEnvelope().getMax(0);
+    for (int i = 0; i < 37; ++i) // Advance by a non-multiple of the period
+        buffer.pushSample(samples[(size_t)i]);
+    scope.onFrame(0.0);
+    EXPECT_NEAR(scope.getEnvelope().getMax(0), firstMax, 0.05f);
+}
@@ -89,4 +89,5 @@ TEST_F(ShortcutManagerTest, GetActionDescription_Works) {
     EXPECT_EQ(ShortcutManager::getActionDescription("openPreset"), "Open Preset");
     EXPECT_EQ(ShortcutManager::getActionDescription("undo"), "Undo");
     EXPECT_EQ(ShortcutManager::getActionDescription("redo"), "Redo");
+    EXPECT_EQ(ShortcutManager::getActionDescription("toggleTrace"), "Start/Stop Trace Capture");
 }
@@ -0,0 +1,100 @@
+#include "SpectrumAnalyser.h"
+#include "TripleBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(TripleBufferTest, ReaderOnlySeesNewerCompleteValues) {
+    gsynth::TripleBuffer<std::array<int, 64>> buffer;
+    constexpr int kFrames = 20000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (int i = 1; i <= kFrames; ++i) {
+            buffer.getWriteBuffer().fill(i);
+            buffer.publish();
+        }
+        done = true;
+    });
+
+    int last = 0;
+    bool finished = false;
+    while (!finished) {
+        finished = done.load();
+        if (buffer.update()) {
+            auto& frame = buffer.getReadBuffer();
+            EXPECT_TRUE(std::all_of(frame.begin(), frame.end(), [&](int v) { return v == frame[0]; })); // No tearing
+            EXPECT_GT(frame[0], last);
+            last = frame[0];
+        }
+    }
+    writer.join();
+
+    if (buffer.update())
+        last = buffer.getReadBuffer()[0];
+    EXPECT_EQ(last, kFrames);
+    EXPECT_FALSE(buffer.update());
+}
+
+TEST(SpectrumAnalyserTest, PublishesSinePeakToEverySubscriber) {
+    constexpr int kBin = 64;
+    auto buffer = std::make_unique<VisualBuffer>();
+    for (int i = 0; i < gsynth::SpectrumAnalyser::kFftSize; ++i)
+        buffer->pushSample(std::sin(juce::MathConstants<float>::twoPi * kBin * (float)i /
+                                    (float)gsynth::SpectrumAnalyser::kFftSize));
+
+    gsynth::SpectrumAnalyser analyser;
+    auto first = analyser.subscribe(*buffer);
+    auto second = analyser.subscribe(*buffer);
+    EXPECT_EQ(analyser.getNumSources(), 1); // Shared analysis per buffer
+
+    analyser.analysePending(); // May race the worker; either way a frame gets published
+
+    for (auto& subscription : {first, second}) {
+        const gsynth::SpectrumAnalyser::Frame* frame = nullptr;
+        for (int attempt = 0; attempt < 100 && frame == nullptr; ++attempt) {
+            frame = subscription->readLatest();
+            if (frame == nullptr)
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_NE(frame, nullptr);
+
+        auto peak = std::max_element(frame->magnitudes.begin(), frame->magnitudes.end());
+        EXPECT_EQ(std::distance(frame->magnitudes.begin(), peak), kBin);
+    }
+
+    // Destroying the buffer detaches it from the worker; subscriptions stay safe to poll
+    buffer.reset();
+    EXPECT_EQ(analyser.getNumSources(), 0);
+    first->readLatest();
+    analyser.unsubscribe(first);
+    analyser.unsubscribe(second);
+}
+
+TEST(SpectrumAnalyserTest, WaitsForAHopOfNewSamples) {
+    VisualBuffer buffer;
+    gsynth::SpectrumAnalyser analyser;
+    auto subscription = analyser.subscribe(buffer);
+
+    // Let the first (immediate) frame through, then drain it
+    for (int attempt = 0; attempt < 100 && subscription->readLatest() == nullptr; ++attempt)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    EXPECT_EQ(analyser.analysePending(), 0); // Nothing new since
+
+    for (int i = 0; i < gsynth::SpectrumAnalyser::kHopSize; ++i)
+        buffer.pushSample(0.5f);
+    // The worker may have taken this hop already; in either case exactly one more frame appears
+    analyser.analysePending();
+    const gsynth::SpectrumAnalyser::Frame* frame = nullptr;
+    for (int attempt = 0; attempt < 100 && frame == nullptr; ++attempt) {
+        frame = subscription->readLatest();
+        if (frame == nullptr)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_NE(frame, nullptr);
+
+    analyser.unsubscribe(subscription);
+    EXPECT_EQ(analyser.getNumSources(), 0);
+}
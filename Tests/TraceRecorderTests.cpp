@@ -0,0 +1,135 @@
+#include "Modules/OscillatorModule.h"
+#include "TraceRecorder.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace {
+
+juce::Array<juce::var> completeEvents(const juce::var& trace, const juce::String& name) {
+    juce::Array<juce::var> result;
+    if (auto* events = trace["traceEvents"].getArray())
+        for (auto& e : *events)
+            if (e["ph"].toString() == "X" && e["name"].toString() == name)
+                result.add(e);
+    return result;
+}
+
+} // namespace
+
+TEST(TraceRecorderTest, ExportsScopesAsChromeTraceJSON) {
+    auto& recorder = gsynth::TraceRecorder::getInstance();
+    recorder.start();
+    {
+        GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::outer");
+        GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::inner");
+    }
+    recorder.stop();
+
+    auto trace = juce::JSON::parse(recorder.toChromeTraceJSON());
+    ASSERT_TRUE(trace.isObject());
+
+    auto outer = completeEvents(trace, "TraceRecorderTest::outer");
+    auto inner = completeEvents(trace, "TraceRecorderTest::inner");
+    ASSERT_EQ(outer.size(), 1);
+    ASSERT_EQ(inner.size(), 1);
+    EXPECT_EQ(outer[0]["cat"].toString(), "test");
+    EXPECT_GE((double)outer[0]["dur"], (double)inner[0]["dur"]);
+    EXPECT_LE((double)outer[0]["ts"], (double)inner[0]["ts"]);
+}
+
+TEST(TraceRecorderTest, IgnoresScopesWhileStopped) {
+    auto& recorder = gsynth::TraceRecorder::getInstance();
+    recorder.start();
+    recorder.stop();
+    { GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::stopped"); }
+
+    auto trace = juce::JSON::parse(recorder.toChromeTraceJSON());
+    EXPECT_TRUE(completeEvents(trace, "TraceRecorderTest::stopped").isEmpty());
+}
+
+TEST(TraceRecorderTest, RestartDiscardsEarlierEvents) {
+    auto& recorder = gsynth::TraceRecorder::getInstance();
+    recorder.start();
+    { GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::old"); }
+    recorder.start();
+    { GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::new"); }
+    recorder.stop();
+
+    auto trace = juce::JSON::parse(recorder.toChromeTraceJSON());
+    EXPECT_TRUE(completeEvents(trace, "TraceRecorderTest::old").isEmpty());
+    EXPECT_EQ(completeEvents(trace, "TraceRecorderTest::new").size(), 1);
+}
+
+TEST(TraceRecorderTest, SeparatesThreadsAndKeepsNewestWhenRingWraps) {
+    auto& recorder = gsynth::TraceRecorder::getInstance();
+    recorder.start();
+
+    std::thread worker([] {
+        gsynth::TraceRecorder::getInstance().setCurrentThreadName("TraceTestWorker");
+        for (int i = 0; i < gsynth::TraceRecorder::kEventsPerThread + 100; ++i) {
+            GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::worker");
+        }
+    });
+    worker.join();
+    { GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::main"); }
+    recorder.stop();
+
+    auto trace = juce::JSON::parse(recorder.toChromeTraceJSON());
+    auto workerEvents = completeEvents(trace, "TraceRecorderTest::worker");
+    auto mainEvents = completeEvents(trace, "TraceRecorderTest::main");
+    // A full ring exports all but its oldest slot, which a live writer would be overwriting next
+    EXPECT_EQ(workerEvents.size(), gsynth::TraceRecorder::kEventsPerThread - 1);
+    ASSERT_EQ(mainEvents.size(), 1);
+    EXPECT_NE((int)workerEvents[0]["tid"], (int)mainEvents[0]["tid"]);
+
+    bool named = false;
+    for (auto& e : *trace["traceEvents"].getArray())
+        if (e["ph"].toString() == "M" && e["args"]["name"].toString() == "TraceTestWorker")
+            named = (int)e["tid"] == (int)workerEvents[0]["tid"];
+    EXPECT_TRUE(named);
+}
+
+TEST(TraceRecorderTest, ReusesTheRingsOfExitedThreads) {
+    auto& recorder = gsynth::TraceRecorder::getInstance();
+    recorder.start();
+
+    // More threads than rings over the run, as audio restarts and AI workers come and go
+    for (int i = 0; i < gsynth::TraceRecorder::kMaxThreads * 2; ++i)
+        std::thread([] { GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::shortLived"); }).join();
+
+    std::thread late([] {
+        gsynth::TraceRecorder::getInstance().setCurrentThreadName("TraceTestLate");
+        GSYNTH_TRACE_SCOPE("test", "TraceRecorderTest::late");
+    });
+    late.join();
+    recorder.stop();
+
+    auto trace = juce::JSON::parse(recorder.toChromeTraceJSON());
+    auto lateEvents = completeEvents(trace, "TraceRecorderTest::late");
+    ASSERT_EQ(lateEvents.size(), 1);
+
+    // A reused ring exports only its current thread's events, under that thread's name
+    for (auto& e : completeEvents(trace, "TraceRecorderTest::shortLived"))
+        EXPECT_NE((int)e["tid"], (int)lateEvents[0]["tid"]);
+    bool named = false;
+    for (auto& e : *trace["traceEvents"].getArray())
+        if (e["ph"].toString() == "M" && (int)e["tid"] == (int)lateEvents[0]["tid"])
+            named = e["args"]["name"].toString() == "TraceTestLate";
+    EXPECT_TRUE(named);
+}
+
+TEST(TraceRecorderTest, RecordsModuleProcessBlocks) {
+    auto& recorder = gsynth::TraceRecorder::getInstance();
+    OscillatorModule osc;
+    osc.setPlayConfigDetails(osc.getTotalNumInputChannels(), osc.getTotalNumOutputChannels(), 44100.0, 64);
+    osc.prepareToPlay(44100.0, 64);
+    juce::AudioBuffer<float> buffer(juce::jmax(osc.getTotalNumInputChannels(), osc.getTotalNumOutputChannels()), 64);
+    juce::MidiBuffer midi;
+
+    recorder.start();
+    osc.processBlock(buffer, midi);
+    recorder.stop();
+
+    auto trace = juce::JSON::parse(recorder.toChromeTraceJSON());
+    EXPECT_EQ(completeEvents(trace, "Oscillator").size(), 1);
+}
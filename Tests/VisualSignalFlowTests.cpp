@@ -1,85 +1,75 @@
 #include "AudioEngine.h"
-#include "Modules/AttenuverterModule.h"
 #include "Modules/LFOModule.h"
+#include "Modules/ModMatrixModule.h"
 #include "Modules/VCAModule.h"
 #include "Modules/VisualBuffer.h"
 #include <cmath>
 #include <gtest/gtest.h>
 
-// --- AttenuverterModule Peak/Mod Tracking Tests ---
+// --- ModMatrixModule Peak/Mod Tracking Tests ---
 
-class AttenuverterVisualTests : public ::testing::Test {
+class ModMatrixVisualTests : public ::testing::Test {
 protected:
-    std::unique_ptr<AttenuverterModule> module;
+    std::unique_ptr<ModMatrixModule> module;
+    int slot = -1;
 
     void SetUp() override {
-        module = std::make_unique<AttenuverterModule>();
+        module = std::make_unique<ModMatrixModule>();
         module->prepareToPlay(44100.0, 512);
+        module->allocateSlot(0.0f, false); // Slot 0 stays silent
+        slot = module->allocateSlot(0.0f, false);
+    }
+
+    // Feeds value into the slot under test for numBlocks blocks
+    void process(float value, int numSamples, int numBlocks = 1) {
+        juce::MidiBuffer midi;
+        for (int block = 0; block < numBlocks; ++block) {
+            juce::AudioBuffer<float> buffer(ModMatrixModule::kNumSlots, numSamples);
+            buffer.clear();
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample(slot, i, value);
+            module->processBlock(buffer, midi);
+        }
     }
 };
 
-TEST_F(AttenuverterVisualTests, PeakTrackingWithSignal) {
+TEST_F(ModMatrixVisualTests, PeakTrackingWithSignal) {
     // Set amount to 1.0 (full pass-through)
-    if (auto* amt = dynamic_cast<juce::AudioParameterFloat*>(module->getParameters()[1]))
-        amt->setValueNotifyingHost(amt->convertTo0to1(1.0f));
+    auto& amount = module->getAmountParameter(slot);
+    amount.setValueNotifyingHost(amount.convertTo0to1(1.0f));
 
-    juce::MidiBuffer midi;
     // Process multiple blocks to let SmoothedValue ramp to target
-    for (int block = 0; block < 5; ++block) {
-        juce::AudioBuffer<float> buffer(2, 512);
-        buffer.clear();
-        for (int i = 0; i < 512; ++i)
-            buffer.setSample(0, i, 0.5f);
-        module->processBlock(buffer, midi);
-    }
+    process(0.5f, 512, 5);
 
-    EXPECT_NEAR(module->getLastOutputPeak(), 0.5f, 0.05f);
+    EXPECT_NEAR(module->getLastOutputPeak(slot), 0.5f, 0.05f);
+    EXPECT_FLOAT_EQ(module->getLastOutputPeak(0), 0.0f);
 }
 
-TEST_F(AttenuverterVisualTests, ModValueTrackingReturnsMidBlockSample) {
-    if (auto* amt = dynamic_cast<juce::AudioParameterFloat*>(module->getParameters()[1]))
-        amt->setValueNotifyingHost(amt->convertTo0to1(1.0f));
+TEST_F(ModMatrixVisualTests, ModValueTrackingReturnsMidBlockSample) {
+    auto& amount = module->getAmountParameter(slot);
+    amount.setValueNotifyingHost(amount.convertTo0to1(1.0f));
 
-    juce::MidiBuffer midi;
-    // Process multiple blocks to let SmoothedValue ramp to target
-    for (int block = 0; block < 5; ++block) {
-        juce::AudioBuffer<float> buffer(2, 512);
-        buffer.clear();
-        for (int i = 0; i < 512; ++i)
-            buffer.setSample(0, i, 0.75f);
-        module->processBlock(buffer, midi);
-    }
+    process(0.75f, 512, 5);
 
-    EXPECT_NEAR(module->getLastModValue(), 0.75f, 0.1f);
+    EXPECT_NEAR(module->getLastModValue(slot), 0.75f, 0.1f);
 }
 
-TEST_F(AttenuverterVisualTests, BypassedReturnsZeroPeakAndMod) {
-    // Set bypass (parameter index 0 in ModuleBase)
-    if (auto* bp = dynamic_cast<juce::AudioParameterBool*>(module->getParameters()[0]))
-        bp->setValueNotifyingHost(1.0f);
-
-    juce::AudioBuffer<float> buffer(2, 128);
-    for (int i = 0; i < 128; ++i)
-        buffer.setSample(0, i, 1.0f);
-    juce::MidiBuffer midi;
+TEST_F(ModMatrixVisualTests, BypassedReturnsZeroPeakAndMod) {
+    auto& amount = module->getAmountParameter(slot);
+    amount.setValueNotifyingHost(amount.convertTo0to1(1.0f));
+    module->getBypassParameter(slot).setValueNotifyingHost(1.0f);
 
-    module->processBlock(buffer, midi);
+    process(1.0f, 128);
 
-    EXPECT_FLOAT_EQ(module->getLastOutputPeak(), 0.0f);
-    EXPECT_FLOAT_EQ(module->getLastModValue(), 0.0f);
+    EXPECT_FLOAT_EQ(module->getLastOutputPeak(slot), 0.0f);
+    EXPECT_FLOAT_EQ(module->getLastModValue(slot), 0.0f);
 }
 
-TEST_F(AttenuverterVisualTests, ZeroAmountProducesZeroPeak) {
-    // Default amount is 0.0
-    juce::AudioBuffer<float> buffer(2, 128);
-    buffer.clear();
-    for (int i = 0; i < 128; ++i)
-        buffer.setSample(0, i, 1.0f);
-    juce::MidiBuffer midi;
-
-    module->processBlock(buffer, midi);
+TEST_F(ModMatrixVisualTests, ZeroAmountProducesZeroPeak) {
+    // The slot was allocated with amount 0.0
+    process(1.0f, 128);
 
-    EXPECT_NEAR(module->getLastOutputPeak(), 0.0f, 0.05f);
+    EXPECT_NEAR(module->getLastOutputPeak(slot), 0.0f, 0.05f);
 }
 
 // --- VisualBuffer RMS Computation Test ---
@@ -136,8 +126,8 @@ TEST_F(ModulationDisplayInfoTests, EmptyGraphReturnsEmptyInfo) {
     EXPECT_TRUE(info.empty());
 }
 
-TEST_F(ModulationDisplayInfoTests, UnconnectedAttenuverterIsExcluded) {
-    // Add an empty mod routing (attenuverter with no connections)
+TEST_F(ModulationDisplayInfoTests, UnconnectedRoutingIsExcluded) {
+    // Add an empty mod routing (a matrix slot with no connections)
     engine->addEmptyModRouting();
 
     auto info = engine->getModulationDisplayInfo();
@@ -147,7 +137,7 @@ TEST_F(ModulationDisplayInfoTests, UnconnectedAttenuverterIsExcluded) {
 TEST_F(ModulationDisplayInfoTests, ConnectedRoutingAppearsInInfo) {
     auto& graph = engine->getGraph();
 
-    // Use non-attenuverter modules as src/dst to avoid false matches
+    // Use non-matrix modules as src/dst to avoid false matches
     auto srcNode = graph.addNode(std::make_unique<LFOModule>());
     auto dstNode = graph.addNode(std::make_unique<VCAModule>());
     ASSERT_NE(srcNode, nullptr);
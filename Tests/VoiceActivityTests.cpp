@@ -0,0 +1,147 @@
+#include "Modules/ADSRModule.h"
+#include "Modules/FilterModule.h"
+#include "Modules/LFOModule.h"
+#include "Modules/OscillatorModule.h"
+#include "Modules/PolyMidiModule.h"
+#include "VoiceActivityBinder.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+void setParameter(juce::AudioProcessor& processor, const juce::String& paramID, float normalisedValue) {
+    for (auto* param : processor.getParameters())
+        if (auto* p = dynamic_cast<juce::AudioProcessorParameterWithID*>(param); p != nullptr && p->paramID == paramID)
+            p->setValueNotifyingHost(normalisedValue);
+}
+
+void processNote(PolyMidiModule& polyMidi, juce::AudioBuffer<float>& buffer, bool noteOn) {
+    juce::MidiBuffer midi;
+    midi.addEvent(noteOn ? juce::MidiMessage::noteOn(1, 60, 0.8f) : juce::MidiMessage::noteOff(1, 60), 0);
+    polyMidi.processBlock(buffer, midi);
+}
+
+} // namespace
+
+TEST(VoiceActivityTest, PolyMidiPublishesVoicesUntilTheirGateCloses) {
+    PolyMidiModule polyMidi;
+    polyMidi.prepareToPlay(44100.0, 512);
+    juce::AudioBuffer<float> buffer(2 * kMaxPolyVoices, 512);
+    auto activity = polyMidi.getVoiceActivity();
+
+    processNote(polyMidi, buffer, true);
+    EXPECT_EQ(activity->getSoundingVoices(), polyMidi.getActiveVoiceMask());
+    EXPECT_NE(activity->getSoundingVoices(), 0u);
+
+    // The gate closes within the block of the note-off, which still counts as sounding
+    processNote(polyMidi, buffer, false);
+    EXPECT_NE(activity->getSoundingVoices(), 0u);
+
+    juce::MidiBuffer midi;
+    polyMidi.processBlock(buffer, midi);
+    EXPECT_EQ(activity->getSoundingVoices(), 0u);
+}
+
+TEST(VoiceActivityTest, OscillatorRendersOnlySoundingVoices) {
+    PolyMidiModule polyMidi;
+    polyMidi.prepareToPlay(44100.0, 512);
+    juce::AudioBuffer<float> midiOut(2 * kMaxPolyVoices, 512);
+    processNote(polyMidi, midiOut, true); // Voice 0 only
+
+    OscillatorModule oscillator;
+    oscillator.prepareToPlay(44100.0, 512);
+    setParameter(oscillator, "poly", 1.0f);
+
+    juce::AudioBuffer<float> buffer(kMaxPolyVoices + 6, 512);
+    auto render = [&] {
+        buffer.clear();
+        for (int v = 0; v < 2; ++v)
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(v), 440.0f, 512);
+        juce::MidiBuffer midi;
+        oscillator.processBlock(buffer, midi);
+    };
+
+    render(); // Unbound: every voice with a pitch renders
+    EXPECT_GT(buffer.getMagnitude(1, 0, 512), 0.1f);
+
+    oscillator.getVoiceActivityLink().bind(polyMidi.getVoiceActivity());
+    render();
+    EXPECT_GT(buffer.getMagnitude(0, 0, 512), 0.1f);
+    EXPECT_EQ(buffer.getMagnitude(1, 0, 512), 0.0f);
+}
+
+TEST(VoiceActivityTest, EnvelopeKeepsReleasedVoicesSoundingUntilItFinishes) {
+    PolyMidiModule polyMidi;
+    polyMidi.prepareToPlay(44100.0, 512);
+    auto activity = polyMidi.getVoiceActivity();
+    activity->setNumEnvelopes(1);
+
+    ADSRModule adsr;
+    adsr.prepareToPlay(44100.0, 512);
+    setParameter(adsr, "poly", 1.0f);
+    setParameter(adsr, "sustain", 1.0f);
+    adsr.getVoiceActivityLink().bind(activity, 0);
+
+    juce::AudioBuffer<float> midiOut(2 * kMaxPolyVoices, 512);
+    juce::AudioBuffer<float> envelope(kMaxPolyVoices, 512);
+    auto processEnvelope = [&] {
+        for (int v = 0; v < kMaxPolyVoices; ++v)
+            envelope.copyFrom(v, 0, midiOut, kMaxPolyVoices + v, 0, 512);
+        juce::MidiBuffer midi;
+        adsr.processBlock(envelope, midi);
+    };
+
+    processNote(polyMidi, midiOut, true);
+    processEnvelope();
+    processNote(polyMidi, midiOut, false);
+    processEnvelope();
+
+    // The gate has closed, but the release (0.1 s by default) is still running
+    juce::MidiBuffer none;
+    polyMidi.processBlock(midiOut, none);
+    processEnvelope();
+    EXPECT_NE(activity->getSoundingVoices(), 0u);
+
+    for (int block = 0; block < 20; ++block) {
+        polyMidi.processBlock(midiOut, none);
+        processEnvelope();
+    }
+    EXPECT_EQ(activity->getSoundingVoices(), 0u);
+}
+
+TEST(VoiceActivityTest, BinderFollowsVoiceChannelsFromEachPolyMidi) {
+    juce::AudioProcessorGraph graph;
+    auto polyMidi = graph.addNode(std::make_unique<PolyMidiModule>());
+    auto oscillator = graph.addNode(std::make_unique<OscillatorModule>());
+    auto adsr = graph.addNode(std::make_unique<ADSRModule>());
+    auto filter = graph.addNode(std::make_unique<FilterModule>());
+    auto lfo = graph.addNode(std::make_unique<LFOModule>());
+    auto drone = graph.addNode(std::make_unique<OscillatorModule>());
+    auto mixedFilter = graph.addNode(std::make_unique<FilterModule>());
+
+    graph.addConnection({{polyMidi->nodeID, 0}, {oscillator->nodeID, 0}});
+    graph.addConnection({{polyMidi->nodeID, kMaxPolyVoices}, {adsr->nodeID, 0}});
+    graph.addConnection({{oscillator->nodeID, 0}, {filter->nodeID, 0}});
+    graph.addConnection({{lfo->nodeID, 0}, {filter->nodeID, kMaxPolyVoices}}); // Shared cutoff CV
+    graph.addConnection({{oscillator->nodeID, 0}, {mixedFilter->nodeID, 0}});
+    graph.addConnection({{drone->nodeID, 0}, {mixedFilter->nodeID, 1}});
+
+    gsynth::bindVoiceActivity(graph);
+
+    auto link = [](auto& node) -> const VoiceActivityLink& {
+        return dynamic_cast<ModuleBase*>(node->getProcessor())->getVoiceActivityLink();
+    };
+    EXPECT_TRUE(link(oscillator).isBound());
+    EXPECT_TRUE(link(adsr).isBound());
+    EXPECT_EQ(link(adsr).getEnvelopeSlot(), 0);
+    EXPECT_EQ(link(oscillator).getEnvelopeSlot(), -1);
+    EXPECT_TRUE(link(filter).isBound());
+    EXPECT_FALSE(link(lfo).isBound());
+    EXPECT_FALSE(link(drone).isBound());
+    EXPECT_FALSE(link(mixedFilter).isBound()); // One voice comes from outside the chain
+
+    // Disconnecting the chain unbinds it on the next pass
+    graph.removeConnection({{polyMidi->nodeID, 0}, {oscillator->nodeID, 0}});
+    gsynth::bindVoiceActivity(graph);
+    EXPECT_FALSE(link(oscillator).isBound());
+    EXPECT_FALSE(link(filter).isBound());
+}
@@ -0,0 +1,82 @@
+#include "Modules/VoicePool.h"
+#include <gtest/gtest.h>
+
+using Pool8 = VoicePool<8>;
+
+TEST(VoicePoolTest, AllocatesVoicesInOrder) {
+    Pool8 pool;
+    for (int i = 0; i < 8; ++i)
+        EXPECT_EQ(pool.noteOn(60 + i, 1.0f, (uint64_t)i), i);
+
+    EXPECT_EQ(pool.getActiveMask(), Pool8::kAllVoicesMask);
+    EXPECT_EQ(pool.getNumActive(), 8);
+    EXPECT_EQ(pool.getNumFree(), 0);
+}
+
+TEST(VoicePoolTest, RetriggerReusesVoiceAndRefreshesAge) {
+    Pool8 pool;
+    pool.noteOn(60, 1.0f, 0);
+    pool.noteOn(62, 1.0f, 10);
+    EXPECT_EQ(pool.getOldestVoice(), 0);
+
+    EXPECT_EQ(pool.noteOn(60, 0.5f, 20), 0);
+    EXPECT_EQ(pool.getNumActive(), 2);
+    EXPECT_EQ(pool.getOldestVoice(), 1);
+    EXPECT_EQ(pool.getStartSample(0), 20u);
+    EXPECT_FLOAT_EQ(pool.getVelocity(0), 0.5f);
+}
+
+TEST(VoicePoolTest, StealsLeastRecentlyTriggered) {
+    Pool8 pool;
+    for (int i = 0; i < 8; ++i)
+        pool.noteOn(60 + i, 1.0f, (uint64_t)i * 100);
+
+    // Retrigger the oldest so voice 1 becomes the steal candidate
+    pool.noteOn(60, 1.0f, 1000);
+    EXPECT_EQ(pool.noteOn(80, 1.0f, 1100), 1);
+    EXPECT_EQ(pool.getVoiceForNote(61), Pool8::kNoVoice);
+    EXPECT_EQ(pool.getVoiceForNote(80), 1);
+    EXPECT_EQ(pool.getNumActive(), 8);
+}
+
+TEST(VoicePoolTest, ReusesLongestReleasedVoiceFirst) {
+    Pool8 pool;
+    for (int i = 0; i < 8; ++i)
+        pool.noteOn(60 + i, 1.0f, (uint64_t)i);
+
+    EXPECT_EQ(pool.noteOff(65), 5);
+    EXPECT_EQ(pool.noteOff(62), 2);
+    EXPECT_FALSE(pool.isActive(5));
+
+    EXPECT_EQ(pool.noteOn(90, 1.0f, 10), 5);
+    EXPECT_EQ(pool.noteOn(91, 1.0f, 11), 2);
+}
+
+TEST(VoicePoolTest, NoteOffForUnknownNoteIsIgnored) {
+    Pool8 pool;
+    pool.noteOn(60, 1.0f, 0);
+    EXPECT_EQ(pool.noteOff(61), Pool8::kNoVoice);
+    EXPECT_EQ(pool.noteOff(200), Pool8::kNoVoice);
+    EXPECT_EQ(pool.getNumActive(), 1);
+}
+
+TEST(VoicePoolTest, AllNotesOffFreesEverything) {
+    Pool8 pool;
+    for (int i = 0; i < 8; ++i)
+        pool.noteOn(60 + i, 1.0f, (uint64_t)i);
+
+    pool.allNotesOff();
+    EXPECT_EQ(pool.getActiveMask(), 0u);
+    EXPECT_EQ(pool.getNumFree(), 8);
+    EXPECT_EQ(pool.getOldestVoice(), Pool8::kNoVoice);
+    EXPECT_EQ(pool.getVoiceForNote(60), Pool8::kNoVoice);
+}
+
+TEST(VoicePoolTest, SixtyFourVoicesFillWholeMask) {
+    VoicePool<64> pool;
+    for (int i = 0; i < 64; ++i)
+        pool.noteOn(i, 1.0f, (uint64_t)i);
+
+    EXPECT_EQ(pool.getActiveMask(), ~VoiceMask{0});
+    EXPECT_EQ(pool.noteOn(100, 1.0f, 64), 0);
+}
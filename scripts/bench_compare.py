@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""Compare two GravisynthBench JSON results and fail on ns/sample regressions.
+
+Usage:
+    python3 scripts/bench_compare.py baseline.json current.json [--threshold 0.10]
+
+Both files are Google Benchmark JSON output (--benchmark_out_format=json).
+When repetitions are used, the median aggregate is compared; otherwise the
+single run. Exits 1 if any benchmark is slower than the baseline by more than
+the threshold (fractional, default 10%).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_ns_per_sample(path):
+    with open(path) as f:
+        data = json.load(f)
+
+    results = {}
+    medians = {}
+    for b in data.get("benchmarks", []):
+        ips = b.get("items_per_second")
+        if not ips:
+            continue
+        ns_per_sample = 1e9 / ips
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[b["run_name"]] = ns_per_sample
+        else:
+            results.setdefault(b.get("run_name", b["name"]), ns_per_sample)
+
+    results.update(medians)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10, help="allowed slowdown as a fraction (default 0.10)")
+    args = parser.parse_args()
+
+    baseline = load_ns_per_sample(args.baseline)
+    current = load_ns_per_sample(args.current)
+
+    regressions = []
+    print(f"{'benchmark':<60} {'base ns/smp':>12} {'new ns/smp':>12} {'change':>8}")
+    for name in sorted(current):
+        if name not in baseline:
+            print(f"{name:<60} {'-':>12} {current[name]:>12.3f}      new")
+            continue
+        base, new = baseline[name], current[name]
+        change = (new - base) / base
+        flag = ""
+        if change > args.threshold:
+            regressions.append(name)
+            flag = "  REGRESSION"
+        print(f"{name:<60} {base:>12.3f} {new:>12.3f} {change:>+7.1%}{flag}")
+
+    for name in sorted(set(baseline) - set(current)):
+        print(f"{name:<60} {baseline[name]:>12.3f} {'-':>12}  removed")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) regressed by more than {args.threshold:.0%}:")
+        for name in regressions:
+            print(f"  {name}")
+        return 1
+
+    print(f"\nNo regressions beyond {args.threshold:.0%}.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())